@@ -124,6 +124,30 @@ Ref<Resource> ResourceLoader::get_cached_ref(const String &p_path) {
 	return ResourceCache::get_ref(local_path);
 }
 
+void ResourceLoader::set_cache_retained_budget(int64_t p_bytes) {
+	ERR_FAIL_COND(p_bytes < 0);
+	ResourceCache::set_retained_budget(p_bytes);
+}
+
+int64_t ResourceLoader::get_cache_retained_budget() const {
+	return ResourceCache::get_retained_budget();
+}
+
+void ResourceLoader::clear_cache_retained() {
+	ResourceCache::clear_retained();
+}
+
+Dictionary ResourceLoader::get_cached_memory_usage() const {
+	HashMap<StringName, uint64_t> usage;
+	ResourceCache::get_resident_memory_usage_by_type(usage);
+
+	Dictionary ret;
+	for (const KeyValue<StringName, uint64_t> &E : usage) {
+		ret[E.key] = E.value;
+	}
+	return ret;
+}
+
 bool ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 	return ::ResourceLoader::exists(p_path, p_type_hint);
 }
@@ -149,6 +173,10 @@ void ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &ResourceLoader::get_dependencies);
 	ClassDB::bind_method(D_METHOD("has_cached", "path"), &ResourceLoader::has_cached);
 	ClassDB::bind_method(D_METHOD("get_cached_ref", "path"), &ResourceLoader::get_cached_ref);
+	ClassDB::bind_method(D_METHOD("set_cache_retained_budget", "bytes"), &ResourceLoader::set_cache_retained_budget);
+	ClassDB::bind_method(D_METHOD("get_cache_retained_budget"), &ResourceLoader::get_cache_retained_budget);
+	ClassDB::bind_method(D_METHOD("clear_cache_retained"), &ResourceLoader::clear_cache_retained);
+	ClassDB::bind_method(D_METHOD("get_cached_memory_usage"), &ResourceLoader::get_cached_memory_usage);
 	ClassDB::bind_method(D_METHOD("exists", "path", "type_hint"), &ResourceLoader::exists, DEFVAL(""));
 	ClassDB::bind_method(D_METHOD("get_resource_uid", "path"), &ResourceLoader::get_resource_uid);
 	ClassDB::bind_method(D_METHOD("list_directory", "directory_path"), &ResourceLoader::list_directory);
@@ -80,6 +80,10 @@ public:
 	PackedStringArray get_dependencies(const String &p_path);
 	bool has_cached(const String &p_path);
 	Ref<Resource> get_cached_ref(const String &p_path);
+	void set_cache_retained_budget(int64_t p_bytes);
+	int64_t get_cache_retained_budget() const;
+	void clear_cache_retained();
+	Dictionary get_cached_memory_usage() const;
 	bool exists(const String &p_path, const String &p_type_hint = "");
 	ResourceUID::ID get_resource_uid(const String &p_path);
 
@@ -30,6 +30,9 @@
 
 #include "delta_encoding.h"
 
+#include "core/io/marshalls.h"
+#include "core/templates/hash_map.h"
+
 #include <zstd.h>
 
 #define ERR_FAIL_ZSTD_V_MSG(m_result, m_retval, m_msg) \
@@ -49,8 +52,62 @@ struct ZstdDecompressionContext {
 
 static constexpr uint8_t DELTA_MAGIC[4] = { 'G', 'D', 'D', 'L' };
 static constexpr uint8_t DELTA_VERSION_NUMBER = 1;
+static constexpr uint8_t DELTA_VERSION_NUMBER_CHUNKED = 2;
 static constexpr size_t DELTA_HEADER_SIZE = 5;
 
+// Content-defined chunking (gear hash, as in FastCDC). Boundaries depend only on the bytes
+// right before them, so chunks of unchanged regions line up again after an insertion.
+static constexpr uint64_t CHUNK_MIN_SIZE = 2 * 1024;
+static constexpr uint64_t CHUNK_MAX_SIZE = 64 * 1024;
+static constexpr uint64_t CHUNK_BOUNDARY_MASK = ((uint64_t(1) << 13) - 1) << 51; // ~8 KiB average chunks.
+
+// Each operation copies `length` bytes either from the old data or from the literal stream.
+enum ChunkedDeltaOp : uint8_t {
+	CHUNKED_DELTA_OP_COPY,
+	CHUNKED_DELTA_OP_LITERAL,
+};
+static constexpr size_t CHUNKED_DELTA_OP_SIZE = 1 + 8 + 4;
+
+struct GearTable {
+	uint64_t values[256];
+
+	constexpr GearTable() :
+			values() {
+		// SplitMix64, so the table is fixed across platforms and versions.
+		uint64_t state = 0;
+		for (int i = 0; i < 256; i++) {
+			state += 0x9e3779b97f4a7c15;
+			uint64_t z = state;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+			values[i] = z ^ (z >> 31);
+		}
+	}
+};
+
+static constexpr GearTable GEAR_TABLE;
+
+static uint64_t _find_chunk_size(const uint8_t *p_data, uint64_t p_size) {
+	if (p_size <= CHUNK_MIN_SIZE) {
+		return p_size;
+	}
+
+	const uint64_t limit = MIN(p_size, CHUNK_MAX_SIZE);
+	uint64_t hash = 0;
+	for (uint64_t i = CHUNK_MIN_SIZE; i < limit; i++) {
+		hash = (hash << 1) + GEAR_TABLE.values[p_data[i]];
+		if (!(hash & CHUNK_BOUNDARY_MASK)) {
+			return i + 1;
+		}
+	}
+	return limit;
+}
+
+static _FORCE_INLINE_ uint64_t _hash_chunk(const uint8_t *p_data, uint64_t p_size) {
+	uint64_t h = hash_murmur3_buffer(p_data, p_size);
+	return (h << 32) | hash_murmur3_buffer(p_data, p_size, uint32_t(p_size));
+}
+
 Error DeltaEncoding::encode_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_new_data, Vector<uint8_t> &r_delta, int p_compression_level) {
 	size_t zstd_result = ZSTD_compressBound(p_new_data.size());
 	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to encode delta. Calculating compression bounds failed.");
@@ -86,6 +143,178 @@ Error DeltaEncoding::encode_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_new_
 	return OK;
 }
 
+Error DeltaEncoding::encode_chunked_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_new_data, Vector<uint8_t> &r_delta, int p_compression_level) {
+	struct Chunk {
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	HashMap<uint64_t, Chunk> old_chunks;
+	for (uint64_t offset = 0; offset < p_old_data.size();) {
+		Chunk chunk;
+		chunk.offset = offset;
+		chunk.size = _find_chunk_size(p_old_data.ptr() + offset, p_old_data.size() - offset);
+		old_chunks.insert(_hash_chunk(p_old_data.ptr() + offset, chunk.size), chunk);
+		offset += chunk.size;
+	}
+
+	// Build the operation list, merging adjacent operations that continue each other.
+	// Literals can exceed 4 GiB for large packs.
+	LocalVector<uint8_t, uint64_t> ops;
+	LocalVector<uint8_t, uint64_t> literals;
+	uint32_t op_count = 0;
+	ChunkedDeltaOp last_op = CHUNKED_DELTA_OP_LITERAL;
+	uint64_t last_offset = 0;
+	uint64_t last_size = 0;
+
+	auto flush_op = [&]() {
+		if (last_size == 0) {
+			return;
+		}
+		// Chunks are at most CHUNK_MAX_SIZE, but merged operations can grow past 32 bits.
+		while (last_size > 0) {
+			uint32_t size = uint32_t(MIN(last_size, uint64_t(UINT32_MAX)));
+			uint64_t pos = ops.size();
+			ops.resize(pos + CHUNKED_DELTA_OP_SIZE);
+			ops[pos] = last_op;
+			encode_uint64(last_offset, &ops[pos + 1]);
+			encode_uint32(size, &ops[pos + 9]);
+			op_count++;
+			last_offset += size;
+			last_size -= size;
+		}
+	};
+
+	for (uint64_t offset = 0; offset < p_new_data.size();) {
+		const uint8_t *chunk_data = p_new_data.ptr() + offset;
+		const uint64_t chunk_size = _find_chunk_size(chunk_data, p_new_data.size() - offset);
+
+		const Chunk *match = old_chunks.getptr(_hash_chunk(chunk_data, chunk_size));
+		if (match && (match->size != chunk_size || memcmp(p_old_data.ptr() + match->offset, chunk_data, chunk_size) != 0)) {
+			match = nullptr; // Hash collision.
+		}
+
+		ChunkedDeltaOp op = match ? CHUNKED_DELTA_OP_COPY : CHUNKED_DELTA_OP_LITERAL;
+		uint64_t source_offset = match ? match->offset : literals.size();
+		if (op != last_op || source_offset != last_offset + last_size) {
+			flush_op();
+			last_op = op;
+			last_offset = source_offset;
+			last_size = 0;
+		}
+		last_size += chunk_size;
+
+		if (!match) {
+			uint64_t pos = literals.size();
+			literals.resize(pos + chunk_size);
+			memcpy(&literals[pos], chunk_data, chunk_size);
+		}
+
+		offset += chunk_size;
+	}
+	flush_op();
+
+	Vector<uint8_t> payload;
+	payload.resize(4 + ops.size() + literals.size());
+	encode_uint32(op_count, payload.ptrw());
+	if (!ops.is_empty()) {
+		memcpy(payload.ptrw() + 4, ops.ptr(), ops.size());
+	}
+	if (!literals.is_empty()) {
+		memcpy(payload.ptrw() + 4 + ops.size(), literals.ptr(), literals.size());
+	}
+
+	size_t zstd_result = ZSTD_compressBound(payload.size());
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to encode chunked delta. Calculating compression bounds failed.");
+
+	r_delta.reserve_exact(DELTA_HEADER_SIZE + 8 + zstd_result);
+	r_delta.resize(DELTA_HEADER_SIZE + 8 + zstd_result);
+
+	memcpy(r_delta.ptrw(), DELTA_MAGIC, 4);
+	r_delta.write[4] = DELTA_VERSION_NUMBER_CHUNKED;
+	encode_uint64(p_new_data.size(), r_delta.ptrw() + DELTA_HEADER_SIZE);
+
+	ZstdCompressionContext zstd_context;
+
+	zstd_result = ZSTD_CCtx_setParameter(zstd_context, ZSTD_c_compressionLevel, p_compression_level);
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to encode chunked delta. Setting compression level failed.");
+
+	zstd_result = ZSTD_CCtx_setParameter(zstd_context, ZSTD_c_contentSizeFlag, 1);
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to encode chunked delta. Setting content size flag failed.");
+
+	zstd_result = ZSTD_CCtx_setParameter(zstd_context, ZSTD_c_checksumFlag, 1);
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to encode chunked delta. Setting checksum flag failed.");
+
+	zstd_result = ZSTD_compress2(zstd_context, r_delta.ptrw() + DELTA_HEADER_SIZE + 8, r_delta.size() - DELTA_HEADER_SIZE - 8, payload.ptr(), payload.size());
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to encode chunked delta. Compression failed.");
+
+	r_delta.resize(DELTA_HEADER_SIZE + 8 + zstd_result);
+
+	return OK;
+}
+
+static Error _decode_chunked_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_delta, Vector<uint8_t> &r_new_data) {
+	ERR_FAIL_COND_V_MSG(p_delta.size() < DELTA_HEADER_SIZE + 8, ERR_INVALID_DATA, vformat("Failed to decode chunked delta. File size (%d) is too small.", p_delta.size()));
+
+	const uint64_t new_size = decode_uint64(p_delta.ptr() + DELTA_HEADER_SIZE);
+	const uint8_t *frame = p_delta.ptr() + DELTA_HEADER_SIZE + 8;
+	const size_t frame_size = p_delta.size() - DELTA_HEADER_SIZE - 8;
+
+	size_t zstd_result = ZSTD_getFrameContentSize(frame, frame_size);
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to decode chunked delta. Unable to find decompressed size.");
+	ERR_FAIL_COND_V(zstd_result < 4, ERR_FILE_CORRUPT);
+
+	Vector<uint8_t> payload;
+	payload.resize(zstd_result);
+
+	ZstdDecompressionContext zstd_context;
+	zstd_result = ZSTD_decompressDCtx(zstd_context, payload.ptrw(), payload.size(), frame, frame_size);
+	ERR_FAIL_ZSTD_V_MSG(zstd_result, FAILED, "Failed to decode chunked delta. Decompression failed.");
+	ERR_FAIL_COND_V(zstd_result != (size_t)payload.size(), ERR_FILE_CORRUPT);
+
+	const uint32_t op_count = decode_uint32(payload.ptr());
+	const uint64_t ops_size = uint64_t(op_count) * CHUNKED_DELTA_OP_SIZE;
+	ERR_FAIL_COND_V(4 + ops_size > (uint64_t)payload.size(), ERR_FILE_CORRUPT);
+
+	const uint8_t *ops = payload.ptr() + 4;
+	const uint8_t *literals = ops + ops_size;
+	const uint64_t literals_size = payload.size() - 4 - ops_size;
+
+	// Validate every operation before allocating, so the size in the header can't request more
+	// memory than the operations actually produce.
+	uint64_t total_size = 0;
+	for (uint32_t i = 0; i < op_count; i++) {
+		const uint8_t *op = ops + i * CHUNKED_DELTA_OP_SIZE;
+		const uint64_t offset = decode_uint64(op + 1);
+		const uint64_t size = decode_uint32(op + 9);
+		ERR_FAIL_COND_V(size > new_size - total_size, ERR_FILE_CORRUPT);
+
+		if (op[0] == CHUNKED_DELTA_OP_COPY) {
+			ERR_FAIL_COND_V(size > p_old_data.size() || offset > p_old_data.size() - size, ERR_FILE_CORRUPT);
+		} else if (op[0] == CHUNKED_DELTA_OP_LITERAL) {
+			ERR_FAIL_COND_V(size > literals_size || offset > literals_size - size, ERR_FILE_CORRUPT);
+		} else {
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, vformat("Failed to decode chunked delta. Unknown operation %d.", op[0]));
+		}
+		total_size += size;
+	}
+	ERR_FAIL_COND_V(total_size != new_size, ERR_FILE_CORRUPT);
+
+	r_new_data.reserve_exact(new_size);
+	r_new_data.resize(new_size);
+	uint8_t *dst = r_new_data.ptrw();
+
+	for (uint32_t i = 0; i < op_count; i++) {
+		const uint8_t *op = ops + i * CHUNKED_DELTA_OP_SIZE;
+		const uint64_t offset = decode_uint64(op + 1);
+		const uint64_t size = decode_uint32(op + 9);
+		memcpy(dst, (op[0] == CHUNKED_DELTA_OP_COPY ? p_old_data.ptr() : literals) + offset, size);
+		dst += size;
+	}
+
+	return OK;
+}
+
 Error DeltaEncoding::decode_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_delta, Vector<uint8_t> &r_new_data) {
 	ERR_FAIL_COND_V_MSG(p_delta.size() < DELTA_HEADER_SIZE, ERR_INVALID_DATA, vformat("Failed to decode delta. File size (%d) is too small.", p_delta.size()));
 
@@ -94,6 +323,9 @@ Error DeltaEncoding::decode_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_delt
 	uint8_t version = p_delta[4];
 
 	ERR_FAIL_COND_V_MSG(memcmp(magic, DELTA_MAGIC, 4) != 0, ERR_FILE_CORRUPT, "Failed to decode delta. Header is invalid.");
+	if (version == DELTA_VERSION_NUMBER_CHUNKED) {
+		return _decode_chunked_delta(p_old_data, p_delta, r_new_data);
+	}
 	ERR_FAIL_COND_V_MSG(version != DELTA_VERSION_NUMBER, ERR_FILE_UNRECOGNIZED, vformat("Failed to decode delta. Expected version %d but found %d.", DELTA_VERSION_NUMBER, version));
 
 	size_t zstd_result = ZSTD_getFrameContentSize(p_delta.ptr() + DELTA_HEADER_SIZE, p_delta.size() - DELTA_HEADER_SIZE);
@@ -34,6 +34,13 @@
 
 class DeltaEncoding {
 public:
+	// Above this size, the old data no longer fits in the Zstandard match window used by
+	// `encode_delta`, so `encode_chunked_delta` usually produces much smaller deltas.
+	static constexpr int64_t CHUNKED_DELTA_THRESHOLD = 8 * 1024 * 1024;
+
 	static Error encode_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_new_data, Vector<uint8_t> &r_delta, int p_compression_level = 19);
+	// Splits both buffers into content-defined chunks, and only stores the chunks of the new data that aren't found anywhere in the old data.
+	static Error encode_chunked_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_new_data, Vector<uint8_t> &r_delta, int p_compression_level = 19);
+	// Decodes deltas produced by either of the encoding functions.
 	static Error decode_delta(Span<uint8_t> p_old_data, Span<uint8_t> p_delta, Vector<uint8_t> &r_new_data);
 };
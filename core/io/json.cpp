@@ -48,13 +48,150 @@ const char *JSON::tk_name[TK_MAX] = {
 	"EOF",
 };
 
-void JSON::_add_indent(String &r_result, const String &p_indent, int p_size) {
+// Growable UTF-8 output buffer used by JSON::stringify_to_utf8_buffer().
+// It mirrors the subset of the String interface used by JSON::_stringify().
+class JSONUTF8Writer {
+	Vector<uint8_t> data;
+	int64_t length = 0;
+	CharString indent;
+
+	_FORCE_INLINE_ uint8_t *_reserve(int64_t p_size) {
+		if (unlikely(length + p_size > data.size())) {
+			data.resize(MAX(length + p_size, MAX(data.size() * 2, (int64_t)256)));
+		}
+		uint8_t *w = data.ptrw() + length;
+		length += p_size;
+		return w;
+	}
+
+public:
+	void operator+=(char p_char) {
+		*_reserve(1) = p_char;
+	}
+
+	void operator+=(const char *p_str) {
+		const int64_t len = strlen(p_str);
+		memcpy(_reserve(len), p_str, len);
+	}
+
+	void operator+=(const String &p_string) {
+		const char32_t *src = p_string.ptr();
+		const int64_t len = p_string.length();
+		for (int64_t i = 0; i < len; i++) {
+			if (src[i] >= 0x80) {
+				const CharString utf8 = p_string.utf8();
+				memcpy(_reserve(utf8.length()), utf8.get_data(), utf8.length());
+				return;
+			}
+		}
+		// ASCII only, which is the common case for numbers and keys.
+		uint8_t *w = _reserve(len);
+		for (int64_t i = 0; i < len; i++) {
+			w[i] = src[i];
+		}
+	}
+
+	void add_indent(int p_size) {
+		for (int i = 0; i < p_size; i++) {
+			memcpy(_reserve(indent.length()), indent.get_data(), indent.length());
+		}
+	}
+
+	// Equivalent to `'"' + p_string.json_escape() + '"'`, without the intermediate strings.
+	void add_escaped(const String &p_string) {
+		*this += '"';
+		const char32_t *src = p_string.ptr();
+		const int64_t len = p_string.length();
+		for (int64_t i = 0; i < len; i++) {
+			const char32_t c = src[i];
+			switch (c) {
+				case '\\':
+					*this += "\\\\";
+					break;
+				case '\b':
+					*this += "\\b";
+					break;
+				case '\f':
+					*this += "\\f";
+					break;
+				case '\n':
+					*this += "\\n";
+					break;
+				case '\r':
+					*this += "\\r";
+					break;
+				case '\t':
+					*this += "\\t";
+					break;
+				case '\v':
+					*this += "\\v";
+					break;
+				case '"':
+					*this += "\\\"";
+					break;
+				default: {
+					if (c < 0x80) {
+						*_reserve(1) = c;
+					} else if (c < 0x800) {
+						uint8_t *w = _reserve(2);
+						w[0] = 0xc0 | (c >> 6);
+						w[1] = 0x80 | (c & 0x3f);
+					} else if (c < 0x10000) {
+						uint8_t *w = _reserve(3);
+						w[0] = 0xe0 | (c >> 12);
+						w[1] = 0x80 | ((c >> 6) & 0x3f);
+						w[2] = 0x80 | (c & 0x3f);
+					} else if (c < 0x110000) {
+						uint8_t *w = _reserve(4);
+						w[0] = 0xf0 | (c >> 18);
+						w[1] = 0x80 | ((c >> 12) & 0x3f);
+						w[2] = 0x80 | ((c >> 6) & 0x3f);
+						w[3] = 0x80 | (c & 0x3f);
+					} else {
+						// Let String report the invalid code point.
+						*this += String::chr(c);
+					}
+				} break;
+			}
+		}
+		*this += '"';
+	}
+
+	Vector<uint8_t> finish() {
+		data.resize(length);
+		return data;
+	}
+
+	explicit JSONUTF8Writer(const String &p_indent) :
+			indent(p_indent.utf8()) {}
+};
+
+template <typename T>
+void JSON::_add_indent(T &r_result, const String &p_indent, int p_size) {
 	for (int i = 0; i < p_size; i++) {
 		r_result += p_indent;
 	}
 }
 
-void JSON::_stringify(String &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision) {
+template <>
+void JSON::_add_indent<JSONUTF8Writer>(JSONUTF8Writer &r_result, const String &p_indent, int p_size) {
+	r_result.add_indent(p_size);
+}
+
+template <typename T>
+void JSON::_add_string(T &r_result, const String &p_string) {
+	r_result += '"';
+	r_result += p_string.json_escape();
+	r_result += '"';
+}
+
+template <>
+void JSON::_add_string<JSONUTF8Writer>(JSONUTF8Writer &r_result, const String &p_string) {
+	r_result.add_escaped(p_string);
+}
+
+template <typename T>
+void JSON::_stringify(T &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision) {
 	if (p_cur_indent > Variant::MAX_RECURSION_DEPTH) {
 		r_result += "...";
 		ERR_FAIL_MSG("JSON structure is too deep. Bailing.");
@@ -186,14 +323,12 @@ void JSON::_stringify(String &r_result, const Variant &p_var, const String &p_in
 			return;
 		}
 		default:
-			r_result += '"';
-			r_result += String(p_var).json_escape();
-			r_result += '"';
+			_add_string(r_result, String(p_var));
 			return;
 	}
 }
 
-Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
+Error JSON::_get_token(const char32_t *p_str, int64_t &index, int64_t p_len, Token &r_token, int &line, String &r_err_str) {
 	while (p_len > 0) {
 		switch (p_str[index]) {
 			case '\n': {
@@ -414,7 +549,352 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
+// SWAR ("SIMD within a register") helpers used to scan UTF-8 input eight bytes at a time.
+static constexpr uint64_t JSON_SWAR_ONES = 0x0101010101010101ULL;
+static constexpr uint64_t JSON_SWAR_HIGHS = 0x8080808080808080ULL;
+
+// Non-zero if any byte of `p_word` may equal `p_byte`. There are no false negatives,
+// false positives only ever appear above a real match.
+static _FORCE_INLINE_ uint64_t _json_swar_has_byte(uint64_t p_word, uint8_t p_byte) {
+	const uint64_t x = p_word ^ (JSON_SWAR_ONES * p_byte);
+	return (x - JSON_SWAR_ONES) & ~x & JSON_SWAR_HIGHS;
+}
+
+// Returns the index of the first byte that can end a plain run of string characters
+// ('"', '\\', '\n' or NUL), or `p_len` if there is none.
+static int64_t _json_find_string_special(const uint8_t *p_str, int64_t p_index, int64_t p_len) {
+	while (p_index + 8 <= p_len) {
+		uint64_t word;
+		memcpy(&word, p_str + p_index, sizeof(uint64_t));
+		if (_json_swar_has_byte(word, '"') | _json_swar_has_byte(word, '\\') | _json_swar_has_byte(word, '\n') | _json_swar_has_byte(word, 0)) {
+			break;
+		}
+		p_index += 8;
+	}
+	while (p_index < p_len) {
+		const uint8_t c = p_str[p_index];
+		if (c == '"' || c == '\\' || c == '\n' || c == 0) {
+			break;
+		}
+		p_index++;
+	}
+	return p_index;
+}
+
+static bool _json_parse_hex4(const uint8_t *p_str, char32_t &r_value) {
+	r_value = 0;
+	for (int j = 0; j < 4; j++) {
+		const uint8_t c = p_str[j];
+		char32_t v;
+		if (is_digit(c)) {
+			v = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			v = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			v = c - 'A' + 10;
+		} else {
+			return false;
+		}
+		r_value = (r_value << 4) | v;
+	}
+	return true;
+}
+
+static void _json_append_utf8(LocalVector<char> &r_buffer, char32_t p_char) {
+	if (p_char < 0x80) {
+		r_buffer.push_back(p_char);
+	} else if (p_char < 0x800) {
+		r_buffer.push_back(0xc0 | (p_char >> 6));
+		r_buffer.push_back(0x80 | (p_char & 0x3f));
+	} else if (p_char < 0x10000) {
+		r_buffer.push_back(0xe0 | (p_char >> 12));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3f));
+		r_buffer.push_back(0x80 | (p_char & 0x3f));
+	} else {
+		r_buffer.push_back(0xf0 | (p_char >> 18));
+		r_buffer.push_back(0x80 | ((p_char >> 12) & 0x3f));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3f));
+		r_buffer.push_back(0x80 | (p_char & 0x3f));
+	}
+}
+
+Error JSON::_get_token(const uint8_t *p_str, int64_t &index, int64_t p_len, Token &r_token, int &line, String &r_err_str, bool p_partial) {
+	// Skip whitespace, eight bytes at a time while they are plain spaces (as in indented output).
+	while (index < p_len) {
+		while (index + 8 <= p_len) {
+			uint64_t word;
+			memcpy(&word, p_str + index, sizeof(uint64_t));
+			if (word != JSON_SWAR_ONES * ' ') {
+				break;
+			}
+			index += 8;
+		}
+		if (index >= p_len || p_str[index] > 32) {
+			break;
+		}
+		if (p_str[index] == 0) {
+			r_token.type = TK_EOF;
+			return OK;
+		}
+		if (p_str[index] == '\n') {
+			line++;
+		}
+		index++;
+	}
+
+	if (index >= p_len) {
+		if (p_partial) {
+			return ERR_BUSY;
+		}
+		r_token.type = TK_EOF;
+		return OK;
+	}
+
+	switch (p_str[index]) {
+		case '{': {
+			r_token.type = TK_CURLY_BRACKET_OPEN;
+			index++;
+			return OK;
+		}
+		case '}': {
+			r_token.type = TK_CURLY_BRACKET_CLOSE;
+			index++;
+			return OK;
+		}
+		case '[': {
+			r_token.type = TK_BRACKET_OPEN;
+			index++;
+			return OK;
+		}
+		case ']': {
+			r_token.type = TK_BRACKET_CLOSE;
+			index++;
+			return OK;
+		}
+		case ':': {
+			r_token.type = TK_COLON;
+			index++;
+			return OK;
+		}
+		case ',': {
+			r_token.type = TK_COMMA;
+			index++;
+			return OK;
+		}
+		case '"': {
+			const int64_t token_start = index;
+			const int token_line = line;
+			index++;
+
+			// Plain runs are copied straight from the input, escapes are decoded into `unescaped`.
+			// Strings without escapes are converted from the input buffer directly.
+			LocalVector<char> unescaped;
+			bool has_escapes = false;
+			int64_t run_start = index;
+			while (true) {
+				index = _json_find_string_special(p_str, index, p_len);
+				if (index >= p_len || p_str[index] == 0) {
+					if (p_partial && index >= p_len) {
+						index = token_start;
+						line = token_line;
+						return ERR_BUSY;
+					}
+					r_err_str = "Unterminated string";
+					return ERR_PARSE_ERROR;
+				}
+
+				const uint8_t c = p_str[index];
+				if (c == '\n') {
+					line++;
+					index++;
+					continue;
+				}
+
+				if (has_escapes || c == '\\') {
+					const uint32_t run_length = index - run_start;
+					const uint32_t old_size = unescaped.size();
+					unescaped.resize(old_size + run_length);
+					memcpy(unescaped.ptr() + old_size, p_str + run_start, run_length);
+					has_escapes = true;
+				}
+
+				if (c == '"') {
+					break;
+				}
+
+				// Escaped characters.
+				index++;
+				if (index >= p_len) {
+					if (p_partial) {
+						index = token_start;
+						line = token_line;
+						return ERR_BUSY;
+					}
+					r_err_str = "Unterminated string";
+					return ERR_PARSE_ERROR;
+				}
+
+				const uint8_t next = p_str[index];
+				switch (next) {
+					case 'b':
+						unescaped.push_back(8);
+						break;
+					case 't':
+						unescaped.push_back(9);
+						break;
+					case 'n':
+						unescaped.push_back(10);
+						break;
+					case 'f':
+						unescaped.push_back(12);
+						break;
+					case 'r':
+						unescaped.push_back(13);
+						break;
+					case 'u': {
+						if (index + 4 >= p_len) {
+							if (p_partial) {
+								index = token_start;
+								line = token_line;
+								return ERR_BUSY;
+							}
+							r_err_str = "Unterminated string";
+							return ERR_PARSE_ERROR;
+						}
+						char32_t res;
+						if (!_json_parse_hex4(p_str + index + 1, res)) {
+							r_err_str = "Malformed hex constant in string";
+							return ERR_PARSE_ERROR;
+						}
+						index += 4;
+
+						if ((res & 0xfffffc00) == 0xd800) {
+							if (index + 6 >= p_len) {
+								if (p_partial) {
+									index = token_start;
+									line = token_line;
+									return ERR_BUSY;
+								}
+								if (index + 2 >= p_len || p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
+									r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+								} else {
+									r_err_str = "Unterminated string";
+								}
+								return ERR_PARSE_ERROR;
+							}
+							if (p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
+								r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+								return ERR_PARSE_ERROR;
+							}
+							char32_t trail;
+							if (!_json_parse_hex4(p_str + index + 3, trail)) {
+								r_err_str = "Malformed hex constant in string";
+								return ERR_PARSE_ERROR;
+							}
+							if ((trail & 0xfffffc00) != 0xdc00) {
+								r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+								return ERR_PARSE_ERROR;
+							}
+							res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
+							index += 6;
+						} else if ((res & 0xfffffc00) == 0xdc00) {
+							r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
+							return ERR_PARSE_ERROR;
+						}
+
+						_json_append_utf8(unescaped, res);
+					} break;
+					case '"':
+					case '\\':
+					case '/': {
+						unescaped.push_back(next);
+					} break;
+					default: {
+						r_err_str = "Invalid escape sequence";
+						return ERR_PARSE_ERROR;
+					}
+				}
+				index++;
+				run_start = index;
+			}
+
+			if (has_escapes) {
+				r_token.value = String::utf8(unescaped.ptr(), unescaped.size());
+			} else {
+				r_token.value = String::utf8((const char *)p_str + run_start, index - run_start);
+			}
+			index++;
+			r_token.type = TK_STRING;
+			return OK;
+		}
+		default: {
+			const int64_t token_start = index;
+
+			if (p_str[index] == '-' || is_digit(p_str[index])) {
+				// A number. Find where it ends, then convert it from a null-terminated copy.
+				if (p_str[index] == '-') {
+					index++;
+				}
+				while (index < p_len && is_digit(p_str[index])) {
+					index++;
+				}
+				if (index < p_len && p_str[index] == '.') {
+					index++;
+					while (index < p_len && is_digit(p_str[index])) {
+						index++;
+					}
+				}
+				if (index < p_len && (p_str[index] == 'e' || p_str[index] == 'E')) {
+					index++;
+					if (index < p_len && (p_str[index] == '+' || p_str[index] == '-')) {
+						index++;
+					}
+					while (index < p_len && is_digit(p_str[index])) {
+						index++;
+					}
+				}
+				if (p_partial && index >= p_len) {
+					index = token_start;
+					return ERR_BUSY;
+				}
+
+				const int64_t number_length = index - token_start;
+				char number[64];
+				double value;
+				if (number_length < (int64_t)sizeof(number)) {
+					memcpy(number, p_str + token_start, number_length);
+					number[number_length] = 0;
+					value = String::to_float(number);
+				} else {
+					value = String::ascii(Span<char>((const char *)p_str + token_start, number_length)).to_float();
+				}
+
+				r_token.type = TK_NUMBER;
+				r_token.value = value;
+				return OK;
+
+			} else if (is_ascii_alphabet_char(p_str[index])) {
+				while (index < p_len && is_ascii_alphabet_char(p_str[index])) {
+					index++;
+				}
+				if (p_partial && index >= p_len) {
+					index = token_start;
+					return ERR_BUSY;
+				}
+
+				r_token.type = TK_IDENTIFIER;
+				r_token.value = String::ascii(Span<char>((const char *)p_str + token_start, index - token_start));
+				return OK;
+			} else {
+				r_err_str = "Unexpected character";
+				return ERR_PARSE_ERROR;
+			}
+		}
+	}
+}
+
+template <typename T>
+Error JSON::_parse_value(Variant &value, Token &token, const T *p_str, int64_t &index, int64_t p_len, int &line, int p_depth, String &r_err_str) {
 	if (p_depth > Variant::MAX_RECURSION_DEPTH) {
 		r_err_str = "JSON structure is too deep";
 		return ERR_OUT_OF_MEMORY;
@@ -458,7 +938,8 @@ Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, in
 	return OK;
 }
 
-Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
+template <typename T>
+Error JSON::_parse_array(Array &array, const T *p_str, int64_t &index, int64_t p_len, int &line, int p_depth, String &r_err_str) {
 	Token token;
 	bool need_comma = false;
 
@@ -496,7 +977,8 @@ Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_
 	return ERR_PARSE_ERROR;
 }
 
-Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
+template <typename T>
+Error JSON::_parse_object(Dictionary &object, const T *p_str, int64_t &index, int64_t p_len, int &line, int p_depth, String &r_err_str) {
 	bool at_key = true;
 	String key;
 	Token token;
@@ -564,25 +1046,23 @@ void JSON::set_data(const Variant &p_data) {
 	text.clear();
 }
 
-Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
-	const char32_t *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
+template <typename T>
+Error JSON::_parse_buffer(const T *p_str, int64_t p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	int64_t idx = 0;
 	Token token;
 	r_err_line = 0;
-	String aux_key;
 
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	Error err = _get_token(p_str, idx, p_len, token, r_err_line, r_err_str);
 	if (err) {
 		return err;
 	}
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, 0, r_err_str);
+	err = _parse_value(r_ret, token, p_str, idx, p_len, r_err_line, 0, r_err_str);
 
 	// Check if EOF is reached
 	// or it's a type of the next token.
-	if (err == OK && idx < len) {
-		err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	if (err == OK && idx < p_len) {
+		err = _get_token(p_str, idx, p_len, token, r_err_line, r_err_str);
 
 		if (err || token.type != TK_EOF) {
 			r_err_str = "Expected 'EOF'";
@@ -595,6 +1075,10 @@ Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_st
 	return err;
 }
 
+Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	return _parse_buffer(p_json.ptr(), p_json.length(), r_ret, r_err_str, r_err_line);
+}
+
 Error JSON::parse(const String &p_json_string, bool p_keep_text) {
 	Error err = _parse_string(p_json_string, data, err_str, err_line);
 	if (err == Error::OK) {
@@ -606,6 +1090,22 @@ Error JSON::parse(const String &p_json_string, bool p_keep_text) {
 	return err;
 }
 
+Error JSON::parse_utf8_buffer(const Vector<uint8_t> &p_json_buffer) {
+	const uint8_t *ptr = p_json_buffer.ptr();
+	int64_t len = p_json_buffer.size();
+	if (len >= 3 && ptr[0] == 0xef && ptr[1] == 0xbb && ptr[2] == 0xbf) {
+		// Skip the UTF-8 byte order mark.
+		ptr += 3;
+		len -= 3;
+	}
+
+	Error err = _parse_buffer(ptr, len, data, err_str, err_line);
+	if (err == Error::OK) {
+		err_line = 0;
+	}
+	return err;
+}
+
 String JSON::get_parsed_text() const {
 	return text;
 }
@@ -617,6 +1117,13 @@ String JSON::stringify(const Variant &p_var, const String &p_indent, bool p_sort
 	return result;
 }
 
+Vector<uint8_t> JSON::stringify_to_utf8_buffer(const Variant &p_var, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	JSONUTF8Writer writer(p_indent);
+	HashSet<const void *> markers;
+	_stringify(writer, p_var, p_indent, 0, p_sort_keys, markers, p_full_precision);
+	return writer.finish();
+}
+
 Variant JSON::parse_string(const String &p_json_string) {
 	Ref<JSON> json;
 	json.instantiate();
@@ -627,8 +1134,10 @@ Variant JSON::parse_string(const String &p_json_string) {
 
 void JSON::_bind_methods() {
 	ClassDB::bind_static_method("JSON", D_METHOD("stringify", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify, DEFVAL(""), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_static_method("JSON", D_METHOD("stringify_to_utf8_buffer", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify_to_utf8_buffer, DEFVAL(""), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_static_method("JSON", D_METHOD("parse_string", "json_string"), &JSON::parse_string);
 	ClassDB::bind_method(D_METHOD("parse", "json_text", "keep_text"), &JSON::parse, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("parse_utf8_buffer", "json_buffer"), &JSON::parse_utf8_buffer);
 
 	ClassDB::bind_method(D_METHOD("get_data"), &JSON::get_data);
 	ClassDB::bind_method(D_METHOD("set_data", "data"), &JSON::set_data);
@@ -1548,6 +2057,331 @@ Variant JSON::_to_native(const Variant &p_json, bool p_allow_objects, int p_dept
 
 ////////////
 
+void JSONStreamParser::_reset() {
+	buffer.clear();
+	position = 0;
+	containers.clear();
+	state = STATE_VALUE;
+	event_type = EVENT_NONE;
+	value = Variant();
+	skip_depth = -1;
+	current_line = 0;
+	err_str = String();
+}
+
+void JSONStreamParser::_compact_buffer() {
+	if (position == 0) {
+		return;
+	}
+	const int64_t remaining = buffer.size() - position;
+	if (remaining > 0) {
+		memmove(buffer.ptr(), buffer.ptr() + position, remaining);
+	}
+	buffer.resize(remaining);
+	position = 0;
+}
+
+bool JSONStreamParser::_fill_buffer() {
+	if (file.is_null()) {
+		return false;
+	}
+
+	_compact_buffer();
+	const int64_t old_size = buffer.size();
+	buffer.resize(old_size + READ_CHUNK_SIZE);
+	const uint64_t read = file->get_buffer(buffer.ptr() + old_size, READ_CHUNK_SIZE);
+	buffer.resize(old_size + read);
+
+	if (read < READ_CHUNK_SIZE) {
+		end_of_data = true;
+		file.unref();
+	}
+	return true;
+}
+
+Error JSONStreamParser::_set_error(const String &p_message) {
+	err_str = p_message;
+	state = STATE_ERROR;
+	event_type = EVENT_NONE;
+	value = Variant();
+	return ERR_PARSE_ERROR;
+}
+
+void JSONStreamParser::_value_read() {
+	state = containers.is_empty() ? STATE_EOF : STATE_COMMA;
+}
+
+Error JSONStreamParser::open(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot open file '%s'.", p_path));
+
+	_reset();
+	file = f;
+	is_open = true;
+	feeding = false;
+	end_of_data = false;
+
+	_fill_buffer();
+	if (buffer.size() >= 3 && buffer[0] == 0xef && buffer[1] == 0xbb && buffer[2] == 0xbf) {
+		// Skip the UTF-8 byte order mark.
+		position = 3;
+	}
+	return OK;
+}
+
+Error JSONStreamParser::open_buffer(const Vector<uint8_t> &p_buffer) {
+	file.unref();
+	_reset();
+	is_open = true;
+	feeding = false;
+	end_of_data = true;
+
+	buffer.resize(p_buffer.size());
+	if (p_buffer.size()) {
+		memcpy(buffer.ptr(), p_buffer.ptr(), p_buffer.size());
+	}
+	if (buffer.size() >= 3 && buffer[0] == 0xef && buffer[1] == 0xbb && buffer[2] == 0xbf) {
+		position = 3;
+	}
+	return OK;
+}
+
+Error JSONStreamParser::feed(const Vector<uint8_t> &p_data) {
+	if (!is_open) {
+		_reset();
+		is_open = true;
+		feeding = true;
+		end_of_data = false;
+	}
+	ERR_FAIL_COND_V_MSG(!feeding, ERR_UNAVAILABLE, "Cannot feed data to a parser that was opened on a file or buffer.");
+	ERR_FAIL_COND_V_MSG(end_of_data, ERR_UNAVAILABLE, "Cannot feed data after finish() was called. Call close() to start a new document.");
+
+	_compact_buffer();
+	const int64_t old_size = buffer.size();
+	buffer.resize(old_size + p_data.size());
+	if (p_data.size()) {
+		memcpy(buffer.ptr() + old_size, p_data.ptr(), p_data.size());
+	}
+	return OK;
+}
+
+void JSONStreamParser::finish() {
+	ERR_FAIL_COND_MSG(!feeding, "finish() can only be called after feeding data with feed().");
+	end_of_data = true;
+}
+
+void JSONStreamParser::close() {
+	file.unref();
+	buffer.reset();
+	position = 0;
+	containers.reset();
+	is_open = false;
+	feeding = false;
+	end_of_data = false;
+	state = STATE_DONE;
+	event_type = EVENT_NONE;
+	value = Variant();
+	skip_depth = -1;
+}
+
+Error JSONStreamParser::read() {
+	ERR_FAIL_COND_V_MSG(!is_open, ERR_UNCONFIGURED, "No JSON source was opened. Call open(), open_buffer() or feed() first.");
+	if (state == STATE_ERROR) {
+		return ERR_PARSE_ERROR;
+	}
+	if (state == STATE_DONE) {
+		event_type = EVENT_NONE;
+		return ERR_FILE_EOF;
+	}
+
+	JSON::Token token;
+	while (true) {
+		Error err = JSON::_get_token(buffer.ptr(), position, buffer.size(), token, current_line, err_str, !end_of_data);
+		if (err == ERR_BUSY) {
+			if (_fill_buffer()) {
+				continue;
+			}
+			// Wait for more data to be fed.
+			event_type = EVENT_NONE;
+			return ERR_UNAVAILABLE;
+		}
+		if (err != OK) {
+			return _set_error(err_str);
+		}
+
+		if (token.type == JSON::TK_EOF) {
+			if (state == STATE_EOF) {
+				state = STATE_DONE;
+				event_type = EVENT_NONE;
+				value = Variant();
+				return ERR_FILE_EOF;
+			}
+			if (!containers.is_empty()) {
+				return _set_error(containers[containers.size() - 1] ? "Expected '}'" : "Expected ']'");
+			}
+		}
+
+		switch (state) {
+			case STATE_VALUE: {
+				if (token.type == JSON::TK_CURLY_BRACKET_OPEN) {
+					containers.push_back(true);
+					state = STATE_KEY;
+					event_type = EVENT_OBJECT_BEGIN;
+					value = Variant();
+				} else if (token.type == JSON::TK_BRACKET_OPEN) {
+					containers.push_back(false);
+					state = STATE_VALUE;
+					event_type = EVENT_ARRAY_BEGIN;
+					value = Variant();
+				} else if (token.type == JSON::TK_BRACKET_CLOSE && !containers.is_empty() && !containers[containers.size() - 1]) {
+					containers.resize(containers.size() - 1);
+					_value_read();
+					event_type = EVENT_ARRAY_END;
+					value = Variant();
+				} else if (token.type == JSON::TK_IDENTIFIER) {
+					const String id = token.value;
+					if (id == "true") {
+						value = true;
+					} else if (id == "false") {
+						value = false;
+					} else if (id == "null") {
+						value = Variant();
+					} else {
+						return _set_error(vformat("Expected 'true', 'false', or 'null', got '%s'", id));
+					}
+					_value_read();
+					event_type = EVENT_VALUE;
+				} else if (token.type == JSON::TK_NUMBER || token.type == JSON::TK_STRING) {
+					value = token.value;
+					_value_read();
+					event_type = EVENT_VALUE;
+				} else {
+					return _set_error(vformat("Expected value, got '%s'", String(JSON::tk_name[token.type])));
+				}
+			} break;
+			case STATE_KEY: {
+				if (token.type == JSON::TK_CURLY_BRACKET_CLOSE) {
+					containers.resize(containers.size() - 1);
+					_value_read();
+					event_type = EVENT_OBJECT_END;
+					value = Variant();
+				} else if (token.type == JSON::TK_STRING) {
+					value = token.value;
+					state = STATE_COLON;
+					event_type = EVENT_KEY;
+				} else {
+					return _set_error("Expected key");
+				}
+			} break;
+			case STATE_COLON: {
+				if (token.type != JSON::TK_COLON) {
+					return _set_error("Expected ':'");
+				}
+				state = STATE_VALUE;
+				continue;
+			}
+			case STATE_COMMA: {
+				const bool in_object = containers[containers.size() - 1];
+				if (token.type == JSON::TK_COMMA) {
+					state = in_object ? STATE_KEY : STATE_VALUE;
+					continue;
+				}
+				if (in_object && token.type == JSON::TK_CURLY_BRACKET_CLOSE) {
+					event_type = EVENT_OBJECT_END;
+				} else if (!in_object && token.type == JSON::TK_BRACKET_CLOSE) {
+					event_type = EVENT_ARRAY_END;
+				} else {
+					return _set_error(in_object ? "Expected '}' or ','" : "Expected ','");
+				}
+				containers.resize(containers.size() - 1);
+				_value_read();
+				value = Variant();
+			} break;
+			case STATE_EOF: {
+				return _set_error("Expected 'EOF'");
+			}
+			default: {
+				ERR_FAIL_V(ERR_BUG);
+			}
+		}
+
+		return OK;
+	}
+}
+
+Error JSONStreamParser::skip_section() {
+	if (skip_depth < 0) {
+		if (event_type != EVENT_OBJECT_BEGIN && event_type != EVENT_ARRAY_BEGIN) {
+			return OK;
+		}
+		skip_depth = containers.size() - 1;
+	}
+
+	while (true) {
+		Error err = read();
+		if (err == ERR_UNAVAILABLE) {
+			// Keep `skip_depth` so that calling this again after feeding more data resumes skipping.
+			return err;
+		}
+		if (err != OK) {
+			skip_depth = -1;
+			return err;
+		}
+		if ((event_type == EVENT_OBJECT_END || event_type == EVENT_ARRAY_END) && (int)containers.size() == skip_depth) {
+			skip_depth = -1;
+			return OK;
+		}
+	}
+}
+
+JSONStreamParser::EventType JSONStreamParser::get_event_type() const {
+	return event_type;
+}
+
+Variant JSONStreamParser::get_value() const {
+	return value;
+}
+
+int JSONStreamParser::get_depth() const {
+	return containers.size();
+}
+
+int JSONStreamParser::get_current_line() const {
+	return current_line;
+}
+
+String JSONStreamParser::get_error_message() const {
+	return err_str;
+}
+
+void JSONStreamParser::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("open", "path"), &JSONStreamParser::open);
+	ClassDB::bind_method(D_METHOD("open_buffer", "buffer"), &JSONStreamParser::open_buffer);
+	ClassDB::bind_method(D_METHOD("feed", "data"), &JSONStreamParser::feed);
+	ClassDB::bind_method(D_METHOD("finish"), &JSONStreamParser::finish);
+	ClassDB::bind_method(D_METHOD("close"), &JSONStreamParser::close);
+
+	ClassDB::bind_method(D_METHOD("read"), &JSONStreamParser::read);
+	ClassDB::bind_method(D_METHOD("skip_section"), &JSONStreamParser::skip_section);
+
+	ClassDB::bind_method(D_METHOD("get_event_type"), &JSONStreamParser::get_event_type);
+	ClassDB::bind_method(D_METHOD("get_value"), &JSONStreamParser::get_value);
+	ClassDB::bind_method(D_METHOD("get_depth"), &JSONStreamParser::get_depth);
+	ClassDB::bind_method(D_METHOD("get_current_line"), &JSONStreamParser::get_current_line);
+	ClassDB::bind_method(D_METHOD("get_error_message"), &JSONStreamParser::get_error_message);
+
+	BIND_ENUM_CONSTANT(EVENT_NONE);
+	BIND_ENUM_CONSTANT(EVENT_OBJECT_BEGIN);
+	BIND_ENUM_CONSTANT(EVENT_OBJECT_END);
+	BIND_ENUM_CONSTANT(EVENT_ARRAY_BEGIN);
+	BIND_ENUM_CONSTANT(EVENT_ARRAY_END);
+	BIND_ENUM_CONSTANT(EVENT_KEY);
+	BIND_ENUM_CONSTANT(EVENT_VALUE);
+}
+
+////////////
+
 Ref<Resource> ResourceFormatLoaderJSON::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) {
 	if (r_error) {
 		*r_error = ERR_FILE_CANT_OPEN;
@@ -1563,7 +2397,13 @@ Ref<Resource> ResourceFormatLoaderJSON::load(const String &p_path, const String
 	Ref<JSON> json;
 	json.instantiate();
 
-	Error err = json->parse(FileAccess::get_file_as_string(p_path), Engine::get_singleton()->is_editor_hint());
+	Error err;
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// Keep the text so the code editor can edit it.
+		err = json->parse(FileAccess::get_file_as_string(p_path), true);
+	} else {
+		err = json->parse_utf8_buffer(FileAccess::get_file_as_bytes(p_path));
+	}
 	if (err != OK) {
 		String err_text = "Error parsing JSON file at '" + p_path + "', on line " + itos(json->get_error_line()) + ": " + json->get_error_message();
 
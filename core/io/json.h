@@ -30,14 +30,18 @@
 
 #pragma once
 
+#include "core/io/file_access.h"
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 class JSON : public Resource {
 	GDCLASS(JSON, Resource);
 
+	friend class JSONStreamParser;
+
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
 		TK_CURLY_BRACKET_CLOSE,
@@ -71,12 +75,23 @@ class JSON : public Resource {
 
 	static const char *tk_name[];
 
-	static void _add_indent(String &r_result, const String &p_indent, int p_size);
-	static void _stringify(String &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision);
-	static Error _get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
+	template <typename T>
+	static void _add_indent(T &r_result, const String &p_indent, int p_size);
+	template <typename T>
+	static void _add_string(T &r_result, const String &p_string);
+	template <typename T>
+	static void _stringify(T &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision);
+	static Error _get_token(const char32_t *p_str, int64_t &index, int64_t p_len, Token &r_token, int &line, String &r_err_str);
+	// With `p_partial`, returns `ERR_BUSY` instead of failing when a token is cut off by the end of the buffer.
+	static Error _get_token(const uint8_t *p_str, int64_t &index, int64_t p_len, Token &r_token, int &line, String &r_err_str, bool p_partial = false);
+	template <typename T>
+	static Error _parse_value(Variant &value, Token &token, const T *p_str, int64_t &index, int64_t p_len, int &line, int p_depth, String &r_err_str);
+	template <typename T>
+	static Error _parse_array(Array &array, const T *p_str, int64_t &index, int64_t p_len, int &line, int p_depth, String &r_err_str);
+	template <typename T>
+	static Error _parse_object(Dictionary &object, const T *p_str, int64_t &index, int64_t p_len, int &line, int p_depth, String &r_err_str);
+	template <typename T>
+	static Error _parse_buffer(const T *p_str, int64_t p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
 	static Error _parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
 
 	static Variant _from_native(const Variant &p_variant, bool p_full_objects, int p_depth);
@@ -87,9 +102,11 @@ protected:
 
 public:
 	Error parse(const String &p_json_string, bool p_keep_text = false);
+	Error parse_utf8_buffer(const Vector<uint8_t> &p_json_buffer);
 	String get_parsed_text() const;
 
 	static String stringify(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	static Vector<uint8_t> stringify_to_utf8_buffer(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
 	static Variant parse_string(const String &p_json_string);
 
 	_FORCE_INLINE_ static Variant from_native(const Variant &p_variant, bool p_full_objects = false) {
@@ -106,6 +123,76 @@ public:
 	_FORCE_INLINE_ String get_error_message() const { return err_str; }
 };
 
+class JSONStreamParser : public RefCounted {
+	GDCLASS(JSONStreamParser, RefCounted);
+
+public:
+	enum EventType {
+		EVENT_NONE,
+		EVENT_OBJECT_BEGIN,
+		EVENT_OBJECT_END,
+		EVENT_ARRAY_BEGIN,
+		EVENT_ARRAY_END,
+		EVENT_KEY,
+		EVENT_VALUE,
+	};
+
+private:
+	enum State {
+		STATE_VALUE, // Expecting a value, or the end of the enclosing array.
+		STATE_KEY, // Expecting a key, or the end of the enclosing object.
+		STATE_COLON,
+		STATE_COMMA, // Expecting ',' or the end of the enclosing container.
+		STATE_EOF, // The top-level value was read, only whitespace may follow.
+		STATE_DONE,
+		STATE_ERROR,
+	};
+
+	static constexpr uint64_t READ_CHUNK_SIZE = 64 * 1024;
+
+	Ref<FileAccess> file;
+	LocalVector<uint8_t> buffer;
+	int64_t position = 0;
+	bool is_open = false;
+	bool feeding = false;
+	bool end_of_data = false;
+
+	LocalVector<bool> containers; // `true` for objects, `false` for arrays.
+	State state = STATE_DONE;
+	EventType event_type = EVENT_NONE;
+	Variant value;
+	int skip_depth = -1;
+	int current_line = 0;
+	String err_str;
+
+	void _reset();
+	void _compact_buffer();
+	bool _fill_buffer();
+	Error _set_error(const String &p_message);
+	void _value_read();
+
+protected:
+	static void _bind_methods();
+
+public:
+	Error open(const String &p_path);
+	Error open_buffer(const Vector<uint8_t> &p_buffer);
+	Error feed(const Vector<uint8_t> &p_data);
+	void finish();
+	void close();
+
+	Error read();
+	Error skip_section();
+
+	EventType get_event_type() const;
+	Variant get_value() const;
+	int get_depth() const;
+	int get_current_line() const;
+	String get_error_message() const;
+};
+
+VARIANT_ENUM_CAST(JSONStreamParser::EventType);
+
 class ResourceFormatLoaderJSON : public ResourceFormatLoader {
 	GDSOFTCLASS(ResourceFormatLoaderJSON, ResourceFormatLoader);
 
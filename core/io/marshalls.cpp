@@ -88,6 +88,52 @@ enum ContainerTypeKind {
 #define GET_CONTAINER_TYPE_KIND(m_header, m_field) \
 	((ContainerTypeKind)(((m_header) & HEADER_DATA_FIELD_##m_field##_MASK) >> HEADER_DATA_FIELD_##m_field##_SHIFT))
 
+static_assert(sizeof(Vector2) == sizeof(real_t) * 2 && sizeof(Vector3) == sizeof(real_t) * 3 && sizeof(Vector4) == sizeof(real_t) * 4, "Packed vector elements must be tightly packed for bulk copies.");
+static_assert(sizeof(Color) == sizeof(float) * 4, "Packed color elements must be tightly packed for bulk copies.");
+
+// Packed array payloads are stored as little-endian words, so on little-endian
+// hosts they can be copied in bulk instead of element by element.
+#ifdef BIG_ENDIAN_ENABLED
+static void _swap_packed_words(uint8_t *p_data, int64_t p_count, size_t p_word_size) {
+	// Kept as a plain loop over unaligned words so compilers can vectorize it into byte shuffles.
+	if (p_word_size == sizeof(uint64_t)) {
+		for (int64_t i = 0; i < p_count; i++) {
+			uint64_t word;
+			memcpy(&word, p_data + i * sizeof(uint64_t), sizeof(uint64_t));
+			word = BSWAP64(word);
+			memcpy(p_data + i * sizeof(uint64_t), &word, sizeof(uint64_t));
+		}
+	} else {
+		for (int64_t i = 0; i < p_count; i++) {
+			uint32_t word;
+			memcpy(&word, p_data + i * sizeof(uint32_t), sizeof(uint32_t));
+			word = BSWAP32(word);
+			memcpy(p_data + i * sizeof(uint32_t), &word, sizeof(uint32_t));
+		}
+	}
+}
+#endif
+
+static void _decode_packed_words(const uint8_t *p_src, int64_t p_count, size_t p_word_size, void *r_dst) {
+	if (p_count == 0) {
+		return;
+	}
+	memcpy(r_dst, p_src, p_count * p_word_size);
+#ifdef BIG_ENDIAN_ENABLED
+	_swap_packed_words((uint8_t *)r_dst, p_count, p_word_size);
+#endif
+}
+
+static void _encode_packed_words(const void *p_src, int64_t p_count, size_t p_word_size, uint8_t *r_dst) {
+	if (p_count == 0) {
+		return;
+	}
+	memcpy(r_dst, p_src, p_count * p_word_size);
+#ifdef BIG_ENDIAN_ENABLED
+	_swap_packed_words(r_dst, p_count, p_word_size);
+#endif
+}
+
 static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r_string) {
 	ERR_FAIL_COND_V(len < 4, ERR_INVALID_DATA);
 
@@ -928,10 +974,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				uint8_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = buf[i];
-				}
+				memcpy(data.ptrw(), buf, count);
 			}
 
 			r_variant = data;
@@ -955,12 +998,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<int32_t> data;
 
 			if (count) {
-				//const int *rbuf = (const int *)buf;
 				data.resize(count);
-				int32_t *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = decode_uint32(&buf[i * 4]);
-				}
+				_decode_packed_words(buf, count, sizeof(int32_t), data.ptrw());
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -979,12 +1018,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<int64_t> data;
 
 			if (count) {
-				//const int *rbuf = (const int *)buf;
 				data.resize(count);
-				int64_t *w = data.ptrw();
-				for (int64_t i = 0; i < count; i++) {
-					w[i] = decode_uint64(&buf[i * 8]);
-				}
+				_decode_packed_words(buf, count, sizeof(int64_t), data.ptrw());
 			}
 			r_variant = Variant(data);
 			if (r_len) {
@@ -1003,12 +1038,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			Vector<float> data;
 
 			if (count) {
-				//const float *rbuf = (const float *)buf;
 				data.resize(count);
-				float *w = data.ptrw();
-				for (int32_t i = 0; i < count; i++) {
-					w[i] = decode_float(&buf[i * 4]);
-				}
+				_decode_packed_words(buf, count, sizeof(float), data.ptrw());
 			}
 			r_variant = data;
 
@@ -1029,10 +1060,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				data.resize(count);
-				double *w = data.ptrw();
-				for (int64_t i = 0; i < count; i++) {
-					w[i] = decode_double(&buf[i * 8]);
-				}
+				_decode_packed_words(buf, count, sizeof(double), data.ptrw());
 			}
 			r_variant = data;
 
@@ -1086,9 +1114,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
-					for (int32_t i = 0; i < count; i++) {
-						w[i].x = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 0);
-						w[i].y = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 1);
+					if constexpr (sizeof(real_t) == sizeof(double)) {
+						_decode_packed_words(buf, (int64_t)count * 2, sizeof(double), w);
+					} else {
+						for (int32_t i = 0; i < count; i++) {
+							w[i].x = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 0);
+							w[i].y = decode_double(buf + i * sizeof(double) * 2 + sizeof(double) * 1);
+						}
 					}
 
 					int adv = sizeof(double) * 2 * count;
@@ -1111,9 +1143,13 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector2 *w = varray.ptrw();
 
-					for (int32_t i = 0; i < count; i++) {
-						w[i].x = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 0);
-						w[i].y = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 1);
+					if constexpr (sizeof(real_t) == sizeof(float)) {
+						_decode_packed_words(buf, (int64_t)count * 2, sizeof(float), w);
+					} else {
+						for (int32_t i = 0; i < count; i++) {
+							w[i].x = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 0);
+							w[i].y = decode_float(buf + i * sizeof(float) * 2 + sizeof(float) * 1);
+						}
 					}
 
 					int adv = sizeof(float) * 2 * count;
@@ -1146,10 +1182,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
-					for (int32_t i = 0; i < count; i++) {
-						w[i].x = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 0);
-						w[i].y = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 1);
-						w[i].z = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 2);
+					if constexpr (sizeof(real_t) == sizeof(double)) {
+						_decode_packed_words(buf, (int64_t)count * 3, sizeof(double), w);
+					} else {
+						for (int32_t i = 0; i < count; i++) {
+							w[i].x = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 0);
+							w[i].y = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 1);
+							w[i].z = decode_double(buf + i * sizeof(double) * 3 + sizeof(double) * 2);
+						}
 					}
 
 					int adv = sizeof(double) * 3 * count;
@@ -1172,10 +1212,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector3 *w = varray.ptrw();
 
-					for (int32_t i = 0; i < count; i++) {
-						w[i].x = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 0);
-						w[i].y = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 1);
-						w[i].z = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 2);
+					if constexpr (sizeof(real_t) == sizeof(float)) {
+						_decode_packed_words(buf, (int64_t)count * 3, sizeof(float), w);
+					} else {
+						for (int32_t i = 0; i < count; i++) {
+							w[i].x = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 0);
+							w[i].y = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 1);
+							w[i].z = decode_float(buf + i * sizeof(float) * 3 + sizeof(float) * 2);
+						}
 					}
 
 					int adv = sizeof(float) * 3 * count;
@@ -1207,15 +1251,8 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			if (count) {
 				carray.resize(count);
-				Color *w = carray.ptrw();
-
-				for (int32_t i = 0; i < count; i++) {
-					// Colors should always be in single-precision.
-					w[i].r = decode_float(buf + i * 4 * 4 + 4 * 0);
-					w[i].g = decode_float(buf + i * 4 * 4 + 4 * 1);
-					w[i].b = decode_float(buf + i * 4 * 4 + 4 * 2);
-					w[i].a = decode_float(buf + i * 4 * 4 + 4 * 3);
-				}
+				// Colors should always be in single-precision.
+				_decode_packed_words(buf, (int64_t)count * 4, sizeof(float), carray.ptrw());
 
 				int adv = 4 * 4 * count;
 
@@ -1248,11 +1285,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector4 *w = varray.ptrw();
 
-					for (int32_t i = 0; i < count; i++) {
-						w[i].x = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 0);
-						w[i].y = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 1);
-						w[i].z = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 2);
-						w[i].w = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 3);
+					if constexpr (sizeof(real_t) == sizeof(double)) {
+						_decode_packed_words(buf, (int64_t)count * 4, sizeof(double), w);
+					} else {
+						for (int32_t i = 0; i < count; i++) {
+							w[i].x = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 0);
+							w[i].y = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 1);
+							w[i].z = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 2);
+							w[i].w = decode_double(buf + i * sizeof(double) * 4 + sizeof(double) * 3);
+						}
 					}
 
 					int adv = sizeof(double) * 4 * count;
@@ -1275,11 +1316,15 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					varray.resize(count);
 					Vector4 *w = varray.ptrw();
 
-					for (int32_t i = 0; i < count; i++) {
-						w[i].x = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 0);
-						w[i].y = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 1);
-						w[i].z = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 2);
-						w[i].w = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 3);
+					if constexpr (sizeof(real_t) == sizeof(float)) {
+						_decode_packed_words(buf, (int64_t)count * 4, sizeof(float), w);
+					} else {
+						for (int32_t i = 0; i < count; i++) {
+							w[i].x = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 0);
+							w[i].y = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 1);
+							w[i].z = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 2);
+							w[i].w = decode_float(buf + i * sizeof(float) * 4 + sizeof(float) * 3);
+						}
 					}
 
 					int adv = sizeof(float) * 4 * count;
@@ -1930,10 +1975,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const int32_t *r = data.ptr();
-				for (int32_t i = 0; i < datalen; i++) {
-					encode_uint32(r[i], &buf[i * datasize]);
-				}
+				_encode_packed_words(data.ptr(), datalen, datasize, buf);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1947,10 +1989,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const int64_t *r = data.ptr();
-				for (int64_t i = 0; i < datalen; i++) {
-					encode_uint64(r[i], &buf[i * datasize]);
-				}
+				_encode_packed_words(data.ptr(), datalen, datasize, buf);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1964,10 +2003,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const float *r = data.ptr();
-				for (int i = 0; i < datalen; i++) {
-					encode_float(r[i], &buf[i * datasize]);
-				}
+				_encode_packed_words(data.ptr(), datalen, datasize, buf);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -1981,10 +2017,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			if (buf) {
 				encode_uint32(datalen, buf);
 				buf += 4;
-				const double *r = data.ptr();
-				for (int i = 0; i < datalen; i++) {
-					encode_double(r[i], &buf[i * datasize]);
-				}
+				_encode_packed_words(data.ptr(), datalen, datasize, buf);
 			}
 
 			r_len += 4 + datalen * datasize;
@@ -2033,13 +2066,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Vector2 v = data.get(i);
-
-					encode_real(v.x, &buf[0]);
-					encode_real(v.y, &buf[sizeof(real_t)]);
-					buf += sizeof(real_t) * 2;
-				}
+				_encode_packed_words(data.ptr(), (int64_t)len * 2, sizeof(real_t), buf);
+				buf += sizeof(real_t) * 2 * len;
 			}
 
 			r_len += sizeof(real_t) * 2 * len;
@@ -2057,14 +2085,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Vector3 v = data.get(i);
-
-					encode_real(v.x, &buf[0]);
-					encode_real(v.y, &buf[sizeof(real_t)]);
-					encode_real(v.z, &buf[sizeof(real_t) * 2]);
-					buf += sizeof(real_t) * 3;
-				}
+				_encode_packed_words(data.ptr(), (int64_t)len * 3, sizeof(real_t), buf);
+				buf += sizeof(real_t) * 3 * len;
 			}
 
 			r_len += sizeof(real_t) * 3 * len;
@@ -2082,15 +2104,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Color c = data.get(i);
-
-					encode_float(c.r, &buf[0]);
-					encode_float(c.g, &buf[4]);
-					encode_float(c.b, &buf[8]);
-					encode_float(c.a, &buf[12]);
-					buf += 4 * 4; // Colors should always be in single-precision.
-				}
+				// Colors should always be in single-precision.
+				_encode_packed_words(data.ptr(), (int64_t)len * 4, sizeof(float), buf);
+				buf += 4 * 4 * len;
 			}
 
 			r_len += 4 * 4 * len;
@@ -2108,15 +2124,8 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			r_len += 4;
 
 			if (buf) {
-				for (int i = 0; i < len; i++) {
-					Vector4 v = data.get(i);
-
-					encode_real(v.x, &buf[0]);
-					encode_real(v.y, &buf[sizeof(real_t)]);
-					encode_real(v.z, &buf[sizeof(real_t) * 2]);
-					encode_real(v.w, &buf[sizeof(real_t) * 3]);
-					buf += sizeof(real_t) * 4;
-				}
+				_encode_packed_words(data.ptr(), (int64_t)len * 4, sizeof(real_t), buf);
+				buf += sizeof(real_t) * 4 * len;
 			}
 
 			r_len += sizeof(real_t) * 4 * len;
@@ -31,11 +31,16 @@
 #include "pck_packer.h"
 
 #include "core/crypto/crypto_core.h"
+#include "core/io/delta_encoding.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/object/worker_thread_pool.h"
 #include "core/version.h"
 
+// Upper bound of file contents kept in memory at once while flushing in deduplicated mode.
+static constexpr uint64_t PENDING_BATCH_BUDGET = 256 * 1024 * 1024;
+
 static int _get_pad(int p_alignment, int p_n) {
 	int rest = p_n % p_alignment;
 	int pad = 0;
@@ -50,7 +55,23 @@ void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_path", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file", "target_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file_removal", "target_path"), &PCKPacker::add_file_removal);
+	ClassDB::bind_method(D_METHOD("add_pack_patch", "base_pack_path", "new_pack_path", "min_delta_reduction"), &PCKPacker::add_pack_patch, DEFVAL(0.1));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
+
+	ClassDB::bind_method(D_METHOD("set_deduplicate", "enabled"), &PCKPacker::set_deduplicate);
+	ClassDB::bind_method(D_METHOD("is_deduplicating"), &PCKPacker::is_deduplicating);
+	ClassDB::bind_method(D_METHOD("get_deduplicated_size"), &PCKPacker::get_deduplicated_size);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deduplicate"), "set_deduplicate", "is_deduplicating");
+}
+
+void PCKPacker::_store_padding(int p_pad) {
+	static const uint8_t zeros[256] = {};
+	while (p_pad > 0) {
+		int chunk = MIN(p_pad, (int)sizeof(zeros));
+		file->store_buffer(zeros, chunk);
+		p_pad -= chunk;
+	}
 }
 
 Error PCKPacker::pck_start(const String &p_pck_path, int p_alignment, const String &p_key, bool p_encrypt_directory) {
@@ -112,10 +133,7 @@ Error PCKPacker::pck_start(const String &p_pck_path, int p_alignment, const Stri
 	}
 
 	// Align for first file.
-	int pad = _get_pad(alignment, file->get_position());
-	for (int i = 0; i < pad; i++) {
-		file->store_8(0);
-	}
+	_store_padding(_get_pad(alignment, file->get_position()));
 
 	file_base = file->get_position();
 	file->seek(file_base_ofs);
@@ -123,6 +141,8 @@ Error PCKPacker::pck_start(const String &p_pck_path, int p_alignment, const Stri
 	file->seek(file_base);
 
 	files.clear();
+	written_blobs.clear();
+	deduplicated_size = 0;
 
 	return OK;
 }
@@ -158,8 +178,17 @@ Error PCKPacker::add_file(const String &p_target_path, const String &p_source_pa
 	// symbols or 'res://' in them still match the MD5 hash for the saved path.
 	pf.path = p_target_path.simplify_path().trim_prefix("res://");
 	pf.src_path = p_source_path;
-	pf.ofs = file->get_position();
 	pf.size = f->get_length();
+	pf.encrypted = p_encrypt;
+
+	if (deduplicate) {
+		// Contents are read, hashed and written when flushing.
+		pf.pending = true;
+		files.push_back(pf);
+		return OK;
+	}
+
+	pf.ofs = file->get_position();
 
 	Vector<uint8_t> data = FileAccess::get_file_as_bytes(p_source_path);
 	{
@@ -170,8 +199,155 @@ Error PCKPacker::add_file(const String &p_target_path, const String &p_source_pa
 			pf.md5.write[i] = hash[i];
 		}
 	}
-	pf.encrypted = p_encrypt;
 
+	Error err = _write_content(data, p_encrypt);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	files.push_back(pf);
+
+	return OK;
+}
+
+struct PackDirectoryEntry {
+	String path;
+	uint64_t ofs = 0;
+	uint64_t size = 0;
+	uint32_t flags = 0;
+	uint8_t md5[16] = {};
+};
+
+// Reads the directory of a standalone PCK file, with offsets made absolute.
+static Error _read_pack_directory(const Ref<FileAccess> &p_file, LocalVector<PackDirectoryEntry> &r_entries) {
+	ERR_FAIL_COND_V_MSG(p_file->get_32() != PACK_HEADER_MAGIC, ERR_FILE_UNRECOGNIZED, vformat("'%s' is not a PCK file.", p_file->get_path()));
+
+	uint32_t version = p_file->get_32();
+	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION_V3 && version != PACK_FORMAT_VERSION_V2, ERR_FILE_UNRECOGNIZED, vformat("Pack version unsupported: %d.", version));
+	p_file->get_32(); // Engine major version.
+	p_file->get_32(); // Engine minor version.
+	p_file->get_32(); // Engine patch version.
+
+	uint32_t pack_flags = p_file->get_32();
+	ERR_FAIL_COND_V_MSG(pack_flags & (PACK_DIR_ENCRYPTED | PACK_SPARSE_BUNDLE), ERR_UNAVAILABLE, vformat("Encrypted and sparse PCK files can't be used to create patches: '%s'.", p_file->get_path()));
+
+	uint64_t file_base = p_file->get_64();
+	if (version == PACK_FORMAT_VERSION_V3) {
+		p_file->seek(p_file->get_64());
+	} else {
+		ERR_FAIL_COND_V_MSG(!(pack_flags & PACK_REL_FILEBASE), ERR_UNAVAILABLE, vformat("PCK files with absolute offsets can't be used to create patches: '%s'.", p_file->get_path()));
+		for (int i = 0; i < 16; i++) {
+			p_file->get_32(); // Reserved.
+		}
+	}
+
+	uint32_t file_count = p_file->get_32();
+	for (uint32_t i = 0; i < file_count; i++) {
+		uint32_t sl = p_file->get_32();
+		CharString cs;
+		cs.resize_uninitialized(sl + 1);
+		p_file->get_buffer((uint8_t *)cs.ptr(), sl);
+		cs[sl] = 0;
+
+		PackDirectoryEntry entry;
+		entry.path = String::utf8(cs.ptr(), sl);
+		entry.ofs = file_base + p_file->get_64();
+		entry.size = p_file->get_64();
+		p_file->get_buffer(entry.md5, 16);
+		entry.flags = p_file->get_32();
+		ERR_FAIL_COND_V(p_file->get_error() != OK, ERR_FILE_CORRUPT);
+
+		r_entries.push_back(entry);
+	}
+
+	return OK;
+}
+
+static Vector<uint8_t> _read_pack_file(const Ref<FileAccess> &p_file, const PackDirectoryEntry &p_entry) {
+	p_file->seek(p_entry.ofs);
+	return p_file->get_buffer(p_entry.size);
+}
+
+Error PCKPacker::add_pack_patch(const String &p_base_pack_path, const String &p_new_pack_path, float p_min_delta_reduction) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+
+	Error err;
+	Ref<FileAccess> base_pack = FileAccess::open(p_base_pack_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(base_pack.is_null(), err, vformat("Can't open base pack: '%s'.", p_base_pack_path));
+	Ref<FileAccess> new_pack = FileAccess::open(p_new_pack_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(new_pack.is_null(), err, vformat("Can't open new pack: '%s'.", p_new_pack_path));
+
+	LocalVector<PackDirectoryEntry> base_entries;
+	err = _read_pack_directory(base_pack, base_entries);
+	ERR_FAIL_COND_V(err != OK, err);
+	LocalVector<PackDirectoryEntry> new_entries;
+	err = _read_pack_directory(new_pack, new_entries);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	HashMap<String, const PackDirectoryEntry *> base_files;
+	for (const PackDirectoryEntry &entry : base_entries) {
+		if (entry.flags & (PACK_FILE_ENCRYPTED | PACK_FILE_DELTA)) {
+			ERR_FAIL_V_MSG(ERR_UNAVAILABLE, vformat("Base pack file '%s' is encrypted or a delta patch, which can't be used to create patches.", entry.path));
+		}
+		if (entry.flags & PACK_FILE_REMOVAL) {
+			base_files.erase(entry.path);
+		} else {
+			base_files[entry.path] = &entry;
+		}
+	}
+
+	HashSet<String> new_files;
+	for (const PackDirectoryEntry &entry : new_entries) {
+		if (entry.flags & (PACK_FILE_ENCRYPTED | PACK_FILE_DELTA)) {
+			ERR_FAIL_V_MSG(ERR_UNAVAILABLE, vformat("New pack file '%s' is encrypted or a delta patch, which can't be used to create patches.", entry.path));
+		}
+		if (entry.flags & PACK_FILE_REMOVAL) {
+			continue;
+		}
+		new_files.insert(entry.path);
+
+		File pf;
+		pf.path = entry.path;
+		pf.src_path = p_new_pack_path;
+		pf.md5.resize(16);
+		memcpy(pf.md5.ptrw(), entry.md5, 16);
+
+		Vector<uint8_t> new_data = _read_pack_file(new_pack, entry);
+		ERR_FAIL_COND_V_MSG(new_data.size() != (int64_t)entry.size, ERR_FILE_CORRUPT, vformat("Can't read '%s' from new pack.", entry.path));
+		Vector<uint8_t> data = new_data;
+
+		const PackDirectoryEntry **base_entry = base_files.getptr(entry.path);
+		if (base_entry) {
+			// The MD5 stored in packs can be stale, so compare the actual contents.
+			Vector<uint8_t> old_data = _read_pack_file(base_pack, **base_entry);
+			if (old_data == new_data) {
+				continue;
+			}
+
+			Vector<uint8_t> delta;
+			if (DeltaEncoding::encode_chunked_delta(old_data, new_data, delta) == OK && delta.size() <= new_data.size() * (1.0 - p_min_delta_reduction)) {
+				data = delta;
+				pf.delta = true;
+			}
+		}
+
+		pf.ofs = file->get_position();
+		pf.size = data.size();
+		err = _write_content(data, false);
+		ERR_FAIL_COND_V(err != OK, err);
+
+		files.push_back(pf);
+	}
+
+	for (const KeyValue<String, const PackDirectoryEntry *> &E : base_files) {
+		if (!new_files.has(E.key)) {
+			err = add_file_removal(E.key);
+			ERR_FAIL_COND_V(err != OK, err);
+		}
+	}
+
+	return OK;
+}
+
+Error PCKPacker::_write_content(const Vector<uint8_t> &p_data, bool p_encrypt) {
 	Ref<FileAccess> ftmp = file;
 
 	Ref<FileAccessEncrypted> fae;
@@ -184,19 +360,87 @@ Error PCKPacker::add_file(const String &p_target_path, const String &p_source_pa
 		ftmp = fae;
 	}
 
-	ftmp->store_buffer(data);
+	ftmp->store_buffer(p_data);
 
 	if (fae.is_valid()) {
 		ftmp.unref();
 		fae.unref();
 	}
 
-	int pad = _get_pad(alignment, file->get_position());
-	for (int j = 0; j < pad; j++) {
-		file->store_8(0);
+	_store_padding(_get_pad(alignment, file->get_position()));
+
+	return OK;
+}
+
+void PCKPacker::_hash_pending_content(uint32_t p_index, PendingContent *p_pending) {
+	PendingContent &pending = p_pending[p_index];
+	const File &pf = files[pending.file_index];
+
+	pending.data = FileAccess::get_file_as_bytes(pf.src_path, &pending.error);
+	if (pending.error != OK) {
+		return;
 	}
 
-	files.push_back(pf);
+	CryptoCore::md5(pending.data.ptr(), pending.data.size(), pending.md5);
+	CryptoCore::sha256(pending.data.ptr(), pending.data.size(), pending.content_hash.sha256);
+	pending.content_hash.encrypted = pf.encrypted;
+}
+
+Error PCKPacker::_write_pending_files(bool p_verbose) {
+	LocalVector<int> pending_indices;
+	for (int i = 0; i < files.size(); i++) {
+		if (files[i].pending) {
+			pending_indices.push_back(i);
+		}
+	}
+
+	uint32_t next = 0;
+	while (next < pending_indices.size()) {
+		// Read and hash a batch of files in parallel, keeping the amount of data in memory bounded.
+		LocalVector<PendingContent> batch;
+		uint64_t batch_size = 0;
+		while (next < pending_indices.size()) {
+			const File &pf = files[pending_indices[next]];
+			if (!batch.is_empty() && batch_size + pf.size > PENDING_BATCH_BUDGET) {
+				break;
+			}
+			PendingContent pending;
+			pending.file_index = pending_indices[next];
+			batch.push_back(pending);
+			batch_size += pf.size;
+			next++;
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &PCKPacker::_hash_pending_content, batch.ptr(), batch.size(), -1, true, SNAME("PCKPackerHashFiles"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		// Write sequentially, in the order files were added.
+		for (PendingContent &pending : batch) {
+			File &pf = files.write[pending.file_index];
+			ERR_FAIL_COND_V_MSG(pending.error != OK, pending.error, vformat("Can't read file to pack: '%s'.", pf.src_path));
+
+			pf.pending = false;
+			pf.size = pending.data.size();
+			pf.md5.resize(16);
+			memcpy(pf.md5.ptrw(), pending.md5, 16);
+
+			HashMap<ContentHash, uint64_t, ContentHash>::ConstIterator E = written_blobs.find(pending.content_hash);
+			if (E) {
+				pf.ofs = E->value;
+				deduplicated_size += pf.size;
+				if (p_verbose) {
+					print_line(vformat("PCKPacker deduplicated: %s -> %s", pf.src_path, pf.path));
+				}
+			} else {
+				pf.ofs = file->get_position();
+				Error err = _write_content(pending.data, pf.encrypted);
+				ERR_FAIL_COND_V(err != OK, err);
+				written_blobs.insert(pending.content_hash, pf.ofs);
+			}
+
+			pending.data = Vector<uint8_t>();
+		}
+	}
 
 	return OK;
 }
@@ -204,11 +448,14 @@ Error PCKPacker::add_file(const String &p_target_path, const String &p_source_pa
 Error PCKPacker::flush(bool p_verbose) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
-	int dir_padding = _get_pad(alignment, file->get_position());
-	for (int i = 0; i < dir_padding; i++) {
-		file->store_8(0);
+	Error pending_err = _write_pending_files(p_verbose);
+	if (pending_err != OK) {
+		file.unref();
+		return pending_err;
 	}
 
+	_store_padding(_get_pad(alignment, file->get_position()));
+
 	// Write directory.
 	uint64_t dir_offset = file->get_position();
 	file->seek(dir_base_ofs);
@@ -253,6 +500,9 @@ Error PCKPacker::flush(bool p_verbose) {
 		if (files[i].removal) {
 			flags |= PACK_FILE_REMOVAL;
 		}
+		if (files[i].delta) {
+			flags |= PACK_FILE_DELTA;
+		}
 		fhead->store_32(flags);
 
 		if (p_verbose) {
@@ -269,6 +519,18 @@ Error PCKPacker::flush(bool p_verbose) {
 	return OK;
 }
 
+void PCKPacker::set_deduplicate(bool p_enabled) {
+	deduplicate = p_enabled;
+}
+
+bool PCKPacker::is_deduplicating() const {
+	return deduplicate;
+}
+
+uint64_t PCKPacker::get_deduplicated_size() const {
+	return deduplicated_size;
+}
+
 PCKPacker::~PCKPacker() {
 	if (file.is_valid()) {
 		flush();
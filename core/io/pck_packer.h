@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
 
 class FileAccess;
 
@@ -42,6 +43,7 @@ class PCKPacker : public RefCounted {
 
 	Vector<uint8_t> key;
 	bool enc_dir = false;
+	bool deduplicate = false;
 
 	uint64_t file_base = 0;
 	uint64_t file_base_ofs = 0;
@@ -56,15 +58,52 @@ class PCKPacker : public RefCounted {
 		uint64_t size = 0;
 		bool encrypted = false;
 		bool removal = false;
+		bool delta = false;
+		bool pending = false; // Content not written yet, see `deduplicate`.
 		Vector<uint8_t> md5;
 	};
 	Vector<File> files;
 
+	// Deduplicated mode: file contents are read and hashed in parallel when flushing,
+	// and files with identical contents share a single blob in the pack.
+	struct ContentHash {
+		uint8_t sha256[32] = {};
+		bool encrypted = false;
+
+		bool operator==(const ContentHash &p_other) const {
+			return encrypted == p_other.encrypted && memcmp(sha256, p_other.sha256, 32) == 0;
+		}
+		static uint32_t hash(const ContentHash &p_val) {
+			return hash_murmur3_buffer(p_val.sha256, 32, p_val.encrypted ? 1 : 0);
+		}
+	};
+
+	struct PendingContent {
+		int file_index = -1;
+		Vector<uint8_t> data;
+		uint8_t md5[16] = {};
+		ContentHash content_hash;
+		Error error = OK;
+	};
+
+	HashMap<ContentHash, uint64_t, ContentHash> written_blobs;
+	uint64_t deduplicated_size = 0;
+
+	void _hash_pending_content(uint32_t p_index, PendingContent *p_pending);
+	Error _write_content(const Vector<uint8_t> &p_data, bool p_encrypt);
+	Error _write_pending_files(bool p_verbose);
+	void _store_padding(int p_pad);
+
 public:
 	Error pck_start(const String &p_pck_path, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
 	Error add_file(const String &p_target_path, const String &p_source_path, bool p_encrypt = false);
 	Error add_file_removal(const String &p_target_path);
+	Error add_pack_patch(const String &p_base_pack_path, const String &p_new_pack_path, float p_min_delta_reduction = 0.1);
 	Error flush(bool p_verbose = false);
 
+	void set_deduplicate(bool p_enabled);
+	bool is_deduplicating() const;
+	uint64_t get_deduplicated_size() const;
+
 	~PCKPacker();
 };
@@ -42,6 +42,9 @@ void Resource::emit_changed() {
 		emit_changed_state = EMIT_CHANGED_BLOCKED_PENDING_EMIT;
 		return;
 	}
+	if (!path_cache.is_empty()) {
+		ResourceCache::update_memory_usage(this);
+	}
 	if (ResourceLoader::is_within_load() && !Thread::is_main_thread()) {
 		ResourceLoader::resource_changed_emit(this);
 		return;
@@ -76,11 +79,13 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 		p_take_over = false; // Can't take over an empty path
 	}
 
+	const uint64_t memory_usage = p_path.is_empty() ? 0 : get_memory_usage();
+
 	{
 		MutexLock lock(ResourceCache::lock);
 
 		if (!path_cache.is_empty()) {
-			ResourceCache::resources.erase(path_cache);
+			ResourceCache::_erase(path_cache);
 		}
 
 		path_cache = "";
@@ -90,7 +95,7 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 		if (existing.is_valid()) {
 			if (p_take_over) {
 				existing->path_cache = String();
-				ResourceCache::resources.erase(p_path);
+				ResourceCache::_erase(p_path);
 			} else {
 				ERR_FAIL_MSG(vformat("Another resource is loaded from path '%s' (possible cyclic resource inclusion).", p_path));
 			}
@@ -100,6 +105,7 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 
 		if (!path_cache.is_empty()) {
 			ResourceCache::resources[path_cache] = this;
+			ResourceCache::_set_resident_memory_usage(this, memory_usage);
 		}
 	}
 
@@ -785,6 +791,7 @@ Resource::~Resource() {
 	// (Other resources can have the same value in `path_cache` if loaded with `CACHE_IGNORE`.)
 	HashMap<String, Resource *>::Iterator E = ResourceCache::resources.find(path_cache);
 	if (likely(E && E->value == this)) {
+		ResourceCache::resident_size -= resident_memory_usage;
 		ResourceCache::resources.remove(E);
 	}
 }
@@ -799,7 +806,15 @@ Mutex ResourceCache::lock;
 RWLock ResourceCache::path_cache_lock;
 #endif
 
+List<ResourceCache::RetainedEntry> ResourceCache::retained_lru;
+HashMap<Resource *, List<ResourceCache::RetainedEntry>::Element *> ResourceCache::retained;
+uint64_t ResourceCache::retained_budget = 0;
+uint64_t ResourceCache::retained_size = 0;
+uint64_t ResourceCache::resident_size = 0;
+
 void ResourceCache::clear() {
+	clear_retained();
+
 	if (!resources.is_empty()) {
 		if (OS::get_singleton()->is_stdout_verbose()) {
 			ERR_PRINT(vformat("%d resources still in use at exit.", resources.size()));
@@ -812,6 +827,7 @@ void ResourceCache::clear() {
 	}
 
 	resources.clear();
+	resident_size = 0;
 }
 
 bool ResourceCache::has(const String &p_path) {
@@ -825,7 +841,7 @@ bool ResourceCache::has(const String &p_path) {
 		if (res && (*res)->get_reference_count() == 0) {
 			// This resource is in the process of being deleted, ignore its existence.
 			(*res)->path_cache = String();
-			resources.erase(p_path);
+			_erase(p_path);
 			res = nullptr;
 		}
 	}
@@ -850,7 +866,7 @@ Ref<Resource> ResourceCache::get_ref(const String &p_path) {
 		if (res && ref.is_null()) {
 			// This resource is in the process of being deleted, ignore its existence
 			(*res)->path_cache = String();
-			resources.erase(p_path);
+			_erase(p_path);
 			res = nullptr;
 		}
 	}
@@ -877,7 +893,7 @@ void ResourceCache::get_cached_resources(List<Ref<Resource>> *p_resources) {
 	}
 
 	for (const String &E : to_remove) {
-		resources.erase(E);
+		_erase(E);
 	}
 }
 
@@ -885,3 +901,137 @@ int ResourceCache::get_cached_resource_count() {
 	MutexLock mutex_lock(lock);
 	return resources.size();
 }
+
+void ResourceCache::_evict_retained(uint64_t p_budget, LocalVector<Ref<Resource>> &r_evicted) {
+	// Must be called with the lock held. The evicted references are handed back to the caller
+	// so they are released (and possibly freed) only after the lock is gone.
+	while (!retained_lru.is_empty() && retained_size > p_budget) {
+		List<RetainedEntry>::Element *E = retained_lru.back();
+		retained_size -= E->get().size;
+		retained.erase(E->get().resource.ptr());
+		r_evicted.push_back(E->get().resource);
+		retained_lru.erase(E);
+	}
+}
+
+void ResourceCache::retain(const Ref<Resource> &p_resource) {
+	ERR_FAIL_COND(p_resource.is_null());
+
+	// Loads complete here, so this is also where the size of the loaded data is first known.
+	const uint64_t size = p_resource->get_memory_usage();
+
+	LocalVector<Ref<Resource>> evicted;
+	{
+		MutexLock mutex_lock(lock);
+
+		_set_resident_memory_usage(p_resource.ptr(), size);
+
+		// Resources of unknown size are not retained, they could take any amount of memory.
+		if (retained_budget == 0 || size == 0 || p_resource->is_built_in()) {
+			return;
+		}
+
+		List<RetainedEntry>::Element **existing = retained.getptr(p_resource.ptr());
+		if (existing) {
+			retained_lru.move_to_front(*existing);
+			return;
+		}
+
+		RetainedEntry entry;
+		entry.resource = p_resource;
+		entry.size = size;
+		if (entry.size > retained_budget) {
+			return; // Would evict everything else and itself right away.
+		}
+
+		retained[p_resource.ptr()] = retained_lru.push_front(entry);
+		retained_size += entry.size;
+
+		_evict_retained(retained_budget, evicted);
+	}
+}
+
+void ResourceCache::clear_retained() {
+	LocalVector<Ref<Resource>> evicted;
+	{
+		MutexLock mutex_lock(lock);
+		_evict_retained(0, evicted);
+	}
+}
+
+void ResourceCache::set_retained_budget(uint64_t p_bytes) {
+	LocalVector<Ref<Resource>> evicted;
+	{
+		MutexLock mutex_lock(lock);
+		retained_budget = p_bytes;
+		_evict_retained(retained_budget, evicted);
+	}
+}
+
+uint64_t ResourceCache::get_retained_budget() {
+	MutexLock mutex_lock(lock);
+	return retained_budget;
+}
+
+uint64_t ResourceCache::get_retained_memory_usage() {
+	MutexLock mutex_lock(lock);
+	return retained_size;
+}
+
+int ResourceCache::get_retained_resource_count() {
+	MutexLock mutex_lock(lock);
+	return retained_lru.size();
+}
+
+void ResourceCache::_erase(const String &p_path) {
+	// Must be called with the lock held.
+	HashMap<String, Resource *>::Iterator E = resources.find(p_path);
+	if (E) {
+		resident_size -= E->value->resident_memory_usage;
+		E->value->resident_memory_usage = 0;
+		resources.remove(E);
+	}
+}
+
+void ResourceCache::_set_resident_memory_usage(Resource *p_resource, uint64_t p_size) {
+	// Must be called with the lock held. Only the resource listed in the cache counts, other
+	// resources can share its path when loaded with `CACHE_MODE_IGNORE`.
+	Resource **res = resources.getptr(p_resource->path_cache);
+	if (res && *res == p_resource) {
+		resident_size = resident_size - p_resource->resident_memory_usage + p_size;
+		p_resource->resident_memory_usage = p_size;
+	}
+}
+
+void ResourceCache::update_memory_usage(Resource *p_resource) {
+	// The size may be a virtual call into arbitrary code, query it before locking.
+	const uint64_t size = p_resource->get_memory_usage();
+
+	MutexLock mutex_lock(lock);
+	_set_resident_memory_usage(p_resource, size);
+}
+
+uint64_t ResourceCache::get_resident_memory_usage() {
+	MutexLock mutex_lock(lock);
+	return resident_size;
+}
+
+void ResourceCache::get_resident_memory_usage_by_type(HashMap<StringName, uint64_t> &r_usage) {
+	// Take references under the lock, but query the class names and release the references once
+	// it's unlocked. The sizes are the ones counted in the total.
+	LocalVector<Pair<Ref<Resource>, uint64_t>> cached;
+	{
+		MutexLock mutex_lock(lock);
+		cached.reserve(resources.size());
+		for (const KeyValue<String, Resource *> &E : resources) {
+			Ref<Resource> ref = Ref<Resource>(E.value);
+			if (ref.is_valid()) {
+				cached.push_back(Pair<Ref<Resource>, uint64_t>(ref, E.value->resident_memory_usage));
+			}
+		}
+	}
+
+	for (const Pair<Ref<Resource>, uint64_t> &E : cached) {
+		r_usage[E.first->get_class_name()] += E.second;
+	}
+}
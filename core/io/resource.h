@@ -34,6 +34,7 @@
 #include "core/object/class_db.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/list.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 
@@ -73,6 +74,7 @@ private:
 	String name;
 	String path_cache;
 	String scene_unique_id;
+	uint64_t resident_memory_usage = 0; // Last size counted in the resource cache total, see ResourceCache::resident_size.
 
 #ifdef TOOLS_ENABLED
 	uint64_t last_modified_time = 0;
@@ -183,6 +185,7 @@ public:
 	void set_as_translation_remapped(bool p_remapped);
 
 	virtual RID get_rid() const; // Some resources may offer conversion to RID.
+	virtual uint64_t get_memory_usage() const { return 0; } // Estimated resident size in bytes, 0 if unknown. Resources of unknown size are never retained by the resource cache.
 
 	// Helps keep IDs the same when loading/saving scenes. An empty ID clears the entry, and an empty ID is returned when not found.
 	static void set_resource_id_for_path(const String &p_referrer_path, const String &p_resource_path, const String &p_id);
@@ -204,6 +207,27 @@ class ResourceCache {
 	static HashMap<String, HashMap<String, String>> resource_path_cache; // Each tscn has a set of resource paths and IDs.
 	static RWLock path_cache_lock;
 #endif // TOOLS_ENABLED
+
+	// Retained (soft) tier. Keeps recently loaded resources alive after their last external
+	// reference is dropped, so reloading them is a cache hit. Entries are evicted in LRU order
+	// once their estimated size goes over the budget. A budget of 0 disables the tier.
+	struct RetainedEntry {
+		Ref<Resource> resource;
+		uint64_t size = 0;
+	};
+	static List<RetainedEntry> retained_lru; // Most recently used first.
+	static HashMap<Resource *, List<RetainedEntry>::Element *> retained;
+	static uint64_t retained_budget;
+	static uint64_t retained_size;
+
+	// Running total of the sizes of the cached resources. Sizes are sampled when a resource enters
+	// the cache, when its load completes and whenever it emits `changed`.
+	static uint64_t resident_size;
+
+	static void _evict_retained(uint64_t p_budget, LocalVector<Ref<Resource>> &r_evicted);
+	static void _erase(const String &p_path);
+	static void _set_resident_memory_usage(Resource *p_resource, uint64_t p_size);
+
 	friend void unregister_core_types();
 	static void clear();
 	friend void register_core_types();
@@ -213,4 +237,15 @@ public:
 	static Ref<Resource> get_ref(const String &p_path);
 	static void get_cached_resources(List<Ref<Resource>> *p_resources);
 	static int get_cached_resource_count();
+
+	static void retain(const Ref<Resource> &p_resource);
+	static void clear_retained();
+	static void set_retained_budget(uint64_t p_bytes);
+	static uint64_t get_retained_budget();
+	static uint64_t get_retained_memory_usage();
+	static int get_retained_resource_count();
+
+	static void update_memory_usage(Resource *p_resource);
+	static uint64_t get_resident_memory_usage();
+	static void get_resident_memory_usage_by_type(HashMap<StringName, uint64_t> &r_usage);
 };
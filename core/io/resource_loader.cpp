@@ -448,6 +448,7 @@ void ResourceLoader::_run_load_task(void *p_userdata) {
 			if (pending_unlock) {
 				ResourceCache::lock.unlock();
 			}
+			ResourceCache::retain(load_task.resource);
 		} else {
 			load_task.resource->set_path_cache(load_task.local_path);
 		}
@@ -617,6 +618,7 @@ Ref<ResourceLoader::LoadToken> ResourceLoader::_load_start(const String &p_path,
 				Ref<Resource> existing = ResourceCache::get_ref(local_path);
 				if (existing.is_valid()) {
 					//referencing is fine
+					ResourceCache::retain(existing); // Mark as recently used.
 					load_task.resource = existing;
 					load_task.status = THREAD_LOAD_LOADED;
 					load_task.progress = 1.0;
@@ -66,6 +66,7 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
 	}
+	compact_graph_dirty = true;
 }
 
 Vector3 AStar3D::get_point_position(int64_t p_id) const {
@@ -80,6 +81,7 @@ void AStar3D::set_point_position(int64_t p_id, const Vector3 &p_pos) {
 	ERR_FAIL_COND_MSG(!point_entry, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
 	(*point_entry)->pos = p_pos;
+	compact_graph_dirty = true;
 }
 
 real_t AStar3D::get_point_weight_scale(int64_t p_id) const {
@@ -95,6 +97,7 @@ void AStar3D::set_point_weight_scale(int64_t p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 
 	(*point_entry)->weight_scale = p_weight_scale;
+	compact_graph_dirty = true;
 }
 
 void AStar3D::remove_point(int64_t p_id) {
@@ -121,6 +124,7 @@ void AStar3D::remove_point(int64_t p_id) {
 	memdelete(p);
 	points.erase(p_id);
 	last_free_id = p_id;
+	compact_graph_dirty = true;
 }
 
 void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
@@ -159,6 +163,7 @@ void AStar3D::connect_points(int64_t p_id, int64_t p_with_id, bool bidirectional
 	}
 
 	segments.insert(s);
+	compact_graph_dirty = true;
 }
 
 void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectional) {
@@ -198,6 +203,7 @@ void AStar3D::disconnect_points(int64_t p_id, int64_t p_with_id, bool bidirectio
 		if (s.direction != Segment::NONE) {
 			segments.insert(s);
 		}
+		compact_graph_dirty = true;
 	}
 }
 
@@ -243,6 +249,7 @@ void AStar3D::clear() {
 	}
 	segments.clear();
 	points.clear();
+	compact_graph_dirty = true;
 }
 
 int64_t AStar3D::get_point_count() const {
@@ -385,6 +392,325 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point, bool p_allow_partial_
 	return found_route;
 }
 
+bool AStar3D::_is_neighbor_filtered(int64_t p_from_id, int64_t p_neighbor_id) {
+	bool filtered;
+	return GDVIRTUAL_CALL(_filter_neighbor, p_from_id, p_neighbor_id, filtered) && filtered;
+}
+
+struct AStarSortDistances {
+	_FORCE_INLINE_ bool operator()(const Pair<real_t, uint32_t> &A, const Pair<real_t, uint32_t> &B) const {
+		return A.first > B.first;
+	}
+};
+
+static void _astar_compute_shortest_distances(uint32_t p_source, const LocalVector<uint32_t> &p_offsets, const LocalVector<uint32_t> &p_edges, const LocalVector<real_t> &p_edge_costs, LocalVector<real_t> &r_distances) {
+	for (real_t &distance : r_distances) {
+		distance = Math::INF;
+	}
+	r_distances[p_source] = 0;
+
+	LocalVector<Pair<real_t, uint32_t>> heap;
+	SortArray<Pair<real_t, uint32_t>, AStarSortDistances> sorter;
+	heap.push_back(Pair<real_t, uint32_t>(0, p_source));
+
+	while (!heap.is_empty()) {
+		sorter.pop_heap(0, heap.size(), heap.ptr());
+		const Pair<real_t, uint32_t> current = heap[heap.size() - 1];
+		heap.remove_at(heap.size() - 1);
+		if (current.first > r_distances[current.second]) {
+			continue; // Already reached with a shorter distance.
+		}
+
+		for (uint32_t edge = p_offsets[current.second]; edge < p_offsets[current.second + 1]; edge++) {
+			const real_t distance = current.first + p_edge_costs[edge];
+			if (distance < r_distances[p_edges[edge]]) {
+				r_distances[p_edges[edge]] = distance;
+				heap.push_back(Pair<real_t, uint32_t>(distance, p_edges[edge]));
+				sorter.push_heap(0, heap.size() - 1, 0, heap[heap.size() - 1], heap.ptr());
+			}
+		}
+	}
+}
+
+template <typename T>
+void AStar3D::_build_compact_graph(T *p_owner) {
+	CompactGraph &graph = compact_graph;
+	const uint32_t point_count = points.size();
+
+	graph.ids.resize(point_count);
+	graph.indices.clear();
+	graph.indices.reserve(point_count);
+	graph.weight_scales.resize(point_count);
+	graph.enabled.resize(point_count);
+
+	LocalVector<Vector3> positions;
+	positions.resize(point_count);
+
+	uint32_t index = 0;
+	uint32_t neighbor_count = 0;
+	for (const KeyValue<int64_t, Point *> &kv : points) {
+		graph.ids[index] = kv.key;
+		graph.indices.insert(kv.key, index);
+		graph.weight_scales[index] = kv.value->weight_scale;
+		graph.enabled[index] = kv.value->enabled;
+		positions[index] = kv.value->pos;
+		neighbor_count += kv.value->neighbors.size();
+		index++;
+	}
+
+	// Keeps the order of the neighbors, so both searches pick the same path out of equally short ones.
+	graph.neighbor_offsets.resize(point_count + 1);
+	graph.neighbors.resize(neighbor_count);
+	uint32_t offset = 0;
+	index = 0;
+	for (const KeyValue<int64_t, Point *> &kv : points) {
+		graph.neighbor_offsets[index++] = offset;
+		for (const KeyValue<int64_t, Point *> &neighbor : kv.value->neighbors) {
+			graph.neighbors[offset++] = graph.indices[neighbor.key];
+		}
+	}
+	graph.neighbor_offsets[point_count] = offset;
+
+	graph.landmark_count = MIN((uint32_t)landmark_count, point_count);
+	graph.landmark_distances_from.resize(point_count * graph.landmark_count);
+	graph.landmark_distances_to.resize(point_count * graph.landmark_count);
+	if (graph.landmark_count == 0) {
+		return;
+	}
+
+	// The disabled points and the neighbor filter are left out of the distances,
+	// they can only make paths longer, so the distances stay lower bounds when they change.
+	LocalVector<real_t> edge_costs;
+	edge_costs.resize(neighbor_count);
+	LocalVector<uint32_t> reverse_offsets;
+	reverse_offsets.resize(point_count + 1);
+	memset(reverse_offsets.ptr(), 0, sizeof(uint32_t) * (point_count + 1));
+	for (uint32_t i = 0; i < point_count; i++) {
+		for (uint32_t edge = graph.neighbor_offsets[i]; edge < graph.neighbor_offsets[i + 1]; edge++) {
+			const uint32_t neighbor = graph.neighbors[edge];
+			edge_costs[edge] = p_owner->_compute_cost(graph.ids[i], graph.ids[neighbor]) * graph.weight_scales[neighbor];
+			reverse_offsets[neighbor + 1]++;
+		}
+	}
+	for (uint32_t i = 1; i <= point_count; i++) {
+		reverse_offsets[i] += reverse_offsets[i - 1];
+	}
+
+	LocalVector<uint32_t> reverse_edges;
+	reverse_edges.resize(neighbor_count);
+	LocalVector<real_t> reverse_edge_costs;
+	reverse_edge_costs.resize(neighbor_count);
+	LocalVector<uint32_t> reverse_cursors = reverse_offsets;
+	for (uint32_t i = 0; i < point_count; i++) {
+		for (uint32_t edge = graph.neighbor_offsets[i]; edge < graph.neighbor_offsets[i + 1]; edge++) {
+			const uint32_t reverse_edge = reverse_cursors[graph.neighbors[edge]]++;
+			reverse_edges[reverse_edge] = i;
+			reverse_edge_costs[reverse_edge] = edge_costs[edge];
+		}
+	}
+
+	// Spreads the landmarks out by taking the point the furthest away from the ones taken before.
+	LocalVector<real_t> closest_landmark_distances;
+	closest_landmark_distances.resize(point_count);
+	for (uint32_t i = 0; i < point_count; i++) {
+		closest_landmark_distances[i] = positions[i].distance_squared_to(positions[0]);
+	}
+
+	LocalVector<real_t> distances;
+	distances.resize(point_count);
+	for (uint32_t landmark_index = 0; landmark_index < graph.landmark_count; landmark_index++) {
+		uint32_t landmark = 0;
+		for (uint32_t i = 1; i < point_count; i++) {
+			if (closest_landmark_distances[i] > closest_landmark_distances[landmark]) {
+				landmark = i;
+			}
+		}
+		for (uint32_t i = 0; i < point_count; i++) {
+			closest_landmark_distances[i] = MIN(closest_landmark_distances[i], positions[i].distance_squared_to(positions[landmark]));
+		}
+
+		_astar_compute_shortest_distances(landmark, graph.neighbor_offsets, graph.neighbors, edge_costs, distances);
+		for (uint32_t i = 0; i < point_count; i++) {
+			graph.landmark_distances_from[i * graph.landmark_count + landmark_index] = distances[i];
+		}
+
+		_astar_compute_shortest_distances(landmark, reverse_offsets, reverse_edges, reverse_edge_costs, distances);
+		for (uint32_t i = 0; i < point_count; i++) {
+			graph.landmark_distances_to[i * graph.landmark_count + landmark_index] = distances[i];
+		}
+	}
+}
+
+real_t AStar3D::_get_landmark_estimate(uint32_t p_from, uint32_t p_end) const {
+	// By the triangle inequality, the distance from a point to the end is at least
+	// `distance(landmark, end) - distance(landmark, point)` and `distance(point, landmark) - distance(end, landmark)`.
+	const uint32_t count = compact_graph.landmark_count;
+	const real_t *from_point = compact_graph.landmark_distances_from.ptr() + p_from * count;
+	const real_t *from_end = compact_graph.landmark_distances_from.ptr() + p_end * count;
+	const real_t *to_point = compact_graph.landmark_distances_to.ptr() + p_from * count;
+	const real_t *to_end = compact_graph.landmark_distances_to.ptr() + p_end * count;
+
+	real_t estimate = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (from_end[i] != Math::INF && from_point[i] != Math::INF) {
+			estimate = MAX(estimate, from_end[i] - from_point[i]);
+		}
+		if (to_point[i] != Math::INF && to_end[i] != Math::INF) {
+			estimate = MAX(estimate, to_point[i] - to_end[i]);
+		}
+	}
+	return estimate;
+}
+
+template <typename T>
+bool AStar3D::_solve_compact(T *p_owner, CompactQuery &r_query, uint32_t p_begin, uint32_t p_end, bool p_allow_partial_path) {
+	const CompactGraph &graph = compact_graph;
+	const uint32_t point_count = graph.ids.size();
+
+	if (r_query.open_passes.size() != point_count || r_query.pass == UINT32_MAX) {
+		r_query.open_passes.resize(point_count);
+		r_query.closed_passes.resize(point_count);
+		r_query.prev_points.resize(point_count);
+		r_query.g_scores.resize(point_count);
+		r_query.f_scores.resize(point_count);
+		memset(r_query.open_passes.ptr(), 0, sizeof(uint32_t) * point_count);
+		memset(r_query.closed_passes.ptr(), 0, sizeof(uint32_t) * point_count);
+		r_query.pass = 0;
+	}
+	const uint32_t query_pass = ++r_query.pass;
+	r_query.closest_point = UINT32_MAX;
+
+	if (!graph.enabled[p_end] && !p_allow_partial_path) {
+		return false;
+	}
+
+	const int64_t end_id = graph.ids[p_end];
+	const bool use_landmarks = graph.landmark_count > 0;
+
+	bool found_route = false;
+
+	LocalVector<uint32_t> &open_list = r_query.open_list;
+	open_list.clear();
+	SortArray<uint32_t, SortCompactPoints> sorter;
+	sorter.compare.query = &r_query;
+
+	real_t begin_estimate = p_owner->_estimate_cost(graph.ids[p_begin], end_id);
+	if (use_landmarks) {
+		begin_estimate = MAX(begin_estimate, _get_landmark_estimate(p_begin, p_end));
+	}
+	r_query.g_scores[p_begin] = 0;
+	r_query.f_scores[p_begin] = begin_estimate;
+	r_query.open_passes[p_begin] = query_pass;
+	open_list.push_back(p_begin);
+
+	while (!open_list.is_empty()) {
+		const uint32_t p = open_list[0]; // The currently processed point.
+		const int64_t p_id = graph.ids[p];
+
+		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
+		if (r_query.closest_point == UINT32_MAX) {
+			r_query.closest_point = p;
+		} else {
+			const uint32_t closest = r_query.closest_point;
+			const real_t closest_estimate = r_query.f_scores[closest] - r_query.g_scores[closest];
+			const real_t p_estimate = r_query.f_scores[p] - r_query.g_scores[p];
+			if (closest_estimate > p_estimate || (closest_estimate >= p_estimate && r_query.g_scores[closest] > r_query.g_scores[p])) {
+				r_query.closest_point = p;
+			}
+		}
+
+		if (p == p_end) {
+			found_route = true;
+			break;
+		}
+
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
+		open_list.remove_at(open_list.size() - 1);
+		r_query.closed_passes[p] = query_pass; // Mark the point as closed.
+
+		for (uint32_t edge = graph.neighbor_offsets[p]; edge < graph.neighbor_offsets[p + 1]; edge++) {
+			const uint32_t e = graph.neighbors[edge]; // The neighbor point.
+
+			if (!graph.enabled[e] || r_query.closed_passes[e] == query_pass) {
+				continue;
+			}
+
+			if (neighbor_filter_enabled && p_owner->_is_neighbor_filtered(p_id, graph.ids[e])) {
+				continue;
+			}
+
+			real_t tentative_g_score = r_query.g_scores[p] + p_owner->_compute_cost(p_id, graph.ids[e]) * graph.weight_scales[e];
+
+			bool new_point = false;
+
+			if (r_query.open_passes[e] != query_pass) { // The point wasn't inside the open list.
+				r_query.open_passes[e] = query_pass;
+				open_list.push_back(e);
+				new_point = true;
+			} else if (tentative_g_score >= r_query.g_scores[e]) { // The new path is worse than the previous.
+				continue;
+			}
+
+			real_t estimate = p_owner->_estimate_cost(graph.ids[e], end_id);
+			if (use_landmarks) {
+				estimate = MAX(estimate, _get_landmark_estimate(e, p_end));
+			}
+
+			r_query.prev_points[e] = p;
+			r_query.g_scores[e] = tentative_g_score;
+			r_query.f_scores[e] = tentative_g_score + estimate;
+
+			if (new_point) { // The position of the new points is already known.
+				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+			} else {
+				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+			}
+		}
+	}
+
+	return found_route;
+}
+
+template <typename T>
+void AStar3D::_find_compact_path(T *p_owner, int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path, LocalVector<int64_t> &r_path) {
+	CompactQuery *query = nullptr;
+	{
+		MutexLock lock(compact_graph_mutex);
+		if (compact_graph_dirty) {
+			_build_compact_graph(p_owner);
+			compact_graph_dirty = false;
+		}
+
+		if (free_compact_queries.is_empty()) {
+			query = memnew(CompactQuery);
+		} else {
+			query = free_compact_queries[free_compact_queries.size() - 1];
+			free_compact_queries.remove_at(free_compact_queries.size() - 1);
+		}
+	}
+
+	const uint32_t begin_point = *compact_graph.indices.getptr(p_from_id);
+	uint32_t end_point = *compact_graph.indices.getptr(p_to_id);
+
+	bool found_route = _solve_compact(p_owner, *query, begin_point, end_point, p_allow_partial_path);
+	if (!found_route && p_allow_partial_path && query->closest_point != UINT32_MAX) {
+		// Use closest point instead.
+		end_point = query->closest_point;
+		found_route = true;
+	}
+
+	if (found_route) {
+		for (uint32_t p = end_point; p != begin_point; p = query->prev_points[p]) {
+			r_path.push_back(compact_graph.ids[p]);
+		}
+		r_path.push_back(p_from_id);
+		r_path.reverse();
+	}
+
+	MutexLock lock(compact_graph_mutex);
+	free_compact_queries.push_back(query);
+}
+
 real_t AStar3D::_estimate_cost(int64_t p_from_id, int64_t p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -434,6 +760,19 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 		return ret;
 	}
 
+	if (compact_graph_enabled) {
+		LocalVector<int64_t> id_path;
+		_find_compact_path(this, p_from_id, p_to_id, p_allow_partial_path, id_path);
+
+		Vector<Vector3> path;
+		path.resize(id_path.size());
+		Vector3 *w = path.ptrw();
+		for (uint32_t i = 0; i < id_path.size(); i++) {
+			w[i] = (*points.getptr(id_path[i]))->pos;
+		}
+		return path;
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -492,6 +831,12 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 		return Vector<int64_t>();
 	}
 
+	if (compact_graph_enabled) {
+		LocalVector<int64_t> id_path;
+		_find_compact_path(this, p_from_id, p_to_id, p_allow_partial_path, id_path);
+		return Vector<int64_t>(id_path);
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -539,12 +884,55 @@ void AStar3D::set_neighbor_filter_enabled(bool p_enabled) {
 	neighbor_filter_enabled = p_enabled;
 }
 
+void AStar3D::set_compact_graph_enabled(bool p_enabled) {
+	if (compact_graph_enabled == p_enabled) {
+		return;
+	}
+
+	compact_graph_enabled = p_enabled;
+	compact_graph_dirty = true;
+	if (!p_enabled) {
+		compact_graph.ids.reset();
+		compact_graph.indices.reset();
+		compact_graph.weight_scales.reset();
+		compact_graph.enabled.reset();
+		compact_graph.neighbor_offsets.reset();
+		compact_graph.neighbors.reset();
+		compact_graph.landmark_distances_from.reset();
+		compact_graph.landmark_distances_to.reset();
+		for (CompactQuery *query : free_compact_queries) {
+			memdelete(query);
+		}
+		free_compact_queries.clear();
+	}
+}
+
+bool AStar3D::is_compact_graph_enabled() const {
+	return compact_graph_enabled;
+}
+
+void AStar3D::set_landmark_count(int p_landmark_count) {
+	ERR_FAIL_COND_MSG(p_landmark_count < 0, vformat("Can't set the landmark count less than 0: %d.", p_landmark_count));
+	if (landmark_count != p_landmark_count) {
+		landmark_count = p_landmark_count;
+		compact_graph_dirty = true;
+	}
+}
+
+int AStar3D::get_landmark_count() const {
+	return landmark_count;
+}
+
 void AStar3D::set_point_disabled(int64_t p_id, bool p_disabled) {
 	Point **p_entry = points.getptr(p_id);
 	ERR_FAIL_COND_MSG(!p_entry, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 	Point *p = *p_entry;
 
 	p->enabled = !p_disabled;
+	if (!compact_graph_dirty) {
+		// The landmark distances don't depend on disabled points, no need to build the compact graph again.
+		compact_graph.enabled[compact_graph.indices[p_id]] = !p_disabled;
+	}
 }
 
 bool AStar3D::is_point_disabled(int64_t p_id) const {
@@ -573,6 +961,11 @@ void AStar3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_neighbor_filter_enabled", "enabled"), &AStar3D::set_neighbor_filter_enabled);
 	ClassDB::bind_method(D_METHOD("is_neighbor_filter_enabled"), &AStar3D::is_neighbor_filter_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_compact_graph_enabled", "enabled"), &AStar3D::set_compact_graph_enabled);
+	ClassDB::bind_method(D_METHOD("is_compact_graph_enabled"), &AStar3D::is_compact_graph_enabled);
+	ClassDB::bind_method(D_METHOD("set_landmark_count", "landmark_count"), &AStar3D::set_landmark_count);
+	ClassDB::bind_method(D_METHOD("get_landmark_count"), &AStar3D::get_landmark_count);
+
 	ClassDB::bind_method(D_METHOD("connect_points", "id", "to_id", "bidirectional"), &AStar3D::connect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("disconnect_points", "id", "to_id", "bidirectional"), &AStar3D::disconnect_points, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("are_points_connected", "id", "to_id", "bidirectional"), &AStar3D::are_points_connected, DEFVAL(true));
@@ -593,10 +986,15 @@ void AStar3D::_bind_methods() {
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "neighbor_filter_enabled"), "set_neighbor_filter_enabled", "is_neighbor_filter_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compact_graph_enabled"), "set_compact_graph_enabled", "is_compact_graph_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "landmark_count", PROPERTY_HINT_RANGE, "0,32,1,or_greater"), "set_landmark_count", "get_landmark_count");
 }
 
 AStar3D::~AStar3D() {
 	clear();
+	for (CompactQuery *query : free_compact_queries) {
+		memdelete(query);
+	}
 }
 
 /////////////////////////////////////////////////////////////
@@ -650,6 +1048,22 @@ void AStar2D::set_neighbor_filter_enabled(bool p_enabled) {
 	astar.neighbor_filter_enabled = p_enabled;
 }
 
+void AStar2D::set_compact_graph_enabled(bool p_enabled) {
+	astar.set_compact_graph_enabled(p_enabled);
+}
+
+bool AStar2D::is_compact_graph_enabled() const {
+	return astar.is_compact_graph_enabled();
+}
+
+void AStar2D::set_landmark_count(int p_landmark_count) {
+	astar.set_landmark_count(p_landmark_count);
+}
+
+int AStar2D::get_landmark_count() const {
+	return astar.get_landmark_count();
+}
+
 void AStar2D::set_point_disabled(int64_t p_id, bool p_disabled) {
 	astar.set_point_disabled(p_id, p_disabled);
 }
@@ -695,6 +1109,11 @@ Vector2 AStar2D::get_closest_position_in_segment(const Vector2 &p_point) const {
 	return Vector2(p.x, p.y);
 }
 
+bool AStar2D::_is_neighbor_filtered(int64_t p_from_id, int64_t p_neighbor_id) {
+	bool filtered;
+	return GDVIRTUAL_CALL(_filter_neighbor, p_from_id, p_neighbor_id, filtered) && filtered;
+}
+
 real_t AStar2D::_estimate_cost(int64_t p_from_id, int64_t p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -743,6 +1162,20 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 		return ret;
 	}
 
+	if (astar.compact_graph_enabled) {
+		LocalVector<int64_t> id_path;
+		astar._find_compact_path(this, p_from_id, p_to_id, p_allow_partial_path, id_path);
+
+		Vector<Vector2> path;
+		path.resize(id_path.size());
+		Vector2 *w = path.ptrw();
+		for (uint32_t i = 0; i < id_path.size(); i++) {
+			const Vector3 &pos = (*astar.points.getptr(id_path[i]))->pos;
+			w[i] = Vector2(pos.x, pos.y);
+		}
+		return path;
+	}
+
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
@@ -801,6 +1234,12 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 		return Vector<int64_t>();
 	}
 
+	if (astar.compact_graph_enabled) {
+		LocalVector<int64_t> id_path;
+		astar._find_compact_path(this, p_from_id, p_to_id, p_allow_partial_path, id_path);
+		return Vector<int64_t>(id_path);
+	}
+
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
@@ -934,6 +1373,11 @@ void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_neighbor_filter_enabled", "enabled"), &AStar2D::set_neighbor_filter_enabled);
 	ClassDB::bind_method(D_METHOD("is_neighbor_filter_enabled"), &AStar2D::is_neighbor_filter_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_compact_graph_enabled", "enabled"), &AStar2D::set_compact_graph_enabled);
+	ClassDB::bind_method(D_METHOD("is_compact_graph_enabled"), &AStar2D::is_compact_graph_enabled);
+	ClassDB::bind_method(D_METHOD("set_landmark_count", "landmark_count"), &AStar2D::set_landmark_count);
+	ClassDB::bind_method(D_METHOD("get_landmark_count"), &AStar2D::get_landmark_count);
+
 	ClassDB::bind_method(D_METHOD("set_point_disabled", "id", "disabled"), &AStar2D::set_point_disabled, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("is_point_disabled", "id"), &AStar2D::is_point_disabled);
 
@@ -957,4 +1401,6 @@ void AStar2D::_bind_methods() {
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "neighbor_filter_enabled"), "set_neighbor_filter_enabled", "is_neighbor_filter_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compact_graph_enabled"), "set_compact_graph_enabled", "is_compact_graph_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "landmark_count", PROPERTY_HINT_RANGE, "0,32,1,or_greater"), "set_landmark_count", "get_landmark_count");
 }
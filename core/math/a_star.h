@@ -32,6 +32,7 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
 #include "core/templates/a_hash_map.h"
 
 /**
@@ -105,6 +106,49 @@ class AStar3D : public RefCounted {
 		}
 	};
 
+	// Snapshot of the graph in compressed sparse rows, searched instead of the points when the compact graph is enabled.
+	// The searches only read it and keep their state in a `CompactQuery`, so they can run on several threads at once.
+	struct CompactGraph {
+		LocalVector<int64_t> ids;
+		AHashMap<int64_t, uint32_t> indices;
+		LocalVector<real_t> weight_scales;
+		LocalVector<uint8_t> enabled;
+
+		// The neighbors of the point `i` are stored from `neighbor_offsets[i]` to `neighbor_offsets[i + 1]`.
+		LocalVector<uint32_t> neighbor_offsets;
+		LocalVector<uint32_t> neighbors;
+
+		// Shortest distances from and to each landmark, `landmark_count` values per point.
+		uint32_t landmark_count = 0;
+		LocalVector<real_t> landmark_distances_from;
+		LocalVector<real_t> landmark_distances_to;
+	};
+
+	struct CompactQuery {
+		uint32_t pass = 0;
+		LocalVector<uint32_t> open_passes;
+		LocalVector<uint32_t> closed_passes;
+		LocalVector<uint32_t> prev_points;
+		LocalVector<real_t> g_scores;
+		LocalVector<real_t> f_scores;
+		LocalVector<uint32_t> open_list;
+		uint32_t closest_point = 0;
+	};
+
+	struct SortCompactPoints {
+		const CompactQuery *query = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t A, uint32_t B) const { // Returns true when the point A is worse than point B.
+			if (query->f_scores[A] > query->f_scores[B]) {
+				return true;
+			} else if (query->f_scores[A] < query->f_scores[B]) {
+				return false;
+			} else {
+				return query->g_scores[A] < query->g_scores[B]; // If the f_costs are the same then prioritize the points that are further away from the start.
+			}
+		}
+	};
+
 	mutable int64_t last_free_id = 0;
 	uint64_t pass = 1;
 
@@ -113,7 +157,23 @@ class AStar3D : public RefCounted {
 	Point *last_closest_point = nullptr;
 	bool neighbor_filter_enabled = false;
 
+	bool compact_graph_enabled = false;
+	bool compact_graph_dirty = true;
+	int landmark_count = 0;
+	CompactGraph compact_graph;
+	LocalVector<CompactQuery *> free_compact_queries;
+	Mutex compact_graph_mutex;
+
 	bool _solve(Point *begin_point, Point *end_point, bool p_allow_partial_path);
+	bool _is_neighbor_filtered(int64_t p_from_id, int64_t p_neighbor_id);
+
+	template <typename T>
+	void _build_compact_graph(T *p_owner);
+	real_t _get_landmark_estimate(uint32_t p_from, uint32_t p_end) const;
+	template <typename T>
+	bool _solve_compact(T *p_owner, CompactQuery &r_query, uint32_t p_begin, uint32_t p_end, bool p_allow_partial_path);
+	template <typename T>
+	void _find_compact_path(T *p_owner, int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path, LocalVector<int64_t> &r_path);
 
 protected:
 	static void _bind_methods();
@@ -147,6 +207,12 @@ public:
 	bool is_neighbor_filter_enabled() const;
 	void set_neighbor_filter_enabled(bool p_enabled);
 
+	void set_compact_graph_enabled(bool p_enabled);
+	bool is_compact_graph_enabled() const;
+
+	void set_landmark_count(int p_landmark_count);
+	int get_landmark_count() const;
+
 	void set_point_disabled(int64_t p_id, bool p_disabled = true);
 	bool is_point_disabled(int64_t p_id) const;
 
@@ -170,9 +236,11 @@ public:
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
+	friend class AStar3D;
 	AStar3D astar;
 
 	bool _solve(AStar3D::Point *begin_point, AStar3D::Point *end_point, bool p_allow_partial_path);
+	bool _is_neighbor_filtered(int64_t p_from_id, int64_t p_neighbor_id);
 
 protected:
 	static void _bind_methods();
@@ -206,6 +274,12 @@ public:
 	bool is_neighbor_filter_enabled() const;
 	void set_neighbor_filter_enabled(bool p_enabled);
 
+	void set_compact_graph_enabled(bool p_enabled);
+	bool is_compact_graph_enabled() const;
+
+	void set_landmark_count(int p_landmark_count);
+	int get_landmark_count() const;
+
 	void set_point_disabled(int64_t p_id, bool p_disabled = true);
 	bool is_point_disabled(int64_t p_id) const;
 
@@ -31,6 +31,7 @@
 #include "a_star_grid_2d.h"
 #include "a_star_grid_2d.compat.inc"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 
 static real_t heuristic_euclidean(const Vector2i &p_from, const Vector2i &p_to) {
@@ -126,48 +127,142 @@ void AStarGrid2D::update() {
 		return;
 	}
 
-	points.clear();
-	solid_mask.clear();
+	const int32_t mask_width = region.size.x + 2;
+	const size_t mask_size = (size_t)mask_width * (region.size.y + 2);
+	solid_mask.resize((mask_size + 63) / 64);
+	memset(solid_mask.ptr(), 0, solid_mask.size() * sizeof(uint64_t));
 
-	const int32_t end_x = region.get_end().x;
-	const int32_t end_y = region.get_end().y;
-	const Vector2 half_cell_size = cell_size / 2;
-	for (int32_t x = region.position.x; x < end_x + 2; x++) {
-		solid_mask.push_back(true);
-	}
-
-	for (int32_t y = region.position.y; y < end_y; y++) {
-		LocalVector<Point> line;
-		solid_mask.push_back(true);
-		for (int32_t x = region.position.x; x < end_x; x++) {
-			Vector2 v = offset;
-			switch (cell_shape) {
-				case CELL_SHAPE_ISOMETRIC_RIGHT:
-					v += half_cell_size + Vector2(x + y, y - x) * half_cell_size;
-					break;
-				case CELL_SHAPE_ISOMETRIC_DOWN:
-					v += half_cell_size + Vector2(x - y, x + y) * half_cell_size;
-					break;
-				case CELL_SHAPE_SQUARE:
-					v += Vector2(x, y) * cell_size;
-					break;
-				default:
-					break;
-			}
-			line.push_back(Point(Vector2i(x, y), v));
-			solid_mask.push_back(false);
-		}
-		solid_mask.push_back(true);
-		points.push_back(line);
+	// The first and last rows, then the right edge of each row together with the left edge of the next one.
+	_set_solid_range(0, mask_width, true);
+	_set_solid_range(mask_size - mask_width, mask_size, true);
+	for (int32_t y = 1; y <= region.size.y + 1; y++) {
+		_set_solid_range((size_t)y * mask_width - 1, (size_t)y * mask_width + 1, true);
 	}
 
-	for (int32_t x = region.position.x; x < end_x + 2; x++) {
-		solid_mask.push_back(true);
+	weight_scales.resize((size_t)region.size.x * region.size.y);
+	for (real_t &weight_scale : weight_scales) {
+		weight_scale = 1.0;
 	}
 
+	jump_distances.clear();
+	jump_dirty_rows.resize(region.size.y);
+	jump_dirty_columns.resize(region.size.x);
+	jump_distances_dirty = false;
+
 	dirty = false;
 }
 
+void AStarGrid2D::_set_solid_range(size_t p_from_index, size_t p_to_index, bool p_solid) {
+	while (p_from_index < p_to_index) {
+		const size_t bit = p_from_index & 63;
+		const size_t count = MIN(p_to_index - p_from_index, 64 - bit);
+		const uint64_t bits = (count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << bit;
+		if (p_solid) {
+			solid_mask[p_from_index >> 6] |= bits;
+		} else {
+			solid_mask[p_from_index >> 6] &= ~bits;
+		}
+		p_from_index += count;
+	}
+}
+
+void AStarGrid2D::_mark_jump_distances_dirty(const Rect2i &p_region) {
+	// The scans along a line also read the lines next to it.
+	const int32_t from_y = MAX(p_region.position.y - 1, region.position.y) - region.position.y;
+	const int32_t to_y = MIN(p_region.get_end().y + 1, region.get_end().y) - region.position.y;
+	for (int32_t y = from_y; y < to_y; y++) {
+		jump_dirty_rows[y] = 1;
+	}
+
+	const int32_t from_x = MAX(p_region.position.x - 1, region.position.x) - region.position.x;
+	const int32_t to_x = MIN(p_region.get_end().x + 1, region.get_end().x) - region.position.x;
+	for (int32_t x = from_x; x < to_x; x++) {
+		jump_dirty_columns[x] = 1;
+	}
+
+	jump_distances_dirty = true;
+}
+
+void AStarGrid2D::_update_jump_distance_line(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, int32_t p_length) {
+	// Goes backwards from the last point of the line, so the distances of the next point are known.
+	const int direction = _get_jump_direction(p_dx, p_dy);
+	int32_t walkable_count = 0;
+	int32_t forced_distance = INT32_MAX;
+
+	int32_t x = p_x;
+	int32_t y = p_y;
+	for (int32_t i = 0; i < p_length; i++) {
+		walkable_count = _is_walkable(x, y) ? MIN(walkable_count + 1, JUMP_DISTANCE_MAX) : 0;
+		if (_is_forced(x, y, p_dx, p_dy)) {
+			forced_distance = 0;
+		} else if (forced_distance != INT32_MAX) {
+			forced_distance++;
+		}
+
+		// The distance to the forced point when the scan reaches it, otherwise the amount of walkable points as a negative value.
+		// A run of JUMP_DISTANCE_MAX walkable points is stored as INT16_MIN, the scan goes on after it.
+		jump_distances[_to_point_index(x, y) * 4 + direction] = int16_t(forced_distance < walkable_count ? forced_distance : -walkable_count - 1);
+
+		x -= p_dx;
+		y -= p_dy;
+	}
+}
+
+void AStarGrid2D::_update_jump_distances() {
+	const size_t point_count = (size_t)region.size.x * region.size.y;
+	if (jump_distances.size() != point_count * 4) {
+		jump_distances.resize(point_count * 4);
+		for (uint8_t &row_dirty : jump_dirty_rows) {
+			row_dirty = 1;
+		}
+		for (uint8_t &column_dirty : jump_dirty_columns) {
+			column_dirty = 1;
+		}
+		jump_distances_dirty = true;
+	}
+
+	if (!jump_distances_dirty) {
+		return;
+	}
+
+	const Vector2i end = region.get_end() - Vector2i(1, 1);
+	for (int32_t y = 0; y < region.size.y; y++) {
+		if (jump_dirty_rows[y]) {
+			_update_jump_distance_line(end.x, region.position.y + y, 1, 0, region.size.x);
+			_update_jump_distance_line(region.position.x, region.position.y + y, -1, 0, region.size.x);
+			jump_dirty_rows[y] = 0;
+		}
+	}
+	for (int32_t x = 0; x < region.size.x; x++) {
+		if (jump_dirty_columns[x]) {
+			_update_jump_distance_line(region.position.x + x, end.y, 0, 1, region.size.y);
+			_update_jump_distance_line(region.position.x + x, region.position.y, 0, -1, region.size.y);
+			jump_dirty_columns[x] = 0;
+		}
+	}
+
+	jump_distances_dirty = false;
+}
+
+Vector2 AStarGrid2D::_get_point_position_unchecked(const Vector2i &p_id) const {
+	const Vector2 half_cell_size = cell_size / 2;
+	Vector2 v = offset;
+	switch (cell_shape) {
+		case CELL_SHAPE_ISOMETRIC_RIGHT:
+			v += half_cell_size + Vector2(p_id.x + p_id.y, p_id.y - p_id.x) * half_cell_size;
+			break;
+		case CELL_SHAPE_ISOMETRIC_DOWN:
+			v += half_cell_size + Vector2(p_id.x - p_id.y, p_id.x + p_id.y) * half_cell_size;
+			break;
+		case CELL_SHAPE_SQUARE:
+			v += Vector2(p_id) * cell_size;
+			break;
+		default:
+			break;
+	}
+	return v;
+}
+
 bool AStarGrid2D::is_in_bounds(int32_t p_x, int32_t p_y) const {
 	return region.has_point(Vector2i(p_x, p_y));
 }
@@ -218,7 +313,12 @@ AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
 void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is disabled. Point %s out of bounds %s.", p_id, region));
-	_set_solid_unchecked(p_id, p_solid);
+	if (_get_solid_unchecked(p_id) == p_solid) {
+		return;
+	}
+	const size_t index = _to_mask_index(p_id.x, p_id.y);
+	_set_solid_range(index, index + 1, p_solid);
+	_mark_jump_distances_dirty(Rect2i(p_id, Vector2i(1, 1)));
 }
 
 bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
@@ -231,27 +331,30 @@ void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_s
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point %s out of bounds %s.", p_id, region));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
-	_get_point_unchecked(p_id)->weight_scale = p_weight_scale;
+	weight_scales[_to_point_index(p_id.x, p_id.y)] = p_weight_scale;
 }
 
 real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, 0, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), 0, vformat("Can't get point's weight scale. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->weight_scale;
+	return weight_scales[_to_point_index(p_id.x, p_id.y)];
 }
 
 void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 
 	const Rect2i safe_region = p_region.intersection(region);
+	if (!safe_region.has_area()) {
+		return;
+	}
+
 	const int32_t end_x = safe_region.get_end().x;
 	const int32_t end_y = safe_region.get_end().y;
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
-		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_set_solid_unchecked(x, y, p_solid);
-		}
+		_set_solid_range(_to_mask_index(safe_region.position.x, y), _to_mask_index(end_x, y), p_solid);
 	}
+	_mark_jump_distances_dirty(safe_region);
 }
 
 void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale) {
@@ -259,42 +362,47 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 
 	const Rect2i safe_region = p_region.intersection(region);
-	const int32_t end_x = safe_region.get_end().x;
 	const int32_t end_y = safe_region.get_end().y;
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
-		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_get_point_unchecked(x, y)->weight_scale = p_weight_scale;
+		real_t *line = weight_scales.ptr() + _to_point_index(safe_region.position.x, y);
+		for (int32_t x = 0; x < safe_region.size.x; x++) {
+			line[x] = p_weight_scale;
 		}
 	}
 }
 
-AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
-	int32_t from_x = p_from->id.x;
-	int32_t from_y = p_from->id.y;
+bool AStarGrid2D::_jump(const Vector2i &p_from, const Vector2i &p_to, const Vector2i &p_end, Vector2i &r_jump) const {
+	int32_t from_x = p_from.x;
+	int32_t from_y = p_from.y;
 
-	int32_t to_x = p_to->id.x;
-	int32_t to_y = p_to->id.y;
+	int32_t to_x = p_to.x;
+	int32_t to_y = p_to.y;
 
 	int32_t dx = to_x - from_x;
 	int32_t dy = to_y - from_y;
 
+	Vector2i successor;
+
 	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
 		if (dx == 0 || dy == 0) {
-			return _forced_successor(to_x, to_y, dx, dy);
+			return _forced_successor(to_x, to_y, dx, dy, p_end, false, r_jump);
 		}
 
 		while (_is_walkable(to_x, to_y) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || _is_walkable(to_x, to_y - dy) || _is_walkable(to_x - dx, to_y))) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (p_end.x == to_x && p_end.y == to_y) {
+				r_jump = p_end;
+				return true;
 			}
 
 			if ((_is_walkable(to_x - dx, to_y + dy) && !_is_walkable(to_x - dx, to_y)) || (_is_walkable(to_x + dx, to_y - dy) && !_is_walkable(to_x, to_y - dy))) {
-				return _get_point_unchecked(to_x, to_y);
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
-			if (_forced_successor(to_x + dx, to_y, dx, 0) != nullptr || _forced_successor(to_x, to_y + dy, 0, dy) != nullptr) {
-				return _get_point_unchecked(to_x, to_y);
+			if (_forced_successor(to_x + dx, to_y, dx, 0, p_end, false, successor) || _forced_successor(to_x, to_y + dy, 0, dy, p_end, false, successor)) {
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
 			to_x += dx;
@@ -303,20 +411,23 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
 		if (dx == 0 || dy == 0) {
-			return _forced_successor(from_x, from_y, dx, dy, true);
+			return _forced_successor(from_x, from_y, dx, dy, p_end, true, r_jump);
 		}
 
 		while (_is_walkable(to_x, to_y) && _is_walkable(to_x, to_y - dy) && _is_walkable(to_x - dx, to_y)) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (p_end.x == to_x && p_end.y == to_y) {
+				r_jump = p_end;
+				return true;
 			}
 
 			if ((_is_walkable(to_x + dx, to_y + dy) && !_is_walkable(to_x, to_y + dy)) || !_is_walkable(to_x + dx, to_y)) {
-				return _get_point_unchecked(to_x, to_y);
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
-			if (_forced_successor(to_x, to_y, dx, 0) != nullptr || _forced_successor(to_x, to_y, 0, dy) != nullptr) {
-				return _get_point_unchecked(to_x, to_y);
+			if (_forced_successor(to_x, to_y, dx, 0, p_end, false, successor) || _forced_successor(to_x, to_y, 0, dy, p_end, false, successor)) {
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
 			to_x += dx;
@@ -325,129 +436,116 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 
 	} else { // DIAGONAL_MODE_NEVER
 		if (dy == 0) {
-			return _forced_successor(from_x, from_y, dx, 0, true);
+			return _forced_successor(from_x, from_y, dx, 0, p_end, true, r_jump);
 		}
 
 		while (_is_walkable(to_x, to_y)) {
-			if (end->id.x == to_x && end->id.y == to_y) {
-				return end;
+			if (p_end.x == to_x && p_end.y == to_y) {
+				r_jump = p_end;
+				return true;
 			}
 
 			if ((_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy)) || (_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy))) {
-				return _get_point_unchecked(to_x, to_y);
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
-			if (_forced_successor(to_x, to_y, 1, 0, true) != nullptr || _forced_successor(to_x, to_y, -1, 0, true) != nullptr) {
-				return _get_point_unchecked(to_x, to_y);
+			if (_forced_successor(to_x, to_y, 1, 0, p_end, true, successor) || _forced_successor(to_x, to_y, -1, 0, p_end, true, successor)) {
+				r_jump = Vector2i(to_x, to_y);
+				return true;
 			}
 
 			to_y += dy;
 		}
 	}
 
-	return nullptr;
+	return false;
 }
 
-AStarGrid2D::Point *AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive) {
-	// Remembering previous results can improve performance.
-	bool l_prev = false, r_prev = false, l = false, r = false;
+bool AStarGrid2D::_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, const Vector2i &p_end, bool p_inclusive, Vector2i &r_successor) const {
+	// Scans the points from the given one, or from the next one when inclusive, until a forced point, the end point or a solid point.
+	if (!_is_walkable(p_x, p_y)) {
+		if (!p_inclusive || !_is_walkable(p_x + p_dx, p_y + p_dy)) {
+			return false;
+		}
 
-	int32_t o_x = p_x, o_y = p_y;
-	if (p_inclusive) {
-		o_x += p_dx;
-		o_y += p_dy;
+		// The distances are only stored for walkable points, take the first step by hand.
+		p_x += p_dx;
+		p_y += p_dy;
+		if (p_end.x == p_x && p_end.y == p_y) {
+			r_successor = p_end;
+			return true;
+		}
+		if (_is_forced(p_x - p_dx, p_y - p_dy, p_dx, p_dy)) {
+			r_successor = Vector2i(p_x, p_y);
+			return true;
+		}
 	}
 
-	int32_t l_x = p_x - p_dy, l_y = p_y - p_dx;
-	int32_t r_x = p_x + p_dy, r_y = p_y + p_dx;
+	int32_t first_step = p_inclusive ? 1 : 0;
+	while (true) {
+		const int32_t distance = jump_distances[_to_point_index(p_x, p_y) * 4 + _get_jump_direction(p_dx, p_dy)];
 
-	while (_is_walkable(o_x, o_y)) {
-		if (end->id.x == o_x && end->id.y == o_y) {
-			return end;
+		// An inclusive scan stops one point after the forced one, when that point is walkable.
+		int32_t forced_step = -1;
+		int32_t last_step = -distance - 2;
+		if (distance >= 0) {
+			if (!p_inclusive) {
+				forced_step = distance;
+			} else if (_is_walkable(p_x + (distance + 1) * p_dx, p_y + (distance + 1) * p_dy)) {
+				forced_step = distance + 1;
+			}
+			last_step = forced_step >= 0 ? forced_step : distance;
 		}
 
-		l_prev = l || _is_walkable(l_x, l_y);
-		r_prev = r || _is_walkable(r_x, r_y);
-
-		l_x += p_dx;
-		l_y += p_dy;
-		r_x += p_dx;
-		r_y += p_dy;
+		const int32_t end_step = p_dx != 0 ? (p_end.x - p_x) * p_dx : (p_end.y - p_y) * p_dy;
+		const bool end_on_line = p_dx != 0 ? p_end.y == p_y : p_end.x == p_x;
+		if (end_on_line && end_step >= first_step && end_step <= last_step) {
+			r_successor = p_end;
+			return true;
+		}
 
-		l = _is_walkable(l_x, l_y);
-		r = _is_walkable(r_x, r_y);
+		if (forced_step >= 0) {
+			r_successor = Vector2i(p_x + forced_step * p_dx, p_y + forced_step * p_dy);
+			return true;
+		}
 
-		if ((l && !l_prev) || (r && !r_prev)) {
-			return _get_point_unchecked(o_x, o_y);
+		if (distance != INT16_MIN) {
+			return false;
 		}
 
-		o_x += p_dx;
-		o_y += p_dy;
+		// The run was too long to be stored at once, read the distances of the point after it.
+		p_x += JUMP_DISTANCE_MAX * p_dx;
+		p_y += JUMP_DISTANCE_MAX * p_dy;
+		first_step = 0;
 	}
-	return nullptr;
 }
 
-void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
+void AStarGrid2D::_get_nbors(const Vector2i &p_id, LocalVector<Vector2i> &r_nbors) const {
 	bool ts0 = false, td0 = false,
 		 ts1 = false, td1 = false,
 		 ts2 = false, td2 = false,
 		 ts3 = false, td3 = false;
 
-	Point *left = nullptr;
-	Point *right = nullptr;
-	Point *top = nullptr;
-	Point *bottom = nullptr;
-
-	Point *top_left = nullptr;
-	Point *top_right = nullptr;
-	Point *bottom_left = nullptr;
-	Point *bottom_right = nullptr;
+	// The points around the region are solid, no need to check the bounds.
+	const Vector2i top = p_id + Vector2i(0, -1);
+	const Vector2i right = p_id + Vector2i(1, 0);
+	const Vector2i bottom = p_id + Vector2i(0, 1);
+	const Vector2i left = p_id + Vector2i(-1, 0);
 
-	{
-		bool has_left = false;
-		bool has_right = false;
-
-		if (p_point->id.x - 1 >= region.position.x) {
-			left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y);
-			has_left = true;
-		}
-		if (p_point->id.x + 1 < region.position.x + region.size.width) {
-			right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y);
-			has_right = true;
-		}
-		if (p_point->id.y - 1 >= region.position.y) {
-			top = _get_point_unchecked(p_point->id.x, p_point->id.y - 1);
-			if (has_left) {
-				top_left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y - 1);
-			}
-			if (has_right) {
-				top_right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y - 1);
-			}
-		}
-		if (p_point->id.y + 1 < region.position.y + region.size.height) {
-			bottom = _get_point_unchecked(p_point->id.x, p_point->id.y + 1);
-			if (has_left) {
-				bottom_left = _get_point_unchecked(p_point->id.x - 1, p_point->id.y + 1);
-			}
-			if (has_right) {
-				bottom_right = _get_point_unchecked(p_point->id.x + 1, p_point->id.y + 1);
-			}
-		}
-	}
-
-	if (top && !_get_solid_unchecked(top->id)) {
+	if (_is_walkable(top.x, top.y)) {
 		r_nbors.push_back(top);
 		ts0 = true;
 	}
-	if (right && !_get_solid_unchecked(right->id)) {
+	if (_is_walkable(right.x, right.y)) {
 		r_nbors.push_back(right);
 		ts1 = true;
 	}
-	if (bottom && !_get_solid_unchecked(bottom->id)) {
+	if (_is_walkable(bottom.x, bottom.y)) {
 		r_nbors.push_back(bottom);
 		ts2 = true;
 	}
-	if (left && !_get_solid_unchecked(left->id)) {
+	if (_is_walkable(left.x, left.y)) {
 		r_nbors.push_back(left);
 		ts3 = true;
 	}
@@ -477,99 +575,118 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 			break;
 	}
 
-	if (td0 && (top_left && !_get_solid_unchecked(top_left->id))) {
-		r_nbors.push_back(top_left);
+	if (td0 && _is_walkable(p_id.x - 1, p_id.y - 1)) {
+		r_nbors.push_back(p_id + Vector2i(-1, -1));
 	}
-	if (td1 && (top_right && !_get_solid_unchecked(top_right->id))) {
-		r_nbors.push_back(top_right);
+	if (td1 && _is_walkable(p_id.x + 1, p_id.y - 1)) {
+		r_nbors.push_back(p_id + Vector2i(1, -1));
 	}
-	if (td2 && (bottom_right && !_get_solid_unchecked(bottom_right->id))) {
-		r_nbors.push_back(bottom_right);
+	if (td2 && _is_walkable(p_id.x + 1, p_id.y + 1)) {
+		r_nbors.push_back(p_id + Vector2i(1, 1));
 	}
-	if (td3 && (bottom_left && !_get_solid_unchecked(bottom_left->id))) {
-		r_nbors.push_back(bottom_left);
+	if (td3 && _is_walkable(p_id.x - 1, p_id.y + 1)) {
+		r_nbors.push_back(p_id + Vector2i(-1, 1));
 	}
 }
 
-bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
-	last_closest_point = nullptr;
-	pass++;
+bool AStarGrid2D::_solve(SolveContext &r_context, const Vector2i &p_begin, const Vector2i &p_end, bool p_allow_partial_path) {
+	r_context.node_indices.clear();
+	r_context.nodes.clear();
+	r_context.open_list.clear();
+	r_context.closest_node = UINT32_MAX;
 
-	if (_get_solid_unchecked(p_end_point->id) && !p_allow_partial_path) {
+	if (_get_solid_unchecked(p_end) && !p_allow_partial_path) {
 		return false;
 	}
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
-	LocalVector<Point *> nbors;
+	LocalVector<SolveNode> &nodes = r_context.nodes;
+	LocalVector<uint32_t> &open_list = r_context.open_list;
+	SortArray<uint32_t, SortNodes> sorter;
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	p_begin_point->abs_g_score = 0;
-	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
-	end = p_end_point;
+	// The begin point is always the first node.
+	nodes.push_back(SolveNode(p_begin));
+	nodes[0].f_score = _estimate_cost(p_begin, p_end);
+	r_context.node_indices.insert(p_begin, 0);
+	open_list.push_back(0);
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		const uint32_t p_index = open_list[0]; // The currently processed point.
+		const Vector2i p_id = nodes[p_index].id;
+		const real_t p_g_score = nodes[p_index].g_score;
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		if (r_context.closest_node == UINT32_MAX) {
+			r_context.closest_node = p_index;
+		} else {
+			const SolveNode &closest = nodes[r_context.closest_node];
+			const real_t closest_estimate = closest.f_score - closest.g_score;
+			const real_t p_estimate = nodes[p_index].f_score - p_g_score;
+			if (closest_estimate > p_estimate || (closest_estimate >= p_estimate && closest.g_score > p_g_score)) {
+				r_context.closest_node = p_index;
+			}
 		}
 
-		if (p == p_end_point) {
+		if (p_id == p_end) {
 			found_route = true;
 			break;
 		}
 
+		sorter.compare.nodes = nodes.ptr();
 		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		nodes[p_index].closed = true;
 
-		nbors.clear();
-		_get_nbors(p, nbors);
+		r_context.nbors.clear();
+		_get_nbors(p_id, r_context.nbors);
 
-		for (Point *e : nbors) {
+		for (Vector2i e : r_context.nbors) {
 			real_t weight_scale = 1.0;
 
 			if (jumping_enabled) {
 				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
-				if (!e || e->closed_pass == pass) {
+				if (!_jump(p_id, e, p_end, e)) {
 					continue;
 				}
 			} else {
-				if (_get_solid_unchecked(e->id) || e->closed_pass == pass) {
+				if (_get_solid_unchecked(e)) {
 					continue;
 				}
-				weight_scale = e->weight_scale;
+				weight_scale = weight_scales[_to_point_index(e.x, e.y)];
+			}
+
+			const uint32_t *existing_index = r_context.node_indices.getptr(e);
+			if (existing_index && nodes[*existing_index].closed) {
+				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * weight_scale;
+			real_t tentative_g_score = p_g_score + _compute_cost(p_id, e) * weight_scale;
 			bool new_point = false;
+			uint32_t e_index;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (!existing_index) { // The point wasn't inside the open list.
+				e_index = nodes.size();
+				nodes.push_back(SolveNode(e));
+				r_context.node_indices.insert(e, e_index);
+				open_list.push_back(e_index);
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= nodes[*existing_index].g_score) { // The new path is worse than the previous.
 				continue;
+			} else {
+				e_index = *existing_index;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
-
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			SolveNode &e_node = nodes[e_index];
+			e_node.prev_node = p_index;
+			e_node.g_score = tentative_g_score;
+			e_node.f_score = e_node.g_score + _estimate_cost(e, p_end);
 
+			sorter.compare.nodes = nodes.ptr();
 			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+				sorter.push_heap(0, open_list.size() - 1, 0, e_index, open_list.ptr());
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				sorter.push_heap(0, open_list.find(e_index), 0, e_index, open_list.ptr());
 			}
 		}
 	}
@@ -577,6 +694,44 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 	return found_route;
 }
 
+void AStarGrid2D::_find_path(SolveContext &r_context, const Vector2i &p_from_id, const Vector2i &p_to_id, bool p_allow_partial_path, LocalVector<Vector2i> &r_path) {
+	r_path.clear();
+
+	if (p_from_id == p_to_id) {
+		r_path.push_back(p_from_id);
+		return;
+	}
+
+	uint32_t end_node;
+	if (_solve(r_context, p_from_id, p_to_id, p_allow_partial_path)) {
+		end_node = r_context.node_indices[p_to_id];
+	} else {
+		if (!p_allow_partial_path || r_context.closest_node == UINT32_MAX) {
+			return;
+		}
+
+		// Use closest point instead.
+		end_node = r_context.closest_node;
+	}
+
+	for (uint32_t node = end_node; node != 0; node = r_context.nodes[node].prev_node) {
+		r_path.push_back(r_context.nodes[node].id);
+	}
+	r_path.push_back(p_from_id);
+	r_path.reverse();
+}
+
+void AStarGrid2D::_find_batch_path(uint32_t p_index, PathBatch *p_batch) {
+	const Vector2i &from_id = p_batch->from_ids[p_index];
+	const Vector2i &to_id = p_batch->to_ids[p_index];
+	if (!is_in_boundsv(from_id) || !is_in_boundsv(to_id)) {
+		return;
+	}
+
+	SolveContext context;
+	_find_path(context, from_id, to_id, p_batch->allow_partial_path, p_batch->paths[p_index]);
+}
+
 real_t AStarGrid2D::_estimate_cost(const Vector2i &p_from_id, const Vector2i &p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -594,36 +749,39 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 }
 
 void AStarGrid2D::clear() {
-	points.clear();
+	solid_mask.clear();
+	weight_scales.clear();
+	jump_distances.clear();
+	jump_dirty_rows.clear();
+	jump_dirty_columns.clear();
+	jump_distances_dirty = false;
 	region = Rect2i();
 }
 
 Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, Vector2(), "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), Vector2(), vformat("Can't get point's position. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->pos;
+	return _get_point_position_unchecked(p_id);
 }
 
 TypedArray<Dictionary> AStarGrid2D::get_point_data_in_region(const Rect2i &p_region) const {
 	ERR_FAIL_COND_V_MSG(dirty, TypedArray<Dictionary>(), "Grid is not initialized. Call the update method.");
 	const Rect2i inter_region = region.intersection(p_region);
 
-	const int32_t start_x = inter_region.position.x - region.position.x;
-	const int32_t start_y = inter_region.position.y - region.position.y;
-	const int32_t end_x = inter_region.get_end().x - region.position.x;
-	const int32_t end_y = inter_region.get_end().y - region.position.y;
+	const int32_t end_x = inter_region.get_end().x;
+	const int32_t end_y = inter_region.get_end().y;
 
 	TypedArray<Dictionary> data;
 
-	for (int32_t y = start_y; y < end_y; y++) {
-		for (int32_t x = start_x; x < end_x; x++) {
-			const Point &p = points[y][x];
+	for (int32_t y = inter_region.position.y; y < end_y; y++) {
+		for (int32_t x = inter_region.position.x; x < end_x; x++) {
+			const Vector2i id(x, y);
 
 			Dictionary dict;
-			dict["id"] = p.id;
-			dict["position"] = p.pos;
-			dict["solid"] = _get_solid_unchecked(p.id);
-			dict["weight_scale"] = p.weight_scale;
+			dict["id"] = id;
+			dict["position"] = _get_point_position_unchecked(id);
+			dict["solid"] = _get_solid_unchecked(id);
+			dict["weight_scale"] = weight_scales[_to_point_index(x, y)];
 			data.push_back(dict);
 		}
 	}
@@ -636,49 +794,18 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), Vector<Vector2>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
-
-	if (a == b) {
-		Vector<Vector2> ret;
-		ret.push_back(a->pos);
-		return ret;
+	if (jumping_enabled) {
+		_update_jump_distances();
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
+	LocalVector<Vector2i> id_path;
+	_find_path(solve_context, p_from_id, p_to_id, p_allow_partial_path, id_path);
 
 	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
-		}
-
-		w[0] = p->pos;
+	path.resize(id_path.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < id_path.size(); i++) {
+		w[i] = _get_point_position_unchecked(id_path[i]);
 	}
 
 	return path;
@@ -689,50 +816,68 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_from_id, region));
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), TypedArray<Vector2i>(), vformat("Can't get id path. Point %s out of bounds %s.", p_to_id, region));
 
-	Point *a = _get_point(p_from_id.x, p_from_id.y);
-	Point *b = _get_point(p_to_id.x, p_to_id.y);
+	if (jumping_enabled) {
+		_update_jump_distances();
+	}
+
+	LocalVector<Vector2i> id_path;
+	_find_path(solve_context, p_from_id, p_to_id, p_allow_partial_path, id_path);
 
-	if (a == b) {
-		TypedArray<Vector2i> ret;
-		ret.push_back(a->id);
-		return ret;
+	TypedArray<Vector2i> path;
+	path.resize(id_path.size());
+	for (uint32_t i = 0; i < id_path.size(); i++) {
+		path[i] = id_path[i];
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	return path;
+}
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
-	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return TypedArray<Vector2i>();
-		}
+TypedArray<Array> AStarGrid2D::get_id_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path) {
+	ERR_FAIL_COND_V_MSG(dirty, TypedArray<Array>(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), TypedArray<Array>(), vformat("Can't get id paths. The amount of start points %d doesn't match the amount of end points %d.", p_from_ids.size(), p_to_ids.size()));
 
-		// Use closest point instead.
-		end_point = last_closest_point;
+	const uint32_t path_count = p_from_ids.size();
+
+	PathBatch batch;
+	batch.allow_partial_path = p_allow_partial_path;
+	batch.from_ids.resize(path_count);
+	batch.to_ids.resize(path_count);
+	batch.paths.resize(path_count);
+	for (uint32_t i = 0; i < path_count; i++) {
+		batch.from_ids[i] = p_from_ids[i];
+		batch.to_ids[i] = p_to_ids[i];
+		if (!is_in_boundsv(batch.from_ids[i]) || !is_in_boundsv(batch.to_ids[i])) {
+			ERR_PRINT(vformat("Can't get id path %d. Point %s or %s out of bounds %s.", i, batch.from_ids[i], batch.to_ids[i], region));
+		}
 	}
 
-	Point *p = end_point;
-	int32_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	if (jumping_enabled) {
+		_update_jump_distances();
 	}
 
-	TypedArray<Vector2i> path;
-	path.resize(pc);
-
-	{
-		p = end_point;
-		int32_t idx = pc - 1;
-		while (p != begin_point) {
-			path[idx--] = p->id;
-			p = p->prev_point;
+	// Script costs may not be safe to call from several threads.
+	if (path_count > 1 && !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost)) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStarGrid2D::_find_batch_path, &batch, path_count, -1, true, SNAME("AStarGrid2DPaths"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < path_count; i++) {
+			_find_batch_path(i, &batch);
 		}
+	}
 
-		path[0] = p->id;
+	TypedArray<Array> paths;
+	paths.resize(path_count);
+	for (uint32_t i = 0; i < path_count; i++) {
+		const LocalVector<Vector2i> &id_path = batch.paths[i];
+		TypedArray<Vector2i> path;
+		path.resize(id_path.size());
+		for (uint32_t j = 0; j < id_path.size(); j++) {
+			path[j] = id_path[j];
+		}
+		paths[i] = path;
 	}
 
-	return path;
+	return paths;
 }
 
 void AStarGrid2D::_bind_methods() {
@@ -770,6 +915,7 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_data_in_region", "region"), &AStarGrid2D::get_point_data_in_region);
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids", "allow_partial_path"), &AStarGrid2D::get_id_paths, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
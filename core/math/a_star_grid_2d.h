@@ -32,6 +32,7 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/a_hash_map.h"
 #include "core/templates/local_vector.h"
 
 class AStarGrid2D : public RefCounted {
@@ -73,92 +74,104 @@ private:
 	Heuristic default_compute_heuristic = HEURISTIC_EUCLIDEAN;
 	Heuristic default_estimate_heuristic = HEURISTIC_EUCLIDEAN;
 
-	struct Point {
+	// Search state of a single path query, kept apart from the grid so several queries can run at once.
+	struct SolveNode {
 		Vector2i id;
-
-		Vector2 pos;
-		real_t weight_scale = 1.0;
-
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
+		uint32_t prev_node = 0;
 		real_t g_score = 0;
 		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
+		bool closed = false;
 
-		// Used for getting last_closest_point.
-		real_t abs_g_score = 0;
-		real_t abs_f_score = 0;
+		SolveNode() {}
 
-		Point() {}
-
-		Point(const Vector2i &p_id, const Vector2 &p_pos) :
-				id(p_id), pos(p_pos) {}
+		SolveNode(const Vector2i &p_id) :
+				id(p_id) {}
 	};
 
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+	struct SortNodes {
+		const SolveNode *nodes = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t A, uint32_t B) const { // Returns true when the node A is worse than node B.
+			if (nodes[A].f_score > nodes[B].f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (nodes[A].f_score < nodes[B].f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return nodes[A].g_score < nodes[B].g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
 
-	LocalVector<bool> solid_mask;
-	LocalVector<LocalVector<Point>> points;
-	Point *end = nullptr;
-	Point *last_closest_point = nullptr;
+	struct SolveContext {
+		// Only the visited points get a node, most queries touch a small part of big grids.
+		AHashMap<Vector2i, uint32_t> node_indices;
+		LocalVector<SolveNode> nodes;
+		LocalVector<uint32_t> open_list;
+		LocalVector<Vector2i> nbors;
+		uint32_t closest_node = UINT32_MAX;
+	};
+
+	struct PathBatch {
+		LocalVector<Vector2i> from_ids;
+		LocalVector<Vector2i> to_ids;
+		LocalVector<LocalVector<Vector2i>> paths;
+		bool allow_partial_path = false;
+	};
+
+	// One bit per point, with a solid border around the region so neighbors never need bounds checks.
+	LocalVector<uint64_t> solid_mask;
+	LocalVector<real_t> weight_scales;
+	SolveContext solve_context;
 
-	uint64_t pass = 1;
+	// JPS+ distances of the straight scans from each point, four per point, see `_update_jump_distance_line()`.
+	// Solid changes only invalidate the lines around them, which are recomputed before the next jumping query.
+	// Longer runs than JUMP_DISTANCE_MAX are split, the scan reads the distances again where a run is cut.
+	static constexpr int32_t JUMP_DISTANCE_MAX = INT16_MAX;
+	LocalVector<int16_t> jump_distances;
+	LocalVector<uint8_t> jump_dirty_rows;
+	LocalVector<uint8_t> jump_dirty_columns;
+	bool jump_distances_dirty = false;
 
 private: // Internal routines.
 	_FORCE_INLINE_ size_t _to_mask_index(int32_t p_x, int32_t p_y) const {
 		return ((p_y - region.position.y + 1) * (region.size.x + 2)) + p_x - region.position.x + 1;
 	}
 
-	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
-		return !solid_mask[_to_mask_index(p_x, p_y)];
-	}
-
-	_FORCE_INLINE_ Point *_get_point(int32_t p_x, int32_t p_y) {
-		if (region.has_point(Vector2i(p_x, p_y))) {
-			return &points[p_y - region.position.y][p_x - region.position.x];
-		}
-		return nullptr;
+	_FORCE_INLINE_ size_t _to_point_index(int32_t p_x, int32_t p_y) const {
+		return (p_y - region.position.y) * region.size.x + p_x - region.position.x;
 	}
 
-	_FORCE_INLINE_ void _set_solid_unchecked(int32_t p_x, int32_t p_y, bool p_solid) {
-		solid_mask[_to_mask_index(p_x, p_y)] = p_solid;
-	}
-
-	_FORCE_INLINE_ void _set_solid_unchecked(const Vector2i &p_id, bool p_solid) {
-		solid_mask[_to_mask_index(p_id.x, p_id.y)] = p_solid;
+	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
+		const size_t index = _to_mask_index(p_x, p_y);
+		return !((solid_mask[index >> 6] >> (index & 63)) & 1);
 	}
 
 	_FORCE_INLINE_ bool _get_solid_unchecked(const Vector2i &p_id) const {
-		return solid_mask[_to_mask_index(p_id.x, p_id.y)];
+		return !_is_walkable(p_id.x, p_id.y);
 	}
 
-	_FORCE_INLINE_ Point *_get_point_unchecked(int32_t p_x, int32_t p_y) {
-		return &points[p_y - region.position.y][p_x - region.position.x];
+	// A scan is forced to stop at a point when a side of it is blocked, but not the same side of the next point.
+	_FORCE_INLINE_ bool _is_forced(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const {
+		return (!_is_walkable(p_x - p_dy, p_y - p_dx) && _is_walkable(p_x - p_dy + p_dx, p_y - p_dx + p_dy)) ||
+				(!_is_walkable(p_x + p_dy, p_y + p_dx) && _is_walkable(p_x + p_dy + p_dx, p_y + p_dx + p_dy));
 	}
 
-	_FORCE_INLINE_ Point *_get_point_unchecked(const Vector2i &p_id) {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
+	_FORCE_INLINE_ static int _get_jump_direction(int32_t p_dx, int32_t p_dy) {
+		return p_dx != 0 ? (1 - p_dx) / 2 : 2 + (1 - p_dy) / 2;
 	}
 
-	_FORCE_INLINE_ const Point *_get_point_unchecked(const Vector2i &p_id) const {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
-	}
+	void _set_solid_range(size_t p_from_index, size_t p_to_index, bool p_solid);
+	void _mark_jump_distances_dirty(const Rect2i &p_region);
+	void _update_jump_distance_line(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, int32_t p_length);
+	void _update_jump_distances();
+	Vector2 _get_point_position_unchecked(const Vector2i &p_id) const;
 
-	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
-	Point *_jump(Point *p_from, Point *p_to);
-	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
-	Point *_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive = false);
+	void _get_nbors(const Vector2i &p_id, LocalVector<Vector2i> &r_nbors) const;
+	bool _jump(const Vector2i &p_from, const Vector2i &p_to, const Vector2i &p_end, Vector2i &r_jump) const;
+	bool _forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, const Vector2i &p_end, bool p_inclusive, Vector2i &r_successor) const;
+	bool _solve(SolveContext &r_context, const Vector2i &p_begin, const Vector2i &p_end, bool p_allow_partial_path);
+	void _find_path(SolveContext &r_context, const Vector2i &p_from_id, const Vector2i &p_to_id, bool p_allow_partial_path, LocalVector<Vector2i> &r_path);
+	void _find_batch_path(uint32_t p_index, PathBatch *p_batch);
 
 protected:
 	static void _bind_methods();
@@ -224,6 +237,7 @@ public:
 	TypedArray<Dictionary> get_point_data_in_region(const Rect2i &p_region) const;
 	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
 	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
+	TypedArray<Array> get_id_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, bool p_allow_partial_path = false);
 };
 
 VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
@@ -53,6 +53,7 @@
 #include "bvh_tree.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -89,6 +90,13 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// When at least this many items have changed since the last collision check,
+	// the new pairs are searched for on the worker threads. 0 disables this.
+	void params_set_parallel_pairing_threshold(uint32_t p_threshold) {
+		BVH_LOCKED_FUNCTION
+		_parallel_pairing_threshold = p_threshold;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -382,6 +390,17 @@ public:
 		return params.result_count_overall;
 	}
 
+	// Batched version of cull_segment(), reporting every hit as
+	// p_hit_func(segment_index, userdata, subindex) rather than filling result arrays.
+	template <typename HitFunc>
+	void cull_segments(const POINT *p_from, const POINT *p_to, int p_count, HitFunc &p_hit_func, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF) {
+		BVH_LOCKED_FUNCTION
+		if (p_count <= 0) {
+			return;
+		}
+		tree.cull_segments(p_from, p_to, p_count, p_tester, p_tree_collision_mask, p_hit_func);
+	}
+
 	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
 		BVH_LOCKED_FUNCTION
 		typename BVHTREE_CLASS::CullParams params;
@@ -436,6 +455,11 @@ private:
 			return;
 		}
 
+		if (USE_PAIRS && _parallel_pairing_threshold && changed_items.size() >= _parallel_pairing_threshold) {
+			_check_for_collisions_parallel(p_full_check);
+			return;
+		}
+
 		typename BVHTREE_CLASS::CullParams params;
 
 		params.result_count_overall = 0;
@@ -479,6 +503,83 @@ private:
 		_reset();
 	}
 
+	// Same result as the serial check, but the tree is culled for the changed items
+	// on the worker threads. The leavers are removed first, so the tree and pairs
+	// are only read while the threads run. Each chunk of changed items collects
+	// the candidate pairs into its own list, and the lists are merged in order, so
+	// the callbacks are always sent in the same order.
+	void _check_for_collisions_parallel(bool p_full_check) {
+		for (const BVHHandle &h : changed_items) {
+			BVHABB_CLASS abb;
+			abb.from(tree._pairs[h.id()].expanded_aabb);
+			_find_leavers(h, abb, p_full_check);
+		}
+
+		WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+		uint32_t chunk_count = MIN(changed_items.size(), uint32_t(thread_pool->get_thread_count()) * PAIRING_CHUNKS_PER_THREAD);
+		if (_pairing_chunks.size() < chunk_count) {
+			_pairing_chunks.resize(chunk_count);
+		}
+
+		WorkerThreadPool::GroupID group_task = thread_pool->add_template_group_task(this, &BVH_Manager::_find_enterers_chunk, chunk_count, chunk_count, -1, true, SNAME("BVHFindPairs"));
+		thread_pool->wait_for_group_task_completion(group_task);
+
+		for (uint32_t c = 0; c < chunk_count; c++) {
+			const LocalVector<BVHHandle> &enterers = _pairing_chunks[c];
+			for (uint32_t n = 0; n < enterers.size(); n += 2) {
+				// a pair may have been found from both of its items
+				_collide(enterers[n], enterers[n + 1]);
+			}
+		}
+		_reset();
+	}
+
+	// Stores the candidate pairs of the changed items in the chunk as handle pairs.
+	// The pairs which already exist are skipped here, as they are most of the hits.
+	void _find_enterers_chunk(uint32_t p_chunk, uint32_t p_chunk_count) {
+		LocalVector<BVHHandle> &enterers = _pairing_chunks[p_chunk];
+		enterers.clear();
+
+		uint32_t from = uint64_t(changed_items.size()) * p_chunk / p_chunk_count;
+		uint32_t to = uint64_t(changed_items.size()) * (p_chunk + 1) / p_chunk_count;
+
+		for (uint32_t i = from; i < to; i++) {
+			const BVHHandle h = changed_items[i];
+			const uint32_t changed_item_ref_id = h.id();
+			const typename BVHTREE_CLASS::ItemExtra &exa = _get_extra(h);
+			const typename BVHTREE_CLASS::ItemPairs &pairs = tree._pairs[changed_item_ref_id];
+
+			BVHABB_CLASS abb;
+			abb.from(pairs.expanded_aabb);
+
+			auto hit_func = [&](uint32_t p_ref_id) {
+				// don't collide against ourself
+				if (p_ref_id == changed_item_ref_id) {
+					return;
+				}
+
+				BVHHandle h_collidee;
+				h_collidee.set_id(p_ref_id);
+
+				const typename BVHTREE_CLASS::ItemExtra &exb = _get_extra(h_collidee);
+				if ((exa.userdata == exb.userdata) && exa.userdata) {
+					return;
+				}
+				if (!USER_PAIR_TEST_FUNCTION::user_pair_check(exa.userdata, exb.userdata)) {
+					return;
+				}
+				if (pairs.contains_pair_to(h_collidee)) {
+					return;
+				}
+
+				enterers.push_back(h);
+				enterers.push_back(h_collidee);
+			};
+
+			tree.cull_aabb_ref_ids(abb, exa.userdata, exa.tree_collision_mask, hit_func);
+		}
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
@@ -772,6 +873,11 @@ private:
 	LocalVector<BVHHandle> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// Several chunks per thread, as the number of hits varies a lot between items.
+	static constexpr uint32_t PAIRING_CHUNKS_PER_THREAD = 4;
+	uint32_t _parallel_pairing_threshold = 0;
+	LocalVector<LocalVector<BVHHandle>> _pairing_chunks;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
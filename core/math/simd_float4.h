@@ -0,0 +1,230 @@
+/**************************************************************************/
+/*  simd_float4.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_FLOAT4_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SIMD_FLOAT4_NEON
+#include <arm_neon.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+
+// Four single precision floats processed together, used by code that works on
+// four independent elements at a time (structure of arrays). Maps to SSE2 or
+// NEON registers when available, and to plain arrays otherwise.
+// Comparisons return masks with all bits set in the lanes where they are true,
+// which can be combined with the `mask_*` functions and used by `select()`.
+// `mask_bits()` packs a mask into an integer, with bit i set when lane i is.
+struct SIMDFloat4 {
+	static constexpr int LANES = 4;
+
+#if defined(SIMD_FLOAT4_SSE2)
+	__m128 v;
+
+	_FORCE_INLINE_ SIMDFloat4() {}
+	_FORCE_INLINE_ SIMDFloat4(__m128 p_v) :
+			v(p_v) {}
+	_FORCE_INLINE_ explicit SIMDFloat4(float p_value) :
+			v(_mm_set1_ps(p_value)) {}
+
+	_FORCE_INLINE_ static SIMDFloat4 load(const float *p_ptr) { return _mm_loadu_ps(p_ptr); }
+	_FORCE_INLINE_ void store(float *p_ptr) const { _mm_storeu_ps(p_ptr, v); }
+
+	_FORCE_INLINE_ SIMDFloat4 operator+(const SIMDFloat4 &p_other) const { return _mm_add_ps(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator-(const SIMDFloat4 &p_other) const { return _mm_sub_ps(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator*(const SIMDFloat4 &p_other) const { return _mm_mul_ps(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator/(const SIMDFloat4 &p_other) const { return _mm_div_ps(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator-() const { return _mm_xor_ps(v, _mm_set1_ps(-0.0f)); }
+
+	_FORCE_INLINE_ static SIMDFloat4 min(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return _mm_min_ps(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static SIMDFloat4 max(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return _mm_max_ps(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static SIMDFloat4 sqrt(const SIMDFloat4 &p_a) { return _mm_sqrt_ps(p_a.v); }
+	_FORCE_INLINE_ static SIMDFloat4 abs(const SIMDFloat4 &p_a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), p_a.v); }
+
+	_FORCE_INLINE_ static SIMDFloat4 greater(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return _mm_cmpgt_ps(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static SIMDFloat4 mask_and(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return _mm_and_ps(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static SIMDFloat4 mask_or(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return _mm_or_ps(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static bool mask_any(const SIMDFloat4 &p_mask) { return _mm_movemask_ps(p_mask.v) != 0; }
+	_FORCE_INLINE_ static int mask_bits(const SIMDFloat4 &p_mask) { return _mm_movemask_ps(p_mask.v); }
+	// Returns p_a in the lanes where p_mask is set, and p_b in the other lanes.
+	_FORCE_INLINE_ static SIMDFloat4 select(const SIMDFloat4 &p_mask, const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return _mm_or_ps(_mm_and_ps(p_mask.v, p_a.v), _mm_andnot_ps(p_mask.v, p_b.v)); }
+
+#elif defined(SIMD_FLOAT4_NEON)
+	float32x4_t v;
+
+	_FORCE_INLINE_ SIMDFloat4() {}
+	_FORCE_INLINE_ SIMDFloat4(float32x4_t p_v) :
+			v(p_v) {}
+	_FORCE_INLINE_ explicit SIMDFloat4(float p_value) :
+			v(vdupq_n_f32(p_value)) {}
+
+	_FORCE_INLINE_ static SIMDFloat4 load(const float *p_ptr) { return vld1q_f32(p_ptr); }
+	_FORCE_INLINE_ void store(float *p_ptr) const { vst1q_f32(p_ptr, v); }
+
+	_FORCE_INLINE_ SIMDFloat4 operator+(const SIMDFloat4 &p_other) const { return vaddq_f32(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator-(const SIMDFloat4 &p_other) const { return vsubq_f32(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator*(const SIMDFloat4 &p_other) const { return vmulq_f32(v, p_other.v); }
+	_FORCE_INLINE_ SIMDFloat4 operator/(const SIMDFloat4 &p_other) const {
+#if defined(__aarch64__) || defined(_M_ARM64)
+		return vdivq_f32(v, p_other.v);
+#else
+		// Two Newton-Raphson steps refine the reciprocal estimate to full precision.
+		float32x4_t reciprocal = vrecpeq_f32(p_other.v);
+		reciprocal = vmulq_f32(vrecpsq_f32(p_other.v, reciprocal), reciprocal);
+		reciprocal = vmulq_f32(vrecpsq_f32(p_other.v, reciprocal), reciprocal);
+		return vmulq_f32(v, reciprocal);
+#endif
+	}
+	_FORCE_INLINE_ SIMDFloat4 operator-() const { return vnegq_f32(v); }
+
+	_FORCE_INLINE_ static SIMDFloat4 min(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return vminq_f32(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static SIMDFloat4 max(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return vmaxq_f32(p_a.v, p_b.v); }
+	_FORCE_INLINE_ static SIMDFloat4 sqrt(const SIMDFloat4 &p_a) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+		return vsqrtq_f32(p_a.v);
+#else
+		float lanes[4];
+		vst1q_f32(lanes, p_a.v);
+		for (int i = 0; i < 4; i++) {
+			lanes[i] = std::sqrt(lanes[i]);
+		}
+		return vld1q_f32(lanes);
+#endif
+	}
+	_FORCE_INLINE_ static SIMDFloat4 abs(const SIMDFloat4 &p_a) { return vabsq_f32(p_a.v); }
+
+	_FORCE_INLINE_ static SIMDFloat4 greater(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return vreinterpretq_f32_u32(vcgtq_f32(p_a.v, p_b.v)); }
+	_FORCE_INLINE_ static SIMDFloat4 mask_and(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(p_a.v), vreinterpretq_u32_f32(p_b.v))); }
+	_FORCE_INLINE_ static SIMDFloat4 mask_or(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(p_a.v), vreinterpretq_u32_f32(p_b.v))); }
+	_FORCE_INLINE_ static bool mask_any(const SIMDFloat4 &p_mask) {
+		uint32x4_t mask = vreinterpretq_u32_f32(p_mask.v);
+		uint32x2_t folded = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+		return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+	}
+	_FORCE_INLINE_ static int mask_bits(const SIMDFloat4 &p_mask) {
+		uint32x4_t mask = vshrq_n_u32(vreinterpretq_u32_f32(p_mask.v), 31);
+		return (int)(vgetq_lane_u32(mask, 0) | (vgetq_lane_u32(mask, 1) << 1) | (vgetq_lane_u32(mask, 2) << 2) | (vgetq_lane_u32(mask, 3) << 3));
+	}
+	// Returns p_a in the lanes where p_mask is set, and p_b in the other lanes.
+	_FORCE_INLINE_ static SIMDFloat4 select(const SIMDFloat4 &p_mask, const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { return vbslq_f32(vreinterpretq_u32_f32(p_mask.v), p_a.v, p_b.v); }
+
+#else
+	float v[4];
+
+	_FORCE_INLINE_ SIMDFloat4() {}
+	_FORCE_INLINE_ explicit SIMDFloat4(float p_value) {
+		for (int i = 0; i < 4; i++) {
+			v[i] = p_value;
+		}
+	}
+
+	_FORCE_INLINE_ static SIMDFloat4 load(const float *p_ptr) {
+		SIMDFloat4 r;
+		memcpy(r.v, p_ptr, sizeof(r.v));
+		return r;
+	}
+	_FORCE_INLINE_ void store(float *p_ptr) const { memcpy(p_ptr, v, sizeof(v)); }
+
+#define SIMD_FLOAT4_LANEWISE(m_expr) \
+	SIMDFloat4 r;                    \
+	for (int i = 0; i < 4; i++) {    \
+		r.v[i] = m_expr;             \
+	}                                \
+	return r;
+
+	_FORCE_INLINE_ SIMDFloat4 operator+(const SIMDFloat4 &p_other) const { SIMD_FLOAT4_LANEWISE(v[i] + p_other.v[i]) }
+	_FORCE_INLINE_ SIMDFloat4 operator-(const SIMDFloat4 &p_other) const { SIMD_FLOAT4_LANEWISE(v[i] - p_other.v[i]) }
+	_FORCE_INLINE_ SIMDFloat4 operator*(const SIMDFloat4 &p_other) const { SIMD_FLOAT4_LANEWISE(v[i] * p_other.v[i]) }
+	_FORCE_INLINE_ SIMDFloat4 operator/(const SIMDFloat4 &p_other) const { SIMD_FLOAT4_LANEWISE(v[i] / p_other.v[i]) }
+	_FORCE_INLINE_ SIMDFloat4 operator-() const { SIMD_FLOAT4_LANEWISE(-v[i]) }
+
+	_FORCE_INLINE_ static SIMDFloat4 min(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { SIMD_FLOAT4_LANEWISE(p_a.v[i] < p_b.v[i] ? p_a.v[i] : p_b.v[i]) }
+	_FORCE_INLINE_ static SIMDFloat4 max(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { SIMD_FLOAT4_LANEWISE(p_a.v[i] > p_b.v[i] ? p_a.v[i] : p_b.v[i]) }
+	_FORCE_INLINE_ static SIMDFloat4 sqrt(const SIMDFloat4 &p_a) { SIMD_FLOAT4_LANEWISE(std::sqrt(p_a.v[i])) }
+	_FORCE_INLINE_ static SIMDFloat4 abs(const SIMDFloat4 &p_a) { SIMD_FLOAT4_LANEWISE(std::fabs(p_a.v[i])) }
+
+	_FORCE_INLINE_ static SIMDFloat4 greater(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { SIMD_FLOAT4_LANEWISE(_from_bits(p_a.v[i] > p_b.v[i] ? 0xFFFFFFFF : 0)) }
+	_FORCE_INLINE_ static SIMDFloat4 mask_and(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { SIMD_FLOAT4_LANEWISE(_from_bits(_to_bits(p_a.v[i]) & _to_bits(p_b.v[i]))) }
+	_FORCE_INLINE_ static SIMDFloat4 mask_or(const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { SIMD_FLOAT4_LANEWISE(_from_bits(_to_bits(p_a.v[i]) | _to_bits(p_b.v[i]))) }
+	_FORCE_INLINE_ static bool mask_any(const SIMDFloat4 &p_mask) {
+		return (_to_bits(p_mask.v[0]) | _to_bits(p_mask.v[1]) | _to_bits(p_mask.v[2]) | _to_bits(p_mask.v[3])) != 0;
+	}
+	_FORCE_INLINE_ static int mask_bits(const SIMDFloat4 &p_mask) {
+		int bits = 0;
+		for (int i = 0; i < 4; i++) {
+			bits |= (_to_bits(p_mask.v[i]) >> 31) << i;
+		}
+		return bits;
+	}
+	// Returns p_a in the lanes where p_mask is set, and p_b in the other lanes.
+	_FORCE_INLINE_ static SIMDFloat4 select(const SIMDFloat4 &p_mask, const SIMDFloat4 &p_a, const SIMDFloat4 &p_b) { SIMD_FLOAT4_LANEWISE(_to_bits(p_mask.v[i]) ? p_a.v[i] : p_b.v[i]) }
+
+#undef SIMD_FLOAT4_LANEWISE
+
+private:
+	_FORCE_INLINE_ static uint32_t _to_bits(float p_value) {
+		uint32_t bits;
+		memcpy(&bits, &p_value, sizeof(bits));
+		return bits;
+	}
+	_FORCE_INLINE_ static float _from_bits(uint32_t p_bits) {
+		float value;
+		memcpy(&value, &p_bits, sizeof(value));
+		return value;
+	}
+
+public:
+#endif
+
+	_FORCE_INLINE_ SIMDFloat4 &operator+=(const SIMDFloat4 &p_other) {
+		*this = *this + p_other;
+		return *this;
+	}
+	_FORCE_INLINE_ SIMDFloat4 &operator-=(const SIMDFloat4 &p_other) {
+		*this = *this - p_other;
+		return *this;
+	}
+	_FORCE_INLINE_ SIMDFloat4 &operator*=(const SIMDFloat4 &p_other) {
+		*this = *this * p_other;
+		return *this;
+	}
+
+	_FORCE_INLINE_ static SIMDFloat4 zero() { return SIMDFloat4(0.0f); }
+	_FORCE_INLINE_ static SIMDFloat4 mask_none() { return SIMDFloat4(0.0f); }
+	// Returns a mask with the lanes set where p_values is not zero.
+	_FORCE_INLINE_ static SIMDFloat4 mask_from(const float *p_values) { return mask_or(greater(load(p_values), zero()), greater(zero(), load(p_values))); }
+};
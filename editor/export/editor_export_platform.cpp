@@ -383,7 +383,12 @@ Error EditorExportPlatform::_save_pack_patch_file(const Ref<EditorExportPreset>
 	Vector<uint8_t> patch_data = p_data;
 
 	if (delta) {
-		Error err = DeltaEncoding::encode_delta(old_data, p_data, patch_data, p_preset->get_patch_delta_zstd_level());
+		Error err;
+		if (old_data.size() > DeltaEncoding::CHUNKED_DELTA_THRESHOLD) {
+			err = DeltaEncoding::encode_chunked_delta(old_data, p_data, patch_data, p_preset->get_patch_delta_zstd_level());
+		} else {
+			err = DeltaEncoding::encode_delta(old_data, p_data, patch_data, p_preset->get_patch_delta_zstd_level());
+		}
 		if (err != OK) {
 			return err;
 		}
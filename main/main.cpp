@@ -862,6 +862,8 @@ void Main::test_cleanup() {
 		TextServerManager::get_singleton()->get_interface(i)->cleanup();
 	}
 
+	ResourceCache::clear_retained();
+
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 	PropertyListHelper::clear_base_helpers();
@@ -5071,6 +5073,7 @@ void Main::cleanup(bool p_force) {
 	}
 
 	ResourceLoader::clear_thread_load_tasks();
+	ResourceCache::clear_retained();
 
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
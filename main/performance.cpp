@@ -133,6 +133,9 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_3D_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_3D_OBSTACLE_COUNT);
 #endif // NAVIGATION_3D_DISABLED
+	BIND_ENUM_CONSTANT(OBJECT_RESOURCE_RETAINED_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_RESOURCE_RESIDENT);
+	BIND_ENUM_CONSTANT(MEMORY_RESOURCE_RETAINED);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 
 	BIND_ENUM_CONSTANT(MONITOR_TYPE_QUANTITY);
@@ -228,6 +231,9 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation_3d/edges_free"),
 		PNAME("navigation_3d/obstacles"),
 #endif // NAVIGATION_3D_DISABLED
+		PNAME("object/resources_retained"),
+		PNAME("memory/resources_resident"),
+		PNAME("memory/resources_retained"),
 	};
 	static_assert(std_size(names) == MONITOR_MAX);
 
@@ -256,6 +262,12 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return ObjectDB::get_object_count();
 		case OBJECT_RESOURCE_COUNT:
 			return ResourceCache::get_cached_resource_count();
+		case OBJECT_RESOURCE_RETAINED_COUNT:
+			return ResourceCache::get_retained_resource_count();
+		case MEMORY_RESOURCE_RESIDENT:
+			return ResourceCache::get_resident_memory_usage();
+		case MEMORY_RESOURCE_RETAINED:
+			return ResourceCache::get_retained_memory_usage();
 		case OBJECT_NODE_COUNT:
 			return _get_node_count();
 		case OBJECT_ORPHAN_NODE_COUNT:
@@ -525,7 +537,9 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 #endif // _3D_DISABLED
-
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 	};
 	static_assert((sizeof(types) / sizeof(MonitorType)) == MONITOR_MAX);
 
@@ -121,6 +121,9 @@ public:
 		NAVIGATION_3D_EDGE_FREE_COUNT,
 		NAVIGATION_3D_OBSTACLE_COUNT,
 #endif // _3D_DISABLED
+		OBJECT_RESOURCE_RETAINED_COUNT,
+		MEMORY_RESOURCE_RESIDENT,
+		MEMORY_RESOURCE_RETAINED,
 		MONITOR_MAX
 	};
 
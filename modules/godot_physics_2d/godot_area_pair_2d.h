@@ -45,6 +45,8 @@ class GodotAreaPair2D : public GodotConstraint2D {
 	bool body_has_attached_area = false;
 
 public:
+	virtual OrderKey get_order_key() const override { return _make_order_key(ORDER_TYPE_AREA_PAIR, area->get_self(), body->get_self(), area_shape, body_shape); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -66,6 +68,8 @@ class GodotArea2Pair2D : public GodotConstraint2D {
 	bool area_b_monitorable;
 
 public:
+	virtual OrderKey get_order_key() const override { return _make_order_key(ORDER_TYPE_AREA_2_PAIR, area_a->get_self(), area_b->get_self(), shape_a, shape_b); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
@@ -149,6 +149,46 @@ void GodotBody2D::set_active(bool p_active) {
 	}
 }
 
+void GodotBody2D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.transform = get_transform();
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.constant_force = constant_force;
+	r_snapshot.constant_torque = constant_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody2D::restore_snapshot(const Snapshot &p_snapshot) {
+	if (mode == PhysicsServer2D::BODY_MODE_STATIC) {
+		return;
+	}
+
+	_set_transform(p_snapshot.transform);
+	_set_inv_transform(get_transform().affine_inverse());
+	if (mode == PhysicsServer2D::BODY_MODE_KINEMATIC) {
+		new_transform = p_snapshot.transform;
+	} else {
+		_update_transform_dependent();
+	}
+
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	applied_force = p_snapshot.applied_force;
+	applied_torque = p_snapshot.applied_torque;
+	constant_force = p_snapshot.constant_force;
+	constant_torque = p_snapshot.constant_torque;
+	still_time = p_snapshot.still_time;
+	set_active(p_snapshot.active);
+
+	// Report the restored state on the next flush of the queries, even if the body is asleep.
+	if (get_space() && (fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+}
+
 void GodotBody2D::set_param(PhysicsServer2D::BodyParameter p_param, const Variant &p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::BODY_PARAM_BOUNCE: {
@@ -247,6 +247,70 @@ real_t combine_friction(GodotBody2D *A, GodotBody2D *B) {
 	return Math::abs(MIN(A->get_friction(), B->get_friction()));
 }
 
+void GodotBodyPair2D::get_snapshot_header(SnapshotHeader &r_header) const {
+	memset(&r_header, 0, sizeof(SnapshotHeader));
+	r_header.body_A = A->get_self();
+	r_header.body_B = B->get_self();
+	r_header.shape_A = shape_A;
+	r_header.shape_B = shape_B;
+	r_header.sep_axis = sep_axis;
+	r_header.contact_count = contact_count;
+	r_header.oneway_disabled = oneway_disabled;
+}
+
+uint8_t *GodotBodyPair2D::save_snapshot(uint8_t *p_data) const {
+	SnapshotHeader header;
+	get_snapshot_header(header);
+	memcpy(p_data, &header, sizeof(SnapshotHeader));
+
+	// The contacts are copied field by field, their padding is not initialized.
+	uint8_t *w = p_data + sizeof(SnapshotHeader);
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		Contact contact;
+		memset(&contact, 0, sizeof(Contact));
+		contact.position = c.position;
+		contact.normal = c.normal;
+		contact.local_A = c.local_A;
+		contact.local_B = c.local_B;
+		contact.acc_impulse = c.acc_impulse;
+		contact.acc_normal_impulse = c.acc_normal_impulse;
+		contact.acc_tangent_impulse = c.acc_tangent_impulse;
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		contact.mass_normal = c.mass_normal;
+		contact.mass_tangent = c.mass_tangent;
+		contact.bias = c.bias;
+		contact.depth = c.depth;
+		contact.active = c.active;
+		contact.used = c.used;
+		contact.rA = c.rA;
+		contact.rB = c.rB;
+		contact.bounce = c.bounce;
+		memcpy(w, &contact, sizeof(Contact));
+		w += sizeof(Contact);
+	}
+	return p_data + get_snapshot_size(contact_count);
+}
+
+void GodotBodyPair2D::restore_snapshot(const uint8_t *p_data) {
+	if (!p_data) {
+		sep_axis = Vector2();
+		contact_count = 0;
+		collided = false;
+		oneway_disabled = false;
+		return;
+	}
+
+	SnapshotHeader header;
+	memcpy(&header, p_data, sizeof(SnapshotHeader));
+	sep_axis = header.sep_axis;
+	contact_count = header.contact_count;
+	oneway_disabled = header.oneway_disabled;
+	memcpy(contacts, p_data + sizeof(SnapshotHeader), contact_count * sizeof(Contact));
+	collided = contact_count > 0;
+}
+
 bool GodotBodyPair2D::setup(real_t p_step) {
 	check_ccd = false;
 
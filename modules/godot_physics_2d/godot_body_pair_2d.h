@@ -88,7 +88,34 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
+	friend class GodotContactSolver2D;
+
 public:
+	// Contacts kept between steps for warm starting, saved by GodotSpace2D::save_state().
+	// The header is followed by contact_count contacts.
+	struct SnapshotHeader {
+		RID body_A;
+		RID body_B;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		Vector2 sep_axis;
+		int32_t contact_count = 0;
+		bool oneway_disabled = false;
+	};
+
+	static constexpr int get_max_snapshot_contacts() { return MAX_CONTACTS; }
+	static constexpr size_t get_snapshot_size(int p_contact_count) { return sizeof(SnapshotHeader) + p_contact_count * sizeof(Contact); }
+
+	// Also zeroes the padding of the header, so equal states are saved as equal bytes.
+	void get_snapshot_header(SnapshotHeader &r_header) const;
+	// Returns the end of the written data.
+	uint8_t *save_snapshot(uint8_t *p_data) const;
+	// Passing nullptr clears the contacts, for pairs that didn't exist when the state was saved.
+	void restore_snapshot(const uint8_t *p_data);
+
+	virtual GodotBodyPair2D *get_body_pair() override { return this; }
+	virtual OrderKey get_order_key() const override { return _make_order_key(ORDER_TYPE_BODY_PAIR, A->get_self(), B->get_self(), shape_A, shape_B); }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
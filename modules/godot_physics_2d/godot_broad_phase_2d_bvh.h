@@ -66,6 +66,9 @@ class GodotBroadPhase2DBVH : public GodotBroadPhase2D {
 
 	BVH_Manager<GodotCollisionObject2D, 2, true, 128, UserPairTestFunction<GodotCollisionObject2D>, UserCullTestFunction<GodotCollisionObject2D>, Rect2, Vector2> bvh;
 
+	// Number of moved shapes from which new pairs are searched for on the worker threads.
+	static constexpr uint32_t PARALLEL_PAIRING_THRESHOLD = 256;
+
 	static void *_pair_callback(void *, uint32_t, GodotCollisionObject2D *, int, uint32_t, GodotCollisionObject2D *, int);
 	static void _unpair_callback(void *, uint32_t, GodotCollisionObject2D *, int, uint32_t, GodotCollisionObject2D *, int, void *);
 
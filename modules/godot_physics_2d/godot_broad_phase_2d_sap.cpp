@@ -0,0 +1,331 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_sap.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_broad_phase_2d_sap.h"
+#include "godot_collision_object_2d.h"
+
+bool GodotBroadPhase2DSAP::_is_element_valid(ID p_id) const {
+	return p_id > 0 && p_id <= elements.size() && elements[p_id - 1].owner;
+}
+
+bool GodotBroadPhase2DSAP::_can_pair(const Element &p_a, const Element &p_b) const {
+	if (p_a.owner == p_b.owner) {
+		return false;
+	}
+	if (p_a.is_static && p_b.is_static) {
+		return false;
+	}
+	return p_a.owner->interacts_with(p_b.owner);
+}
+
+void GodotBroadPhase2DSAP::_add_pair(ID p_a, ID p_b) {
+	Element &a = _get_element(p_a);
+	Element &b = _get_element(p_b);
+
+	Pair pair;
+	pair.pass = pass;
+	if (pair_callback) {
+		pair.data = pair_callback(a.owner, a.subindex, b.owner, b.subindex, pair_userdata);
+	}
+	pairs.insert(_get_pair_key(p_a, p_b), pair);
+
+	a.pairs.push_back(p_b);
+	b.pairs.push_back(p_a);
+}
+
+void GodotBroadPhase2DSAP::_remove_pair(ID p_a, ID p_b) {
+	uint64_t key = _get_pair_key(p_a, p_b);
+	Pair *pair = pairs.getptr(key);
+	ERR_FAIL_NULL(pair);
+	void *data = pair->data;
+	pairs.erase(key);
+
+	Element &a = _get_element(p_a);
+	Element &b = _get_element(p_b);
+	a.pairs.erase_unordered(p_b);
+	b.pairs.erase_unordered(p_a);
+
+	if (unpair_callback) {
+		unpair_callback(a.owner, a.subindex, b.owner, b.subindex, data, unpair_userdata);
+	}
+}
+
+void GodotBroadPhase2DSAP::_sort() {
+	if (!sorted_dirty) {
+		return;
+	}
+	sorted_dirty = false;
+
+	// Drop the removed elements and refresh the keys.
+	uint32_t count = 0;
+	max_width = 0.0;
+	for (uint32_t i = 0; i < sorted.size(); i++) {
+		const Element &element = _get_element(sorted[i].id);
+		if (!element.owner) {
+			continue;
+		}
+		sorted[count].x = element.pairing_aabb.position.x;
+		sorted[count].id = sorted[i].id;
+		max_width = MAX(max_width, element.pairing_aabb.size.x);
+		count++;
+	}
+	sorted.resize(count);
+
+	for (ID id : removed_ids) {
+		free_ids.push_back(id);
+	}
+	removed_ids.clear();
+
+	// Insertion sort, which is close to linear when the order barely changed.
+	// Fall back to a full sort when too much moved, like after adding many
+	// elements at once.
+	SortItem *items = sorted.ptr();
+	uint64_t moves = 0;
+	const uint64_t max_moves = uint64_t(count) * 8;
+	for (uint32_t i = 1; i < count; i++) {
+		SortItem item = items[i];
+		uint32_t j = i;
+		while (j > 0 && item < items[j - 1]) {
+			items[j] = items[j - 1];
+			j--;
+		}
+		items[j] = item;
+
+		moves += i - j;
+		if (moves > max_moves) {
+			sorted.sort();
+			break;
+		}
+	}
+}
+
+uint32_t GodotBroadPhase2DSAP::_find_first_sorted(real_t p_left) const {
+	// Nothing that starts left of this can reach p_left.
+	const real_t from = p_left - max_width;
+
+	uint32_t low = 0;
+	uint32_t high = sorted.size();
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		if (sorted[middle].x < from) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+GodotBroadPhase2D::ID GodotBroadPhase2DSAP::create(GodotCollisionObject2D *p_object, int p_subindex, const Rect2 &p_aabb, bool p_static) {
+	ERR_FAIL_NULL_V(p_object, 0);
+	MutexLock lock(mutex);
+
+	ID id;
+	if (free_ids.size()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		elements.push_back(Element());
+		id = elements.size();
+	}
+
+	Element &element = _get_element(id);
+	element.owner = p_object;
+	element.aabb = p_aabb;
+	element.pairing_aabb = p_aabb.grow(PAIRING_MARGIN);
+	element.subindex = p_subindex;
+	element.is_static = p_static;
+
+	SortItem item;
+	item.id = id;
+	sorted.push_back(item);
+	sorted_dirty = true;
+
+	// The pairs are found in the next update.
+	return id;
+}
+
+void GodotBroadPhase2DSAP::move(ID p_id, const Rect2 &p_aabb) {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND(!_is_element_valid(p_id));
+	Element &element = _get_element(p_id);
+	element.aabb = p_aabb;
+
+	// Keep the pairing AABB while it still holds the shape and isn't much larger than needed.
+	const Vector2 excess = element.pairing_aabb.size - p_aabb.size;
+	if (element.pairing_aabb.encloses(p_aabb) && excess.x + excess.y < PAIRING_SHRINK_THRESHOLD) {
+		return;
+	}
+	element.pairing_aabb = p_aabb.grow(PAIRING_MARGIN);
+	sorted_dirty = true;
+}
+
+void GodotBroadPhase2DSAP::set_static(ID p_id, bool p_static) {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND(!_is_element_valid(p_id));
+	// Pairs between static elements are removed in the next update.
+	_get_element(p_id).is_static = p_static;
+}
+
+void GodotBroadPhase2DSAP::remove(ID p_id) {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND(!_is_element_valid(p_id));
+	Element &element = _get_element(p_id);
+
+	// The owner may be freed after this, so unpair now.
+	while (element.pairs.size()) {
+		_remove_pair(p_id, element.pairs[element.pairs.size() - 1]);
+	}
+
+	element.owner = nullptr;
+	removed_ids.push_back(p_id);
+	sorted_dirty = true;
+}
+
+GodotCollisionObject2D *GodotBroadPhase2DSAP::get_object(ID p_id) const {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND_V(!_is_element_valid(p_id), nullptr);
+	return _get_element(p_id).owner;
+}
+
+bool GodotBroadPhase2DSAP::is_static(ID p_id) const {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND_V(!_is_element_valid(p_id), false);
+	return _get_element(p_id).is_static;
+}
+
+int GodotBroadPhase2DSAP::get_subindex(ID p_id) const {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND_V(!_is_element_valid(p_id), 0);
+	return _get_element(p_id).subindex;
+}
+
+int GodotBroadPhase2DSAP::cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	MutexLock lock(mutex);
+	_sort();
+
+	Rect2 bounds(p_from, Vector2());
+	bounds.expand_to(p_to);
+	const real_t right = bounds.position.x + bounds.size.x;
+
+	int count = 0;
+	for (uint32_t i = _find_first_sorted(bounds.position.x); i < sorted.size() && sorted[i].x <= right && count < p_max_results; i++) {
+		const Element &element = _get_element(sorted[i].id);
+		if (!element.aabb.intersects(bounds, true) || !element.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		p_results[count] = element.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = element.subindex;
+		}
+		count++;
+	}
+	return count;
+}
+
+int GodotBroadPhase2DSAP::cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices) {
+	MutexLock lock(mutex);
+	_sort();
+
+	const real_t right = p_aabb.position.x + p_aabb.size.x;
+
+	int count = 0;
+	for (uint32_t i = _find_first_sorted(p_aabb.position.x); i < sorted.size() && sorted[i].x <= right && count < p_max_results; i++) {
+		const Element &element = _get_element(sorted[i].id);
+		if (!element.aabb.intersects(p_aabb, true)) {
+			continue;
+		}
+
+		p_results[count] = element.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = element.subindex;
+		}
+		count++;
+	}
+	return count;
+}
+
+void GodotBroadPhase2DSAP::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DSAP::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void GodotBroadPhase2DSAP::update() {
+	MutexLock lock(mutex);
+	_sort();
+	pass++;
+
+	// Sweep along X. Everything starting before the right edge of an element
+	// overlaps it on X, so only Y is left to test.
+	for (uint32_t i = 0; i < sorted.size(); i++) {
+		const ID id_a = sorted[i].id;
+		const Element &a = _get_element(id_a);
+		const real_t right = a.pairing_aabb.position.x + a.pairing_aabb.size.x;
+
+		for (uint32_t j = i + 1; j < sorted.size() && sorted[j].x <= right; j++) {
+			const ID id_b = sorted[j].id;
+			const Element &b = _get_element(id_b);
+			if (a.pairing_aabb.position.y > b.pairing_aabb.position.y + b.pairing_aabb.size.y || b.pairing_aabb.position.y > a.pairing_aabb.position.y + a.pairing_aabb.size.y) {
+				continue;
+			}
+			if (!_can_pair(a, b)) {
+				continue;
+			}
+
+			Pair *pair = pairs.getptr(_get_pair_key(id_a, id_b));
+			if (pair) {
+				pair->pass = pass;
+			} else {
+				_add_pair(id_a, id_b);
+			}
+		}
+	}
+
+	// Pairs which were not found again have separated.
+	for (const KeyValue<uint64_t, Pair> &E : pairs) {
+		if (E.value.pass != pass) {
+			removed_pairs.push_back(E.key);
+		}
+	}
+	for (uint64_t key : removed_pairs) {
+		_remove_pair(ID(key >> 32), ID(key & 0xFFFFFFFF));
+	}
+	removed_pairs.clear();
+}
+
+GodotBroadPhase2D *GodotBroadPhase2DSAP::_create() {
+	return memnew(GodotBroadPhase2DSAP);
+}
@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*  godot_broad_phase_2d_sap.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "godot_broad_phase_2d.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Sweep and prune broadphase. The shapes are kept sorted by the left edge of
+// their AABB, and pairs are found by sweeping along the X axis. Since the order
+// changes little between steps, resorting it is close to linear. This works
+// best for worlds which are much wider than they are high, such as side
+// scrollers, where the BVH is mostly traversed for nothing.
+class GodotBroadPhase2DSAP : public GodotBroadPhase2D {
+	// Pairs are found with AABBs grown by this margin, which are only updated
+	// once the shapes leave them, like the pairing expansion of the BVH. This
+	// keeps pairs from being removed and created again on every small movement.
+	static constexpr real_t PAIRING_MARGIN = 0.1;
+	// Grown AABBs are also updated once they are this much larger than needed.
+	static constexpr real_t PAIRING_SHRINK_THRESHOLD = PAIRING_MARGIN * 2.0 * 2.0 * 1.1;
+
+	struct Element {
+		GodotCollisionObject2D *owner = nullptr; // nullptr once removed.
+		Rect2 aabb;
+		Rect2 pairing_aabb; // aabb grown by PAIRING_MARGIN.
+		int subindex = 0;
+		bool is_static = false;
+		LocalVector<ID> pairs;
+	};
+
+	struct Pair {
+		void *data = nullptr;
+		uint64_t pass = 0;
+	};
+
+	struct SortItem {
+		real_t x = 0.0;
+		ID id = 0;
+
+		_FORCE_INLINE_ bool operator<(const SortItem &p_other) const {
+			return x == p_other.x ? id < p_other.id : x < p_other.x;
+		}
+	};
+
+	LocalVector<Element> elements; // Indexed by ID - 1.
+	LocalVector<ID> free_ids;
+	// Removed elements stay in the sorted list until the next sort, and
+	// their IDs can only be reused after that.
+	LocalVector<ID> removed_ids;
+	LocalVector<SortItem> sorted; // Sorted by the left edge of the pairing AABB.
+	HashMap<uint64_t, Pair> pairs;
+	LocalVector<uint64_t> removed_pairs;
+
+	bool sorted_dirty = false;
+	// Widest pairing AABB, used to find where queries start in the sorted list.
+	real_t max_width = 0.0;
+	uint64_t pass = 0;
+
+	// Locks everything, like the thread safe BVH.
+	Mutex mutex;
+
+	PairCallback pair_callback = nullptr;
+	void *pair_userdata = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *unpair_userdata = nullptr;
+
+	_FORCE_INLINE_ static uint64_t _get_pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? (uint64_t(p_a) << 32 | p_b) : (uint64_t(p_b) << 32 | p_a);
+	}
+
+	_FORCE_INLINE_ Element &_get_element(ID p_id) { return elements[p_id - 1]; }
+	_FORCE_INLINE_ const Element &_get_element(ID p_id) const { return elements[p_id - 1]; }
+
+	bool _is_element_valid(ID p_id) const;
+	bool _can_pair(const Element &p_a, const Element &p_b) const;
+	void _add_pair(ID p_a, ID p_b);
+	void _remove_pair(ID p_a, ID p_b);
+	void _sort();
+	uint32_t _find_first_sorted(real_t p_left) const;
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(GodotCollisionObject2D *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false) override;
+	virtual void move(ID p_id, const Rect2 &p_aabb) override;
+	virtual void set_static(ID p_id, bool p_static) override;
+	virtual void remove(ID p_id) override;
+
+	virtual GodotCollisionObject2D *get_object(ID p_id) const override;
+	virtual bool is_static(ID p_id) const override;
+	virtual int get_subindex(ID p_id) const override;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+	virtual int cull_aabb(const Rect2 &p_aabb, GodotCollisionObject2D **p_results, int p_max_results, int *p_result_indices = nullptr) override;
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
+
+	virtual void update() override;
+
+	static GodotBroadPhase2D *_create();
+};
@@ -32,6 +32,8 @@
 
 #include "godot_body_2d.h"
 
+class GodotBodyPair2D;
+
 class GodotConstraint2D {
 	GodotBody2D **_body_ptr;
 	int _body_count;
@@ -40,7 +42,33 @@ class GodotConstraint2D {
 
 	RID self;
 
+public:
+	// Orders constraints by the objects they link rather than by memory address or
+	// creation time, so that deterministic spaces solve them in the same order on every run.
+	struct OrderKey {
+		uint64_t objects = 0;
+		uint64_t shapes = 0;
+
+		_FORCE_INLINE_ bool operator<(const OrderKey &p_other) const {
+			return objects != p_other.objects ? objects < p_other.objects : shapes < p_other.shapes;
+		}
+	};
+
 protected:
+	enum OrderType {
+		ORDER_TYPE_JOINT,
+		ORDER_TYPE_BODY_PAIR,
+		ORDER_TYPE_AREA_PAIR,
+		ORDER_TYPE_AREA_2_PAIR,
+	};
+
+	_FORCE_INLINE_ static OrderKey _make_order_key(OrderType p_type, const RID &p_object_A, const RID &p_object_B, int p_shape_A = 0, int p_shape_B = 0) {
+		OrderKey key;
+		key.objects = (uint64_t(p_object_A.get_local_index()) << 32) | p_object_B.get_local_index();
+		key.shapes = (uint64_t(p_type) << 62) | (uint64_t(p_shape_A & 0x7FFFFFFF) << 31) | uint64_t(p_shape_B & 0x7FFFFFFF);
+		return key;
+	}
+
 	GodotConstraint2D(GodotBody2D **p_body_ptr = nullptr, int p_body_count = 0) {
 		_body_ptr = p_body_ptr;
 		_body_count = p_body_count;
@@ -56,9 +84,14 @@ public:
 	_FORCE_INLINE_ GodotBody2D **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
+	// Returns this constraint as a body pair, so its contacts can be batched by GodotContactSolver2D.
+	virtual GodotBodyPair2D *get_body_pair() { return nullptr; }
+
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	virtual OrderKey get_order_key() const { return _make_order_key(ORDER_TYPE_JOINT, self, RID()); }
+
 	virtual bool setup(real_t p_step) = 0;
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
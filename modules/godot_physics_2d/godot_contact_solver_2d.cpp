@@ -0,0 +1,341 @@
+/**************************************************************************/
+/*  godot_contact_solver_2d.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_contact_solver_2d.h"
+
+#define MIN_VELOCITY 0.001
+#define MAX_BIAS_ROTATION (Math::PI / 8)
+// Number of the most recent batches searched for a free lane before starting a new batch.
+#define BATCH_SEARCH_WINDOW 8
+
+namespace {
+
+struct Vector2x4 {
+	SIMDFloat4 x, y;
+
+	_FORCE_INLINE_ static Vector2x4 load(const float p_values[2][SIMDFloat4::LANES]) {
+		return { SIMDFloat4::load(p_values[0]), SIMDFloat4::load(p_values[1]) };
+	}
+
+	_FORCE_INLINE_ void store(float r_values[2][SIMDFloat4::LANES]) const {
+		x.store(r_values[0]);
+		y.store(r_values[1]);
+	}
+
+	_FORCE_INLINE_ Vector2x4 operator+(const Vector2x4 &p_other) const { return { x + p_other.x, y + p_other.y }; }
+	_FORCE_INLINE_ Vector2x4 operator-(const Vector2x4 &p_other) const { return { x - p_other.x, y - p_other.y }; }
+	_FORCE_INLINE_ Vector2x4 operator*(const SIMDFloat4 &p_scalar) const { return { x * p_scalar, y * p_scalar }; }
+
+	_FORCE_INLINE_ SIMDFloat4 dot(const Vector2x4 &p_other) const { return x * p_other.x + y * p_other.y; }
+	_FORCE_INLINE_ SIMDFloat4 cross(const Vector2x4 &p_other) const { return x * p_other.y - y * p_other.x; }
+	_FORCE_INLINE_ Vector2x4 orthogonal() const { return { y, -x }; }
+
+	// Velocity of a point at this offset from the center of a body rotating at p_angular_velocity.
+	_FORCE_INLINE_ Vector2x4 rotated_velocity(const SIMDFloat4 &p_angular_velocity) const { return { -p_angular_velocity * y, p_angular_velocity * x }; }
+};
+
+struct BodyVelocities {
+	float linear[2][SIMDFloat4::LANES];
+	float angular[SIMDFloat4::LANES];
+	float biased_linear[2][SIMDFloat4::LANES];
+	float biased_angular[SIMDFloat4::LANES];
+};
+
+_FORCE_INLINE_ void gather_vector(float r_values[2][SIMDFloat4::LANES], int p_lane, const Vector2 &p_vector) {
+	r_values[0][p_lane] = p_vector.x;
+	r_values[1][p_lane] = p_vector.y;
+}
+
+_FORCE_INLINE_ Vector2 scatter_vector(const float p_values[2][SIMDFloat4::LANES], int p_lane) {
+	return Vector2(p_values[0][p_lane], p_values[1][p_lane]);
+}
+
+} // namespace
+
+bool GodotContactSolver2D::_writes_body(const GodotBody2D *p_body) {
+	// Static and kinematic bodies are only read by the solver, so lanes can share them.
+	return p_body->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC;
+}
+
+bool GodotContactSolver2D::_can_add_to_batch(const Batch &p_batch, const GodotBodyPair2D *p_pair) const {
+	if (p_batch.lane_count == LANES) {
+		return false;
+	}
+
+	for (int lane = 0; lane < p_batch.lane_count; lane++) {
+		const GodotBodyPair2D *other = p_batch.pairs[lane];
+		for (int i = 0; i < 2; i++) {
+			const GodotBody2D *body = p_pair->_arr[i];
+			if (_writes_body(body) && (body == other->A || body == other->B)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void GodotContactSolver2D::_add_to_batch(Batch &p_batch, GodotBodyPair2D *p_pair) {
+	const int lane = p_batch.lane_count++;
+	p_batch.pairs[lane] = p_pair;
+	p_batch.row_count = MAX(p_batch.row_count, p_pair->contact_count);
+
+	const GodotBody2D *A = p_pair->A;
+	const GodotBody2D *B = p_pair->B;
+
+	// Bodies that don't collide get no impulses, which is the same as having infinite mass.
+	p_batch.inv_mass_A[lane] = p_pair->collide_A ? A->get_inv_mass() : 0.0;
+	p_batch.inv_mass_B[lane] = p_pair->collide_B ? B->get_inv_mass() : 0.0;
+	p_batch.inv_inertia_A[lane] = p_pair->collide_A ? A->get_inv_inertia() : 0.0;
+	p_batch.inv_inertia_B[lane] = p_pair->collide_B ? B->get_inv_inertia() : 0.0;
+	p_batch.friction[lane] = Math::abs(MIN(A->get_friction(), B->get_friction()));
+
+	for (int i = 0; i < p_pair->contact_count; i++) {
+		const GodotBodyPair2D::Contact &c = p_pair->contacts[i];
+		ContactRow &row = p_batch.rows[i];
+
+		gather_vector(row.rA, lane, c.rA);
+		gather_vector(row.rB, lane, c.rB);
+		gather_vector(row.normal, lane, c.normal);
+		row.bias[lane] = c.bias;
+		row.bounce[lane] = c.bounce;
+		row.mass_normal[lane] = c.mass_normal;
+		row.mass_tangent[lane] = c.mass_tangent;
+		row.acc_bias_impulse[lane] = c.acc_bias_impulse;
+		row.acc_bias_impulse_center_of_mass[lane] = c.acc_bias_impulse_center_of_mass;
+		row.acc_normal_impulse[lane] = c.acc_normal_impulse;
+		row.acc_tangent_impulse[lane] = c.acc_tangent_impulse;
+		gather_vector(row.acc_impulse, lane, c.acc_impulse);
+		row.active[lane] = c.active ? 1.0 : 0.0;
+	}
+}
+
+bool GodotContactSolver2D::setup(LocalVector<GodotConstraint2D *> &p_constraints, real_t p_step) {
+	step = p_step;
+	batch_count = 0;
+
+	uint32_t constraint_count = 0;
+	for (GodotConstraint2D *constraint : p_constraints) {
+		GodotBodyPair2D *pair = constraint->get_body_pair();
+		if (!pair || !pair->collided || pair->oneway_disabled) {
+			// Keep it to be solved on its own.
+			p_constraints[constraint_count++] = constraint;
+			continue;
+		}
+
+		// Look for a free lane in the last batches, so that setup stays linear.
+		Batch *batch = nullptr;
+		for (uint32_t batch_index = batch_count > BATCH_SEARCH_WINDOW ? batch_count - BATCH_SEARCH_WINDOW : 0; batch_index < batch_count; batch_index++) {
+			if (_can_add_to_batch(batches[batch_index], pair)) {
+				batch = &batches[batch_index];
+				break;
+			}
+		}
+
+		if (!batch) {
+			if (batch_count == batches.size()) {
+				batches.resize(batch_count + 1);
+			}
+			batch = &batches[batch_count++];
+			// Unused lanes stay zeroed, which makes them inactive.
+			*batch = Batch();
+		}
+
+		_add_to_batch(*batch, pair);
+	}
+	p_constraints.resize(constraint_count);
+
+	return batch_count > 0;
+}
+
+void GodotContactSolver2D::solve_batch(uint32_t p_batch_index) {
+	Batch &batch = batches[p_batch_index];
+
+	BodyVelocities velocities_A = {};
+	BodyVelocities velocities_B = {};
+	for (int lane = 0; lane < batch.lane_count; lane++) {
+		const GodotBodyPair2D *pair = batch.pairs[lane];
+		gather_vector(velocities_A.linear, lane, pair->A->get_linear_velocity());
+		velocities_A.angular[lane] = pair->A->get_angular_velocity();
+		gather_vector(velocities_A.biased_linear, lane, pair->A->get_biased_linear_velocity());
+		velocities_A.biased_angular[lane] = pair->A->get_biased_angular_velocity();
+		gather_vector(velocities_B.linear, lane, pair->B->get_linear_velocity());
+		velocities_B.angular[lane] = pair->B->get_angular_velocity();
+		gather_vector(velocities_B.biased_linear, lane, pair->B->get_biased_linear_velocity());
+		velocities_B.biased_angular[lane] = pair->B->get_biased_angular_velocity();
+	}
+
+	Vector2x4 lvA = Vector2x4::load(velocities_A.linear);
+	SIMDFloat4 avA = SIMDFloat4::load(velocities_A.angular);
+	Vector2x4 blvA = Vector2x4::load(velocities_A.biased_linear);
+	SIMDFloat4 bavA = SIMDFloat4::load(velocities_A.biased_angular);
+	Vector2x4 lvB = Vector2x4::load(velocities_B.linear);
+	SIMDFloat4 avB = SIMDFloat4::load(velocities_B.angular);
+	Vector2x4 blvB = Vector2x4::load(velocities_B.biased_linear);
+	SIMDFloat4 bavB = SIMDFloat4::load(velocities_B.biased_angular);
+
+	const SIMDFloat4 inv_mass_A = SIMDFloat4::load(batch.inv_mass_A);
+	const SIMDFloat4 inv_mass_B = SIMDFloat4::load(batch.inv_mass_B);
+	const SIMDFloat4 inv_inertia_A = SIMDFloat4::load(batch.inv_inertia_A);
+	const SIMDFloat4 inv_inertia_B = SIMDFloat4::load(batch.inv_inertia_B);
+	const SIMDFloat4 friction = SIMDFloat4::load(batch.friction);
+
+	const SIMDFloat4 zero = SIMDFloat4::zero();
+	const SIMDFloat4 min_velocity(MIN_VELOCITY);
+	const SIMDFloat4 max_bias_av(MAX_BIAS_ROTATION / step);
+
+	// Same as GodotBodyPair2D::solve(), with inactive contacts masked out.
+	for (int i = 0; i < batch.row_count; i++) {
+		ContactRow &row = batch.rows[i];
+
+		const SIMDFloat4 active = SIMDFloat4::mask_from(row.active);
+		if (!SIMDFloat4::mask_any(active)) {
+			continue;
+		}
+
+		const Vector2x4 rA = Vector2x4::load(row.rA);
+		const Vector2x4 rB = Vector2x4::load(row.rB);
+		const Vector2x4 normal = Vector2x4::load(row.normal);
+		const SIMDFloat4 bias = SIMDFloat4::load(row.bias);
+		const SIMDFloat4 mass_normal = SIMDFloat4::load(row.mass_normal);
+
+		// Relative velocity at contact.
+
+		const Vector2x4 dv = lvB + rB.rotated_velocity(avB) - lvA - rA.rotated_velocity(avA);
+		Vector2x4 dbv = blvB + rB.rotated_velocity(bavB) - blvA - rA.rotated_velocity(bavA);
+
+		const SIMDFloat4 vn = dv.dot(normal);
+		SIMDFloat4 vbn = dbv.dot(normal);
+
+		const Vector2x4 tangent = normal.orthogonal();
+		const SIMDFloat4 vt = dv.dot(tangent);
+
+		const SIMDFloat4 jbn = (bias - vbn) * mass_normal;
+		const SIMDFloat4 jbn_old = SIMDFloat4::load(row.acc_bias_impulse);
+		const SIMDFloat4 acc_bias_impulse = SIMDFloat4::select(active, SIMDFloat4::max(jbn_old + jbn, zero), jbn_old);
+		acc_bias_impulse.store(row.acc_bias_impulse);
+
+		const Vector2x4 jb = normal * (acc_bias_impulse - jbn_old);
+
+		// Angular bias velocity changes are limited by max_bias_av.
+		blvA = blvA - jb * inv_mass_A;
+		bavA = bavA + SIMDFloat4::min(inv_inertia_A * -rA.cross(jb), max_bias_av);
+		blvB = blvB + jb * inv_mass_B;
+		bavB = bavB + SIMDFloat4::min(inv_inertia_B * rB.cross(jb), max_bias_av);
+
+		dbv = blvB + rB.rotated_velocity(bavB) - blvA - rA.rotated_velocity(bavA);
+		vbn = dbv.dot(normal);
+
+		const SIMDFloat4 bias_com_active = SIMDFloat4::mask_and(active, SIMDFloat4::greater(SIMDFloat4::abs(bias - vbn), min_velocity));
+		if (SIMDFloat4::mask_any(bias_com_active)) {
+			const SIMDFloat4 jbn_com = (bias - vbn) / (inv_mass_A + inv_mass_B);
+			const SIMDFloat4 jbn_old_com = SIMDFloat4::load(row.acc_bias_impulse_center_of_mass);
+			const SIMDFloat4 acc_bias_impulse_com = SIMDFloat4::select(bias_com_active, SIMDFloat4::max(jbn_old_com + jbn_com, zero), jbn_old_com);
+			acc_bias_impulse_com.store(row.acc_bias_impulse_center_of_mass);
+
+			const Vector2x4 jb_com = normal * (acc_bias_impulse_com - jbn_old_com);
+
+			blvA = blvA - jb_com * inv_mass_A;
+			blvB = blvB + jb_com * inv_mass_B;
+		}
+
+		const SIMDFloat4 jn = -(SIMDFloat4::load(row.bounce) + vn) * mass_normal;
+		const SIMDFloat4 jn_old = SIMDFloat4::load(row.acc_normal_impulse);
+		const SIMDFloat4 acc_normal_impulse = SIMDFloat4::select(active, SIMDFloat4::max(jn_old + jn, zero), jn_old);
+		acc_normal_impulse.store(row.acc_normal_impulse);
+
+		const SIMDFloat4 jt_max = friction * acc_normal_impulse;
+		const SIMDFloat4 jt = -vt * SIMDFloat4::load(row.mass_tangent);
+		const SIMDFloat4 jt_old = SIMDFloat4::load(row.acc_tangent_impulse);
+		const SIMDFloat4 acc_tangent_impulse = SIMDFloat4::select(active, SIMDFloat4::min(SIMDFloat4::max(jt_old + jt, -jt_max), jt_max), jt_old);
+		acc_tangent_impulse.store(row.acc_tangent_impulse);
+
+		const Vector2x4 j = normal * (acc_normal_impulse - jn_old) + tangent * (acc_tangent_impulse - jt_old);
+
+		lvA = lvA - j * inv_mass_A;
+		avA = avA + inv_inertia_A * -rA.cross(j);
+		lvB = lvB + j * inv_mass_B;
+		avB = avB + inv_inertia_B * rB.cross(j);
+
+		(Vector2x4::load(row.acc_impulse) - j).store(row.acc_impulse);
+	}
+
+	lvA.store(velocities_A.linear);
+	avA.store(velocities_A.angular);
+	blvA.store(velocities_A.biased_linear);
+	bavA.store(velocities_A.biased_angular);
+	lvB.store(velocities_B.linear);
+	avB.store(velocities_B.angular);
+	blvB.store(velocities_B.biased_linear);
+	bavB.store(velocities_B.biased_angular);
+
+	for (int lane = 0; lane < batch.lane_count; lane++) {
+		const GodotBodyPair2D *pair = batch.pairs[lane];
+		if (pair->collide_A) {
+			GodotBody2D *A = pair->A;
+			A->set_linear_velocity(scatter_vector(velocities_A.linear, lane));
+			A->set_angular_velocity(velocities_A.angular[lane]);
+			A->set_biased_linear_velocity(scatter_vector(velocities_A.biased_linear, lane));
+			A->set_biased_angular_velocity(velocities_A.biased_angular[lane]);
+		}
+		if (pair->collide_B) {
+			GodotBody2D *B = pair->B;
+			B->set_linear_velocity(scatter_vector(velocities_B.linear, lane));
+			B->set_angular_velocity(velocities_B.angular[lane]);
+			B->set_biased_linear_velocity(scatter_vector(velocities_B.biased_linear, lane));
+			B->set_biased_angular_velocity(velocities_B.biased_angular[lane]);
+		}
+	}
+}
+
+void GodotContactSolver2D::solve() {
+	for (uint32_t batch_index = 0; batch_index < batch_count; batch_index++) {
+		solve_batch(batch_index);
+	}
+}
+
+void GodotContactSolver2D::finish() {
+	for (uint32_t batch_index = 0; batch_index < batch_count; batch_index++) {
+		const Batch &batch = batches[batch_index];
+		for (int lane = 0; lane < batch.lane_count; lane++) {
+			GodotBodyPair2D *pair = batch.pairs[lane];
+			for (int i = 0; i < pair->contact_count; i++) {
+				GodotBodyPair2D::Contact &c = pair->contacts[i];
+				const ContactRow &row = batch.rows[i];
+
+				c.acc_bias_impulse = row.acc_bias_impulse[lane];
+				c.acc_bias_impulse_center_of_mass = row.acc_bias_impulse_center_of_mass[lane];
+				c.acc_normal_impulse = row.acc_normal_impulse[lane];
+				c.acc_tangent_impulse = row.acc_tangent_impulse[lane];
+				c.acc_impulse = scatter_vector(row.acc_impulse, lane);
+			}
+		}
+	}
+}
@@ -50,6 +50,11 @@ class GodotPhysicsServer2D : public PhysicsServer2D {
 	int active_objects = 0;
 	int collision_pairs = 0;
 
+	enum BroadPhase {
+		BROADPHASE_BVH,
+		BROADPHASE_SAP,
+	};
+
 	bool using_threads = false;
 
 	bool flushing_queries = false;
@@ -117,6 +122,9 @@ public:
 
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) override;
+	virtual PackedByteArray space_save_state(RID p_space) const override;
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override;
+	virtual uint32_t space_get_state_hash(RID p_space) const override;
 
 	/* AREA API */
 
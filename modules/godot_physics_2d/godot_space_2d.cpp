@@ -1089,6 +1089,223 @@ const HashSet<GodotCollisionObject2D *> &GodotSpace2D::get_objects() const {
 	return objects;
 }
 
+// A saved state starts with this header, followed by the bodies, then by the body pairs and their contacts.
+struct SpaceStateHeader2D {
+	static constexpr uint32_t MAGIC = 0x44335347; // "GS2D"
+
+	uint32_t magic = MAGIC;
+	uint32_t real_size = sizeof(real_t);
+	uint32_t body_count = 0;
+	uint32_t pair_count = 0;
+};
+
+struct BodyStateRecord2D {
+	RID rid;
+	GodotBody2D::Snapshot snapshot;
+};
+
+struct BodyPairStateKey2D {
+	RID body_A;
+	RID body_B;
+	int32_t shape_A = 0;
+	int32_t shape_B = 0;
+
+	uint32_t hash() const {
+		uint32_t h = hash_murmur3_one_64(body_A.get_id());
+		h = hash_murmur3_one_64(body_B.get_id(), h);
+		h = hash_murmur3_one_32(shape_A, h);
+		h = hash_murmur3_one_32(shape_B, h);
+		return hash_fmix32(h);
+	}
+
+	bool operator==(const BodyPairStateKey2D &p_other) const {
+		return body_A == p_other.body_A && body_B == p_other.body_B && shape_A == p_other.shape_A && shape_B == p_other.shape_B;
+	}
+
+	BodyPairStateKey2D() {}
+	BodyPairStateKey2D(const GodotBodyPair2D::SnapshotHeader &p_header) :
+			body_A(p_header.body_A), body_B(p_header.body_B), shape_A(p_header.shape_A), shape_B(p_header.shape_B) {}
+};
+
+// Each pair is stored once, by its first body.
+static _FORCE_INLINE_ GodotBodyPair2D *_get_first_body_pair(const Pair<GodotConstraint2D *, int> &p_constraint) {
+	return p_constraint.second == 0 ? p_constraint.first->get_body_pair() : nullptr;
+}
+
+PackedByteArray GodotSpace2D::save_state() const {
+	LocalVector<const GodotBody2D *> bodies;
+	LocalVector<const GodotBodyPair2D *> pairs;
+	bodies.reserve(objects.size());
+
+	SpaceStateHeader2D header;
+	size_t size = sizeof(SpaceStateHeader2D);
+
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() != GodotCollisionObject2D::TYPE_BODY) {
+			continue;
+		}
+
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(object);
+		if (body->get_mode() != PhysicsServer2D::BODY_MODE_STATIC) {
+			bodies.push_back(body);
+			size += sizeof(BodyStateRecord2D);
+		}
+
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			const GodotBodyPair2D *pair = _get_first_body_pair(E);
+			if (pair) {
+				pairs.push_back(pair);
+				GodotBodyPair2D::SnapshotHeader pair_header;
+				pair->get_snapshot_header(pair_header);
+				size += GodotBodyPair2D::get_snapshot_size(pair_header.contact_count);
+			}
+		}
+	}
+
+	header.body_count = bodies.size();
+	header.pair_count = pairs.size();
+
+	PackedByteArray state;
+	state.resize(size);
+	uint8_t *w = state.ptrw();
+
+	memcpy(w, &header, sizeof(SpaceStateHeader2D));
+	w += sizeof(SpaceStateHeader2D);
+
+	for (const GodotBody2D *body : bodies) {
+		// Zeroed first, the padding of the record is saved too.
+		BodyStateRecord2D record;
+		memset(&record, 0, sizeof(BodyStateRecord2D));
+		record.rid = body->get_self();
+		body->save_snapshot(record.snapshot);
+		memcpy(w, &record, sizeof(BodyStateRecord2D));
+		w += sizeof(BodyStateRecord2D);
+	}
+
+	for (const GodotBodyPair2D *pair : pairs) {
+		w = pair->save_snapshot(w);
+	}
+
+	DEV_ASSERT(w == state.ptrw() + size);
+	return state;
+}
+
+bool GodotSpace2D::restore_state(const PackedByteArray &p_state) {
+	const uint8_t *r = p_state.ptr();
+	const uint8_t *end = r + p_state.size();
+
+	SpaceStateHeader2D header;
+	ERR_FAIL_COND_V_MSG(p_state.size() < (int64_t)sizeof(SpaceStateHeader2D), false, "Invalid physics space state.");
+	memcpy(&header, r, sizeof(SpaceStateHeader2D));
+	r += sizeof(SpaceStateHeader2D);
+	ERR_FAIL_COND_V_MSG(header.magic != SpaceStateHeader2D::MAGIC, false, "Invalid physics space state, it wasn't saved by GodotPhysics2D.");
+	ERR_FAIL_COND_V_MSG(header.real_size != sizeof(real_t), false, "Invalid physics space state, it was saved by a build using a different floating-point precision.");
+	ERR_FAIL_COND_V_MSG(header.body_count > size_t(end - r) / sizeof(BodyStateRecord2D), false, "Invalid physics space state.");
+
+	const uint8_t *body_records = r;
+	r += header.body_count * sizeof(BodyStateRecord2D);
+
+	// Check all the pairs before changing anything.
+	HashMap<BodyPairStateKey2D, const uint8_t *> saved_pairs;
+	saved_pairs.reserve(header.pair_count);
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		GodotBodyPair2D::SnapshotHeader pair_header;
+		ERR_FAIL_COND_V_MSG(size_t(end - r) < sizeof(GodotBodyPair2D::SnapshotHeader), false, "Invalid physics space state.");
+		memcpy(&pair_header, r, sizeof(GodotBodyPair2D::SnapshotHeader));
+		ERR_FAIL_COND_V_MSG(pair_header.contact_count < 0 || pair_header.contact_count > GodotBodyPair2D::get_max_snapshot_contacts(), false, "Invalid physics space state.");
+		const size_t pair_size = GodotBodyPair2D::get_snapshot_size(pair_header.contact_count);
+		ERR_FAIL_COND_V_MSG(size_t(end - r) < pair_size, false, "Invalid physics space state.");
+
+		saved_pairs.insert(BodyPairStateKey2D(pair_header), r);
+		r += pair_size;
+	}
+	ERR_FAIL_COND_V_MSG(r != end, false, "Invalid physics space state.");
+
+	HashMap<RID, GodotBody2D *> bodies;
+	bodies.reserve(objects.size());
+	for (GodotCollisionObject2D *object : objects) {
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.insert(object->get_self(), static_cast<GodotBody2D *>(object));
+		}
+	}
+
+	// Bodies added to the space after the state was saved are left as they are.
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		BodyStateRecord2D record;
+		memcpy(&record, body_records + i * sizeof(BodyStateRecord2D), sizeof(BodyStateRecord2D));
+
+		GodotBody2D **body = bodies.getptr(record.rid);
+		if (body) {
+			(*body)->restore_snapshot(record.snapshot);
+		}
+	}
+
+	// Pairs created after the state was saved lose their contacts, and pairs removed since then
+	// are created again by the broadphase on the next step, without contacts.
+	for (const KeyValue<RID, GodotBody2D *> &E : bodies) {
+		for (const Pair<GodotConstraint2D *, int> &F : E.value->get_constraint_list()) {
+			GodotBodyPair2D *pair = _get_first_body_pair(F);
+			if (pair) {
+				GodotBodyPair2D::SnapshotHeader pair_header;
+				pair->get_snapshot_header(pair_header);
+				const uint8_t *const *saved_pair = saved_pairs.getptr(BodyPairStateKey2D(pair_header));
+				pair->restore_snapshot(saved_pair ? *saved_pair : nullptr);
+			}
+		}
+	}
+
+	return true;
+}
+
+static _FORCE_INLINE_ uint32_t _hash_real_bits(real_t p_value, uint32_t p_hash) {
+	// Hash the exact bits, so that any difference is detected, down to the sign of zero.
+#ifdef REAL_T_IS_DOUBLE
+	uint64_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	return hash_murmur3_one_64(bits, p_hash);
+#else
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	return hash_murmur3_one_32(bits, p_hash);
+#endif
+}
+
+struct BodyRIDComparator {
+	_FORCE_INLINE_ bool operator()(const GodotBody2D *p_a, const GodotBody2D *p_b) const {
+		return p_a->get_self() < p_b->get_self();
+	}
+};
+
+uint32_t GodotSpace2D::get_state_hash() const {
+	// Bodies are hashed in RID order, so the result doesn't depend on the order they were added to the space in.
+	LocalVector<const GodotBody2D *> bodies;
+	for (const GodotCollisionObject2D *object : objects) {
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.push_back(static_cast<const GodotBody2D *>(object));
+		}
+	}
+	bodies.sort_custom<BodyRIDComparator>();
+
+	uint32_t hash = HASH_MURMUR3_SEED;
+	for (const GodotBody2D *body : bodies) {
+		hash = hash_murmur3_one_32(body->get_mode(), hash);
+		hash = hash_murmur3_one_32(body->is_active(), hash);
+
+		const Transform2D &transform = body->get_transform();
+		for (int i = 0; i < 3; i++) {
+			hash = _hash_real_bits(transform.columns[i].x, hash);
+			hash = _hash_real_bits(transform.columns[i].y, hash);
+		}
+
+		const Vector2 linear_velocity = body->get_linear_velocity();
+		hash = _hash_real_bits(linear_velocity.x, hash);
+		hash = _hash_real_bits(linear_velocity.y, hash);
+		hash = _hash_real_bits(body->get_angular_velocity(), hash);
+	}
+
+	return hash_fmix32(hash);
+}
+
 void GodotSpace2D::body_add_to_state_query_list(SelfList<GodotBody2D> *p_body) {
 	state_query_list.add(p_body);
 }
@@ -1220,7 +1437,12 @@ GodotSpace2D::GodotSpace2D() {
 	body_linear_velocity_sleep_threshold = GLOBAL_GET("physics/2d/sleep_threshold_linear");
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/2d/sleep_threshold_angular");
 	body_time_to_sleep = GLOBAL_GET("physics/2d/time_before_sleep");
+	deterministic = GLOBAL_GET("physics/2d/deterministic_simulation");
 	solver_iterations = GLOBAL_GET("physics/2d/solver/solver_iterations");
+#ifndef REAL_T_IS_DOUBLE
+	// The SIMD solver works with single precision floats.
+	contact_solver = ContactSolver(int(GLOBAL_GET("physics/2d/solver/contact_solver")));
+#endif
 	contact_recycle_radius = GLOBAL_GET("physics/2d/solver/contact_recycle_radius");
 	contact_max_separation = GLOBAL_GET("physics/2d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/2d/solver/contact_max_allowed_penetration");
@@ -65,6 +65,11 @@ public:
 
 	};
 
+	enum ContactSolver {
+		CONTACT_SOLVER_SCALAR,
+		CONTACT_SOLVER_SIMD,
+	};
+
 private:
 	struct ExcludedShapeSW {
 		GodotShape2D *local_shape = nullptr;
@@ -92,6 +97,8 @@ private:
 	GodotArea2D *area = nullptr;
 
 	int solver_iterations = 0;
+	ContactSolver contact_solver = CONTACT_SOLVER_SCALAR;
+	bool deterministic = false;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
@@ -153,7 +160,13 @@ public:
 	void remove_object(GodotCollisionObject2D *p_object);
 	const HashSet<GodotCollisionObject2D *> &get_objects() const;
 
+	// Snapshots of the bodies and of the contacts between them, for rollback.
+	PackedByteArray save_state() const;
+	bool restore_state(const PackedByteArray &p_state);
+
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ ContactSolver get_contact_solver() const { return contact_solver; }
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -185,6 +198,8 @@ public:
 
 	int get_collision_pairs() const { return collision_pairs; }
 
+	uint32_t get_state_hash() const;
+
 	bool test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::MotionParameters &p_parameters, PhysicsServer2D::MotionResult *r_result);
 
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
@@ -73,6 +73,29 @@ void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D
 	}
 }
 
+struct ConstraintOrderComparator {
+	_FORCE_INLINE_ bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+		return p_a->get_order_key() < p_b->get_order_key();
+	}
+};
+
+void GodotStep2D::_sort_island(uint32_t p_island_index, void *p_userdata) {
+	constraint_islands[p_island_index].sort_custom<ConstraintOrderComparator>();
+}
+
+// Body pairs can slow down bodies using ray CCD in their setup, while other pairs read their velocity.
+static bool _constraint_has_ccd_setup(GodotConstraint2D *p_constraint) {
+	if (!p_constraint->get_body_pair()) {
+		return false;
+	}
+	for (int i = 0; i < p_constraint->get_body_count(); i++) {
+		if (p_constraint->get_body_ptr()[i]->get_continuous_collision_detection_mode() == PhysicsServer2D::CCD_MODE_CAST_RAY) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void GodotStep2D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
 	GodotConstraint2D *constraint = all_constraints[p_constraint_index];
 	constraint->setup(delta);
@@ -91,15 +114,27 @@ void GodotStep2D::_pre_solve_island(LocalVector<GodotConstraint2D *> &p_constrai
 	p_constraint_island.resize(valid_constraint_count);
 }
 
-void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const {
-	const LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[p_island_index];
+void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) {
+	LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[p_island_index];
+
+	GodotContactSolver2D *contact_solver = nullptr;
+	if (use_contact_solver && island_contact_solvers[p_island_index].setup(constraint_island, delta)) {
+		contact_solver = &island_contact_solvers[p_island_index];
+	}
 
 	for (int i = 0; i < iterations; i++) {
+		if (contact_solver) {
+			contact_solver->solve();
+		}
 		uint32_t constraint_count = constraint_island.size();
 		for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
 			constraint_island[constraint_index]->solve(delta);
 		}
 	}
+
+	if (contact_solver) {
+		contact_solver->finish();
+	}
 }
 
 void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) const {
@@ -240,10 +275,39 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
+	WorkerThreadPool::GroupID group_task;
+
+	if (p_space->is_deterministic()) {
+		// Constraints are found in an order that depends on when their pairs were created, and on
+		// memory addresses. Sort them by the objects they link instead, so that they are processed
+		// in the same order on every run. Islands don't share bodies, so they can still be sorted
+		// and solved in parallel.
+		group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_sort_island, nullptr, island_count, -1, true, SNAME("Physics2DSortIslands"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		serial_setup_constraints.clear();
+		uint32_t parallel_constraint_count = 0;
+		for (GodotConstraint2D *constraint : all_constraints) {
+			if (_constraint_has_ccd_setup(constraint)) {
+				serial_setup_constraints.push_back(constraint);
+			} else {
+				all_constraints[parallel_constraint_count++] = constraint;
+			}
+		}
+		all_constraints.resize(parallel_constraint_count);
+		serial_setup_constraints.sort_custom<ConstraintOrderComparator>();
+	}
+
 	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics2DConstraintSetup"));
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics2DConstraintSetup"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
+	// Only filled when the space is deterministic, see above.
+	for (GodotConstraint2D *constraint : serial_setup_constraints) {
+		constraint->setup(delta);
+	}
+	serial_setup_constraints.clear();
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace2D::ELAPSED_TIME_SETUP_CONSTRAINTS, profile_endtime - profile_begtime);
@@ -261,6 +325,11 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	// WARNING: `_solve_island` modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
+	use_contact_solver = p_space->get_contact_solver() == GodotSpace2D::CONTACT_SOLVER_SIMD;
+	if (use_contact_solver && island_contact_solvers.size() < island_count) {
+		island_contact_solvers.resize(island_count);
+	}
+
 	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics2DConstraintSolveIslands"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "godot_contact_solver_2d.h"
 #include "godot_space_2d.h"
 
 #include "core/templates/local_vector.h"
@@ -44,10 +45,20 @@ class GodotStep2D {
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
 	LocalVector<GodotConstraint2D *> all_constraints;
 
+	// Batched contact solvers, one per island, used instead of GodotBodyPair2D::solve()
+	// when the space uses the SIMD contact solver.
+	bool use_contact_solver = false;
+	LocalVector<GodotContactSolver2D> island_contact_solvers;
+
+	// When the space is deterministic, constraints whose setup can change body velocities
+	// (continuous collision detection) are set up serially, in a fixed order.
+	LocalVector<GodotConstraint2D *> serial_setup_constraints;
+
 	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
+	void _sort_island(uint32_t p_island_index, void *p_userdata = nullptr);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const;
-	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr) const;
+	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
 	void _check_suspend(LocalVector<GodotBody2D *> &p_body_island) const;
 
 public:
@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*  test_godot_physics_2d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_physics_server_2d.h"
+
+namespace TestGodotPhysics2D {
+
+// A static floor with a pile of slightly overlapping 20x20 boxes resting on it.
+struct BoxPile {
+	RID floor_shape;
+	RID floor;
+	RID box_shape;
+	LocalVector<RID> boxes;
+
+	void create(GodotPhysicsServer2D *p_server, RID p_space, int p_columns, int p_rows) {
+		floor_shape = p_server->rectangle_shape_create();
+		p_server->shape_set_data(floor_shape, Vector2(1000, 10));
+		floor = p_server->body_create();
+		p_server->body_set_mode(floor, PhysicsServer2D::BODY_MODE_STATIC);
+		p_server->body_add_shape(floor, floor_shape, Transform2D(0, Vector2(0, 10)));
+		p_server->body_set_space(floor, p_space);
+
+		box_shape = p_server->rectangle_shape_create();
+		p_server->shape_set_data(box_shape, Vector2(10, 10));
+
+		for (int y = 0; y < p_rows; y++) {
+			for (int x = 0; x < p_columns; x++) {
+				RID box = p_server->body_create();
+				p_server->body_add_shape(box, box_shape);
+				p_server->body_set_space(box, p_space);
+				p_server->body_set_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(x * 19.8, -10 - y * 19.8)));
+				boxes.push_back(box);
+			}
+		}
+	}
+
+	void free(GodotPhysicsServer2D *p_server) {
+		for (const RID &box : boxes) {
+			p_server->free(box);
+		}
+		boxes.clear();
+		p_server->free(box_shape);
+		p_server->free(floor);
+		p_server->free(floor_shape);
+	}
+};
+
+} // namespace TestGodotPhysics2D
@@ -0,0 +1,190 @@
+/**************************************************************************/
+/*  test_godot_physics_2d_broad_phase.h                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_body_2d.h"
+#include "../godot_broad_phase_2d_bvh.h"
+#include "../godot_broad_phase_2d_sap.h"
+
+#include "core/templates/hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysics2DBroadPhase {
+
+constexpr int GRID_SIZE = 20;
+constexpr real_t GRID_SPACING = 30.0;
+constexpr real_t BOX_SIZE = 10.0;
+// The pairs of all rows but the static one.
+constexpr uint32_t PAIR_COUNT = (GRID_SIZE / 2 - 1) * (GRID_SIZE - 1);
+
+// The subindex of every shape is its index, so pairs can be keyed by index.
+static void *record_pair(GodotCollisionObject2D *p_object_A, int p_subindex_A, GodotCollisionObject2D *p_object_B, int p_subindex_B, void *p_userdata) {
+	HashSet<uint64_t> *pairs = static_cast<HashSet<uint64_t> *>(p_userdata);
+	pairs->insert(uint64_t(MIN(p_subindex_A, p_subindex_B)) << 32 | MAX(p_subindex_A, p_subindex_B));
+	return p_userdata;
+}
+
+static void record_unpair(GodotCollisionObject2D *p_object_A, int p_subindex_A, GodotCollisionObject2D *p_object_B, int p_subindex_B, void *p_data, void *p_userdata) {
+	HashSet<uint64_t> *pairs = static_cast<HashSet<uint64_t> *>(p_userdata);
+	CHECK_MESSAGE(pairs->erase(uint64_t(MIN(p_subindex_A, p_subindex_B)) << 32 | MAX(p_subindex_A, p_subindex_B)), "Unpaired shapes should have been paired.");
+}
+
+static Rect2 get_box(int p_index, real_t p_shift) {
+	// Every other column is shifted into its right neighbor.
+	int x = p_index % GRID_SIZE;
+	int y = p_index / GRID_SIZE;
+	return Rect2(x * GRID_SPACING + (x % 2) * p_shift, y * GRID_SPACING, BOX_SIZE, BOX_SIZE);
+}
+
+static void check_same_pairs(const HashSet<uint64_t> &p_pairs_a, const HashSet<uint64_t> &p_pairs_b) {
+	CHECK(p_pairs_a.size() == p_pairs_b.size());
+	for (uint64_t pair : p_pairs_a) {
+		CHECK(p_pairs_b.has(pair));
+	}
+}
+
+TEST_CASE("[GodotPhysics2D] Sweep and prune finds the same pairs as the BVH") {
+	GodotBroadPhase2D *bvh = GodotBroadPhase2DBVH::_create();
+	GodotBroadPhase2D *sap = GodotBroadPhase2DSAP::_create();
+	HashSet<uint64_t> bvh_pairs;
+	HashSet<uint64_t> sap_pairs;
+	bvh->set_pair_callback(record_pair, &bvh_pairs);
+	bvh->set_unpair_callback(record_unpair, &bvh_pairs);
+	sap->set_pair_callback(record_pair, &sap_pairs);
+	sap->set_unpair_callback(record_unpair, &sap_pairs);
+
+	// Enough shapes to use the parallel pairing of the BVH. The first row is
+	// static, and static shapes never pair with each other.
+	LocalVector<GodotBody2D *> bodies;
+	LocalVector<GodotBroadPhase2D::ID> bvh_ids;
+	LocalVector<GodotBroadPhase2D::ID> sap_ids;
+	for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+		bool is_static = i < GRID_SIZE;
+		bodies.push_back(memnew(GodotBody2D));
+		bvh_ids.push_back(bvh->create(bodies[i], i, get_box(i, 0), is_static));
+		sap_ids.push_back(sap->create(bodies[i], i, get_box(i, 0), is_static));
+	}
+	bvh->update();
+	sap->update();
+	CHECK(bvh_pairs.is_empty());
+	CHECK(sap_pairs.is_empty());
+
+	// Overlap the columns in pairs.
+	for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+		bvh->move(bvh_ids[i], get_box(i, 25));
+		sap->move(sap_ids[i], get_box(i, 25));
+	}
+	bvh->update();
+	sap->update();
+	CHECK(sap_pairs.size() == PAIR_COUNT);
+	check_same_pairs(bvh_pairs, sap_pairs);
+
+	GodotCollisionObject2D *bvh_results[16];
+	GodotCollisionObject2D *sap_results[16];
+	const Rect2 query = Rect2(GRID_SPACING * 4 + 2, GRID_SPACING * 4 + 2, GRID_SPACING * 2, GRID_SPACING * 2);
+	CHECK(bvh->cull_aabb(query, bvh_results, 16) == 12);
+	CHECK(sap->cull_aabb(query, sap_results, 16) == 12);
+	const Vector2 from = Vector2(-5, GRID_SPACING * 3 + 5);
+	const Vector2 to = Vector2(GRID_SPACING * GRID_SIZE, GRID_SPACING * 3 + 5);
+	CHECK(sap->cull_segment(from, to, sap_results, 16) == 16);
+
+	// Removing a shape unpairs it right away.
+	bvh->remove(bvh_ids[GRID_SIZE + 1]);
+	sap->remove(sap_ids[GRID_SIZE + 1]);
+	CHECK(sap_pairs.size() == PAIR_COUNT - 1);
+	check_same_pairs(bvh_pairs, sap_pairs);
+
+	// Move them back apart.
+	for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+		if (i == GRID_SIZE + 1) {
+			continue;
+		}
+		bvh->move(bvh_ids[i], get_box(i, 0));
+		sap->move(sap_ids[i], get_box(i, 0));
+	}
+	bvh->update();
+	sap->update();
+	CHECK(bvh_pairs.is_empty());
+	CHECK(sap_pairs.is_empty());
+
+	memdelete(bvh);
+	memdelete(sap);
+	for (GodotBody2D *body : bodies) {
+		memdelete(body);
+	}
+}
+
+static void *count_pair(GodotCollisionObject2D *p_object_A, int p_subindex_A, GodotCollisionObject2D *p_object_B, int p_subindex_B, void *p_userdata) {
+	(*static_cast<int *>(p_userdata))++;
+	return nullptr;
+}
+
+static void count_unpair(GodotCollisionObject2D *p_object_A, int p_subindex_A, GodotCollisionObject2D *p_object_B, int p_subindex_B, void *p_data, void *p_userdata) {
+	(*static_cast<int *>(p_userdata))++;
+}
+
+TEST_CASE("[GodotPhysics2D] Sweep and prune keeps pairs through small movements") {
+	GodotBroadPhase2D *sap = GodotBroadPhase2DSAP::_create();
+	int pair_count = 0;
+	int unpair_count = 0;
+	sap->set_pair_callback(count_pair, &pair_count);
+	sap->set_unpair_callback(count_unpair, &unpair_count);
+
+	GodotBody2D *body_a = memnew(GodotBody2D);
+	GodotBody2D *body_b = memnew(GodotBody2D);
+	GodotBroadPhase2D::ID id_a = sap->create(body_a, 0, Rect2(0, 0, BOX_SIZE, BOX_SIZE));
+	GodotBroadPhase2D::ID id_b = sap->create(body_b, 0, Rect2(BOX_SIZE - 1, 0, BOX_SIZE, BOX_SIZE));
+	sap->update();
+	CHECK(pair_count == 1);
+
+	// Shapes that separate by less than the margins stay paired, and moving
+	// inside their pairing AABBs doesn't pair them again.
+	for (int i = 0; i < 10; i++) {
+		sap->move(id_b, Rect2(BOX_SIZE + 0.01 * i, 0, BOX_SIZE, BOX_SIZE));
+		sap->update();
+	}
+	CHECK(pair_count == 1);
+	CHECK(unpair_count == 0);
+
+	// Separating further unpairs them.
+	sap->move(id_b, Rect2(BOX_SIZE * 2, 0, BOX_SIZE, BOX_SIZE));
+	sap->update();
+	CHECK(unpair_count == 1);
+
+	sap->remove(id_a);
+	sap->remove(id_b);
+	memdelete(sap);
+	memdelete(body_a);
+	memdelete(body_b);
+}
+
+} // namespace TestGodotPhysics2DBroadPhase
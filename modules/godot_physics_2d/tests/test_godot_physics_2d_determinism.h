@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*  test_godot_physics_2d_determinism.h                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "test_godot_physics_2d.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_tools.h"
+
+namespace TestGodotPhysics2DDeterminism {
+
+// Drops a pile of 10x10 slightly overlapping boxes, with fast moving CCD bodies
+// shot through them, and returns the state hash of the space after each step.
+static LocalVector<uint32_t> simulate_box_pile(int p_steps) {
+	// Spaces read this setting when they are created.
+	ProjectSettingOverride deterministic_simulation("physics/2d/deterministic_simulation", true);
+
+	GodotPhysicsServer2D *server = memnew(GodotPhysicsServer2D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	TestGodotPhysics2D::BoxPile pile;
+	pile.create(server, space, 10, 10);
+
+	LocalVector<RID> bullets;
+	RID bullet_shape = server->circle_shape_create();
+	server->shape_set_data(bullet_shape, 2.0);
+	for (int i = 0; i < 4; i++) {
+		RID bullet = server->body_create();
+		server->body_add_shape(bullet, bullet_shape);
+		server->body_set_continuous_collision_detection_mode(bullet, PhysicsServer2D::CCD_MODE_CAST_RAY);
+		server->body_set_space(bullet, space);
+		server->body_set_state(bullet, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(-100, -20 - i * 40)));
+		server->body_set_state(bullet, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(5000, 0));
+		bullets.push_back(bullet);
+	}
+
+	LocalVector<uint32_t> hashes;
+	for (int i = 0; i < p_steps; i++) {
+		server->step(1.0 / 60.0);
+		hashes.push_back(server->space_get_state_hash(space));
+	}
+
+	for (const RID &bullet : bullets) {
+		server->free(bullet);
+	}
+	server->free(bullet_shape);
+	pile.free(server);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+
+	return hashes;
+}
+
+TEST_CASE("[GodotPhysics2D] Deterministic simulation") {
+	const LocalVector<uint32_t> hashes = simulate_box_pile(60);
+	REQUIRE(hashes.size() == 60);
+
+	SUBCASE("State hash follows the simulation") {
+		CHECK(hashes[0] != hashes[1]);
+		CHECK(hashes[1] != hashes[59]);
+	}
+
+	SUBCASE("Repeated runs produce the same states") {
+		const LocalVector<uint32_t> hashes_again = simulate_box_pile(60);
+		REQUIRE(hashes_again.size() == hashes.size());
+
+		int first_mismatch = -1;
+		for (uint32_t i = 0; i < hashes.size(); i++) {
+			if (hashes[i] != hashes_again[i]) {
+				first_mismatch = i;
+				break;
+			}
+		}
+		CHECK(first_mismatch == -1);
+	}
+}
+
+TEST_CASE("[GodotPhysics2D] Saving and restoring space states") {
+	GodotPhysicsServer2D *server = memnew(GodotPhysicsServer2D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	TestGodotPhysics2D::BoxPile pile;
+	pile.create(server, space, 5, 5);
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	const PackedByteArray state = server->space_save_state(space);
+	const uint32_t saved_hash = server->space_get_state_hash(space);
+	REQUIRE(!state.is_empty());
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+	const uint32_t stepped_hash = server->space_get_state_hash(space);
+	CHECK(stepped_hash != saved_hash);
+
+	SUBCASE("Restoring brings back the saved state") {
+		CHECK(server->space_restore_state(space, state));
+		CHECK(server->space_get_state_hash(space) == saved_hash);
+	}
+
+	SUBCASE("Invalid states are rejected") {
+		PackedByteArray truncated_state = state;
+		truncated_state.resize(state.size() - 1);
+
+		ERR_PRINT_OFF;
+		CHECK_FALSE(server->space_restore_state(space, PackedByteArray()));
+		CHECK_FALSE(server->space_restore_state(space, truncated_state));
+		ERR_PRINT_ON;
+
+		CHECK(server->space_get_state_hash(space) == stepped_hash);
+	}
+
+	pile.free(server);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestGodotPhysics2DDeterminism
@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  test_godot_physics_2d_step.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "test_godot_physics_2d.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_tools.h"
+
+namespace TestGodotPhysics2DStep {
+
+#ifndef REAL_T_IS_DOUBLE
+
+struct BodyStates {
+	LocalVector<Vector2> positions;
+	LocalVector<Vector2> linear_velocities;
+	LocalVector<real_t> angular_velocities;
+};
+
+// Steps a pile of 10x10 slightly overlapping boxes falling on a floor, which forms
+// a single island, and returns the final states of the boxes.
+static BodyStates simulate_box_pile(int p_steps, GodotSpace2D::ContactSolver p_contact_solver) {
+	// Spaces read the solver from the project settings when they are created.
+	ProjectSettingOverride contact_solver("physics/2d/solver/contact_solver", p_contact_solver);
+
+	GodotPhysicsServer2D *server = memnew(GodotPhysicsServer2D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+	server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 980.0);
+	server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+
+	TestGodotPhysics2D::BoxPile pile;
+	pile.create(server, space, 10, 10);
+
+	for (int i = 0; i < p_steps; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	BodyStates states;
+	for (const RID &box : pile.boxes) {
+		const Transform2D transform = server->body_get_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM);
+		states.positions.push_back(transform.get_origin());
+		states.linear_velocities.push_back(server->body_get_state(box, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY));
+		states.angular_velocities.push_back(server->body_get_state(box, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY));
+	}
+
+	pile.free(server);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+
+	return states;
+}
+
+TEST_CASE("[GodotPhysics2D] Large island stepping with the SIMD contact solver") {
+	SUBCASE("Impulses match the scalar solver closely") {
+		// Starting from the same contacts, the velocities after the first steps only
+		// differ by the impulses the two solvers applied.
+		const BodyStates simd_states = simulate_box_pile(2, GodotSpace2D::CONTACT_SOLVER_SIMD);
+		const BodyStates scalar_states = simulate_box_pile(2, GodotSpace2D::CONTACT_SOLVER_SCALAR);
+		REQUIRE(simd_states.linear_velocities.size() == scalar_states.linear_velocities.size());
+
+		// Contacts are solved in a different order, so impulses are close but not identical.
+		// Gravity alone adds about 16 px/s per step.
+		real_t max_linear_difference = 0.0;
+		real_t max_angular_difference = 0.0;
+		for (uint32_t i = 0; i < simd_states.linear_velocities.size(); i++) {
+			max_linear_difference = MAX(max_linear_difference, simd_states.linear_velocities[i].distance_to(scalar_states.linear_velocities[i]));
+			max_angular_difference = MAX(max_angular_difference, Math::abs(simd_states.angular_velocities[i] - scalar_states.angular_velocities[i]));
+		}
+		CHECK(max_linear_difference < 4.0);
+		CHECK(max_angular_difference < 0.2);
+	}
+
+	const BodyStates states = simulate_box_pile(60, GodotSpace2D::CONTACT_SOLVER_SIMD);
+
+	SUBCASE("Bodies stay on the floor") {
+		for (const Vector2 &position : states.positions) {
+			CHECK(position.y < 5.0);
+			CHECK(position.y > -200.0);
+		}
+	}
+
+	SUBCASE("Results match the scalar solver closely") {
+		const BodyStates scalar_states = simulate_box_pile(60, GodotSpace2D::CONTACT_SOLVER_SCALAR);
+		REQUIRE(scalar_states.positions.size() == states.positions.size());
+
+		real_t max_distance = 0.0;
+		for (uint32_t i = 0; i < states.positions.size(); i++) {
+			max_distance = MAX(max_distance, states.positions[i].distance_to(scalar_states.positions[i]));
+		}
+		CHECK(max_distance < 5.0);
+	}
+
+	SUBCASE("Results are deterministic") {
+		const BodyStates states_again = simulate_box_pile(60, GodotSpace2D::CONTACT_SOLVER_SIMD);
+		REQUIRE(states_again.positions.size() == states.positions.size());
+
+		int mismatch_count = 0;
+		for (uint32_t i = 0; i < states.positions.size(); i++) {
+			if (states.positions[i] != states_again.positions[i]) {
+				mismatch_count++;
+			}
+		}
+		CHECK(mismatch_count == 0);
+	}
+}
+
+#endif // REAL_T_IS_DOUBLE
+
+} // namespace TestGodotPhysics2DStep
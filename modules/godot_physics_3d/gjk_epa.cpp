@@ -103,9 +103,32 @@ struct sResults	{
 typedef unsigned int	U;
 typedef unsigned char	U1;
 
+// -- GODOT start --
+// Iteration counts of the GJK evaluations, see gjk_epa_take_iteration_histogram().
+static bool statistics_enabled = false;
+static SafeNumeric<uint32_t> iteration_histogram[GJK_EPA_ITERATION_BUCKETS];
+
+static inline void record_iterations(U p_iterations) {
+	if (!statistics_enabled) {
+		return;
+	}
+	int bucket = 0;
+	while ((p_iterations >> (bucket + 1)) && bucket < GJK_EPA_ITERATION_BUCKETS - 1) {
+		bucket++;
+	}
+	iteration_histogram[bucket].increment();
+}
+// -- GODOT end --
+
 // MinkowskiDiff
+// -- GODOT start --
+// Templated on the shape types, so the support functions of final shape
+// classes are called directly and can be inlined. Use GodotShape3D for
+// shapes only known at runtime.
+template <typename ShapeA, typename ShapeB>
 struct	MinkowskiDiff {
-	const GodotShape3D* m_shapes[2];
+	const ShapeA* shape_A = nullptr;
+	const ShapeB* shape_B = nullptr;
 
 	Transform3D transform_A;
 	Transform3D transform_B;
@@ -113,29 +136,25 @@ struct	MinkowskiDiff {
 	real_t margin_A = 0.0;
 	real_t margin_B = 0.0;
 
-	Vector3 (*get_support)(const GodotShape3D*, const Vector3&, real_t) = nullptr;
+	bool with_margin = false;
 
-	void Initialize(const GodotShape3D* shape0, const Transform3D& wtrs0, const real_t margin0,
-		const GodotShape3D* shape1, const Transform3D& wtrs1, const real_t margin1) {
-		m_shapes[0]		=	shape0;
-		m_shapes[1]		=	shape1;
+	void Initialize(const ShapeA* shape0, const Transform3D& wtrs0, const real_t margin0,
+		const ShapeB* shape1, const Transform3D& wtrs1, const real_t margin1) {
+		shape_A			=	shape0;
+		shape_B			=	shape1;
 		transform_A		=	wtrs0;
 		transform_B		=	wtrs1;
 		margin_A		=	margin0;
 		margin_B		=	margin1;
-
-		if ((margin0 > 0.0) || (margin1 > 0.0)) {
-			get_support = get_support_with_margin;
-		} else {
-			get_support = get_support_without_margin;
-		}
+		with_margin		=	(margin0 > 0.0) || (margin1 > 0.0);
 	}
 
-	static Vector3 get_support_without_margin(const GodotShape3D* p_shape, const Vector3& p_dir, real_t p_margin) {
-		return p_shape->get_support(p_dir.normalized());
-	}
+	template <typename S>
+	static _FORCE_INLINE_ Vector3 get_support(const S* p_shape, const Vector3& p_dir, real_t p_margin, bool p_with_margin) {
+		if (!p_with_margin) {
+			return p_shape->get_support(p_dir.normalized());
+		}
 
-	static Vector3 get_support_with_margin(const GodotShape3D* p_shape, const Vector3& p_dir, real_t p_margin) {
 		Vector3 local_dir_norm = p_dir;
 		if (local_dir_norm.length_squared() < CMP_EPSILON2) {
 			local_dir_norm = Vector3(-1.0, -1.0, -1.0);
@@ -145,14 +164,14 @@ struct	MinkowskiDiff {
 		return p_shape->get_support(local_dir_norm) + p_margin * local_dir_norm;
 	}
 
-	// i wonder how this could be sped up... if it can
 	_FORCE_INLINE_ Vector3 Support0(const Vector3& d) const {
-		return transform_A.xform(get_support(m_shapes[0], transform_A.basis.xform_inv(d), margin_A));
+		return transform_A.xform(get_support(shape_A, transform_A.basis.xform_inv(d), margin_A, with_margin));
 	}
 
 	_FORCE_INLINE_ Vector3 Support1(const Vector3& d) const {
-		return transform_B.xform(get_support(m_shapes[1], transform_B.basis.xform_inv(d), margin_B));
+		return transform_B.xform(get_support(shape_B, transform_B.basis.xform_inv(d), margin_B, with_margin));
 	}
+// -- GODOT end --
 
 	_FORCE_INLINE_ Vector3 Support (const Vector3& d) const {
 		return (Support0(d) - Support1(-d));
@@ -167,10 +186,9 @@ struct	MinkowskiDiff {
 	}
 };
 
-typedef	MinkowskiDiff tShape;
-
 
 // GJK
+template <typename tShape>
 struct	GJK
 {
 	/* Types		*/
@@ -198,7 +216,7 @@ struct	GJK
 		U				m_nfree = 0;
 		U				m_current = 0;
 		sSimplex*		m_simplex = nullptr;
-		eStatus::_		m_status;
+		typename eStatus::_		m_status;
 		/* Methods		*/
 		GJK()
 		{
@@ -212,7 +230,7 @@ struct	GJK
 			m_current	=	0;
 			m_distance	=	0;
 		}
-		eStatus::_			Evaluate(const tShape& shapearg,const Vector3& guess)
+		typename eStatus::_			Evaluate(const tShape& shapearg,const Vector3& guess)
 		{
 			U			iterations=0;
 			real_t	sqdist=0;
@@ -325,6 +343,9 @@ struct	GJK
 				}
 				m_status=((++iterations)<GJK_MAX_ITERATIONS)?m_status:eStatus::Failed;
 			} while(m_status==eStatus::Valid);
+			// -- GODOT start --
+			record_iterations(iterations);
+			// -- GODOT end --
 			m_simplex=&m_simplices[m_current];
 			switch(m_status)
 			{
@@ -541,10 +562,12 @@ struct	GJK
 };
 
 	// EPA
+	template <typename tShape>
 	struct	EPA
 	{
 		/* Types		*/
-		typedef	GJK::sSV	sSV;
+		typedef	GJK<tShape>	tGJK;
+		typedef	typename tGJK::sSV	sSV;
 		struct	sFace
 		{
 			Vector3	n;
@@ -580,8 +603,8 @@ struct	GJK
 			FallBack,
 			Failed		};};
 			/* Fields		*/
-			eStatus::_		m_status;
-			GJK::sSimplex	m_result;
+			typename eStatus::_		m_status;
+			typename tGJK::sSimplex	m_result;
 			Vector3		m_normal;
 			real_t		m_depth = 0.0f;
 			sSV				m_sv_store[EPA_MAX_VERTICES];
@@ -633,9 +656,9 @@ struct	GJK
 					append(m_stock,&m_fc_store[EPA_MAX_FACES-i-1]);
 				}
 			}
-			eStatus::_			Evaluate(GJK& gjk,const Vector3& guess)
+			typename eStatus::_			Evaluate(tGJK& gjk,const Vector3& guess)
 			{
-				GJK::sSimplex&	simplex=*gjk.m_simplex;
+				typename tGJK::sSimplex&	simplex=*gjk.m_simplex;
 				if((simplex.rank>1)&&gjk.EncloseOrigin())
 				{
 					/* Clean up				*/
@@ -862,10 +885,11 @@ struct	GJK
 	};
 
 	//
-	static void	Initialize(	const GodotShape3D* shape0, const Transform3D& wtrs0, real_t margin0,
-		const GodotShape3D* shape1, const Transform3D& wtrs1, real_t margin1,
+	template <typename ShapeA, typename ShapeB>
+	static void	Initialize(	const ShapeA* shape0, const Transform3D& wtrs0, real_t margin0,
+		const ShapeB* shape1, const Transform3D& wtrs1, real_t margin1,
 		sResults& results,
-		tShape& shape)
+		MinkowskiDiff<ShapeA, ShapeB>& shape)
 	{
 		/* Results		*/
 		results.witnesses[0]	=	Vector3(0,0,0);
@@ -884,20 +908,23 @@ struct	GJK
 //
 
 //
-bool Distance(	const GodotShape3D*	shape0,
+template <typename ShapeA, typename ShapeB>
+bool Distance(	const ShapeA*	shape0,
 									  const Transform3D&		wtrs0,
 									  real_t				margin0,
-									  const GodotShape3D*		shape1,
+									  const ShapeB*		shape1,
 									  const Transform3D&		wtrs1,
 									  real_t				margin1,
 									  const Vector3&		guess,
 									  sResults&				results)
 {
+	typedef	MinkowskiDiff<ShapeA, ShapeB>	tShape;
+	typedef	GJK<tShape>	tGJK;
 	tShape			shape;
 	Initialize(shape0, wtrs0, margin0, shape1, wtrs1, margin1, results, shape);
-	GJK				gjk;
-	GJK::eStatus::_	gjk_status=gjk.Evaluate(shape,guess);
-	if(gjk_status==GJK::eStatus::Valid)
+	tGJK			gjk;
+	typename tGJK::eStatus::_	gjk_status=gjk.Evaluate(shape,guess);
+	if(gjk_status==tGJK::eStatus::Valid)
 	{
 		Vector3	w0=Vector3(0,0,0);
 		Vector3	w1=Vector3(0,0,0);
@@ -916,7 +943,7 @@ bool Distance(	const GodotShape3D*	shape0,
 	}
 	else
 	{
-		results.status	=	gjk_status==GJK::eStatus::Inside?
+		results.status	=	gjk_status==tGJK::eStatus::Inside?
 			sResults::Penetrating	:
 		sResults::GJK_Failed;
 		return(false);
@@ -925,27 +952,31 @@ bool Distance(	const GodotShape3D*	shape0,
 
 
 //
-bool Penetration(	const GodotShape3D*	shape0,
+template <typename ShapeA, typename ShapeB>
+bool Penetration(	const ShapeA*	shape0,
 									 const Transform3D&		wtrs0,
 									 real_t					margin0,
-									 const GodotShape3D*		shape1,
+									 const ShapeB*		shape1,
 									 const Transform3D&		wtrs1,
 									 real_t					margin1,
 									 const Vector3&			guess,
 									 sResults&				results
 									)
 {
+	typedef	MinkowskiDiff<ShapeA, ShapeB>	tShape;
+	typedef	GJK<tShape>	tGJK;
+	typedef	EPA<tShape>	tEPA;
 	tShape			shape;
 	Initialize(shape0, wtrs0, margin0, shape1, wtrs1, margin1, results, shape);
-	GJK				gjk;
-	GJK::eStatus::_	gjk_status=gjk.Evaluate(shape,-guess);
+	tGJK			gjk;
+	typename tGJK::eStatus::_	gjk_status=gjk.Evaluate(shape,-guess);
 	switch(gjk_status)
 	{
-	case	GJK::eStatus::Inside:
+	case	tGJK::eStatus::Inside:
 		{
-			EPA				epa;
-			EPA::eStatus::_	epa_status=epa.Evaluate(gjk,-guess);
-			if(epa_status!=EPA::eStatus::Failed)
+			tEPA			epa;
+			typename tEPA::eStatus::_	epa_status=epa.Evaluate(gjk,-guess);
+			if(epa_status!=tEPA::eStatus::Failed)
 			{
 				Vector3	w0=Vector3(0,0,0);
 				for(U i=0;i<epa.m_result.rank;++i)
@@ -962,7 +993,7 @@ bool Penetration(	const GodotShape3D*	shape0,
 }
 		}
 		break;
-	case	GJK::eStatus::Failed:
+	case	tGJK::eStatus::Failed:
 		results.status=sResults::GJK_Failed;
 		break;
 	default: {}
@@ -993,6 +1024,17 @@ bool Penetration(	const GodotShape3D*	shape0,
 
 /* clang-format on */
 
+void gjk_epa_set_statistics_enabled(bool p_enabled) {
+	GjkEpa2::statistics_enabled = p_enabled;
+}
+
+void gjk_epa_take_iteration_histogram(uint32_t *r_buckets) {
+	for (int i = 0; i < GJK_EPA_ITERATION_BUCKETS; i++) {
+		r_buckets[i] += GjkEpa2::iteration_histogram[i].get();
+		GjkEpa2::iteration_histogram[i].set(0);
+	}
+}
+
 bool gjk_epa_calculate_distance(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, Vector3 &r_result_A, Vector3 &r_result_B) {
 	GjkEpa2::sResults res;
 
@@ -1005,7 +1047,8 @@ bool gjk_epa_calculate_distance(const GodotShape3D *p_shape_A, const Transform3D
 	return false;
 }
 
-bool gjk_epa_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, real_t p_margin_A, real_t p_margin_B) {
+template <typename ShapeA, typename ShapeB>
+bool gjk_epa_calculate_penetration(const ShapeA *p_shape_A, const Transform3D &p_transform_A, const ShapeB *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, real_t p_margin_A, real_t p_margin_B) {
 	GjkEpa2::sResults res;
 
 	if (GjkEpa2::Penetration(p_shape_A, p_transform_A, p_margin_A, p_shape_B, p_transform_B, p_margin_B, p_transform_B.origin - p_transform_A.origin, res)) {
@@ -1023,3 +1066,10 @@ bool gjk_epa_calculate_penetration(const GodotShape3D *p_shape_A, const Transfor
 
 	return false;
 }
+
+bool gjk_epa_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, real_t p_margin_A, real_t p_margin_B) {
+	return gjk_epa_calculate_penetration<GodotShape3D, GodotShape3D>(p_shape_A, p_transform_A, p_shape_B, p_transform_B, p_result_callback, p_userdata, p_swap, p_margin_A, p_margin_B);
+}
+
+template bool gjk_epa_calculate_penetration<GodotCylinderShape3D, GodotCylinderShape3D>(const GodotCylinderShape3D *, const Transform3D &, const GodotCylinderShape3D *, const Transform3D &, GodotCollisionSolver3D::CallbackResult, void *, bool, real_t, real_t);
+template bool gjk_epa_calculate_penetration<GodotCylinderShape3D, GodotConvexPolygonShape3D>(const GodotCylinderShape3D *, const Transform3D &, const GodotConvexPolygonShape3D *, const Transform3D &, GodotCollisionSolver3D::CallbackResult, void *, bool, real_t, real_t);
@@ -33,5 +33,21 @@
 #include "godot_collision_solver_3d.h"
 #include "godot_shape_3d.h"
 
+// Same as gjk_epa_calculate_penetration(), with the support functions of
+// the shapes inlined. Only instantiated for the pairs which need it, see
+// the end of gjk_epa.cpp.
+template <typename ShapeA, typename ShapeB>
+bool gjk_epa_calculate_penetration(const ShapeA *p_shape_A, const Transform3D &p_transform_A, const ShapeB *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap = false, real_t p_margin_A = 0.0, real_t p_margin_B = 0.0);
+
+// GJK evaluations are counted by iteration count when statistics are enabled.
+// Bucket 0 counts evaluations of at most one iteration, and bucket i > 0 those
+// of 2^i to 2^(i+1) - 1 iterations, the last one also counting longer ones.
+static constexpr int GJK_EPA_ITERATION_BUCKETS = 8;
+
+void gjk_epa_set_statistics_enabled(bool p_enabled);
+// Adds the counts recorded since the previous call to r_buckets, which holds
+// GJK_EPA_ITERATION_BUCKETS values. Must not run while collisions are solved.
+void gjk_epa_take_iteration_histogram(uint32_t *r_buckets);
+
 bool gjk_epa_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap = false, real_t p_margin_A = 0.0, real_t p_margin_B = 0.0);
 bool gjk_epa_calculate_distance(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, Vector3 &r_result_A, Vector3 &r_result_B);
@@ -190,6 +190,46 @@ void GodotBody3D::set_active(bool p_active) {
 	}
 }
 
+void GodotBody3D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.transform = get_transform();
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.constant_force = constant_force;
+	r_snapshot.constant_torque = constant_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+}
+
+void GodotBody3D::restore_snapshot(const Snapshot &p_snapshot) {
+	if (mode == PhysicsServer3D::BODY_MODE_STATIC) {
+		return;
+	}
+
+	_set_transform(p_snapshot.transform);
+	_set_inv_transform(get_transform().affine_inverse());
+	if (mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
+		new_transform = p_snapshot.transform;
+	} else {
+		_update_transform_dependent();
+	}
+
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	applied_force = p_snapshot.applied_force;
+	applied_torque = p_snapshot.applied_torque;
+	constant_force = p_snapshot.constant_force;
+	constant_torque = p_snapshot.constant_torque;
+	still_time = p_snapshot.still_time;
+	set_active(p_snapshot.active);
+
+	// Report the restored state on the next flush of the queries, even if the body is asleep.
+	if (get_space() && (fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+}
+
 void GodotBody3D::set_param(PhysicsServer3D::BodyParameter p_param, const Variant &p_value) {
 	switch (p_param) {
 		case PhysicsServer3D::BODY_PARAM_BOUNCE: {
@@ -665,7 +705,8 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector3();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		_update_shape_aabbs_with_motion(motion);
+		integration_flush_flags |= INTEGRATION_FLUSH_BROADPHASE;
 	}
 
 	contact_count = 0;
@@ -679,7 +720,7 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 	ERR_FAIL_NULL(get_space());
 
 	if (fi_callback_data || body_state_callback.is_valid()) {
-		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+		integration_flush_flags |= INTEGRATION_FLUSH_STATE_QUERY;
 	}
 
 	//apply axis lock linear
@@ -702,7 +743,7 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 		_set_transform(new_transform, false);
 		_set_inv_transform(new_transform.affine_inverse());
 		if (contacts.is_empty() && linear_velocity == Vector3() && angular_velocity == Vector3()) {
-			set_active(false); //stopped moving, deactivate
+			integration_flush_flags |= INTEGRATION_FLUSH_DEACTIVATE; //stopped moving, deactivate
 		}
 
 		return;
@@ -731,12 +772,30 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 
 	transform_new.origin += total_linear_velocity * p_step;
 
-	_set_transform(transform_new);
+	_set_transform(transform_new, false);
 	_set_inv_transform(get_transform().inverse());
+	_update_shape_aabbs();
+	integration_flush_flags |= INTEGRATION_FLUSH_BROADPHASE;
 
 	_update_transform_dependent();
 }
 
+void GodotBody3D::flush_integration() {
+	if (integration_flush_flags & INTEGRATION_FLUSH_STATE_QUERY) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+
+	if (integration_flush_flags & INTEGRATION_FLUSH_BROADPHASE) {
+		_move_shapes_in_broadphase();
+	}
+
+	if (integration_flush_flags & INTEGRATION_FLUSH_DEACTIVATE) {
+		set_active(false);
+	}
+
+	integration_flush_flags = 0;
+}
+
 void GodotBody3D::wakeup_neighbours() {
 	for (const KeyValue<GodotConstraint3D *, int> &E : constraint_map) {
 		const GodotConstraint3D *c = E.key;
@@ -107,6 +107,15 @@ class GodotBody3D : public GodotCollisionObject3D {
 	bool can_sleep = true;
 	bool first_time_kinematic = false;
 
+	// Side effects of integrate_forces() and integrate_velocities() on the broadphase
+	// and the space lists, deferred to flush_integration().
+	enum {
+		INTEGRATION_FLUSH_BROADPHASE = 1 << 0,
+		INTEGRATION_FLUSH_STATE_QUERY = 1 << 1,
+		INTEGRATION_FLUSH_DEACTIVATE = 1 << 2,
+	};
+	uint32_t integration_flush_flags = 0;
+
 	void _mass_properties_changed();
 	virtual void _shapes_changed() override;
 	Transform3D new_transform;
@@ -148,6 +157,7 @@ class GodotBody3D : public GodotCollisionObject3D {
 	void _update_transform_dependent();
 
 	friend class GodotPhysicsDirectBodyState3D; // i give up, too many functions to expose
+	friend class GodotContactSolver3D; // Gathers and scatters velocities in batches.
 
 public:
 	void set_state_sync_callback(const Callable &p_callable);
@@ -283,6 +293,22 @@ public:
 	void set_active(bool p_active);
 	_FORCE_INLINE_ bool is_active() const { return active; }
 
+	// State changed by the simulation, saved and restored by GodotSpace3D::save_state().
+	struct Snapshot {
+		Transform3D transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		Vector3 constant_force;
+		Vector3 constant_torque;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void restore_snapshot(const Snapshot &p_snapshot);
+
 	_FORCE_INLINE_ void wakeup() {
 		if ((!get_space()) || mode == PhysicsServer3D::BODY_MODE_STATIC || mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 			return;
@@ -316,8 +342,11 @@ public:
 	void set_axis_lock(PhysicsServer3D::BodyAxis p_axis, bool lock);
 	bool is_axis_locked(PhysicsServer3D::BodyAxis p_axis) const;
 
+	// These only modify the body itself, so they can run on worker threads for
+	// different bodies. flush_integration() must be called serially after each of them.
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
+	void flush_integration();
 
 	_FORCE_INLINE_ Vector3 get_velocity_in_local_point(const Vector3 &rel_pos) const {
 		return linear_velocity + angular_velocity.cross(rel_pos - center_of_mass);
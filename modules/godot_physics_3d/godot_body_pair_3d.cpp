@@ -258,6 +258,68 @@ real_t combine_friction(GodotBody3D *A, GodotBody3D *B) {
 	return Math::abs(MIN(A->get_friction(), B->get_friction()));
 }
 
+void GodotBodyPair3D::get_snapshot_header(SnapshotHeader &r_header) const {
+	memset(&r_header, 0, sizeof(SnapshotHeader));
+	r_header.body_A = A->get_self();
+	r_header.body_B = B->get_self();
+	r_header.shape_A = shape_A;
+	r_header.shape_B = shape_B;
+	r_header.sep_axis = sep_axis;
+	r_header.contact_count = contact_count;
+}
+
+uint8_t *GodotBodyPair3D::save_snapshot(uint8_t *p_data) const {
+	SnapshotHeader header;
+	get_snapshot_header(header);
+	memcpy(p_data, &header, sizeof(SnapshotHeader));
+
+	// The contacts are copied field by field, their padding is not initialized.
+	uint8_t *w = p_data + sizeof(SnapshotHeader);
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		Contact contact;
+		memset(&contact, 0, sizeof(Contact));
+		contact.position = c.position;
+		contact.normal = c.normal;
+		contact.index_A = c.index_A;
+		contact.index_B = c.index_B;
+		contact.local_A = c.local_A;
+		contact.local_B = c.local_B;
+		contact.acc_impulse = c.acc_impulse;
+		contact.acc_normal_impulse = c.acc_normal_impulse;
+		contact.acc_tangent_impulse = c.acc_tangent_impulse;
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		contact.mass_normal = c.mass_normal;
+		contact.bias = c.bias;
+		contact.bounce = c.bounce;
+		contact.depth = c.depth;
+		contact.active = c.active;
+		contact.used = c.used;
+		contact.rA = c.rA;
+		contact.rB = c.rB;
+		memcpy(w, &contact, sizeof(Contact));
+		w += sizeof(Contact);
+	}
+	return p_data + get_snapshot_size(contact_count);
+}
+
+void GodotBodyPair3D::restore_snapshot(const uint8_t *p_data) {
+	if (!p_data) {
+		sep_axis = Vector3();
+		contact_count = 0;
+		collided = false;
+		return;
+	}
+
+	SnapshotHeader header;
+	memcpy(&header, p_data, sizeof(SnapshotHeader));
+	sep_axis = header.sep_axis;
+	contact_count = header.contact_count;
+	memcpy(contacts, p_data + sizeof(SnapshotHeader), contact_count * sizeof(Contact));
+	collided = contact_count > 0;
+}
+
 bool GodotBodyPair3D::setup(real_t p_step) {
 	check_ccd = false;
 
@@ -294,7 +356,7 @@ bool GodotBodyPair3D::setup(real_t p_step) {
 	GodotShape3D *shape_A_ptr = A->get_shape(shape_A);
 	GodotShape3D *shape_B_ptr = B->get_shape(shape_B);
 
-	collided = GodotCollisionSolver3D::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+	collided = GodotCollisionSolver3D::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis, 0, 0, &cull_cache);
 
 	if (!collided) {
 		if (A->is_continuous_collision_detection_enabled() && collide_A) {
@@ -96,6 +96,9 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	// Triangles near the body when one of the shapes is concave.
+	GodotConcaveShape3D::CullCache cull_cache;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
@@ -103,7 +106,34 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	void validate_contacts();
 	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
+	friend class GodotContactSolver3D;
+
 public:
+	// Contacts kept between steps for warm starting, saved by GodotSpace3D::save_state().
+	// The header is followed by contact_count contacts.
+	struct SnapshotHeader {
+		RID body_A;
+		RID body_B;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		Vector3 sep_axis;
+		int32_t contact_count = 0;
+	};
+
+	static constexpr int get_max_snapshot_contacts() { return MAX_CONTACTS; }
+	static constexpr size_t get_snapshot_size(int p_contact_count) { return sizeof(SnapshotHeader) + p_contact_count * sizeof(Contact); }
+
+	// Also zeroes the padding of the header, so equal states are saved as equal bytes.
+	void get_snapshot_header(SnapshotHeader &r_header) const;
+	// Returns the end of the written data.
+	uint8_t *save_snapshot(uint8_t *p_data) const;
+	// Passing nullptr clears the contacts, for pairs that didn't exist when the state was saved.
+	void restore_snapshot(const uint8_t *p_data);
+
+	virtual GodotBodyPair3D *get_body_pair() override { return this; }
+
+	_FORCE_INLINE_ int get_contact_count() const { return contact_count; }
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
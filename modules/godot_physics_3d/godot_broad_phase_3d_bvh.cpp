@@ -86,6 +86,17 @@ int GodotBroadPhase3DBVH::cull_aabb(const AABB &p_aabb, GodotCollisionObject3D *
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+void GodotBroadPhase3DBVH::cull_segments(const Vector3 *p_from, const Vector3 *p_to, int p_count, LocalVector<SegmentHit> &r_hits) {
+	auto hit_func = [&r_hits](uint32_t p_segment, GodotCollisionObject3D *p_object, int p_subindex) {
+		SegmentHit hit;
+		hit.segment = p_segment;
+		hit.object = p_object;
+		hit.subindex = p_subindex;
+		r_hits.push_back(hit);
+	};
+	bvh.cull_segments(p_from, p_to, p_count, hit_func, nullptr);
+}
+
 void *GodotBroadPhase3DBVH::_pair_callback(void *self, uint32_t p_A, GodotCollisionObject3D *p_object_A, int subindex_A, uint32_t p_B, GodotCollisionObject3D *p_object_B, int subindex_B) {
 	GodotBroadPhase3DBVH *bpo = static_cast<GodotBroadPhase3DBVH *>(self);
 	if (!bpo->pair_callback) {
@@ -125,4 +136,5 @@ GodotBroadPhase3D *GodotBroadPhase3DBVH::_create() {
 GodotBroadPhase3DBVH::GodotBroadPhase3DBVH() {
 	bvh.set_pair_callback(_pair_callback, this);
 	bvh.set_unpair_callback(_unpair_callback, this);
+	bvh.params_set_parallel_pairing_threshold(PARALLEL_PAIRING_THRESHOLD);
 }
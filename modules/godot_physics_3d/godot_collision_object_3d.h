@@ -82,6 +82,13 @@ private:
 
 protected:
 	void _update_shapes_with_motion(const Vector3 &p_motion);
+
+	// Split versions of _update_shapes() and _update_shapes_with_motion(): the shape
+	// AABBs only depend on this object and can be computed on worker threads, while
+	// moving them in the broadphase must be done serially.
+	void _update_shape_aabbs();
+	void _update_shape_aabbs_with_motion(const Vector3 &p_motion);
+	void _move_shapes_in_broadphase();
 	void _unregister_shapes();
 
 	_FORCE_INLINE_ void _set_transform(const Transform3D &p_transform, bool p_update_shapes = true) {
@@ -1887,7 +1887,7 @@ static void _collision_cylinder_cylinder(const GodotShape3D *p_a, const Transfor
 	GodotCollisionSolver3D::CallbackResult callback = SeparatorAxisTest<GodotCylinderShape3D, GodotCylinderShape3D, withMargin>::test_contact_points;
 
 	// Fallback to generic algorithm to find the best separating axis.
-	if (!fallback_collision_solver(p_a, p_transform_a, p_b, p_transform_b, callback, &separator, false, p_margin_a, p_margin_b)) {
+	if (!fallback_collision_solver(cylinder_A, p_transform_a, cylinder_B, p_transform_b, callback, &separator, false, p_margin_a, p_margin_b)) {
 		return;
 	}
 
@@ -1904,7 +1904,7 @@ static void _collision_cylinder_convex_polygon(const GodotShape3D *p_a, const Tr
 	GodotCollisionSolver3D::CallbackResult callback = SeparatorAxisTest<GodotCylinderShape3D, GodotConvexPolygonShape3D, withMargin>::test_contact_points;
 
 	// Fallback to generic algorithm to find the best separating axis.
-	if (!fallback_collision_solver(p_a, p_transform_a, p_b, p_transform_b, callback, &separator, false, p_margin_a, p_margin_b)) {
+	if (!fallback_collision_solver(cylinder_A, p_transform_a, convex_polygon_B, p_transform_b, callback, &separator, false, p_margin_a, p_margin_b)) {
 		return;
 	}
 
@@ -34,6 +34,7 @@
 #include "core/typedefs.h"
 
 class GodotBody3D;
+class GodotBodyPair3D;
 class GodotSoftBody3D;
 
 class GodotConstraint3D {
@@ -67,6 +68,9 @@ public:
 	virtual GodotSoftBody3D *get_soft_body_ptr(int p_index) const { return nullptr; }
 	virtual int get_soft_body_count() const { return 0; }
 
+	// Returns this constraint as a body pair, so its contacts can be batched by GodotContactSolver3D.
+	virtual GodotBodyPair3D *get_body_pair() { return nullptr; }
+
 	_FORCE_INLINE_ void set_priority(int p_priority) { priority = p_priority; }
 	_FORCE_INLINE_ int get_priority() const { return priority; }
 
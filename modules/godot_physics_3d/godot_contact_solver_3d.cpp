@@ -0,0 +1,433 @@
+/**************************************************************************/
+/*  godot_contact_solver_3d.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_contact_solver_3d.h"
+
+#define MIN_VELOCITY 0.0001
+#define MAX_BIAS_ROTATION (Math::PI / 8)
+// Number of the most recent batches searched for a free lane before starting a new batch.
+#define BATCH_SEARCH_WINDOW 8
+
+namespace {
+
+struct Vector3x4 {
+	SIMDFloat4 x, y, z;
+
+	_FORCE_INLINE_ static Vector3x4 load(const float p_values[3][SIMDFloat4::LANES]) {
+		return { SIMDFloat4::load(p_values[0]), SIMDFloat4::load(p_values[1]), SIMDFloat4::load(p_values[2]) };
+	}
+
+	_FORCE_INLINE_ void store(float r_values[3][SIMDFloat4::LANES]) const {
+		x.store(r_values[0]);
+		y.store(r_values[1]);
+		z.store(r_values[2]);
+	}
+
+	_FORCE_INLINE_ Vector3x4 operator+(const Vector3x4 &p_other) const { return { x + p_other.x, y + p_other.y, z + p_other.z }; }
+	_FORCE_INLINE_ Vector3x4 operator-(const Vector3x4 &p_other) const { return { x - p_other.x, y - p_other.y, z - p_other.z }; }
+	_FORCE_INLINE_ Vector3x4 operator*(const SIMDFloat4 &p_scalar) const { return { x * p_scalar, y * p_scalar, z * p_scalar }; }
+	_FORCE_INLINE_ Vector3x4 operator-() const { return { -x, -y, -z }; }
+
+	_FORCE_INLINE_ SIMDFloat4 dot(const Vector3x4 &p_other) const { return x * p_other.x + y * p_other.y + z * p_other.z; }
+	_FORCE_INLINE_ Vector3x4 cross(const Vector3x4 &p_other) const {
+		return { y * p_other.z - z * p_other.y, z * p_other.x - x * p_other.z, x * p_other.y - y * p_other.x };
+	}
+	_FORCE_INLINE_ SIMDFloat4 length() const { return SIMDFloat4::sqrt(dot(*this)); }
+
+	_FORCE_INLINE_ static Vector3x4 select(const SIMDFloat4 &p_mask, const Vector3x4 &p_a, const Vector3x4 &p_b) {
+		return { SIMDFloat4::select(p_mask, p_a.x, p_b.x), SIMDFloat4::select(p_mask, p_a.y, p_b.y), SIMDFloat4::select(p_mask, p_a.z, p_b.z) };
+	}
+};
+
+// Row-major 3x3 matrices, as in Basis.
+struct Basisx4 {
+	SIMDFloat4 m[9];
+
+	_FORCE_INLINE_ static Basisx4 load(const float p_values[9][SIMDFloat4::LANES]) {
+		Basisx4 basis;
+		for (int i = 0; i < 9; i++) {
+			basis.m[i] = SIMDFloat4::load(p_values[i]);
+		}
+		return basis;
+	}
+
+	_FORCE_INLINE_ Vector3x4 xform(const Vector3x4 &p_vector) const {
+		return {
+			m[0] * p_vector.x + m[1] * p_vector.y + m[2] * p_vector.z,
+			m[3] * p_vector.x + m[4] * p_vector.y + m[5] * p_vector.z,
+			m[6] * p_vector.x + m[7] * p_vector.y + m[8] * p_vector.z,
+		};
+	}
+};
+
+struct BodyVelocities {
+	float linear[3][SIMDFloat4::LANES];
+	float angular[3][SIMDFloat4::LANES];
+	float biased_linear[3][SIMDFloat4::LANES];
+	float biased_angular[3][SIMDFloat4::LANES];
+};
+
+_FORCE_INLINE_ void gather_vector(float r_values[3][SIMDFloat4::LANES], int p_lane, const Vector3 &p_vector) {
+	r_values[0][p_lane] = p_vector.x;
+	r_values[1][p_lane] = p_vector.y;
+	r_values[2][p_lane] = p_vector.z;
+}
+
+_FORCE_INLINE_ Vector3 scatter_vector(const float p_values[3][SIMDFloat4::LANES], int p_lane) {
+	return Vector3(p_values[0][p_lane], p_values[1][p_lane], p_values[2][p_lane]);
+}
+
+} // namespace
+
+bool GodotContactSolver3D::_writes_body(const GodotBody3D *p_body) {
+	// Static and kinematic bodies are only read by the solver, so lanes can share them.
+	return p_body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC;
+}
+
+bool GodotContactSolver3D::_can_add_to_batch(const Batch &p_batch, const GodotBodyPair3D *p_pair) const {
+	if (p_batch.lane_count == LANES) {
+		return false;
+	}
+
+	for (int lane = 0; lane < p_batch.lane_count; lane++) {
+		const GodotBodyPair3D *other = p_batch.pairs[lane];
+		for (int i = 0; i < 2; i++) {
+			const GodotBody3D *body = p_pair->_arr[i];
+			if (_writes_body(body) && (body == other->A || body == other->B)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void GodotContactSolver3D::_add_to_batch(Batch &p_batch, GodotBodyPair3D *p_pair) {
+	const int lane = p_batch.lane_count++;
+	p_batch.pairs[lane] = p_pair;
+	p_batch.row_count = MAX(p_batch.row_count, p_pair->contact_count);
+
+	const GodotBody3D *A = p_pair->A;
+	const GodotBody3D *B = p_pair->B;
+
+	// Bodies that don't collide get no impulses, which is the same as having infinite mass.
+	p_batch.inv_mass_A[lane] = p_pair->collide_A ? A->get_inv_mass() : 0.0;
+	p_batch.inv_mass_B[lane] = p_pair->collide_B ? B->get_inv_mass() : 0.0;
+
+	Basis zero_basis;
+	zero_basis.set_zero();
+	const Basis &inv_inertia_tensor_A = p_pair->collide_A ? A->get_inv_inertia_tensor() : zero_basis;
+	const Basis &inv_inertia_tensor_B = p_pair->collide_B ? B->get_inv_inertia_tensor() : zero_basis;
+	for (int i = 0; i < 9; i++) {
+		p_batch.inv_inertia_A[i][lane] = inv_inertia_tensor_A.rows[i / 3][i % 3];
+		p_batch.inv_inertia_B[i][lane] = inv_inertia_tensor_B.rows[i / 3][i % 3];
+	}
+
+	p_batch.friction[lane] = Math::abs(MIN(A->get_friction(), B->get_friction()));
+
+	for (int i = 0; i < p_pair->contact_count; i++) {
+		const GodotBodyPair3D::Contact &c = p_pair->contacts[i];
+		ContactRow &row = p_batch.rows[i];
+
+		gather_vector(row.rA, lane, c.rA);
+		gather_vector(row.rB, lane, c.rB);
+		gather_vector(row.normal, lane, c.normal);
+		row.bias[lane] = c.bias;
+		row.bounce[lane] = c.bounce;
+		row.mass_normal[lane] = c.mass_normal;
+		row.acc_bias_impulse[lane] = c.acc_bias_impulse;
+		row.acc_bias_impulse_center_of_mass[lane] = c.acc_bias_impulse_center_of_mass;
+		row.acc_normal_impulse[lane] = c.acc_normal_impulse;
+		gather_vector(row.acc_tangent_impulse, lane, c.acc_tangent_impulse);
+		gather_vector(row.acc_impulse, lane, c.acc_impulse);
+		row.active[lane] = c.active ? 1.0 : 0.0;
+	}
+}
+
+bool GodotContactSolver3D::setup(LocalVector<GodotConstraint3D *> &p_constraints, real_t p_step) {
+	step = p_step;
+	batch_count = 0;
+
+	uint32_t constraint_count = 0;
+	for (GodotConstraint3D *constraint : p_constraints) {
+		GodotBodyPair3D *pair = constraint->get_body_pair();
+		if (!pair || !pair->collided) {
+			// Keep it to be solved on its own.
+			p_constraints[constraint_count++] = constraint;
+			continue;
+		}
+
+		// Look for a free lane in the last batches, so that setup stays linear.
+		Batch *batch = nullptr;
+		for (uint32_t batch_index = batch_count > BATCH_SEARCH_WINDOW ? batch_count - BATCH_SEARCH_WINDOW : 0; batch_index < batch_count; batch_index++) {
+			if (_can_add_to_batch(batches[batch_index], pair)) {
+				batch = &batches[batch_index];
+				break;
+			}
+		}
+
+		if (!batch) {
+			if (batch_count == batches.size()) {
+				batches.resize(batch_count + 1);
+			}
+			batch = &batches[batch_count++];
+			// Unused lanes stay zeroed, which makes them inactive.
+			*batch = Batch();
+		}
+
+		_add_to_batch(*batch, pair);
+	}
+	p_constraints.resize(constraint_count);
+
+	return batch_count > 0;
+}
+
+void GodotContactSolver3D::solve_batch(uint32_t p_batch_index) {
+	Batch &batch = batches[p_batch_index];
+
+	BodyVelocities velocities_A = {};
+	BodyVelocities velocities_B = {};
+	for (int lane = 0; lane < batch.lane_count; lane++) {
+		const GodotBodyPair3D *pair = batch.pairs[lane];
+		gather_vector(velocities_A.linear, lane, pair->A->get_linear_velocity());
+		gather_vector(velocities_A.angular, lane, pair->A->get_angular_velocity());
+		gather_vector(velocities_A.biased_linear, lane, pair->A->get_biased_linear_velocity());
+		gather_vector(velocities_A.biased_angular, lane, pair->A->get_biased_angular_velocity());
+		gather_vector(velocities_B.linear, lane, pair->B->get_linear_velocity());
+		gather_vector(velocities_B.angular, lane, pair->B->get_angular_velocity());
+		gather_vector(velocities_B.biased_linear, lane, pair->B->get_biased_linear_velocity());
+		gather_vector(velocities_B.biased_angular, lane, pair->B->get_biased_angular_velocity());
+	}
+
+	Vector3x4 lvA = Vector3x4::load(velocities_A.linear);
+	Vector3x4 avA = Vector3x4::load(velocities_A.angular);
+	Vector3x4 blvA = Vector3x4::load(velocities_A.biased_linear);
+	Vector3x4 bavA = Vector3x4::load(velocities_A.biased_angular);
+	Vector3x4 lvB = Vector3x4::load(velocities_B.linear);
+	Vector3x4 avB = Vector3x4::load(velocities_B.angular);
+	Vector3x4 blvB = Vector3x4::load(velocities_B.biased_linear);
+	Vector3x4 bavB = Vector3x4::load(velocities_B.biased_angular);
+
+	const SIMDFloat4 inv_mass_A = SIMDFloat4::load(batch.inv_mass_A);
+	const SIMDFloat4 inv_mass_B = SIMDFloat4::load(batch.inv_mass_B);
+	const SIMDFloat4 inv_mass_sum = inv_mass_A + inv_mass_B;
+	const Basisx4 inv_inertia_A = Basisx4::load(batch.inv_inertia_A);
+	const Basisx4 inv_inertia_B = Basisx4::load(batch.inv_inertia_B);
+	const SIMDFloat4 friction = SIMDFloat4::load(batch.friction);
+
+	const SIMDFloat4 zero = SIMDFloat4::zero();
+	const SIMDFloat4 one(1.0f);
+	const SIMDFloat4 min_velocity(MIN_VELOCITY);
+	const SIMDFloat4 epsilon(CMP_EPSILON);
+	const SIMDFloat4 max_bias_av(MAX_BIAS_ROTATION / step);
+
+	// Same as GodotBodyPair3D::solve(), with each branch turned into a lane mask.
+	for (int i = 0; i < batch.row_count; i++) {
+		ContactRow &row = batch.rows[i];
+
+		const SIMDFloat4 active = SIMDFloat4::mask_from(row.active);
+		if (!SIMDFloat4::mask_any(active)) {
+			continue;
+		}
+
+		const Vector3x4 rA = Vector3x4::load(row.rA);
+		const Vector3x4 rB = Vector3x4::load(row.rB);
+		const Vector3x4 normal = Vector3x4::load(row.normal);
+		const SIMDFloat4 bias = SIMDFloat4::load(row.bias);
+		const SIMDFloat4 mass_normal = SIMDFloat4::load(row.mass_normal);
+
+		// Bias impulse.
+
+		Vector3x4 dbv = blvB + bavB.cross(rB) - blvA - bavA.cross(rA);
+		SIMDFloat4 vbn = dbv.dot(normal);
+
+		const SIMDFloat4 bias_active = SIMDFloat4::mask_and(active, SIMDFloat4::greater(SIMDFloat4::abs(bias - vbn), min_velocity));
+		SIMDFloat4 still_active = bias_active;
+
+		if (SIMDFloat4::mask_any(bias_active)) {
+			const SIMDFloat4 jbn = (bias - vbn) * mass_normal;
+			const SIMDFloat4 jbn_old = SIMDFloat4::load(row.acc_bias_impulse);
+			const SIMDFloat4 acc_bias_impulse = SIMDFloat4::select(bias_active, SIMDFloat4::max(jbn_old + jbn, zero), jbn_old);
+			acc_bias_impulse.store(row.acc_bias_impulse);
+
+			const Vector3x4 jb = normal * (acc_bias_impulse - jbn_old);
+
+			blvA = blvA - jb * inv_mass_A;
+			blvB = blvB + jb * inv_mass_B;
+
+			// Angular bias velocity changes are limited in length by max_bias_av.
+			Vector3x4 delta_av_A = inv_inertia_A.xform(rA.cross(-jb));
+			Vector3x4 delta_av_B = inv_inertia_B.xform(rB.cross(jb));
+			const SIMDFloat4 delta_av_A_length = delta_av_A.length();
+			const SIMDFloat4 delta_av_B_length = delta_av_B.length();
+			delta_av_A = delta_av_A * SIMDFloat4::select(SIMDFloat4::greater(delta_av_A_length, max_bias_av), max_bias_av / delta_av_A_length, one);
+			delta_av_B = delta_av_B * SIMDFloat4::select(SIMDFloat4::greater(delta_av_B_length, max_bias_av), max_bias_av / delta_av_B_length, one);
+			bavA = bavA + delta_av_A;
+			bavB = bavB + delta_av_B;
+
+			dbv = blvB + bavB.cross(rB) - blvA - bavA.cross(rA);
+			vbn = dbv.dot(normal);
+
+			const SIMDFloat4 bias_com_active = SIMDFloat4::mask_and(bias_active, SIMDFloat4::greater(SIMDFloat4::abs(bias - vbn), min_velocity));
+			if (SIMDFloat4::mask_any(bias_com_active)) {
+				const SIMDFloat4 jbn_com = (bias - vbn) / inv_mass_sum;
+				const SIMDFloat4 jbn_old_com = SIMDFloat4::load(row.acc_bias_impulse_center_of_mass);
+				const SIMDFloat4 acc_bias_impulse_com = SIMDFloat4::select(bias_com_active, SIMDFloat4::max(jbn_old_com + jbn_com, zero), jbn_old_com);
+				acc_bias_impulse_com.store(row.acc_bias_impulse_center_of_mass);
+
+				const Vector3x4 jb_com = normal * (acc_bias_impulse_com - jbn_old_com);
+
+				blvA = blvA - jb_com * inv_mass_A;
+				blvB = blvB + jb_com * inv_mass_B;
+			}
+		}
+
+		// Normal impulse.
+
+		const Vector3x4 dv = lvB + avB.cross(rB) - lvA - avA.cross(rA);
+		const SIMDFloat4 vn = dv.dot(normal);
+
+		const SIMDFloat4 normal_active = SIMDFloat4::mask_and(active, SIMDFloat4::greater(SIMDFloat4::abs(vn), min_velocity));
+		still_active = SIMDFloat4::mask_or(still_active, normal_active);
+
+		Vector3x4 acc_impulse = Vector3x4::load(row.acc_impulse);
+		const SIMDFloat4 jn_old = SIMDFloat4::load(row.acc_normal_impulse);
+		SIMDFloat4 acc_normal_impulse = jn_old;
+
+		if (SIMDFloat4::mask_any(normal_active)) {
+			const SIMDFloat4 jn = -(SIMDFloat4::load(row.bounce) + vn) * mass_normal;
+			acc_normal_impulse = SIMDFloat4::select(normal_active, SIMDFloat4::max(jn_old + jn, zero), jn_old);
+			acc_normal_impulse.store(row.acc_normal_impulse);
+
+			const Vector3x4 j = normal * (acc_normal_impulse - jn_old);
+
+			lvA = lvA - j * inv_mass_A;
+			avA = avA + inv_inertia_A.xform(rA.cross(-j));
+			lvB = lvB + j * inv_mass_B;
+			avB = avB + inv_inertia_B.xform(rB.cross(j));
+			acc_impulse = acc_impulse - j;
+		}
+
+		// Friction impulse.
+
+		const Vector3x4 dtv = lvB + avB.cross(rB) - lvA - avA.cross(rA);
+		const SIMDFloat4 tn = normal.dot(dtv);
+
+		// Tangential velocity.
+		Vector3x4 tv = dtv - normal * tn;
+		const SIMDFloat4 tvl = tv.length();
+
+		const SIMDFloat4 friction_active = SIMDFloat4::mask_and(active, SIMDFloat4::greater(tvl, min_velocity));
+		still_active = SIMDFloat4::mask_or(still_active, friction_active);
+
+		if (SIMDFloat4::mask_any(friction_active)) {
+			tv = tv * (one / SIMDFloat4::select(friction_active, tvl, one));
+
+			const Vector3x4 temp1 = inv_inertia_A.xform(rA.cross(tv));
+			const Vector3x4 temp2 = inv_inertia_B.xform(rB.cross(tv));
+
+			const SIMDFloat4 t = -tvl / (inv_mass_sum + tv.dot(temp1.cross(rA) + temp2.cross(rB)));
+
+			const Vector3x4 jt_old = Vector3x4::load(row.acc_tangent_impulse);
+			Vector3x4 acc_tangent_impulse = jt_old + Vector3x4::select(friction_active, tv * t, Vector3x4{ zero, zero, zero });
+
+			const SIMDFloat4 fi_len = acc_tangent_impulse.length();
+			const SIMDFloat4 jt_max = acc_normal_impulse * friction;
+
+			const SIMDFloat4 clamp = SIMDFloat4::mask_and(friction_active, SIMDFloat4::mask_and(SIMDFloat4::greater(fi_len, epsilon), SIMDFloat4::greater(fi_len, jt_max)));
+			acc_tangent_impulse = Vector3x4::select(clamp, acc_tangent_impulse * (jt_max / fi_len), acc_tangent_impulse);
+			acc_tangent_impulse.store(row.acc_tangent_impulse);
+
+			const Vector3x4 jt = acc_tangent_impulse - jt_old;
+
+			lvA = lvA - jt * inv_mass_A;
+			avA = avA + inv_inertia_A.xform(rA.cross(-jt));
+			lvB = lvB + jt * inv_mass_B;
+			avB = avB + inv_inertia_B.xform(rB.cross(jt));
+			acc_impulse = acc_impulse - jt;
+		}
+
+		acc_impulse.store(row.acc_impulse);
+		SIMDFloat4::select(still_active, one, zero).store(row.active);
+	}
+
+	lvA.store(velocities_A.linear);
+	avA.store(velocities_A.angular);
+	blvA.store(velocities_A.biased_linear);
+	bavA.store(velocities_A.biased_angular);
+	lvB.store(velocities_B.linear);
+	avB.store(velocities_B.angular);
+	blvB.store(velocities_B.biased_linear);
+	bavB.store(velocities_B.biased_angular);
+
+	for (int lane = 0; lane < batch.lane_count; lane++) {
+		const GodotBodyPair3D *pair = batch.pairs[lane];
+		if (pair->collide_A) {
+			GodotBody3D *A = pair->A;
+			A->linear_velocity = scatter_vector(velocities_A.linear, lane);
+			A->angular_velocity = scatter_vector(velocities_A.angular, lane);
+			A->biased_linear_velocity = scatter_vector(velocities_A.biased_linear, lane);
+			A->biased_angular_velocity = scatter_vector(velocities_A.biased_angular, lane);
+		}
+		if (pair->collide_B) {
+			GodotBody3D *B = pair->B;
+			B->linear_velocity = scatter_vector(velocities_B.linear, lane);
+			B->angular_velocity = scatter_vector(velocities_B.angular, lane);
+			B->biased_linear_velocity = scatter_vector(velocities_B.biased_linear, lane);
+			B->biased_angular_velocity = scatter_vector(velocities_B.biased_angular, lane);
+		}
+	}
+}
+
+void GodotContactSolver3D::solve() {
+	for (uint32_t batch_index = 0; batch_index < batch_count; batch_index++) {
+		solve_batch(batch_index);
+	}
+}
+
+void GodotContactSolver3D::finish() {
+	for (uint32_t batch_index = 0; batch_index < batch_count; batch_index++) {
+		const Batch &batch = batches[batch_index];
+		for (int lane = 0; lane < batch.lane_count; lane++) {
+			GodotBodyPair3D *pair = batch.pairs[lane];
+			for (int i = 0; i < pair->contact_count; i++) {
+				GodotBodyPair3D::Contact &c = pair->contacts[i];
+				const ContactRow &row = batch.rows[i];
+
+				c.acc_bias_impulse = row.acc_bias_impulse[lane];
+				c.acc_bias_impulse_center_of_mass = row.acc_bias_impulse_center_of_mass[lane];
+				c.acc_normal_impulse = row.acc_normal_impulse[lane];
+				c.acc_tangent_impulse = scatter_vector(row.acc_tangent_impulse, lane);
+				c.acc_impulse = scatter_vector(row.acc_impulse, lane);
+				c.active = row.active[lane] != 0.0f;
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*  godot_contact_solver_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "godot_body_pair_3d.h"
+
+#include "core/math/simd_float4.h"
+#include "core/templates/local_vector.h"
+
+// Solves the contacts of body pairs four at a time. Contacts are gathered into
+// batches stored as structures of arrays, where each lane of a batch holds a
+// different pair, and no two lanes apply impulses to the same body. Velocities
+// are read from the bodies at the start of each batch and written back at the
+// end, so the solver can be interleaved with the scalar constraints (joints).
+class GodotContactSolver3D {
+	static constexpr int LANES = SIMDFloat4::LANES;
+	static constexpr int MAX_CONTACTS = GodotBodyPair3D::MAX_CONTACTS;
+
+	struct ContactRow {
+		float rA[3][LANES];
+		float rB[3][LANES];
+		float normal[3][LANES];
+		float bias[LANES];
+		float bounce[LANES];
+		float mass_normal[LANES];
+		float acc_bias_impulse[LANES];
+		float acc_bias_impulse_center_of_mass[LANES];
+		float acc_normal_impulse[LANES];
+		float acc_tangent_impulse[3][LANES];
+		float acc_impulse[3][LANES];
+		float active[LANES]; // 1.0 while the contact still needs solving.
+	};
+
+	struct Batch {
+		GodotBodyPair3D *pairs[LANES] = {};
+		int lane_count = 0;
+		int row_count = 0;
+
+		float inv_mass_A[LANES];
+		float inv_mass_B[LANES];
+		float inv_inertia_A[9][LANES];
+		float inv_inertia_B[9][LANES];
+		float friction[LANES];
+
+		ContactRow rows[MAX_CONTACTS];
+	};
+
+	LocalVector<Batch> batches;
+	uint32_t batch_count = 0;
+	uint32_t open_batch_begin = 0;
+	real_t step = 0.0;
+
+	static bool _writes_body(const GodotBody3D *p_body);
+	bool _can_add_to_batch(const Batch &p_batch, const GodotBodyPair3D *p_pair) const;
+	void _add_to_batch(Batch &p_batch, GodotBodyPair3D *p_pair);
+
+public:
+	// Moves the colliding body pairs of p_constraints into batches, and keeps the
+	// other constraints in p_constraints. Returns true if any pair was added.
+	bool setup(LocalVector<GodotConstraint3D *> &p_constraints, real_t p_step);
+
+	_FORCE_INLINE_ uint32_t get_batch_count() const { return batch_count; }
+
+	// Runs one solver iteration on a batch. Batches may share bodies, so they
+	// must be solved serially unless they come from the same island color.
+	void solve_batch(uint32_t p_batch_index);
+	void solve();
+
+	// Stores the accumulated impulses back into the contacts of the pairs.
+	void finish();
+};
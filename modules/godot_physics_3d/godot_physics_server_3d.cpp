@@ -38,8 +38,10 @@
 #include "joints/godot_pin_joint_3d.h"
 #include "joints/godot_slider_joint_3d.h"
 
+#include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
 #include "core/os/os.h"
+#include "main/performance.h"
 
 #define FLUSH_QUERY_CHECK(m_object) \
 	ERR_FAIL_COND_MSG(m_object->get_space() && flushing_queries, "Can't change this state while flushing queries. Use call_deferred() or set_deferred() to change monitoring state instead.");
@@ -196,6 +198,22 @@ PhysicsDirectSpaceState3D *GodotPhysicsServer3D::space_get_direct_state(RID p_sp
 	return space->get_direct_state();
 }
 
+PackedByteArray GodotPhysicsServer3D::space_save_state(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), PackedByteArray(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	return space->save_state();
+}
+
+bool GodotPhysicsServer3D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, false);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), false, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	return space->restore_state(p_state);
+}
+
 void GodotPhysicsServer3D::space_set_debug_contacts(RID p_space, int p_max_contacts) {
 	GodotSpace3D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_NULL(space);
@@ -1667,8 +1685,42 @@ void GodotPhysicsServer3D::set_active(bool p_active) {
 	active = p_active;
 }
 
+struct GodotPhysics3DMonitor {
+	const char *name;
+	PhysicsServer3D::ProcessInfo info;
+	Performance::MonitorType type;
+};
+
+static const GodotPhysics3DMonitor statistics_monitors[] = {
+	{ "physics_3d/broadphase_time", PhysicsServer3D::INFO_BROADPHASE_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/pair_generation_time", PhysicsServer3D::INFO_PAIR_GENERATION_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/narrowphase_time", PhysicsServer3D::INFO_NARROWPHASE_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/island_generation_time", PhysicsServer3D::INFO_ISLAND_GENERATION_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/solve_time", PhysicsServer3D::INFO_SOLVE_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/integration_time", PhysicsServer3D::INFO_INTEGRATION_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/callback_time", PhysicsServer3D::INFO_CALLBACK_TIME, Performance::MONITOR_TYPE_TIME },
+	{ "physics_3d/contact_count", PhysicsServer3D::INFO_CONTACT_COUNT, Performance::MONITOR_TYPE_QUANTITY },
+	{ "physics_3d/gjk_query_count", PhysicsServer3D::INFO_GJK_QUERY_COUNT, Performance::MONITOR_TYPE_QUANTITY },
+	{ "physics_3d/max_island_size", PhysicsServer3D::INFO_MAX_ISLAND_SIZE, Performance::MONITOR_TYPE_QUANTITY },
+};
+
+double GodotPhysicsServer3D::_get_statistics_monitor(int p_monitor) {
+	const GodotPhysics3DMonitor &monitor = statistics_monitors[p_monitor];
+	const int value = get_process_info(monitor.info);
+	// Times are reported in microseconds, monitors use seconds.
+	return monitor.type == Performance::MONITOR_TYPE_TIME ? USEC_TO_SEC(value) : value;
+}
+
 void GodotPhysicsServer3D::init() {
 	stepper = memnew(GodotStep3D);
+	statistics_enabled = GLOBAL_GET("physics/3d/performance_monitors");
+
+	// Only this server measures these, so it registers the monitors itself.
+	if (statistics_enabled && Performance::get_singleton()) {
+		for (uint32_t i = 0; i < std_size(statistics_monitors); i++) {
+			Performance::get_singleton()->add_custom_monitor(statistics_monitors[i].name, callable_mp(this, &GodotPhysicsServer3D::_get_statistics_monitor), varray(i), statistics_monitors[i].type);
+		}
+	}
 }
 
 void GodotPhysicsServer3D::step(real_t p_step) {
@@ -1678,15 +1730,44 @@ void GodotPhysicsServer3D::step(real_t p_step) {
 
 	_update_shapes();
 
+	// GJK iterations cost a counter update per query and pair generation two clock reads per pair,
+	// so they're only measured when needed.
+	const bool measure_statistics = statistics_enabled || EngineDebugger::is_profiling("servers");
+	gjk_epa_set_statistics_enabled(measure_statistics);
+
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	contact_count = 0;
+	max_island_size = 0;
+	for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
+		elapsed_time[i] = 0;
+	}
+	for (int i = 0; i < GodotSpace3D::ISLAND_SIZE_BUCKETS; i++) {
+		island_size_histogram[i] = 0;
+	}
+	for (int i = 0; i < GJK_EPA_ITERATION_BUCKETS; i++) {
+		gjk_iteration_histogram[i] = 0;
+	}
+
 	for (GodotSpace3D *E : active_spaces) {
+		E->set_pair_generation_timed(measure_statistics);
 		stepper->step(E, p_step);
 		island_count += E->get_island_count();
 		active_objects += E->get_active_objects();
 		collision_pairs += E->get_collision_pairs();
+		contact_count += E->get_contact_count();
+		max_island_size = MAX(max_island_size, E->get_max_island_size());
+		for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
+			elapsed_time[i] += E->get_elapsed_time(GodotSpace3D::ElapsedTime(i));
+		}
+		const uint32_t *space_island_sizes = E->get_island_size_histogram();
+		for (int i = 0; i < GodotSpace3D::ISLAND_SIZE_BUCKETS; i++) {
+			island_size_histogram[i] += space_island_sizes[i];
+		}
 	}
+
+	gjk_epa_take_iteration_histogram(gjk_iteration_histogram);
 }
 
 void GodotPhysicsServer3D::sync() {
@@ -1709,34 +1790,27 @@ void GodotPhysicsServer3D::flush_queries() {
 
 	flushing_queries = false;
 
+	callback_time = OS::get_singleton()->get_ticks_usec() - time_beg;
+
 	if (EngineDebugger::is_profiling("servers")) {
-		uint64_t total_time[GodotSpace3D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace3D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broadphase",
+			"pair_generation",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
 			"integrate_velocities"
 		};
 
-		for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
-			total_time[i] = 0;
-		}
-
-		for (const GodotSpace3D *E : active_spaces) {
-			for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
-				total_time[i] += E->get_elapsed_time(GodotSpace3D::ElapsedTime(i));
-			}
-		}
-
 		Array values;
 		values.resize(GodotSpace3D::ELAPSED_TIME_MAX * 2);
 		for (int i = 0; i < GodotSpace3D::ELAPSED_TIME_MAX; i++) {
 			values[i * 2 + 0] = time_name[i];
-			values[i * 2 + 1] = USEC_TO_SEC(total_time[i]);
+			values[i * 2 + 1] = USEC_TO_SEC(elapsed_time[i]);
 		}
 		values.push_back("flush_queries");
-		values.push_back(USEC_TO_SEC(OS::get_singleton()->get_ticks_usec() - time_beg));
+		values.push_back(USEC_TO_SEC(callback_time));
 
 		values.push_front("physics_3d");
 		EngineDebugger::profiler_add_frame_data("servers", values);
@@ -1748,6 +1822,14 @@ void GodotPhysicsServer3D::end_sync() {
 }
 
 void GodotPhysicsServer3D::finish() {
+	if (Performance::get_singleton()) {
+		for (const GodotPhysics3DMonitor &monitor : statistics_monitors) {
+			if (Performance::get_singleton()->has_custom_monitor(monitor.name)) {
+				Performance::get_singleton()->remove_custom_monitor(monitor.name);
+			}
+		}
+	}
+
 	memdelete(stepper);
 }
 
@@ -1762,11 +1844,64 @@ int GodotPhysicsServer3D::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_BROADPHASE_TIME: {
+			return elapsed_time[GodotSpace3D::ELAPSED_TIME_BROADPHASE];
+		} break;
+		case INFO_PAIR_GENERATION_TIME: {
+			return elapsed_time[GodotSpace3D::ELAPSED_TIME_PAIR_GENERATION];
+		} break;
+		case INFO_NARROWPHASE_TIME: {
+			return elapsed_time[GodotSpace3D::ELAPSED_TIME_SETUP_CONSTRAINTS];
+		} break;
+		case INFO_ISLAND_GENERATION_TIME: {
+			return elapsed_time[GodotSpace3D::ELAPSED_TIME_GENERATE_ISLANDS];
+		} break;
+		case INFO_SOLVE_TIME: {
+			return elapsed_time[GodotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS];
+		} break;
+		case INFO_INTEGRATION_TIME: {
+			return elapsed_time[GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES] + elapsed_time[GodotSpace3D::ELAPSED_TIME_INTEGRATE_VELOCITIES];
+		} break;
+		case INFO_CALLBACK_TIME: {
+			return callback_time;
+		} break;
+		case INFO_CONTACT_COUNT: {
+			return contact_count;
+		} break;
+		case INFO_GJK_QUERY_COUNT: {
+			uint32_t query_count = 0;
+			for (int i = 0; i < GJK_EPA_ITERATION_BUCKETS; i++) {
+				query_count += gjk_iteration_histogram[i];
+			}
+			return query_count;
+		} break;
+		case INFO_MAX_ISLAND_SIZE: {
+			return max_island_size;
+		} break;
 	}
 
 	return 0;
 }
 
+PackedInt32Array GodotPhysicsServer3D::get_process_histogram(ProcessHistogram p_histogram) {
+	PackedInt32Array histogram;
+	switch (p_histogram) {
+		case HISTOGRAM_GJK_ITERATIONS: {
+			histogram.resize(GJK_EPA_ITERATION_BUCKETS);
+			for (int i = 0; i < GJK_EPA_ITERATION_BUCKETS; i++) {
+				histogram.write[i] = gjk_iteration_histogram[i];
+			}
+		} break;
+		case HISTOGRAM_ISLAND_SIZE: {
+			histogram.resize(GodotSpace3D::ISLAND_SIZE_BUCKETS);
+			for (int i = 0; i < GodotSpace3D::ISLAND_SIZE_BUCKETS; i++) {
+				histogram.write[i] = island_size_histogram[i];
+			}
+		} break;
+	}
+	return histogram;
+}
+
 void GodotPhysicsServer3D::_update_shapes() {
 	while (pending_shape_update_list.first()) {
 		pending_shape_update_list.first()->self()->_shape_changed();
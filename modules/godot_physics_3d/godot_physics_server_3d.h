@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "gjk_epa.h"
 #include "godot_joint_3d.h"
 #include "godot_shape_3d.h"
 #include "godot_space_3d.h"
@@ -48,6 +49,17 @@ class GodotPhysicsServer3D : public PhysicsServer3D {
 	int active_objects = 0;
 	int collision_pairs = 0;
 
+	// Statistics of the last step, summed over the active spaces.
+	uint64_t elapsed_time[GodotSpace3D::ELAPSED_TIME_MAX] = {};
+	uint64_t callback_time = 0;
+	int contact_count = 0;
+	uint32_t max_island_size = 0;
+	uint32_t island_size_histogram[GodotSpace3D::ISLAND_SIZE_BUCKETS] = {};
+	uint32_t gjk_iteration_histogram[GJK_EPA_ITERATION_BUCKETS] = {};
+	bool statistics_enabled = false;
+
+	double _get_statistics_monitor(int p_monitor);
+
 	bool using_threads = false;
 	bool doing_sync = false;
 	bool flushing_queries = false;
@@ -111,6 +123,8 @@ public:
 
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState3D *space_get_direct_state(RID p_space) override;
+	virtual PackedByteArray space_save_state(RID p_space) const override;
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override;
 
 	virtual void space_set_debug_contacts(RID p_space, int p_max_contacts) override;
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
@@ -384,6 +398,7 @@ public:
 	virtual bool is_flushing_queries() const override { return flushing_queries; }
 
 	int get_process_info(ProcessInfo p_info) override;
+	PackedInt32Array get_process_histogram(ProcessHistogram p_histogram) override;
 
 	GodotPhysicsServer3D(bool p_using_threads = false);
 	~GodotPhysicsServer3D() {}
@@ -112,6 +112,42 @@ GodotShape3D::~GodotShape3D() {
 	ERR_FAIL_COND(owners.size());
 }
 
+SafeNumeric<uint64_t> GodotConcaveShape3D::cull_cache_version_counter;
+
+bool GodotConcaveShape3D::_cull_cache_begin(const AABB &p_local_aabb, CullCache &r_cache) const {
+	if (r_cache.shape == this && r_cache.version == cull_cache_version && r_cache.expanded_aabb.encloses(p_local_aabb)) {
+		return false;
+	}
+
+	r_cache.shape = this;
+	r_cache.version = cull_cache_version;
+	r_cache.expanded_aabb = p_local_aabb.grow(p_local_aabb.get_longest_axis_size() * CULL_CACHE_EXPANSION);
+	r_cache.triangles.clear();
+	for (int i = 0; i < 3; i++) {
+		r_cache.bounds_min[i].clear();
+		r_cache.bounds_max[i].clear();
+	}
+	return true;
+}
+
+void GodotConcaveShape3D::_cull_cache_add(CullCache &r_cache, uint32_t p_triangle, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) {
+	r_cache.triangles.push_back(p_triangle);
+	for (int i = 0; i < 3; i++) {
+		r_cache.bounds_min[i].push_back(_cull_cache_round_down(MIN(p_a[i], MIN(p_b[i], p_c[i]))));
+		r_cache.bounds_max[i].push_back(_cull_cache_round_up(MAX(p_a[i], MAX(p_b[i], p_c[i]))));
+	}
+}
+
+void GodotConcaveShape3D::_cull_cache_end(CullCache &r_cache) {
+	// Padding lanes have inverted bounds, which never overlap anything.
+	while (r_cache.bounds_min[0].size() % SIMDFloat4::LANES) {
+		for (int i = 0; i < 3; i++) {
+			r_cache.bounds_min[i].push_back(FLT_MAX);
+			r_cache.bounds_max[i].push_back(-FLT_MAX);
+		}
+	}
+}
+
 Plane GodotWorldBoundaryShape3D::get_plane() const {
 	return plane;
 }
@@ -249,21 +285,6 @@ real_t GodotSphereShape3D::get_radius() const {
 	return radius;
 }
 
-void GodotSphereShape3D::project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const {
-	real_t d = p_normal.dot(p_transform.origin);
-
-	// figure out scale at point
-	Vector3 local_normal = p_transform.basis.xform_inv(p_normal);
-	real_t scale = local_normal.length();
-
-	r_min = d - (radius)*scale;
-	r_max = d + (radius)*scale;
-}
-
-Vector3 GodotSphereShape3D::get_support(const Vector3 &p_normal) const {
-	return p_normal * radius;
-}
-
 void GodotSphereShape3D::get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const {
 	*r_supports = p_normal * radius;
 	r_amount = 1;
@@ -309,26 +330,6 @@ GodotSphereShape3D::GodotSphereShape3D() {}
 
 /********** BOX *************/
 
-void GodotBoxShape3D::project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const {
-	// no matter the angle, the box is mirrored anyway
-	Vector3 local_normal = p_transform.basis.xform_inv(p_normal);
-
-	real_t length = local_normal.abs().dot(half_extents);
-	real_t distance = p_normal.dot(p_transform.origin);
-
-	r_min = distance - length;
-	r_max = distance + length;
-}
-
-Vector3 GodotBoxShape3D::get_support(const Vector3 &p_normal) const {
-	Vector3 point(
-			(p_normal.x < 0) ? -half_extents.x : half_extents.x,
-			(p_normal.y < 0) ? -half_extents.y : half_extents.y,
-			(p_normal.z < 0) ? -half_extents.z : half_extents.z);
-
-	return point;
-}
-
 void GodotBoxShape3D::get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const {
 	static const int next[3] = { 1, 2, 0 };
 	static const int next2[3] = { 2, 0, 1 };
@@ -493,27 +494,6 @@ GodotBoxShape3D::GodotBoxShape3D() {}
 
 /********** CAPSULE *************/
 
-void GodotCapsuleShape3D::project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const {
-	Vector3 n = p_transform.basis.xform_inv(p_normal).normalized();
-	real_t h = height * 0.5 - radius;
-
-	n *= radius;
-	n.y += (n.y > 0) ? h : -h;
-
-	r_max = p_normal.dot(p_transform.xform(n));
-	r_min = p_normal.dot(p_transform.xform(-n));
-}
-
-Vector3 GodotCapsuleShape3D::get_support(const Vector3 &p_normal) const {
-	Vector3 n = p_normal;
-
-	real_t h = height * 0.5 - radius;
-
-	n *= radius;
-	n.y += (n.y > 0) ? h : -h;
-	return n;
-}
-
 void GodotCapsuleShape3D::get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const {
 	Vector3 n = p_normal;
 
@@ -1330,42 +1310,21 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+void GodotConcavePolygonShape3D::_quantize_aabb(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max) const {
+	const Vector3 from = (p_aabb.position - bvh_origin) * bvh_scale;
+	const Vector3 to = (p_aabb.get_end() - bvh_origin) * bvh_scale;
 
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
+	// One extra step on each side absorbs the rounding errors of the conversion.
+	for (int i = 0; i < 3; i++) {
+		r_min[i] = (uint16_t)CLAMP(Math::floor(from[i]) - 1, (real_t)0, (real_t)UINT16_MAX);
+		r_max[i] = (uint16_t)CLAMP(Math::ceil(to[i]) + 1, (real_t)0, (real_t)UINT16_MAX);
 	}
+}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		int face_index = params_bvh->face_index;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, face_index, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->face_index = face_index;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
-		}
-	}
+AABB GodotConcavePolygonShape3D::_dequantize_aabb(const BVH &p_node) const {
+	const Vector3 from = bvh_origin + Vector3(p_node.min[0], p_node.min[1], p_node.min[2]) * bvh_inv_scale;
+	const Vector3 to = bvh_origin + Vector3(p_node.max[0], p_node.max[1], p_node.max[2]) * bvh_inv_scale;
+	return AABB(from, to - from);
 }
 
 bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const {
@@ -1377,28 +1336,56 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
+	const int bvh_count = bvh.size();
 
 	GodotFaceShape3D face;
 	face.backface_collision = backface_collision && p_hit_back_faces;
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.dir = (p_end - p_begin).normalized();
+	const Vector3 dir = (p_end - p_begin).normalized();
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	Vector3 result;
+	Vector3 normal;
+	int result_face_index = -1;
+	real_t min_d = 1e20;
+	int collisions = 0;
 
-	params.face = &face;
+	int idx = 0;
+	while (idx < bvh_count) {
+		const BVH &node = br[idx];
 
-	// cull
-	_cull_segment(0, &params);
+		if (!_dequantize_aabb(node).intersects_segment(p_begin, p_end)) {
+			idx = node.link >= 0 ? node.link : idx + 1;
+			continue;
+		}
+
+		if (node.link < 0) {
+			int face_index = -1 - node.link;
+			const Face *f = &fr[face_index];
+			face.normal = f->normal;
+			face.vertex[0] = vr[f->indices[0]];
+			face.vertex[1] = vr[f->indices[1]];
+			face.vertex[2] = vr[f->indices[2]];
+
+			Vector3 res;
+			Vector3 res_normal;
+			if (face.intersect_segment(p_begin, p_end, res, res_normal, face_index, true)) {
+				real_t d = dir.dot(res) - dir.dot(p_begin);
+				if ((d > 0) && (d < min_d)) {
+					min_d = d;
+					result = res;
+					normal = res_normal;
+					result_face_index = face_index;
+					collisions++;
+				}
+			}
+		}
+		idx++;
+	}
 
-	if (params.collisions > 0) {
-		r_result = params.result;
-		r_normal = params.normal;
-		r_face_index = params.face_index;
+	if (collisions > 0) {
+		r_result = result;
+		r_normal = normal;
+		r_face_index = result_face_index;
 		return true;
 	} else {
 		return false;
@@ -1413,68 +1400,97 @@ Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point)
 	return Vector3();
 }
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
-
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
-		return false;
+template <typename ProcessFunction>
+void GodotConcavePolygonShape3D::_cull_faces(const AABB &p_local_aabb, ProcessFunction &p_process) const {
+	if (faces.is_empty() || !p_local_aabb.intersects(get_aabb())) {
+		return;
 	}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
-			}
+	// unlock data
+	const Face *fr = faces.ptr();
+	const Vector3 *vr = vertices.ptr();
+	const BVH *br = bvh.ptr();
+	const int bvh_count = bvh.size();
+
+	uint16_t aabb_min[3];
+	uint16_t aabb_max[3];
+	_quantize_aabb(p_local_aabb, aabb_min, aabb_max);
+
+	int idx = 0;
+	while (idx < bvh_count) {
+		const BVH &node = br[idx];
+
+		if (node.min[0] > aabb_max[0] || node.max[0] < aabb_min[0] ||
+				node.min[1] > aabb_max[1] || node.max[1] < aabb_min[1] ||
+				node.min[2] > aabb_max[2] || node.max[2] < aabb_min[2]) {
+			idx = node.link >= 0 ? node.link : idx + 1;
+			continue;
 		}
 
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
+		if (node.link < 0) {
+			// Quantized bounds are loose, test the face bounds exactly.
+			const int face_index = -1 - node.link;
+			const Face &f = fr[face_index];
+			const Vector3 &a = vr[f.indices[0]];
+			const Vector3 &b = vr[f.indices[1]];
+			const Vector3 &c = vr[f.indices[2]];
+
+			AABB face_aabb(a, Vector3());
+			face_aabb.expand_to(b);
+			face_aabb.expand_to(c);
+			if (p_local_aabb.intersects(face_aabb) && p_process(face_index, a, b, c)) {
+				return;
 			}
 		}
+		idx++;
 	}
-
-	return false;
 }
 
 void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
-	// make matrix local to concave
+	GodotFaceShape3D face; // use this to send in the callback
+	face.backface_collision = backface_collision;
+	face.invert_backface_collision = p_invert_backface_collision;
+
+	const Face *fr = faces.ptr();
+	auto process = [&](int p_face_index, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) -> bool {
+		face.normal = fr[p_face_index].normal;
+		face.vertex[0] = p_a;
+		face.vertex[1] = p_b;
+		face.vertex[2] = p_c;
+		return p_callback(p_userdata, &face);
+	};
+	_cull_faces(p_local_aabb, process);
+}
+
+void GodotConcavePolygonShape3D::cull_cached(const AABB &p_local_aabb, CullCache &r_cache, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
 	if (faces.is_empty()) {
 		return;
 	}
 
-	AABB local_aabb = p_local_aabb;
-
-	// unlock data
-	const Face *fr = faces.ptr();
-	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
+	if (_cull_cache_begin(p_local_aabb, r_cache)) {
+		auto add = [&](int p_face_index, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) -> bool {
+			_cull_cache_add(r_cache, p_face_index, p_a, p_b, p_c);
+			return false;
+		};
+		_cull_faces(r_cache.expanded_aabb, add);
+		_cull_cache_end(r_cache);
+	}
 
-	GodotFaceShape3D face; // use this to send in the callback
+	GodotFaceShape3D face;
 	face.backface_collision = backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
-	params.callback = p_callback;
-	params.userdata = p_userdata;
-
-	// cull
-	_cull(0, &params);
+	const Face *fr = faces.ptr();
+	const Vector3 *vr = vertices.ptr();
+	auto process = [&](uint32_t p_face_index) -> bool {
+		const Face &f = fr[p_face_index];
+		face.normal = f.normal;
+		face.vertex[0] = vr[f.indices[0]];
+		face.vertex[1] = vr[f.indices[1]];
+		face.vertex[2] = vr[f.indices[2]];
+		return p_callback(p_userdata, &face);
+	};
+	_cull_cache_query(r_cache, p_local_aabb, process);
 }
 
 Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -1571,24 +1587,17 @@ _Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int
 void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
 	int idx = p_idx;
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
-
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	_quantize_aabb(p_bvh_tree->aabb, p_bvh_array[idx].min, p_bvh_array[idx].max);
 
+	if (p_bvh_tree->face_index >= 0) {
+		p_bvh_array[idx].link = -1 - p_bvh_tree->face_index;
 	} else {
-		p_bvh_array[p_idx].left = -1;
-	}
-
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
+		// Branches always have both children.
+		++p_idx;
+		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+		++p_idx;
 		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].right = -1;
+		p_bvh_array[idx].link = p_idx + 1;
 	}
 
 	memdelete(p_bvh_tree);
@@ -1639,10 +1648,16 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 		}
 	}
 
+	bvh_origin = _aabb.position;
+	for (int i = 0; i < 3; i++) {
+		bvh_scale[i] = _aabb.size[i] > 0.0 ? UINT16_MAX / _aabb.size[i] : 0.0;
+		bvh_inv_scale[i] = _aabb.size[i] / UINT16_MAX;
+	}
+
 	int count = 0;
 	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
 
-	bvh.resize(count + 1);
+	bvh.resize(count);
 
 	BVH *bvh_arrayw2 = bvh.ptrw();
 
@@ -1651,6 +1666,7 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 
 	backface_collision = p_backface_collision;
 
+	_invalidate_cull_caches();
 	configure(_aabb); // this type of shape has no margin
 }
 
@@ -2012,11 +2028,7 @@ void GodotHeightMapShape3D::_get_cell(const Vector3 &p_point, int &r_x, int &r_y
 	r_z = (clamped_point.z < 0.0) ? (clamped_point.z - 0.5) : (clamped_point.z + 0.5);
 }
 
-void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
-	if (heights.is_empty()) {
-		return;
-	}
-
+void GodotHeightMapShape3D::_get_cell_range(const AABB &p_local_aabb, int &r_start_x, int &r_end_x, int &r_start_z, int &r_end_z) const {
 	AABB local_aabb = p_local_aabb;
 	local_aabb.position += local_origin;
 
@@ -2033,37 +2045,107 @@ void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callb
 		aabb_max[i]++;
 	}
 
-	int start_x = MAX(0, aabb_min[0]);
-	int end_x = MIN(width - 1, aabb_max[0]);
-	int start_z = MAX(0, aabb_min[2]);
-	int end_z = MIN(depth - 1, aabb_max[2]);
+	r_start_x = MAX(0, aabb_min[0]);
+	r_end_x = MIN(width - 1, aabb_max[0]);
+	r_start_z = MAX(0, aabb_min[2]);
+	r_end_z = MIN(depth - 1, aabb_max[2]);
+}
+
+void GodotHeightMapShape3D::_get_triangle(uint32_t p_triangle, Vector3 *r_vertices) const {
+	// Each cell holds two triangles, see cull().
+	const uint32_t cell = p_triangle / 2;
+	const int x = cell % (width - 1);
+	const int z = cell / (width - 1);
+
+	if (p_triangle % 2 == 0) {
+		_get_point(x, z, r_vertices[0]);
+		_get_point(x + 1, z, r_vertices[1]);
+		_get_point(x, z + 1, r_vertices[2]);
+	} else {
+		_get_point(x + 1, z, r_vertices[0]);
+		_get_point(x + 1, z + 1, r_vertices[1]);
+		_get_point(x, z + 1, r_vertices[2]);
+	}
+}
+
+void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
+	if (heights.is_empty()) {
+		return;
+	}
+
+	int start_x, end_x, start_z, end_z;
+	_get_cell_range(p_local_aabb, start_x, end_x, start_z, end_z);
 
 	GodotFaceShape3D face;
 	face.backface_collision = !p_invert_backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
+	// Like cull_cached(), only the triangles whose bounds overlap p_local_aabb are reported.
+	auto process = [&]() -> bool {
+		AABB bounds(face.vertex[0], Vector3());
+		bounds.expand_to(face.vertex[1]);
+		bounds.expand_to(face.vertex[2]);
+		if (!p_local_aabb.intersects(bounds)) {
+			return false;
+		}
+		face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+		return p_callback(p_userdata, &face);
+	};
+
 	for (int z = start_z; z < end_z; z++) {
 		for (int x = start_x; x < end_x; x++) {
 			// First triangle.
 			_get_point(x, z, face.vertex[0]);
 			_get_point(x + 1, z, face.vertex[1]);
 			_get_point(x, z + 1, face.vertex[2]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
+			if (process()) {
 				return;
 			}
 
 			// Second triangle.
 			face.vertex[0] = face.vertex[1];
 			_get_point(x + 1, z + 1, face.vertex[1]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
+			if (process()) {
 				return;
 			}
 		}
 	}
 }
 
+void GodotHeightMapShape3D::cull_cached(const AABB &p_local_aabb, CullCache &r_cache, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
+	if (heights.is_empty()) {
+		return;
+	}
+
+	if (_cull_cache_begin(p_local_aabb, r_cache)) {
+		int start_x, end_x, start_z, end_z;
+		_get_cell_range(r_cache.expanded_aabb, start_x, end_x, start_z, end_z);
+
+		Vector3 vertices[3];
+		for (int z = start_z; z < end_z; z++) {
+			for (int x = start_x; x < end_x; x++) {
+				const uint32_t triangle = ((z * (width - 1)) + x) * 2;
+				_get_triangle(triangle, vertices);
+				_cull_cache_add(r_cache, triangle, vertices[0], vertices[1], vertices[2]);
+				_get_triangle(triangle + 1, vertices);
+				_cull_cache_add(r_cache, triangle + 1, vertices[0], vertices[1], vertices[2]);
+			}
+		}
+		_cull_cache_end(r_cache);
+	}
+
+	GodotFaceShape3D face;
+	face.backface_collision = !p_invert_backface_collision;
+	face.invert_backface_collision = p_invert_backface_collision;
+
+	auto process = [&](uint32_t p_triangle) -> bool {
+		_get_triangle(p_triangle, face.vertex);
+		face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+		return p_callback(p_userdata, &face);
+	};
+	_cull_cache_query(r_cache, p_local_aabb, process);
+}
+
 Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
 	// use bad AABB approximation
 	Vector3 extents = get_aabb().size * 0.5;
@@ -2160,6 +2242,7 @@ void GodotHeightMapShape3D::_setup(const Vector<real_t> &p_heights, int p_width,
 	aabb_new.position -= local_origin;
 
 	_build_accelerator();
+	_invalidate_cull_caches();
 
 	configure(aabb_new);
 }
@@ -31,7 +31,9 @@
 #pragma once
 
 #include "core/math/geometry_3d.h"
+#include "core/math/simd_float4.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/physics_3d/physics_server_3d.h"
 
 class GodotShape3D;
@@ -99,6 +101,9 @@ public:
 };
 
 class GodotConcaveShape3D : public GodotShape3D {
+	static SafeNumeric<uint64_t> cull_cache_version_counter;
+	uint64_t cull_cache_version = 0;
+
 public:
 	virtual bool is_concave() const override { return true; }
 	virtual void get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const override { r_amount = 0; }
@@ -108,6 +113,91 @@ public:
 
 	virtual void cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const = 0;
 
+	// Triangles overlapping expanded_aabb, found by a previous cull_cached() call.
+	// Bounds are stored as structures of arrays, padded with empty bounds to a
+	// multiple of SIMDFloat4::LANES.
+	struct CullCache {
+		const GodotConcaveShape3D *shape = nullptr;
+		uint64_t version = 0;
+		AABB expanded_aabb;
+		LocalVector<uint32_t> triangles;
+		LocalVector<float> bounds_min[3];
+		LocalVector<float> bounds_max[3];
+	};
+
+	// How much the region cached by cull_cached() is grown past the queried AABB,
+	// relative to the longest axis of the queried AABB.
+	static constexpr real_t CULL_CACHE_EXPANSION = 0.5;
+
+	// Same as cull(), but moving bodies that query the same shape every step
+	// can keep a cache, which is only refilled once their AABB leaves the region
+	// cached by the previous fill.
+	virtual void cull_cached(const AABB &p_local_aabb, CullCache &r_cache, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
+		cull(p_local_aabb, p_callback, p_userdata, p_invert_backface_collision);
+	}
+
+protected:
+	// Makes the caches filled with the previous data refill on their next query.
+	void _invalidate_cull_caches() { cull_cache_version = cull_cache_version_counter.increment(); }
+
+	// Returns true if r_cache can't answer a query for p_local_aabb, in which case
+	// it's cleared and the triangles overlapping r_cache.expanded_aabb must be
+	// added with _cull_cache_add(), followed by _cull_cache_end().
+	bool _cull_cache_begin(const AABB &p_local_aabb, CullCache &r_cache) const;
+	static void _cull_cache_add(CullCache &r_cache, uint32_t p_triangle, const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c);
+	static void _cull_cache_end(CullCache &r_cache);
+
+	// The cached bounds are floats, rounded outwards when real_t is double so
+	// that they never cull a triangle the exact bounds would keep.
+	static _FORCE_INLINE_ float _cull_cache_round_down(real_t p_value) {
+#ifdef REAL_T_IS_DOUBLE
+		const float value = float(p_value);
+		return value > p_value ? std::nextafter(value, -FLT_MAX) : value;
+#else
+		return p_value;
+#endif
+	}
+	static _FORCE_INLINE_ float _cull_cache_round_up(real_t p_value) {
+#ifdef REAL_T_IS_DOUBLE
+		const float value = float(p_value);
+		return value < p_value ? std::nextafter(value, FLT_MAX) : value;
+#else
+		return p_value;
+#endif
+	}
+
+	// Calls p_process with each cached triangle whose bounds overlap
+	// p_local_aabb, testing four triangles at a time. Stops when it returns true.
+	template <typename ProcessFunction>
+	static void _cull_cache_query(const CullCache &r_cache, const AABB &p_local_aabb, ProcessFunction &p_process) {
+		const SIMDFloat4 aabb_min[3] = { SIMDFloat4(_cull_cache_round_down(p_local_aabb.position.x)), SIMDFloat4(_cull_cache_round_down(p_local_aabb.position.y)), SIMDFloat4(_cull_cache_round_down(p_local_aabb.position.z)) };
+		const Vector3 end = p_local_aabb.get_end();
+		const SIMDFloat4 aabb_max[3] = { SIMDFloat4(_cull_cache_round_up(end.x)), SIMDFloat4(_cull_cache_round_up(end.y)), SIMDFloat4(_cull_cache_round_up(end.z)) };
+
+		const uint32_t triangle_count = r_cache.triangles.size();
+		for (uint32_t i = 0; i < triangle_count; i += SIMDFloat4::LANES) {
+			// Same strict test as AABB::intersects().
+			SIMDFloat4 overlap = SIMDFloat4::mask_and(
+					SIMDFloat4::greater(SIMDFloat4::load(&r_cache.bounds_max[0][i]), aabb_min[0]),
+					SIMDFloat4::greater(aabb_max[0], SIMDFloat4::load(&r_cache.bounds_min[0][i])));
+			for (int axis = 1; axis < 3; axis++) {
+				overlap = SIMDFloat4::mask_and(overlap, SIMDFloat4::greater(SIMDFloat4::load(&r_cache.bounds_max[axis][i]), aabb_min[axis]));
+				overlap = SIMDFloat4::mask_and(overlap, SIMDFloat4::greater(aabb_max[axis], SIMDFloat4::load(&r_cache.bounds_min[axis][i])));
+			}
+
+			const int bits = SIMDFloat4::mask_bits(overlap);
+			if (bits == 0) {
+				continue;
+			}
+			for (int lane = 0; lane < SIMDFloat4::LANES; lane++) {
+				if ((bits & (1 << lane)) && p_process(r_cache.triangles[i + lane])) {
+					return;
+				}
+			}
+		}
+	}
+
+public:
 	GodotConcaveShape3D() {}
 };
 
@@ -164,7 +254,7 @@ public:
 	GodotSeparationRayShape3D();
 };
 
-class GodotSphereShape3D : public GodotShape3D {
+class GodotSphereShape3D final : public GodotShape3D {
 	real_t radius = 0.0;
 
 	void _setup(real_t p_radius);
@@ -176,8 +266,19 @@ public:
 
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_SPHERE; }
 
-	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
-	virtual Vector3 get_support(const Vector3 &p_normal) const override;
+	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override {
+		real_t d = p_normal.dot(p_transform.origin);
+
+		// figure out scale at point
+		Vector3 local_normal = p_transform.basis.xform_inv(p_normal);
+		real_t scale = local_normal.length();
+
+		r_min = d - radius * scale;
+		r_max = d + radius * scale;
+	}
+	virtual Vector3 get_support(const Vector3 &p_normal) const override {
+		return p_normal * radius;
+	}
 	virtual void get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const override;
 	virtual bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const override;
 	virtual bool intersect_point(const Vector3 &p_point) const override;
@@ -191,7 +292,7 @@ public:
 	GodotSphereShape3D();
 };
 
-class GodotBoxShape3D : public GodotShape3D {
+class GodotBoxShape3D final : public GodotShape3D {
 	Vector3 half_extents;
 	void _setup(const Vector3 &p_half_extents);
 
@@ -201,8 +302,24 @@ public:
 
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_BOX; }
 
-	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
-	virtual Vector3 get_support(const Vector3 &p_normal) const override;
+	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override {
+		// no matter the angle, the box is mirrored anyway
+		Vector3 local_normal = p_transform.basis.xform_inv(p_normal);
+
+		real_t length = local_normal.abs().dot(half_extents);
+		real_t distance = p_normal.dot(p_transform.origin);
+
+		r_min = distance - length;
+		r_max = distance + length;
+	}
+	virtual Vector3 get_support(const Vector3 &p_normal) const override {
+		Vector3 point(
+				(p_normal.x < 0) ? -half_extents.x : half_extents.x,
+				(p_normal.y < 0) ? -half_extents.y : half_extents.y,
+				(p_normal.z < 0) ? -half_extents.z : half_extents.z);
+
+		return point;
+	}
 	virtual void get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const override;
 	virtual bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const override;
 	virtual bool intersect_point(const Vector3 &p_point) const override;
@@ -216,7 +333,7 @@ public:
 	GodotBoxShape3D();
 };
 
-class GodotCapsuleShape3D : public GodotShape3D {
+class GodotCapsuleShape3D final : public GodotShape3D {
 	real_t height = 0.0;
 	real_t radius = 0.0;
 
@@ -230,8 +347,25 @@ public:
 
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_CAPSULE; }
 
-	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
-	virtual Vector3 get_support(const Vector3 &p_normal) const override;
+	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override {
+		Vector3 n = p_transform.basis.xform_inv(p_normal).normalized();
+		real_t h = height * 0.5 - radius;
+
+		n *= radius;
+		n.y += (n.y > 0) ? h : -h;
+
+		r_max = p_normal.dot(p_transform.xform(n));
+		r_min = p_normal.dot(p_transform.xform(-n));
+	}
+	virtual Vector3 get_support(const Vector3 &p_normal) const override {
+		Vector3 n = p_normal;
+
+		real_t h = height * 0.5 - radius;
+
+		n *= radius;
+		n.y += (n.y > 0) ? h : -h;
+		return n;
+	}
 	virtual void get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const override;
 	virtual bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const override;
 	virtual bool intersect_point(const Vector3 &p_point) const override;
@@ -245,7 +379,7 @@ public:
 	GodotCapsuleShape3D();
 };
 
-class GodotCylinderShape3D : public GodotShape3D {
+class GodotCylinderShape3D final : public GodotShape3D {
 	real_t height = 0.0;
 	real_t radius = 0.0;
 
@@ -274,7 +408,7 @@ public:
 	GodotCylinderShape3D();
 };
 
-struct GodotConvexPolygonShape3D : public GodotShape3D {
+struct GodotConvexPolygonShape3D final : public GodotShape3D {
 	Geometry3D::MeshData mesh;
 	LocalVector<int> extreme_vertices;
 	LocalVector<LocalVector<int>> vertex_neighbors;
@@ -315,46 +449,28 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
+	// Nodes are stored depth first, so the first child of a branch always follows
+	// it. Bounds are quantized to 16 bits within the shape AABB, rounded outwards.
 	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
-
-		int face_index = 0;
+		uint16_t min[3] = {};
+		uint16_t max[3] = {};
+		// Branches store the index of the node that follows their subtree, where
+		// traversal continues when they are culled. Leaves store -1 - face index.
+		int32_t link = 0;
 	};
 
 	Vector<BVH> bvh;
-
-	struct _CullParams {
-		AABB aabb;
-		QueryCallback callback = nullptr;
-		void *userdata = nullptr;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-	};
-
-	struct _SegmentCullParams {
-		Vector3 from;
-		Vector3 to;
-		Vector3 dir;
-		const Face *faces = nullptr;
-		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
-		GodotFaceShape3D *face = nullptr;
-
-		Vector3 result;
-		Vector3 normal;
-		int face_index = -1;
-		real_t min_d = 1e20;
-		int collisions = 0;
-	};
+	Vector3 bvh_origin;
+	Vector3 bvh_scale; // Local space to quantized space.
+	Vector3 bvh_inv_scale;
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
+	void _quantize_aabb(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max) const;
+	AABB _dequantize_aabb(const BVH &p_node) const;
+
+	template <typename ProcessFunction>
+	void _cull_faces(const AABB &p_local_aabb, ProcessFunction &p_process) const;
 
 	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
 
@@ -373,6 +489,7 @@ public:
 	virtual Vector3 get_closest_point_to(const Vector3 &p_point) const override;
 
 	virtual void cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const override;
+	virtual void cull_cached(const AABB &p_local_aabb, CullCache &r_cache, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const override;
 
 	virtual Vector3 get_moment_of_inertia(real_t p_mass) const override;
 
@@ -414,6 +531,8 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 	}
 
 	void _get_cell(const Vector3 &p_point, int &r_x, int &r_y, int &r_z) const;
+	void _get_cell_range(const AABB &p_local_aabb, int &r_start_x, int &r_end_x, int &r_start_z, int &r_end_z) const;
+	void _get_triangle(uint32_t p_triangle, Vector3 *r_vertices) const;
 
 	void _build_accelerator();
 
@@ -436,6 +555,7 @@ public:
 
 	virtual Vector3 get_closest_point_to(const Vector3 &p_point) const override;
 	virtual void cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const override;
+	virtual void cull_cached(const AABB &p_local_aabb, CullCache &r_cache, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const override;
 
 	virtual Vector3 get_moment_of_inertia(real_t p_mass) const override;
 
@@ -446,7 +566,7 @@ public:
 };
 
 //used internally
-struct GodotFaceShape3D : public GodotShape3D {
+struct GodotFaceShape3D final : public GodotShape3D {
 	Vector3 normal; //cache
 	Vector3 vertex[3];
 	bool backface_collision = false;
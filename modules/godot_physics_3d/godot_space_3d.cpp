@@ -34,13 +34,15 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "godot_area_pair_3d.h"
 #include "godot_body_pair_3d.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
 
-_FORCE_INLINE_ static bool _can_collide_with(GodotCollisionObject3D *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+_FORCE_INLINE_ static bool _can_collide_with(const GodotCollisionObject3D *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (!(p_object->get_collision_layer() & p_collision_mask)) {
 		return false;
 	}
@@ -107,6 +109,99 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
+// Closest hit found so far while testing the candidates of a ray.
+struct GodotRayCastState3D {
+	bool collided = false;
+	Vector3 point;
+	Vector3 normal;
+	int face_index = -1;
+	int shape = -1;
+	const GodotCollisionObject3D *object = nullptr;
+	real_t min_d = 1e10;
+};
+
+// Tests a single broadphase candidate of the ray. Returns false when no other
+// candidate needs to be tested, because the ray starts inside this one.
+static bool _intersect_ray_candidate(const PhysicsDirectSpaceState3D::RayParameters &p_parameters, const Vector3 &p_begin, const Vector3 &p_end, const Vector3 &p_normal, const GodotCollisionObject3D *p_col_obj, int p_shape_idx, GodotRayCastState3D &r_state) {
+	if (!_can_collide_with(p_col_obj, p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		return true;
+	}
+
+	if (p_parameters.pick_ray && !(p_col_obj->is_ray_pickable())) {
+		return true;
+	}
+
+	if (p_parameters.exclude.has(p_col_obj->get_self())) {
+		return true;
+	}
+
+	Transform3D inv_xform = p_col_obj->get_shape_inv_transform(p_shape_idx) * p_col_obj->get_inv_transform();
+
+	Vector3 local_from = inv_xform.xform(p_begin);
+	Vector3 local_to = inv_xform.xform(p_end);
+
+	const GodotShape3D *shape = p_col_obj->get_shape(p_shape_idx);
+
+	Vector3 shape_point, shape_normal;
+	int shape_face_index = -1;
+
+	if (shape->intersect_point(local_from)) {
+		if (p_parameters.hit_from_inside) {
+			// Hit shape at starting point.
+			r_state.min_d = 0;
+			r_state.point = p_begin;
+			r_state.normal = Vector3();
+			r_state.shape = p_shape_idx;
+			r_state.object = p_col_obj;
+			r_state.collided = true;
+			return false;
+		} else {
+			// Ignore shape when starting inside.
+			return true;
+		}
+	}
+
+	if (shape->intersect_segment(local_from, local_to, shape_point, shape_normal, shape_face_index, p_parameters.hit_back_faces)) {
+		Transform3D xform = p_col_obj->get_transform() * p_col_obj->get_shape_transform(p_shape_idx);
+		shape_point = xform.xform(shape_point);
+
+		real_t ld = p_normal.dot(shape_point);
+
+		if (ld < r_state.min_d) {
+			r_state.min_d = ld;
+			r_state.point = shape_point;
+			r_state.normal = inv_xform.basis.xform_inv(shape_normal).normalized();
+			r_state.face_index = shape_face_index;
+			r_state.shape = p_shape_idx;
+			r_state.object = p_col_obj;
+			r_state.collided = true;
+		}
+	}
+
+	return true;
+}
+
+static bool _intersect_ray_result(const GodotRayCastState3D &p_state, PhysicsDirectSpaceState3D::RayResult &r_result) {
+	if (!p_state.collided) {
+		return false;
+	}
+	ERR_FAIL_NULL_V(p_state.object, false); // Shouldn't happen but silences warning.
+
+	r_result.collider_id = p_state.object->get_instance_id();
+	if (r_result.collider_id.is_valid()) {
+		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
+	} else {
+		r_result.collider = nullptr;
+	}
+	r_result.normal = p_state.normal;
+	r_result.face_index = p_state.face_index;
+	r_result.position = p_state.point;
+	r_result.rid = p_state.object->get_self();
+	r_result.shape = p_state.shape;
+
+	return true;
+}
+
 bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
 	ERR_FAIL_COND_V(space->locked, false);
 
@@ -120,91 +215,89 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
-	bool collided = false;
-	Vector3 res_point, res_normal;
-	int res_face_index = -1;
-	int res_shape = -1;
-	const GodotCollisionObject3D *res_obj = nullptr;
-	real_t min_d = 1e10;
+	GodotRayCastState3D state;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
-			continue;
-		}
-
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
-			continue;
-		}
-
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
-			continue;
+		if (!_intersect_ray_candidate(p_parameters, begin, end, normal, space->intersection_query_results[i], space->intersection_query_subindex_results[i], state)) {
+			break;
 		}
+	}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-
-		int shape_idx = space->intersection_query_subindex_results[i];
-		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
-
-		Vector3 local_from = inv_xform.xform(begin);
-		Vector3 local_to = inv_xform.xform(end);
+	return _intersect_ray_result(state, r_result);
+}
 
-		const GodotShape3D *shape = col_obj->get_shape(shape_idx);
+void GodotPhysicsDirectSpaceState3D::_intersect_rays_process(uint32_t p_index, RayBatch *p_batch) {
+	const Vector3 &begin = p_batch->from[p_index];
+	const Vector3 &end = p_batch->to[p_index];
+	const Vector3 normal = (end - begin).normalized();
 
-		Vector3 shape_point, shape_normal;
-		int shape_face_index = -1;
+	GodotRayCastState3D state;
 
-		if (shape->intersect_point(local_from)) {
-			if (p_parameters.hit_from_inside) {
-				// Hit shape at starting point.
-				min_d = 0;
-				res_point = begin;
-				res_normal = Vector3();
-				res_shape = shape_idx;
-				res_obj = col_obj;
-				collided = true;
-				break;
-			} else {
-				// Ignore shape when starting inside.
-				continue;
-			}
+	for (uint32_t i = p_batch->offsets[p_index]; i < p_batch->offsets[p_index + 1]; i++) {
+		const GodotBroadPhase3D::SegmentHit &candidate = p_batch->candidates[i];
+		if (!_intersect_ray_candidate(*p_batch->parameters, begin, end, normal, candidate.object, candidate.subindex, state)) {
+			break;
 		}
+	}
 
-		if (shape->intersect_segment(local_from, local_to, shape_point, shape_normal, shape_face_index, p_parameters.hit_back_faces)) {
-			Transform3D xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-			shape_point = xform.xform(shape_point);
+	p_batch->hits[p_index] = _intersect_ray_result(state, p_batch->results[p_index]);
+}
 
-			real_t ld = normal.dot(shape_point);
+void GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
 
-			if (ld < min_d) {
-				min_d = ld;
-				res_point = shape_point;
-				res_normal = inv_xform.basis.xform_inv(shape_normal).normalized();
-				res_face_index = shape_face_index;
-				res_shape = shape_idx;
-				res_obj = col_obj;
-				collided = true;
-			}
-		}
+	if (p_ray_count <= 0) {
+		return;
 	}
 
-	if (!collided) {
-		return false;
+	// Broadphase for all rays in a single packet traversal.
+	LocalVector<GodotBroadPhase3D::SegmentHit> &hits = space->ray_batch_hits;
+	hits.clear();
+	space->broadphase->cull_segments(p_from, p_to, p_ray_count, hits);
+
+	// Group the candidates by ray (counting sort, keeping the broadphase order of each ray).
+	LocalVector<uint32_t> &offsets = space->ray_batch_offsets;
+	LocalVector<GodotBroadPhase3D::SegmentHit> &candidates = space->ray_batch_candidates;
+	offsets.resize(p_ray_count + 1);
+	memset(offsets.ptr(), 0, offsets.size() * sizeof(uint32_t));
+	candidates.resize(hits.size());
+
+	bool has_soft_body = false;
+	for (const GodotBroadPhase3D::SegmentHit &hit : hits) {
+		offsets[hit.segment + 1]++;
+		has_soft_body = has_soft_body || hit.object->get_type() == GodotCollisionObject3D::TYPE_SOFT_BODY;
 	}
-	ERR_FAIL_NULL_V(res_obj, false); // Shouldn't happen but silences warning.
-
-	r_result.collider_id = res_obj->get_instance_id();
-	if (r_result.collider_id.is_valid()) {
-		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
+	for (int i = 0; i < p_ray_count; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+	for (const GodotBroadPhase3D::SegmentHit &hit : hits) {
+		candidates[offsets[hit.segment]++] = hit;
+	}
+	// The scatter above advanced each offset to the start of the next ray.
+	for (int i = p_ray_count; i > 0; i--) {
+		offsets[i] = offsets[i - 1];
+	}
+	offsets[0] = 0;
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.offsets = offsets.ptr();
+	batch.candidates = candidates.ptr();
+	batch.results = r_results;
+	batch.hits = r_hits;
+
+	// Narrowphase per ray. Soft bodies build their face tree lazily when first
+	// queried, so batches that hit them stay on this thread.
+	if (p_ray_count < RAY_BATCH_PARALLEL_MIN || has_soft_body) {
+		for (int i = 0; i < p_ray_count; i++) {
+			_intersect_rays_process(i, &batch);
+		}
 	} else {
-		r_result.collider = nullptr;
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_rays_process, &batch, p_ray_count, -1, true, SNAME("Physics3DIntersectRays"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 	}
-	r_result.normal = res_normal;
-	r_result.face_index = res_face_index;
-	r_result.position = res_point;
-	r_result.rid = res_obj->get_self();
-	r_result.shape = res_shape;
-
-	return true;
 }
 
 int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
@@ -1031,6 +1124,25 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 }
 
 // Assumes a valid collision pair, this should have been checked beforehand in the BVH or octree.
+// Adds the time spent in a broadphase callback to the pair generation time of the space.
+// Does nothing when the pair generation isn't timed.
+struct _PairGenerationTimer {
+	uint64_t *time = nullptr;
+	uint64_t time_beg = 0;
+
+	_PairGenerationTimer(uint64_t &r_time, bool p_timed) {
+		if (p_timed) {
+			time = &r_time;
+			time_beg = OS::get_singleton()->get_ticks_usec();
+		}
+	}
+	~_PairGenerationTimer() {
+		if (time) {
+			*time += OS::get_singleton()->get_ticks_usec() - time_beg;
+		}
+	}
+};
+
 void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_self) {
 	GodotCollisionObject3D::Type type_A = A->get_type();
 	GodotCollisionObject3D::Type type_B = B->get_type();
@@ -1041,6 +1153,7 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 	}
 
 	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
+	_PairGenerationTimer timer(self->pair_generation_time, self->pair_generation_timed);
 
 	self->collision_pairs++;
 
@@ -1080,6 +1193,8 @@ void GodotSpace3D::_broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_
 	}
 
 	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
+	_PairGenerationTimer timer(self->pair_generation_time, self->pair_generation_timed);
+
 	self->collision_pairs--;
 	GodotConstraint3D *c = static_cast<GodotConstraint3D *>(p_data);
 	memdelete(c);
@@ -1123,6 +1238,174 @@ const HashSet<GodotCollisionObject3D *> &GodotSpace3D::get_objects() const {
 	return objects;
 }
 
+// A saved state starts with this header, followed by the bodies, then by the body pairs and their contacts.
+struct SpaceStateHeader3D {
+	static constexpr uint32_t MAGIC = 0x44335347; // "GS3D"
+
+	uint32_t magic = MAGIC;
+	uint32_t real_size = sizeof(real_t);
+	uint32_t body_count = 0;
+	uint32_t pair_count = 0;
+};
+
+struct BodyStateRecord3D {
+	RID rid;
+	GodotBody3D::Snapshot snapshot;
+};
+
+struct BodyPairStateKey3D {
+	RID body_A;
+	RID body_B;
+	int32_t shape_A = 0;
+	int32_t shape_B = 0;
+
+	uint32_t hash() const {
+		uint32_t h = hash_murmur3_one_64(body_A.get_id());
+		h = hash_murmur3_one_64(body_B.get_id(), h);
+		h = hash_murmur3_one_32(shape_A, h);
+		h = hash_murmur3_one_32(shape_B, h);
+		return hash_fmix32(h);
+	}
+
+	bool operator==(const BodyPairStateKey3D &p_other) const {
+		return body_A == p_other.body_A && body_B == p_other.body_B && shape_A == p_other.shape_A && shape_B == p_other.shape_B;
+	}
+
+	BodyPairStateKey3D() {}
+	BodyPairStateKey3D(const GodotBodyPair3D::SnapshotHeader &p_header) :
+			body_A(p_header.body_A), body_B(p_header.body_B), shape_A(p_header.shape_A), shape_B(p_header.shape_B) {}
+};
+
+// Each pair is stored once, by its first body.
+static _FORCE_INLINE_ GodotBodyPair3D *_get_first_body_pair(const KeyValue<GodotConstraint3D *, int> &p_constraint) {
+	return p_constraint.value == 0 ? p_constraint.key->get_body_pair() : nullptr;
+}
+
+PackedByteArray GodotSpace3D::save_state() const {
+	LocalVector<const GodotBody3D *> bodies;
+	LocalVector<const GodotBodyPair3D *> pairs;
+	bodies.reserve(objects.size());
+
+	SpaceStateHeader3D header;
+	size_t size = sizeof(SpaceStateHeader3D);
+
+	for (const GodotCollisionObject3D *object : objects) {
+		if (object->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+
+		const GodotBody3D *body = static_cast<const GodotBody3D *>(object);
+		if (body->get_mode() != PhysicsServer3D::BODY_MODE_STATIC) {
+			bodies.push_back(body);
+			size += sizeof(BodyStateRecord3D);
+		}
+
+		for (const KeyValue<GodotConstraint3D *, int> &E : body->get_constraint_map()) {
+			const GodotBodyPair3D *pair = _get_first_body_pair(E);
+			if (pair) {
+				pairs.push_back(pair);
+				GodotBodyPair3D::SnapshotHeader pair_header;
+				pair->get_snapshot_header(pair_header);
+				size += GodotBodyPair3D::get_snapshot_size(pair_header.contact_count);
+			}
+		}
+	}
+
+	header.body_count = bodies.size();
+	header.pair_count = pairs.size();
+
+	PackedByteArray state;
+	state.resize(size);
+	uint8_t *w = state.ptrw();
+
+	memcpy(w, &header, sizeof(SpaceStateHeader3D));
+	w += sizeof(SpaceStateHeader3D);
+
+	for (const GodotBody3D *body : bodies) {
+		// Zeroed first, the padding of the record is saved too.
+		BodyStateRecord3D record;
+		memset(&record, 0, sizeof(BodyStateRecord3D));
+		record.rid = body->get_self();
+		body->save_snapshot(record.snapshot);
+		memcpy(w, &record, sizeof(BodyStateRecord3D));
+		w += sizeof(BodyStateRecord3D);
+	}
+
+	for (const GodotBodyPair3D *pair : pairs) {
+		w = pair->save_snapshot(w);
+	}
+
+	DEV_ASSERT(w == state.ptrw() + size);
+	return state;
+}
+
+bool GodotSpace3D::restore_state(const PackedByteArray &p_state) {
+	const uint8_t *r = p_state.ptr();
+	const uint8_t *end = r + p_state.size();
+
+	SpaceStateHeader3D header;
+	ERR_FAIL_COND_V_MSG(p_state.size() < (int64_t)sizeof(SpaceStateHeader3D), false, "Invalid physics space state.");
+	memcpy(&header, r, sizeof(SpaceStateHeader3D));
+	r += sizeof(SpaceStateHeader3D);
+	ERR_FAIL_COND_V_MSG(header.magic != SpaceStateHeader3D::MAGIC, false, "Invalid physics space state, it wasn't saved by GodotPhysics3D.");
+	ERR_FAIL_COND_V_MSG(header.real_size != sizeof(real_t), false, "Invalid physics space state, it was saved by a build using a different floating-point precision.");
+	ERR_FAIL_COND_V_MSG(header.body_count > size_t(end - r) / sizeof(BodyStateRecord3D), false, "Invalid physics space state.");
+
+	const uint8_t *body_records = r;
+	r += header.body_count * sizeof(BodyStateRecord3D);
+
+	// Check all the pairs before changing anything.
+	HashMap<BodyPairStateKey3D, const uint8_t *> saved_pairs;
+	saved_pairs.reserve(header.pair_count);
+	for (uint32_t i = 0; i < header.pair_count; i++) {
+		GodotBodyPair3D::SnapshotHeader pair_header;
+		ERR_FAIL_COND_V_MSG(size_t(end - r) < sizeof(GodotBodyPair3D::SnapshotHeader), false, "Invalid physics space state.");
+		memcpy(&pair_header, r, sizeof(GodotBodyPair3D::SnapshotHeader));
+		ERR_FAIL_COND_V_MSG(pair_header.contact_count < 0 || pair_header.contact_count > GodotBodyPair3D::get_max_snapshot_contacts(), false, "Invalid physics space state.");
+		const size_t pair_size = GodotBodyPair3D::get_snapshot_size(pair_header.contact_count);
+		ERR_FAIL_COND_V_MSG(size_t(end - r) < pair_size, false, "Invalid physics space state.");
+
+		saved_pairs.insert(BodyPairStateKey3D(pair_header), r);
+		r += pair_size;
+	}
+	ERR_FAIL_COND_V_MSG(r != end, false, "Invalid physics space state.");
+
+	HashMap<RID, GodotBody3D *> bodies;
+	bodies.reserve(objects.size());
+	for (GodotCollisionObject3D *object : objects) {
+		if (object->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			bodies.insert(object->get_self(), static_cast<GodotBody3D *>(object));
+		}
+	}
+
+	// Bodies added to the space after the state was saved are left as they are.
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		BodyStateRecord3D record;
+		memcpy(&record, body_records + i * sizeof(BodyStateRecord3D), sizeof(BodyStateRecord3D));
+
+		GodotBody3D **body = bodies.getptr(record.rid);
+		if (body) {
+			(*body)->restore_snapshot(record.snapshot);
+		}
+	}
+
+	// Pairs created after the state was saved lose their contacts, and pairs removed since then
+	// are created again by the broadphase on the next step, without contacts.
+	for (const KeyValue<RID, GodotBody3D *> &E : bodies) {
+		for (const KeyValue<GodotConstraint3D *, int> &F : E.value->get_constraint_map()) {
+			GodotBodyPair3D *pair = _get_first_body_pair(F);
+			if (pair) {
+				GodotBodyPair3D::SnapshotHeader pair_header;
+				pair->get_snapshot_header(pair_header);
+				const uint8_t *const *saved_pair = saved_pairs.getptr(BodyPairStateKey3D(pair_header));
+				pair->restore_snapshot(saved_pair ? *saved_pair : nullptr);
+			}
+		}
+	}
+
+	return true;
+}
+
 void GodotSpace3D::body_add_to_state_query_list(SelfList<GodotBody3D> *p_body) {
 	state_query_list.add(p_body);
 }
@@ -1186,7 +1469,22 @@ void GodotSpace3D::setup() {
 }
 
 void GodotSpace3D::update() {
+	pair_generation_time = 0;
+	uint64_t time_beg = OS::get_singleton()->get_ticks_usec();
+
 	broadphase->update();
+
+	// Pairs are created by the broadphase callbacks, which time themselves when statistics are enabled.
+	uint64_t time_total = OS::get_singleton()->get_ticks_usec() - time_beg;
+	elapsed_time[ELAPSED_TIME_PAIR_GENERATION] = pair_generation_time;
+	elapsed_time[ELAPSED_TIME_BROADPHASE] = time_total - MIN(pair_generation_time, time_total);
+}
+
+void GodotSpace3D::set_island_sizes(const uint32_t *p_histogram, uint32_t p_max_island_size) {
+	for (int i = 0; i < ISLAND_SIZE_BUCKETS; i++) {
+		island_size_histogram[i] = p_histogram[i];
+	}
+	max_island_size = p_max_island_size;
 }
 
 void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value) {
@@ -1261,6 +1559,10 @@ GodotSpace3D::GodotSpace3D() {
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/3d/sleep_threshold_angular");
 	body_time_to_sleep = GLOBAL_GET("physics/3d/time_before_sleep");
 	solver_iterations = GLOBAL_GET("physics/3d/solver/solver_iterations");
+#ifndef REAL_T_IS_DOUBLE
+	// The SIMD solver works with single precision floats.
+	contact_solver = ContactSolver(int(GLOBAL_GET("physics/3d/solver/contact_solver")));
+#endif
 	contact_recycle_radius = GLOBAL_GET("physics/3d/solver/contact_recycle_radius");
 	contact_max_separation = GLOBAL_GET("physics/3d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/3d/solver/contact_max_allowed_penetration");
@@ -41,11 +41,28 @@
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// Below this many rays, the narrowphase of a batch is not worth dispatching to worker threads.
+	static constexpr int RAY_BATCH_PARALLEL_MIN = 64;
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		// Candidates of ray i are candidates[offsets[i]] to candidates[offsets[i + 1] - 1].
+		const uint32_t *offsets = nullptr;
+		const GodotBroadPhase3D::SegmentHit *candidates = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+	};
+
+	void _intersect_rays_process(uint32_t p_index, RayBatch *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
@@ -59,6 +76,8 @@ class GodotSpace3D {
 public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
+		ELAPSED_TIME_BROADPHASE, // Finding overlapping pairs, without creating their constraints.
+		ELAPSED_TIME_PAIR_GENERATION, // Creating and removing the constraints of the pairs.
 		ELAPSED_TIME_GENERATE_ISLANDS,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
@@ -67,6 +86,13 @@ public:
 
 	};
 
+	enum ContactSolver {
+		CONTACT_SOLVER_SCALAR,
+		CONTACT_SOLVER_SIMD,
+	};
+
+	static constexpr int ISLAND_SIZE_BUCKETS = 16;
+
 private:
 	uint64_t elapsed_time[ELAPSED_TIME_MAX] = {};
 
@@ -89,6 +115,7 @@ private:
 	GodotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
+	ContactSolver contact_solver = CONTACT_SOLVER_SCALAR;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
@@ -102,6 +129,11 @@ private:
 	GodotCollisionObject3D *intersection_query_results[INTERSECTION_QUERY_MAX];
 	int intersection_query_subindex_results[INTERSECTION_QUERY_MAX];
 
+	// Scratch buffers for GodotPhysicsDirectSpaceState3D::intersect_rays(), kept to avoid reallocating them every batch.
+	LocalVector<GodotBroadPhase3D::SegmentHit> ray_batch_hits;
+	LocalVector<GodotBroadPhase3D::SegmentHit> ray_batch_candidates;
+	LocalVector<uint32_t> ray_batch_offsets;
+
 	real_t body_linear_velocity_sleep_threshold = 0.0;
 	real_t body_angular_velocity_sleep_threshold = 0.0;
 	real_t body_time_to_sleep = 0.0;
@@ -113,6 +145,15 @@ private:
 	int island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
+	int contact_count = 0;
+
+	// Bodies per island, in power of two buckets, see set_island_sizes().
+	uint32_t island_size_histogram[ISLAND_SIZE_BUCKETS] = {};
+	uint32_t max_island_size = 0;
+
+	// Only measured with statistics enabled, the broadphase callbacks are hot.
+	bool pair_generation_timed = false;
+	uint64_t pair_generation_time = 0;
 
 	RID static_global_body;
 
@@ -155,7 +196,12 @@ public:
 	void remove_object(GodotCollisionObject3D *p_object);
 	const HashSet<GodotCollisionObject3D *> &get_objects() const;
 
+	// Snapshots of the bodies and of the contacts between them, for rollback.
+	PackedByteArray save_state() const;
+	bool restore_state(const PackedByteArray &p_state);
+
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ ContactSolver get_contact_solver() const { return contact_solver; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -186,6 +232,15 @@ public:
 
 	int get_collision_pairs() const { return collision_pairs; }
 
+	void set_contact_count(int p_contact_count) { contact_count = p_contact_count; }
+	int get_contact_count() const { return contact_count; }
+
+	// Bucket 0 counts islands of one body, and bucket i > 0 islands of
+	// 2^i to 2^(i+1) - 1 bodies. The last bucket also counts larger islands.
+	void set_island_sizes(const uint32_t *p_histogram, uint32_t p_max_island_size);
+	const uint32_t *get_island_size_histogram() const { return island_size_histogram; }
+	uint32_t get_max_island_size() const { return max_island_size; }
+
 	GodotPhysicsDirectSpaceState3D *get_direct_state();
 
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
@@ -203,6 +258,7 @@ public:
 
 	void set_elapsed_time(ElapsedTime p_time, uint64_t p_msec) { elapsed_time[p_time] = p_msec; }
 	uint64_t get_elapsed_time(ElapsedTime p_time) const { return elapsed_time[p_time]; }
+	void set_pair_generation_timed(bool p_timed) { pair_generation_timed = p_timed; }
 
 	bool test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result);
 
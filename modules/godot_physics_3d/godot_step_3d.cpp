@@ -34,12 +34,16 @@
 
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "core/profiling/profiling.h"
 
 #define BODY_ISLAND_COUNT_RESERVE 128
 #define BODY_ISLAND_SIZE_RESERVE 512
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define ISLAND_COLORING_MIN_CONSTRAINTS 256
+#define COLOR_PARALLEL_MIN_CONSTRAINTS 32
+#define COLOR_PARALLEL_MIN_CONTACT_BATCHES 8
 
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -112,6 +116,14 @@ void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, Local
 	}
 }
 
+void GodotStep3D::_integrate_body_forces(uint32_t p_body_index, void *p_userdata) {
+	active_bodies[p_body_index]->integrate_forces(delta);
+}
+
+void GodotStep3D::_integrate_body_velocities(uint32_t p_body_index, void *p_userdata) {
+	active_bodies[p_body_index]->integrate_velocities(delta);
+}
+
 void GodotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
 	GodotConstraint3D *constraint = all_constraints[p_constraint_index];
 	constraint->setup(delta);
@@ -130,31 +142,184 @@ void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constrai
 	p_constraint_island.resize(valid_constraint_count);
 }
 
+// Keeps the first p_constraint_count constraints with at least the given priority, returns how many were kept.
+static uint32_t _keep_priority_constraints(LocalVector<GodotConstraint3D *> &p_constraints, uint32_t p_constraint_count, int p_priority) {
+	uint32_t priority_constraint_count = 0;
+	for (uint32_t constraint_index = 0; constraint_index < p_constraint_count; ++constraint_index) {
+		GodotConstraint3D *constraint = p_constraints[constraint_index];
+		if (constraint->get_priority() >= p_priority) {
+			// Keep this constraint for the next iteration.
+			p_constraints[priority_constraint_count++] = constraint;
+		}
+	}
+	return priority_constraint_count;
+}
+
 void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
 
+	if (constraint_island.size() >= island_coloring_min_constraints) {
+		// Solved afterwards by `_solve_island_colored`, which spreads it over threads on its own.
+		return;
+	}
+
+	// Contacts have the lowest priority, so the batched ones are only solved in the first pass.
+	GodotContactSolver3D *contact_solver = nullptr;
+	if (use_contact_solver && island_contact_solvers[p_island_index].setup(constraint_island, delta)) {
+		contact_solver = &island_contact_solvers[p_island_index];
+	}
+
 	int current_priority = 1;
 
 	uint32_t constraint_count = constraint_island.size();
-	while (constraint_count > 0) {
+	while (constraint_count > 0 || contact_solver) {
 		for (int i = 0; i < iterations; i++) {
 			// Go through all iterations.
+			if (contact_solver) {
+				contact_solver->solve();
+			}
 			for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
 				constraint_island[constraint_index]->solve(delta);
 			}
 		}
 
+		if (contact_solver) {
+			contact_solver->finish();
+			contact_solver = nullptr;
+		}
+
 		// Check priority to keep only higher priority constraints.
-		uint32_t priority_constraint_count = 0;
 		++current_priority;
-		for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
-			GodotConstraint3D *constraint = constraint_island[constraint_index];
-			if (constraint->get_priority() >= current_priority) {
-				// Keep this constraint for the next iteration.
-				constraint_island[priority_constraint_count++] = constraint;
+		constraint_count = _keep_priority_constraints(constraint_island, constraint_count, current_priority);
+	}
+}
+
+void GodotStep3D::_color_island(const LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	for (uint32_t color = 0; color < island_color_count; ++color) {
+		island_colors[color].clear();
+	}
+	island_color_count = 0;
+	island_uncolored.clear();
+	island_color_masks.clear();
+
+	// Greedy coloring: each constraint takes the first color not used yet by any
+	// of the bodies it applies impulses to. Static and kinematic bodies are only
+	// read by the solver, so they don't need to be considered.
+	for (GodotConstraint3D *constraint : p_constraint_island) {
+		GodotBody3D **bodies = constraint->get_body_ptr();
+		const int body_count = constraint->get_body_count();
+		const int soft_body_count = constraint->get_soft_body_count();
+
+		uint64_t used_colors = 0;
+		for (int i = 0; i < body_count; i++) {
+			if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				const uint64_t *body_colors = island_color_masks.getptr(bodies[i]);
+				used_colors |= body_colors ? *body_colors : 0;
+			}
+		}
+		for (int i = 0; i < soft_body_count; i++) {
+			const uint64_t *body_colors = island_color_masks.getptr(constraint->get_soft_body_ptr(i));
+			used_colors |= body_colors ? *body_colors : 0;
+		}
+
+		if (used_colors == UINT64_MAX) {
+			island_uncolored.push_back(constraint);
+			continue;
+		}
+
+		uint32_t color = 0;
+		while (used_colors & (uint64_t(1) << color)) {
+			color++;
+		}
+
+		const uint64_t color_bit = uint64_t(1) << color;
+		for (int i = 0; i < body_count; i++) {
+			if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				island_color_masks[bodies[i]] |= color_bit;
+			}
+		}
+		for (int i = 0; i < soft_body_count; i++) {
+			island_color_masks[constraint->get_soft_body_ptr(i)] |= color_bit;
+		}
+
+		if (color >= island_colors.size()) {
+			island_colors.resize(color + 1);
+		}
+		island_color_count = MAX(island_color_count, color + 1);
+		island_colors[color].push_back(constraint);
+	}
+}
+
+void GodotStep3D::_solve_color_constraint(uint32_t p_constraint_index, LocalVector<GodotConstraint3D *> *p_color) {
+	(*p_color)[p_constraint_index]->solve(delta);
+}
+
+void GodotStep3D::_solve_color_contact_batch(uint32_t p_batch_index, GodotContactSolver3D *p_contact_solver) {
+	p_contact_solver->solve_batch(p_batch_index);
+}
+
+void GodotStep3D::_solve_island_colored(LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	_color_island(p_constraint_island);
+
+	// Pairs of a color don't share bodies, so their contact batches can be solved in parallel too.
+	bool solve_contacts = false;
+	if (use_contact_solver) {
+		if (color_contact_solvers.size() < island_color_count) {
+			color_contact_solvers.resize(island_color_count);
+		}
+		for (uint32_t color = 0; color < island_color_count; ++color) {
+			solve_contacts = color_contact_solvers[color].setup(island_colors[color], delta) || solve_contacts;
+		}
+	}
+
+	int current_priority = 1;
+
+	uint32_t constraint_count = p_constraint_island.size();
+	while (constraint_count > 0) {
+		for (int i = 0; i < iterations; i++) {
+			// Go through all iterations, one color after the other.
+			for (uint32_t color = 0; color < island_color_count; ++color) {
+				if (solve_contacts) {
+					GodotContactSolver3D &contact_solver = color_contact_solvers[color];
+					if (contact_solver.get_batch_count() < COLOR_PARALLEL_MIN_CONTACT_BATCHES) {
+						contact_solver.solve();
+					} else {
+						WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_color_contact_batch, &contact_solver, contact_solver.get_batch_count(), -1, true, SNAME("Physics3DContactSolveColor"));
+						WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+					}
+				}
+
+				LocalVector<GodotConstraint3D *> &color_constraints = island_colors[color];
+				if (color_constraints.size() < COLOR_PARALLEL_MIN_CONSTRAINTS) {
+					for (GodotConstraint3D *constraint : color_constraints) {
+						constraint->solve(delta);
+					}
+				} else {
+					WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_color_constraint, &color_constraints, color_constraints.size(), -1, true, SNAME("Physics3DConstraintSolveColor"));
+					WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+				}
+			}
+			for (GodotConstraint3D *constraint : island_uncolored) {
+				constraint->solve(delta);
 			}
 		}
-		constraint_count = priority_constraint_count;
+
+		if (solve_contacts) {
+			for (uint32_t color = 0; color < island_color_count; ++color) {
+				color_contact_solvers[color].finish();
+			}
+			solve_contacts = false;
+		}
+
+		// Check priority to keep only higher priority constraints.
+		++current_priority;
+		constraint_count = _keep_priority_constraints(island_uncolored, island_uncolored.size(), current_priority);
+		island_uncolored.resize(constraint_count);
+		for (uint32_t color = 0; color < island_color_count; ++color) {
+			LocalVector<GodotConstraint3D *> &color_constraints = island_colors[color];
+			color_constraints.resize(_keep_priority_constraints(color_constraints, color_constraints.size(), current_priority));
+			constraint_count += color_constraints.size();
+		}
 	}
 }
 
@@ -183,6 +348,8 @@ void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island
 }
 
 void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
+	GodotProfileZone("GodotStep3D::step");
+
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
@@ -198,16 +365,26 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* INTEGRATE FORCES */
 
+	GodotProfileZoneGroupedFirst(_profile_zone, "integrate_forces");
+
 	uint64_t profile_begtime = OS::get_singleton()->get_ticks_usec();
 	uint64_t profile_endtime = 0;
 
-	int active_count = 0;
-
+	active_bodies.clear();
 	const SelfList<GodotBody3D> *b = body_list->first();
 	while (b) {
-		b->self()->integrate_forces(p_delta);
+		active_bodies.push_back(b->self());
 		b = b->next();
-		active_count++;
+	}
+
+	int active_count = active_bodies.size();
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_integrate_body_forces, nullptr, active_bodies.size(), -1, true, SNAME("Physics3DIntegrateForces"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	// Broadphase updates are applied serially and in list order, so pairs are found deterministically.
+	for (GodotBody3D *body : active_bodies) {
+		body->flush_integration();
 	}
 
 	/* UPDATE SOFT BODY MOTION */
@@ -221,15 +398,22 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	p_space->set_active_objects(active_count);
 
-	// Update the broadphase to register collision pairs.
-	p_space->update();
-
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
-		profile_begtime = profile_endtime;
 	}
 
+	/* BROADPHASE */
+
+	GodotProfileZoneGrouped(_profile_zone, "broadphase");
+
+	// Update the broadphase to register collision pairs, this times itself.
+	p_space->update();
+
+	profile_begtime = OS::get_singleton()->get_ticks_usec();
+
+	GodotProfileZoneGrouped(_profile_zone, "generate_islands");
+
 	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
 
 	uint32_t island_count = 0;
@@ -335,6 +519,19 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	p_space->set_island_count((int)island_count);
 
+	uint32_t island_size_histogram[GodotSpace3D::ISLAND_SIZE_BUCKETS] = {};
+	uint32_t max_island_size = 0;
+	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
+		uint32_t island_size = body_islands[island_index].size();
+		uint32_t bucket = 0;
+		while ((island_size >> (bucket + 1)) && bucket < GodotSpace3D::ISLAND_SIZE_BUCKETS - 1) {
+			bucket++;
+		}
+		island_size_histogram[bucket]++;
+		max_island_size = MAX(max_island_size, island_size);
+	}
+	p_space->set_island_sizes(island_size_histogram, max_island_size);
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
@@ -343,8 +540,10 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
+	GodotProfileZoneGrouped(_profile_zone, "setup_constraints");
+
 	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
 	{ //profile
@@ -355,18 +554,46 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* PRE-SOLVE CONSTRAINT ISLANDS */
 
+	GodotProfileZoneGrouped(_profile_zone, "solve_constraints");
+
 	// WARNING: This doesn't run on threads, because it involves thread-unsafe processing.
+	int contact_count = 0;
 	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
-		_pre_solve_island(constraint_islands[island_index]);
+		LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_index];
+		_pre_solve_island(constraint_island);
+
+		for (GodotConstraint3D *constraint : constraint_island) {
+			const GodotBodyPair3D *pair = constraint->get_body_pair();
+			if (pair) {
+				contact_count += pair->get_contact_count();
+			}
+		}
 	}
+	p_space->set_contact_count(contact_count);
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	// WARNING: `_solve_island` modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
+	// Islands too large for a single thread are skipped by `_solve_island`, and solved
+	// one at a time afterwards, with their colors spread over the threads.
+	island_coloring_min_constraints = WorkerThreadPool::get_singleton()->get_thread_count() > 1 ? ISLAND_COLORING_MIN_CONSTRAINTS : UINT32_MAX;
+
+	use_contact_solver = p_space->get_contact_solver() == GodotSpace3D::CONTACT_SOLVER_SIMD;
+	if (use_contact_solver && island_contact_solvers.size() < island_count) {
+		island_contact_solvers.resize(island_count);
+	}
+
 	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
+	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_index];
+		if (constraint_island.size() >= island_coloring_min_constraints) {
+			_solve_island_colored(constraint_island);
+		}
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime);
@@ -375,11 +602,21 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* INTEGRATE VELOCITIES */
 
+	GodotProfileZoneGrouped(_profile_zone, "integrate_velocities");
+
+	// Solving may have woken up bodies, so the active list is gathered again.
+	active_bodies.clear();
 	b = body_list->first();
 	while (b) {
-		const SelfList<GodotBody3D> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n;
+		active_bodies.push_back(b->self());
+		b = b->next();
+	}
+
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_integrate_body_velocities, nullptr, active_bodies.size(), -1, true, SNAME("Physics3DIntegrateVelocities"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (GodotBody3D *body : active_bodies) {
+		body->flush_integration();
 	}
 
 	/* SLEEP / WAKE UP ISLANDS */
@@ -412,6 +649,7 @@ GodotStep3D::GodotStep3D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
+	active_bodies.reserve(BODY_ISLAND_SIZE_RESERVE);
 }
 
 GodotStep3D::~GodotStep3D() {
@@ -30,8 +30,10 @@
 
 #pragma once
 
+#include "godot_contact_solver_3d.h"
 #include "godot_space_3d.h"
 
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
 
 class GodotStep3D {
@@ -43,12 +45,38 @@ class GodotStep3D {
 	LocalVector<LocalVector<GodotBody3D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint3D *>> constraint_islands;
 	LocalVector<GodotConstraint3D *> all_constraints;
+	LocalVector<GodotBody3D *> active_bodies;
+
+	// Islands with at least this many constraints are split into colors and solved
+	// by _solve_island_colored() instead of _solve_island().
+	uint32_t island_coloring_min_constraints = UINT32_MAX;
+
+	// Colors of the island being solved by _solve_island_colored(). Constraints of a
+	// color never write to the same body, so each color can be solved in parallel.
+	// Constraints left without a color are solved serially after the colors.
+	LocalVector<LocalVector<GodotConstraint3D *>> island_colors;
+	uint32_t island_color_count = 0;
+	LocalVector<GodotConstraint3D *> island_uncolored;
+	HashMap<const void *, uint64_t> island_color_masks;
+
+	// Batched contact solvers, used instead of GodotBodyPair3D::solve() when the
+	// space uses the SIMD contact solver. One per island, and one per color for
+	// the island being solved by _solve_island_colored().
+	bool use_contact_solver = false;
+	LocalVector<GodotContactSolver3D> island_contact_solvers;
+	LocalVector<GodotContactSolver3D> color_contact_solvers;
 
 	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
+	void _integrate_body_forces(uint32_t p_body_index, void *p_userdata = nullptr);
+	void _integrate_body_velocities(uint32_t p_body_index, void *p_userdata = nullptr);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _color_island(const LocalVector<GodotConstraint3D *> &p_constraint_island);
+	void _solve_color_constraint(uint32_t p_constraint_index, LocalVector<GodotConstraint3D *> *p_color);
+	void _solve_color_contact_batch(uint32_t p_batch_index, GodotContactSolver3D *p_contact_solver);
+	void _solve_island_colored(LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const;
 
 public:
@@ -0,0 +1,241 @@
+/**************************************************************************/
+/*  test_godot_physics_3d_concave_cull.h                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysics3DConcaveCull {
+
+static const int GRID_SIZE = 32;
+
+static real_t get_terrain_height(int p_x, int p_z) {
+	return Math::sin(p_x * 0.4) * 2.0 + Math::cos(p_z * 0.3) * 1.5;
+}
+
+static Vector<Vector3> create_terrain_faces() {
+	Vector<Vector3> faces;
+	const real_t half = 0.5 * (GRID_SIZE - 1);
+	for (int z = 0; z < GRID_SIZE - 1; z++) {
+		for (int x = 0; x < GRID_SIZE - 1; x++) {
+			Vector3 p00(x - half, get_terrain_height(x, z), z - half);
+			Vector3 p10(x + 1 - half, get_terrain_height(x + 1, z), z - half);
+			Vector3 p01(x - half, get_terrain_height(x, z + 1), z + 1 - half);
+			Vector3 p11(x + 1 - half, get_terrain_height(x + 1, z + 1), z + 1 - half);
+			faces.push_back(p00);
+			faces.push_back(p10);
+			faces.push_back(p01);
+			faces.push_back(p10);
+			faces.push_back(p11);
+			faces.push_back(p01);
+		}
+	}
+	return faces;
+}
+
+static bool add_face(void *p_userdata, GodotShape3D *p_convex) {
+	const GodotFaceShape3D *face = static_cast<const GodotFaceShape3D *>(p_convex);
+	static_cast<LocalVector<Vector3> *>(p_userdata)->push_back((face->vertex[0] + face->vertex[1] + face->vertex[2]) / 3.0);
+	return false;
+}
+
+static AABB get_face_aabb(const GodotFaceShape3D *p_face) {
+	AABB aabb(p_face->vertex[0], Vector3());
+	aabb.expand_to(p_face->vertex[1]);
+	aabb.expand_to(p_face->vertex[2]);
+	return aabb;
+}
+
+struct FilteredFaces {
+	AABB aabb;
+	LocalVector<Vector3> centers;
+};
+
+static bool add_face_if_overlapping(void *p_userdata, GodotShape3D *p_convex) {
+	FilteredFaces *filtered = static_cast<FilteredFaces *>(p_userdata);
+	const GodotFaceShape3D *face = static_cast<const GodotFaceShape3D *>(p_convex);
+	if (filtered->aabb.intersects(get_face_aabb(face))) {
+		filtered->centers.push_back((face->vertex[0] + face->vertex[1] + face->vertex[2]) / 3.0);
+	}
+	return false;
+}
+
+static bool have_same_centers(const LocalVector<Vector3> &p_a, const LocalVector<Vector3> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// A body sized box sliding over the terrain, a little further every step.
+static AABB get_query_aabb(int p_step) {
+	const int x = 5 + p_step / 7;
+	const int z = 12 + p_step / 20;
+	const real_t half = 0.5 * (GRID_SIZE - 1);
+	const Vector3 center(x - half + (p_step % 7) * 0.1, get_terrain_height(x, z) + Math::sin(p_step * 0.2) * 0.5, z - half);
+	return AABB(center - Vector3(0.75, 1.0, 0.75), Vector3(1.5, 2.0, 1.5));
+}
+
+TEST_CASE("[GodotPhysics3D] Concave polygon culling matches brute force") {
+	const Vector<Vector3> faces = create_terrain_faces();
+	GodotConcavePolygonShape3D *shape = memnew(GodotConcavePolygonShape3D);
+	Dictionary data;
+	data["faces"] = faces;
+	data["backface_collision"] = false;
+	shape->set_data(data);
+
+	GodotConcaveShape3D::CullCache cache;
+	for (int step = 0; step < 100; step++) {
+		const AABB aabb = get_query_aabb(step);
+
+		LocalVector<Vector3> expected;
+		for (int i = 0; i < faces.size(); i += 3) {
+			AABB face_aabb(faces[i], Vector3());
+			face_aabb.expand_to(faces[i + 1]);
+			face_aabb.expand_to(faces[i + 2]);
+			if (aabb.intersects(face_aabb)) {
+				expected.push_back((faces[i] + faces[i + 1] + faces[i + 2]) / 3.0);
+			}
+		}
+		expected.sort();
+
+		LocalVector<Vector3> culled;
+		shape->cull(aabb, add_face, &culled, false);
+		culled.sort();
+
+		LocalVector<Vector3> cached;
+		shape->cull_cached(aabb, cache, add_face, &cached, false);
+		cached.sort();
+
+		CHECK_MESSAGE(expected.size() > 0, "The query should overlap the terrain at step ", step, ".");
+		CHECK_MESSAGE(have_same_centers(culled, expected), "Culling should find the overlapping faces at step ", step, ".");
+		CHECK_MESSAGE(have_same_centers(cached, expected), "Cached culling should find the overlapping faces at step ", step, ".");
+	}
+
+	// Replacing the faces must not return the cached triangles of the old ones.
+	Vector<Vector3> lifted_faces = faces;
+	for (int i = 0; i < lifted_faces.size(); i++) {
+		lifted_faces.write[i].y += 100.0;
+	}
+	data["faces"] = lifted_faces;
+	shape->set_data(data);
+
+	LocalVector<Vector3> cached;
+	shape->cull_cached(get_query_aabb(99), cache, add_face, &cached, false);
+	CHECK_MESSAGE(cached.is_empty(), "Cached culling should see the new faces.");
+
+	memdelete(shape);
+}
+
+TEST_CASE("[GodotPhysics3D] Concave polygon segment intersection matches brute force") {
+	const Vector<Vector3> faces = create_terrain_faces();
+	GodotConcavePolygonShape3D *shape = memnew(GodotConcavePolygonShape3D);
+	Dictionary data;
+	data["faces"] = faces;
+	data["backface_collision"] = false;
+	shape->set_data(data);
+
+	for (int i = 0; i < 50; i++) {
+		const Vector3 from(-14.0 + i * 0.55, 10.0, 13.0 - i * 0.5);
+		const Vector3 to = from + Vector3(1.0, -20.0, 0.5);
+
+		real_t expected_distance = 1e20;
+		for (int j = 0; j < faces.size(); j += 3) {
+			Vector3 hit;
+			if (Face3(faces[j], faces[j + 1], faces[j + 2]).intersects_segment(from, to, &hit)) {
+				expected_distance = MIN(expected_distance, from.distance_to(hit));
+			}
+		}
+
+		Vector3 result;
+		Vector3 normal;
+		int face_index = -1;
+		REQUIRE(shape->intersect_segment(from, to, result, normal, face_index, true));
+		CHECK(from.distance_to(result) == doctest::Approx(expected_distance));
+		CHECK(face_index >= 0);
+	}
+
+	memdelete(shape);
+}
+
+TEST_CASE("[GodotPhysics3D] Height map cached culling") {
+	Vector<real_t> heights;
+	real_t min_height = 0.0;
+	real_t max_height = 0.0;
+	for (int z = 0; z < GRID_SIZE; z++) {
+		for (int x = 0; x < GRID_SIZE; x++) {
+			const real_t height = get_terrain_height(x, z);
+			heights.push_back(height);
+			min_height = MIN(min_height, height);
+			max_height = MAX(max_height, height);
+		}
+	}
+
+	GodotHeightMapShape3D *shape = memnew(GodotHeightMapShape3D);
+	Dictionary data;
+	data["width"] = GRID_SIZE;
+	data["depth"] = GRID_SIZE;
+	data["heights"] = heights;
+	data["min_height"] = min_height;
+	data["max_height"] = max_height;
+	shape->set_data(data);
+
+	GodotConcaveShape3D::CullCache cache;
+	for (int step = 0; step < 100; step++) {
+		// Both queries only return the triangles whose bounds overlap the query.
+		FilteredFaces expected;
+		expected.aabb = get_query_aabb(step);
+		shape->cull(expected.aabb, add_face_if_overlapping, &expected, false);
+		expected.centers.sort();
+
+		LocalVector<Vector3> culled;
+		shape->cull(expected.aabb, add_face, &culled, false);
+		culled.sort();
+
+		LocalVector<Vector3> cached;
+		shape->cull_cached(expected.aabb, cache, add_face, &cached, false);
+		cached.sort();
+
+		CHECK_MESSAGE(expected.centers.size() > 0, "The query should overlap the terrain at step ", step, ".");
+		CHECK_MESSAGE(have_same_centers(culled, expected.centers), "Culling should find the overlapping triangles at step ", step, ".");
+		CHECK_MESSAGE(have_same_centers(cached, expected.centers), "Cached culling should find the overlapping triangles at step ", step, ".");
+	}
+
+	memdelete(shape);
+}
+
+} // namespace TestGodotPhysics3DConcaveCull
@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*  test_godot_physics_3d_narrowphase.h                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../gjk_epa.h"
+#include "../godot_collision_solver_3d.h"
+#include "../godot_shape_3d.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysics3DNarrowphase {
+
+struct Contacts {
+	LocalVector<Vector3> points;
+};
+
+static void add_contact(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &p_normal, void *p_userdata) {
+	Contacts *contacts = static_cast<Contacts *>(p_userdata);
+	contacts->points.push_back(p_point_A);
+	contacts->points.push_back(p_point_B);
+}
+
+static GodotShape3D *create_shape(PhysicsServer3D::ShapeType p_type) {
+	switch (p_type) {
+		case PhysicsServer3D::SHAPE_SPHERE: {
+			GodotSphereShape3D *sphere = memnew(GodotSphereShape3D);
+			sphere->set_data(0.5);
+			return sphere;
+		}
+		case PhysicsServer3D::SHAPE_BOX: {
+			GodotBoxShape3D *box = memnew(GodotBoxShape3D);
+			box->set_data(Vector3(0.5, 0.5, 0.5));
+			return box;
+		}
+		case PhysicsServer3D::SHAPE_CAPSULE:
+		case PhysicsServer3D::SHAPE_CYLINDER: {
+			GodotShape3D *shape = p_type == PhysicsServer3D::SHAPE_CAPSULE ? static_cast<GodotShape3D *>(memnew(GodotCapsuleShape3D)) : static_cast<GodotShape3D *>(memnew(GodotCylinderShape3D));
+			Dictionary data;
+			data["radius"] = 0.4;
+			data["height"] = 1.6;
+			shape->set_data(data);
+			return shape;
+		}
+		case PhysicsServer3D::SHAPE_CONVEX_POLYGON: {
+			// An octagonal prism.
+			Vector<Vector3> vertices;
+			for (int i = 0; i < 8; i++) {
+				real_t angle = Math::TAU * i / 8;
+				vertices.push_back(Vector3(Math::cos(angle) * 0.5, -0.5, Math::sin(angle) * 0.5));
+				vertices.push_back(Vector3(Math::cos(angle) * 0.5, 0.5, Math::sin(angle) * 0.5));
+			}
+			GodotConvexPolygonShape3D *convex = memnew(GodotConvexPolygonShape3D);
+			convex->set_data(vertices);
+			return convex;
+		}
+		default: {
+			return nullptr;
+		}
+	}
+}
+
+TEST_CASE("[GodotPhysics3D] GJK/EPA gives the same result for typed and untyped shapes") {
+	GodotCylinderShape3D *cylinder = static_cast<GodotCylinderShape3D *>(create_shape(PhysicsServer3D::SHAPE_CYLINDER));
+	GodotConvexPolygonShape3D *convex = static_cast<GodotConvexPolygonShape3D *>(create_shape(PhysicsServer3D::SHAPE_CONVEX_POLYGON));
+	const Transform3D transform_A = Transform3D(Basis(Vector3(1, 0, 1).normalized(), 0.6), Vector3(0, 0.2, 0));
+	const Transform3D transform_B = Transform3D(Basis(Vector3(0, 1, 1).normalized(), 0.3), Vector3(0.5, 0.9, 0.1));
+
+	for (real_t margin : { (real_t)0.0, (real_t)0.04 }) {
+		Contacts typed;
+		Contacts untyped;
+		CHECK(gjk_epa_calculate_penetration(cylinder, transform_A, cylinder, transform_B, add_contact, &typed, false, margin, margin));
+		CHECK(gjk_epa_calculate_penetration(static_cast<const GodotShape3D *>(cylinder), transform_A, static_cast<const GodotShape3D *>(cylinder), transform_B, add_contact, &untyped, false, margin, margin));
+		REQUIRE(typed.points.size() == 2);
+		REQUIRE(untyped.points.size() == 2);
+		CHECK(typed.points[0].is_equal_approx(untyped.points[0]));
+		CHECK(typed.points[1].is_equal_approx(untyped.points[1]));
+
+		typed.points.clear();
+		untyped.points.clear();
+		CHECK(gjk_epa_calculate_penetration(cylinder, transform_A, convex, transform_B, add_contact, &typed, false, margin, margin));
+		CHECK(gjk_epa_calculate_penetration(static_cast<const GodotShape3D *>(cylinder), transform_A, static_cast<const GodotShape3D *>(convex), transform_B, add_contact, &untyped, false, margin, margin));
+		REQUIRE(typed.points.size() == 2);
+		REQUIRE(untyped.points.size() == 2);
+		CHECK(typed.points[0].is_equal_approx(untyped.points[0]));
+		CHECK(typed.points[1].is_equal_approx(untyped.points[1]));
+	}
+
+	memdelete(cylinder);
+	memdelete(convex);
+}
+
+// Times the narrowphase for the most common shape pairs. Skipped by default,
+// run it with `--test --test-case="*Narrowphase benchmark*" --no-skip`.
+TEST_CASE("[GodotPhysics3D] Narrowphase benchmark" * doctest::skip()) {
+	struct ShapePair {
+		PhysicsServer3D::ShapeType type_A;
+		PhysicsServer3D::ShapeType type_B;
+		const char *name;
+	};
+	const ShapePair pairs[] = {
+		{ PhysicsServer3D::SHAPE_BOX, PhysicsServer3D::SHAPE_BOX, "box-box" },
+		{ PhysicsServer3D::SHAPE_CAPSULE, PhysicsServer3D::SHAPE_CAPSULE, "capsule-capsule" },
+		{ PhysicsServer3D::SHAPE_SPHERE, PhysicsServer3D::SHAPE_CONVEX_POLYGON, "sphere-convex" },
+		{ PhysicsServer3D::SHAPE_CONVEX_POLYGON, PhysicsServer3D::SHAPE_CONVEX_POLYGON, "convex-convex" },
+		{ PhysicsServer3D::SHAPE_CYLINDER, PhysicsServer3D::SHAPE_CYLINDER, "cylinder-cylinder" },
+		{ PhysicsServer3D::SHAPE_CYLINDER, PhysicsServer3D::SHAPE_CONVEX_POLYGON, "cylinder-convex" },
+	};
+	const int iterations = 100000;
+
+	for (const ShapePair &pair : pairs) {
+		GodotShape3D *shape_A = create_shape(pair.type_A);
+		GodotShape3D *shape_B = create_shape(pair.type_B);
+		Contacts contacts;
+		int collisions = 0;
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			// Rotate and slide B over A, so both touching and separated cases are timed.
+			real_t t = real_t(i % 1000) / 1000;
+			const Transform3D transform_B = Transform3D(Basis(Vector3(0, 1, 1).normalized(), t * Math::TAU), Vector3(0.9 - t * 0.6, 0.3, 0.1));
+			contacts.points.clear();
+			if (GodotCollisionSolver3D::solve_static(shape_A, Transform3D(), shape_B, transform_B, add_contact, &contacts, nullptr, 0.04, 0.04)) {
+				collisions++;
+			}
+		}
+		uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		MESSAGE(vformat("%s: %.1f ns per pair, %d of %d collided.", pair.name, usec * 1000.0 / iterations, collisions, iterations));
+		CHECK(collisions > 0);
+
+		memdelete(shape_A);
+		memdelete(shape_B);
+	}
+}
+
+} // namespace TestGodotPhysics3DNarrowphase
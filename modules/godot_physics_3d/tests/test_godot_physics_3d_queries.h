@@ -0,0 +1,196 @@
+/**************************************************************************/
+/*  test_godot_physics_3d_queries.h                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysics3DQueries {
+
+// A 40x40 grid of boxes at varying heights, with gaps so that some rays miss.
+static void create_box_grid(GodotPhysicsServer3D *p_server, RID p_space, RID p_shape, LocalVector<RID> &r_bodies) {
+	for (int x = 0; x < 40; x++) {
+		for (int z = 0; z < 40; z++) {
+			if ((x * 7 + z * 3) % 5 == 4) {
+				continue;
+			}
+			RID body = p_server->body_create();
+			p_server->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+			p_server->body_add_shape(body, p_shape, Transform3D(Basis(), Vector3(x * 2, ((x + z) % 3) * 0.5, z * 2)));
+			p_server->body_set_space(body, p_space);
+			r_bodies.push_back(body);
+		}
+	}
+}
+
+TEST_CASE("[GodotPhysics3D] Batched ray queries") {
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID space = server->space_create();
+	RID box = server->box_shape_create();
+	server->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+
+	LocalVector<RID> bodies;
+	create_box_grid(server, space, box, bodies);
+
+	PhysicsDirectSpaceState3D *space_state = server->space_get_direct_state(space);
+	REQUIRE(space_state != nullptr);
+
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+
+	SUBCASE("Single batched ray") {
+		// Straight down on the box at the origin.
+		const Vector3 from(0, 10, 0);
+		const Vector3 to(0, -10, 0);
+		PhysicsDirectSpaceState3D::RayResult result;
+		bool hit = false;
+		space_state->intersect_rays(parameters, &from, &to, 1, &result, &hit);
+
+		CHECK(hit);
+		CHECK(result.position.is_equal_approx(Vector3(0, 0.5, 0)));
+		CHECK(result.normal.is_equal_approx(Vector3(0, 1, 0)));
+		CHECK(result.rid == bodies[0]);
+		CHECK(result.shape == 0);
+	}
+
+	SUBCASE("10k rays match individual queries") {
+		// Enough rays to run the narrowphase on worker threads, slanted so that
+		// each ray crosses several boxes and the closest one must be picked.
+		const int ray_count = 10000;
+		LocalVector<Vector3> from;
+		LocalVector<Vector3> to;
+		from.resize(ray_count);
+		to.resize(ray_count);
+		for (int i = 0; i < ray_count; i++) {
+			const real_t x = (i % 100) * 0.8 - 1;
+			const real_t z = (i / 100) * 0.8 - 1;
+			from[i] = Vector3(x, 5, z);
+			to[i] = Vector3(x + 3, -2, z + 1);
+		}
+		// A degenerate ray, and one starting inside a box.
+		to[0] = from[0];
+		from[1] = Vector3(0, 0, 0);
+
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		LocalVector<bool> hits;
+		results.resize(ray_count);
+		hits.resize(ray_count);
+		space_state->intersect_rays(parameters, from.ptr(), to.ptr(), ray_count, results.ptr(), hits.ptr());
+
+		int hit_count = 0;
+		int mismatch_count = 0;
+		for (int i = 0; i < ray_count; i++) {
+			parameters.from = from[i];
+			parameters.to = to[i];
+			PhysicsDirectSpaceState3D::RayResult expected;
+			const bool expected_hit = space_state->intersect_ray(parameters, expected);
+
+			if (expected_hit != hits[i]) {
+				mismatch_count++;
+				continue;
+			}
+			if (!expected_hit) {
+				continue;
+			}
+			hit_count++;
+			if (!expected.position.is_equal_approx(results[i].position) || !expected.normal.is_equal_approx(results[i].normal) || expected.rid != results[i].rid || expected.shape != results[i].shape) {
+				mismatch_count++;
+			}
+		}
+
+		CHECK(mismatch_count == 0);
+		CHECK(hit_count > ray_count / 2);
+		CHECK(hit_count < ray_count);
+		CHECK_FALSE(hits[1]);
+	}
+
+	SUBCASE("Exclusions and masks apply to every ray") {
+		const Vector3 from[2] = { Vector3(0, 10, 0), Vector3(2, 10, 0) };
+		const Vector3 to[2] = { Vector3(0, -10, 0), Vector3(2, -10, 0) };
+		PhysicsDirectSpaceState3D::RayResult results[2];
+		bool hits[2] = {};
+
+		parameters.exclude.insert(bodies[0]);
+		space_state->intersect_rays(parameters, from, to, 2, results, hits);
+		CHECK_FALSE(hits[0]);
+		CHECK(hits[1]);
+
+		parameters.exclude.clear();
+		parameters.collision_mask = 0;
+		space_state->intersect_rays(parameters, from, to, 2, results, hits);
+		CHECK_FALSE(hits[0]);
+		CHECK_FALSE(hits[1]);
+	}
+
+	SUBCASE("Batched shape casts") {
+		RID sphere = server->sphere_shape_create();
+		server->shape_set_data(sphere, 0.25);
+
+		PhysicsDirectSpaceState3D::ShapeParameters shape_parameters;
+		shape_parameters.shape_rid = sphere;
+		shape_parameters.motion = Vector3(0, -10, 0);
+
+		const Transform3D transforms[3] = {
+			Transform3D(Basis(), Vector3(0, 5, 0)),
+			Transform3D(Basis(), Vector3(2, 5, 2)),
+			Transform3D(Basis(), Vector3(-20, 5, -20)),
+		};
+		real_t closest_safe[3];
+		real_t closest_unsafe[3];
+		CHECK(space_state->cast_motions(shape_parameters, transforms, 3, closest_safe, closest_unsafe));
+
+		for (int i = 0; i < 3; i++) {
+			shape_parameters.transform = transforms[i];
+			real_t expected_safe = 1;
+			real_t expected_unsafe = 1;
+			CHECK(space_state->cast_motion(shape_parameters, expected_safe, expected_unsafe));
+			CHECK(closest_safe[i] == doctest::Approx(expected_safe));
+			CHECK(closest_unsafe[i] == doctest::Approx(expected_unsafe));
+		}
+		CHECK(closest_safe[0] < 1);
+		CHECK(closest_safe[2] == 1);
+
+		server->free(sphere);
+	}
+
+	for (const RID &body : bodies) {
+		server->free(body);
+	}
+	server->free(box);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestGodotPhysics3DQueries
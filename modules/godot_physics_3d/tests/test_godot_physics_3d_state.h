@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*  test_godot_physics_3d_state.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysics3DState {
+
+static LocalVector<Transform3D> get_transforms(GodotPhysicsServer3D *p_server, const LocalVector<RID> &p_bodies) {
+	LocalVector<Transform3D> transforms;
+	for (const RID &body : p_bodies) {
+		transforms.push_back(p_server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM));
+	}
+	return transforms;
+}
+
+TEST_CASE("[GodotPhysics3D] Saving and restoring space states") {
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID floor_shape = server->box_shape_create();
+	server->shape_set_data(floor_shape, Vector3(20, 0.5, 20));
+	RID floor = server->body_create();
+	server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	server->body_add_shape(floor, floor_shape, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+	server->body_set_space(floor, space);
+
+	RID box_shape = server->box_shape_create();
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	LocalVector<RID> boxes;
+	for (int y = 0; y < 2; y++) {
+		for (int x = 0; x < 5; x++) {
+			for (int z = 0; z < 5; z++) {
+				RID box = server->body_create();
+				server->body_add_shape(box, box_shape);
+				server->body_set_space(box, space);
+				server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x * 0.99, 0.5 + y * 0.99, z * 0.99)));
+				boxes.push_back(box);
+			}
+		}
+	}
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	const PackedByteArray state = server->space_save_state(space);
+	const LocalVector<Transform3D> saved_transforms = get_transforms(server, boxes);
+	REQUIRE(!state.is_empty());
+
+	for (int i = 0; i < 30; i++) {
+		server->step(1.0 / 60.0);
+	}
+	const LocalVector<Transform3D> stepped_transforms = get_transforms(server, boxes);
+
+	SUBCASE("Restoring puts bodies back where they were") {
+		CHECK(server->space_restore_state(space, state));
+
+		const LocalVector<Transform3D> restored_transforms = get_transforms(server, boxes);
+		int mismatch_count = 0;
+		for (uint32_t i = 0; i < boxes.size(); i++) {
+			if (restored_transforms[i] != saved_transforms[i]) {
+				mismatch_count++;
+			}
+		}
+		CHECK(mismatch_count == 0);
+	}
+
+	SUBCASE("Simulation continues like it did after saving") {
+		CHECK(server->space_restore_state(space, state));
+		for (int i = 0; i < 30; i++) {
+			server->step(1.0 / 60.0);
+		}
+
+		// Pairs removed after saving come back without their contacts, so results can slightly differ.
+		const LocalVector<Transform3D> restepped_transforms = get_transforms(server, boxes);
+		real_t max_distance = 0.0;
+		for (uint32_t i = 0; i < boxes.size(); i++) {
+			max_distance = MAX(max_distance, restepped_transforms[i].origin.distance_to(stepped_transforms[i].origin));
+		}
+		CHECK(max_distance < 0.05);
+	}
+
+	SUBCASE("Invalid states are rejected") {
+		PackedByteArray truncated_state = state;
+		truncated_state.resize(state.size() - 1);
+
+		ERR_PRINT_OFF;
+		CHECK_FALSE(server->space_restore_state(space, PackedByteArray()));
+		CHECK_FALSE(server->space_restore_state(space, truncated_state));
+		ERR_PRINT_ON;
+
+		// Nothing is changed by invalid states.
+		const LocalVector<Transform3D> transforms = get_transforms(server, boxes);
+		int mismatch_count = 0;
+		for (uint32_t i = 0; i < boxes.size(); i++) {
+			if (transforms[i] != stepped_transforms[i]) {
+				mismatch_count++;
+			}
+		}
+		CHECK(mismatch_count == 0);
+	}
+
+	for (const RID &box : boxes) {
+		server->free(box);
+	}
+	server->free(box_shape);
+	server->free(floor);
+	server->free(floor_shape);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestGodotPhysics3DState
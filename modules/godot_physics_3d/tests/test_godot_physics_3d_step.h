@@ -0,0 +1,223 @@
+/**************************************************************************/
+/*  test_godot_physics_3d_step.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_physics_server_3d.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_tools.h"
+
+namespace TestGodotPhysics3DStep {
+
+// Steps a pile of 10x10x3 slightly overlapping boxes on a floor, which forms a
+// single island large enough to be solved by colors, and returns the final positions.
+static LocalVector<Vector3> simulate_box_pile(int p_steps, GodotSpace3D::ContactSolver p_contact_solver = GodotSpace3D::CONTACT_SOLVER_SCALAR) {
+	// Spaces read the solver from the project settings when they are created.
+	ProjectSettingOverride contact_solver("physics/3d/solver/contact_solver", p_contact_solver);
+
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID floor_shape = server->box_shape_create();
+	server->shape_set_data(floor_shape, Vector3(20, 0.5, 20));
+	RID floor = server->body_create();
+	server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	server->body_add_shape(floor, floor_shape, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+	server->body_set_space(floor, space);
+
+	RID box_shape = server->box_shape_create();
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	LocalVector<RID> boxes;
+	for (int y = 0; y < 3; y++) {
+		for (int x = 0; x < 10; x++) {
+			for (int z = 0; z < 10; z++) {
+				RID box = server->body_create();
+				server->body_add_shape(box, box_shape);
+				server->body_set_space(box, space);
+				server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x * 0.99, 0.5 + y * 0.99, z * 0.99)));
+				boxes.push_back(box);
+			}
+		}
+	}
+
+	for (int i = 0; i < p_steps; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	LocalVector<Vector3> positions;
+	for (const RID &box : boxes) {
+		Transform3D transform = server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		positions.push_back(transform.origin);
+		server->free(box);
+	}
+	server->free(box_shape);
+	server->free(floor);
+	server->free(floor_shape);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+
+	return positions;
+}
+
+TEST_CASE("[GodotPhysics3D] Large island stepping") {
+	const LocalVector<Vector3> positions = simulate_box_pile(60);
+
+	SUBCASE("Bodies stay on the floor") {
+		for (const Vector3 &position : positions) {
+			CHECK(position.y > 0.25);
+			CHECK(position.y < 3.5);
+		}
+	}
+
+	SUBCASE("Results are deterministic") {
+		// Constraints solved in parallel must not race on shared bodies.
+		const LocalVector<Vector3> positions_again = simulate_box_pile(60);
+		REQUIRE(positions_again.size() == positions.size());
+
+		int mismatch_count = 0;
+		for (uint32_t i = 0; i < positions.size(); i++) {
+			if (positions[i] != positions_again[i]) {
+				mismatch_count++;
+			}
+		}
+		CHECK(mismatch_count == 0);
+	}
+}
+
+#ifndef REAL_T_IS_DOUBLE
+TEST_CASE("[GodotPhysics3D] Large island stepping with the SIMD contact solver") {
+	const LocalVector<Vector3> positions = simulate_box_pile(60, GodotSpace3D::CONTACT_SOLVER_SIMD);
+
+	SUBCASE("Bodies stay on the floor") {
+		for (const Vector3 &position : positions) {
+			CHECK(position.y > 0.25);
+			CHECK(position.y < 3.5);
+		}
+	}
+
+	SUBCASE("Results match the scalar solver closely") {
+		// Contacts are solved in a different order, so results are close but not identical.
+		const LocalVector<Vector3> scalar_positions = simulate_box_pile(60);
+		REQUIRE(scalar_positions.size() == positions.size());
+
+		real_t max_distance = 0.0;
+		for (uint32_t i = 0; i < positions.size(); i++) {
+			max_distance = MAX(max_distance, positions[i].distance_to(scalar_positions[i]));
+		}
+		CHECK(max_distance < 0.25);
+	}
+
+	SUBCASE("Results are deterministic") {
+		const LocalVector<Vector3> positions_again = simulate_box_pile(60, GodotSpace3D::CONTACT_SOLVER_SIMD);
+		REQUIRE(positions_again.size() == positions.size());
+
+		int mismatch_count = 0;
+		for (uint32_t i = 0; i < positions.size(); i++) {
+			if (positions[i] != positions_again[i]) {
+				mismatch_count++;
+			}
+		}
+		CHECK(mismatch_count == 0);
+	}
+}
+#endif // REAL_T_IS_DOUBLE
+
+TEST_CASE("[GodotPhysics3D] Step statistics") {
+	// The server reads the setting when it is initialized.
+	ProjectSettingOverride performance_monitors("physics/3d/performance_monitors", true);
+
+	GodotPhysicsServer3D *server = memnew(GodotPhysicsServer3D);
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID floor_shape = server->box_shape_create();
+	server->shape_set_data(floor_shape, Vector3(20, 0.5, 20));
+	RID floor = server->body_create();
+	server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	server->body_add_shape(floor, floor_shape, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+	server->body_set_space(floor, space);
+
+	RID box_shape = server->box_shape_create();
+	server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	// A stack of 3 boxes touching each other, and one box on its own.
+	LocalVector<RID> boxes;
+	for (int i = 0; i < 4; i++) {
+		RID box = server->body_create();
+		server->body_add_shape(box, box_shape);
+		server->body_set_space(box, space);
+		const Vector3 position = i < 3 ? Vector3(0, 0.5 + i * 0.99, 0) : Vector3(10, 0.49, 0);
+		server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), position));
+		boxes.push_back(box);
+	}
+
+	for (int i = 0; i < 5; i++) {
+		server->step(1.0 / 60.0);
+	}
+
+	CHECK(server->get_process_info(PhysicsServer3D::INFO_CONTACT_COUNT) > 0);
+	CHECK(server->get_process_info(PhysicsServer3D::INFO_MAX_ISLAND_SIZE) == 3);
+
+	const PackedInt32Array island_sizes = server->get_process_histogram(PhysicsServer3D::HISTOGRAM_ISLAND_SIZE);
+	REQUIRE(island_sizes.size() == GodotSpace3D::ISLAND_SIZE_BUCKETS);
+	// Sizes 1 and 3 fall into buckets [1, 2) and [2, 4).
+	CHECK(island_sizes[0] == 1);
+	CHECK(island_sizes[1] == 1);
+
+	const PackedInt32Array gjk_iterations = server->get_process_histogram(PhysicsServer3D::HISTOGRAM_GJK_ITERATIONS);
+	REQUIRE(gjk_iterations.size() == GJK_EPA_ITERATION_BUCKETS);
+	int gjk_query_count = 0;
+	for (int count : gjk_iterations) {
+		gjk_query_count += count;
+	}
+	CHECK(server->get_process_info(PhysicsServer3D::INFO_GJK_QUERY_COUNT) == gjk_query_count);
+
+	for (const RID &box : boxes) {
+		server->free(box);
+	}
+	server->free(box_shape);
+	server->free(floor);
+	server->free(floor_shape);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestGodotPhysics3DStep
@@ -0,0 +1,131 @@
+/**************************************************************************/
+/*  test_godot_physics_3d_wrap_mt.h                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../godot_physics_server_3d.h"
+
+#include "core/os/os.h"
+#include "servers/physics_3d/physics_server_3d_wrap_mt.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotPhysics3DWrapMT {
+
+#ifdef THREADS_ENABLED
+
+static const int STEP_COUNT = 120;
+static const real_t STEP_DELTA = 1.0 / 60.0;
+static const real_t LINEAR_SPEED = 2.0;
+static const real_t ANGULAR_SPEED = 0.75;
+
+// The body moves and turns at constant speeds, so its transform tells after how many
+// steps it was published, once from the origin and once from the rotation.
+static void check_published_transform(const Transform3D &p_transform, int p_pushed_steps, int &r_published_steps) {
+	const real_t steps = p_transform.origin.x / (LINEAR_SPEED * STEP_DELTA);
+	const int published_steps = Math::round(steps);
+	CHECK_MESSAGE(Math::abs(steps - published_steps) < 0.01, "The origin should be published after a whole step.");
+	CHECK_MESSAGE(p_transform.basis.get_euler().y == doctest::Approx(published_steps * ANGULAR_SPEED * STEP_DELTA).epsilon(0.001), "The rotation should be published from the same step as the origin.");
+	CHECK_MESSAGE(published_steps <= p_pushed_steps, "Only pushed steps should be published.");
+	CHECK_MESSAGE(published_steps >= r_published_steps, "Published states should never go back to an older step.");
+	r_published_steps = published_steps;
+}
+
+TEST_CASE("[GodotPhysics3D] Body states published by the physics thread") {
+	PhysicsServer3DWrapMT *server = memnew(PhysicsServer3DWrapMT(memnew(GodotPhysicsServer3D(true)), true));
+	server->init();
+
+	RID space = server->space_create();
+	server->space_set_active(space, true);
+
+	RID shape = server->sphere_shape_create();
+	server->shape_set_data(shape, 0.5);
+
+	RID body = server->body_create();
+	server->body_set_mode(body, PhysicsServer3D::BODY_MODE_RIGID);
+	server->body_add_shape(body, shape);
+	server->body_set_param(body, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+	server->body_set_param(body, PhysicsServer3D::BODY_PARAM_LINEAR_DAMP_MODE, PhysicsServer3D::BODY_DAMP_MODE_REPLACE);
+	server->body_set_param(body, PhysicsServer3D::BODY_PARAM_ANGULAR_DAMP_MODE, PhysicsServer3D::BODY_DAMP_MODE_REPLACE);
+	server->body_set_param(body, PhysicsServer3D::BODY_PARAM_LINEAR_DAMP, 0.0);
+	server->body_set_param(body, PhysicsServer3D::BODY_PARAM_ANGULAR_DAMP, 0.0);
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_CAN_SLEEP, false);
+	server->body_set_space(body, space);
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(LINEAR_SPEED, 0.0, 0.0));
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(0.0, ANGULAR_SPEED, 0.0));
+
+	// The first query waits for the physics thread and starts publishing the body.
+	int published_steps = 0;
+	check_published_transform(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM), 0, published_steps);
+	CHECK_EQ(published_steps, 0);
+
+	// The physics thread steps while the main thread keeps reading.
+	for (int step = 1; step <= STEP_COUNT; step++) {
+		server->step(STEP_DELTA);
+		for (int i = 0; i < 16; i++) {
+			check_published_transform(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM), step, published_steps);
+			CHECK(Vector3(server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY)).is_equal_approx(Vector3(LINEAR_SPEED, 0.0, 0.0)));
+			CHECK(Vector3(server->body_get_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY)).is_equal_approx(Vector3(0.0, ANGULAR_SPEED, 0.0)));
+		}
+	}
+
+	// The buffers keep being exchanged until the last step is published.
+	for (int i = 0; i < 1000 && published_steps < STEP_COUNT; i++) {
+		OS::get_singleton()->delay_usec(1000);
+		check_published_transform(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM), STEP_COUNT, published_steps);
+	}
+	CHECK_EQ(published_steps, STEP_COUNT);
+
+	// Writes through the direct body state don't go through the wrapper, they are seen once the sync ends.
+	const Transform3D direct_transform(Basis(), Vector3(5.0, 0.0, 0.0));
+	server->sync();
+	server->flush_queries();
+	PhysicsDirectBodyState3D *direct_state = server->body_get_direct_state(body);
+	REQUIRE(direct_state != nullptr);
+	direct_state->set_transform(direct_transform);
+	server->end_sync();
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).is_equal_approx(direct_transform));
+
+	// Writes are seen by the next read, without waiting for a step to publish them.
+	const Transform3D moved_transform(Basis(), Vector3(-10.0, 0.0, 0.0));
+	server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, moved_transform);
+	CHECK(Transform3D(server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM)).is_equal_approx(moved_transform));
+
+	server->free(body);
+	server->free(shape);
+	server->free(space);
+
+	server->finish();
+	memdelete(server);
+}
+
+#endif // THREADS_ENABLED
+
+} // namespace TestGodotPhysics3DWrapMT
@@ -236,6 +236,22 @@ PhysicsDirectSpaceState3D *JoltPhysicsServer3D::space_get_direct_state(RID p_spa
 	return space->get_direct_state();
 }
 
+PackedByteArray JoltPhysicsServer3D::space_save_state(RID p_space) const {
+	JoltSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+	ERR_FAIL_COND_V_MSG((on_separate_thread && !doing_sync) || space->is_stepping(), PackedByteArray(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	return space->save_state();
+}
+
+bool JoltPhysicsServer3D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	JoltSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, false);
+	ERR_FAIL_COND_V_MSG((on_separate_thread && !doing_sync) || space->is_stepping(), false, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+
+	return space->restore_state(p_state);
+}
+
 void JoltPhysicsServer3D::space_set_debug_contacts(RID p_space, int p_max_contacts) {
 #ifdef DEBUG_ENABLED
 	JoltSpace3D *space = space_owner.get_or_null(p_space);
@@ -157,6 +157,8 @@ public:
 	virtual real_t space_get_param(RID p_space, PhysicsServer3D::SpaceParameter p_param) const override;
 
 	virtual PhysicsDirectSpaceState3D *space_get_direct_state(RID p_space) override;
+	virtual PackedByteArray space_save_state(RID p_space) const override;
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override;
 
 	virtual void space_set_debug_contacts(RID p_space, int p_max_contacts) override;
 	virtual PackedVector3Array space_get_contacts(RID p_space) const override;
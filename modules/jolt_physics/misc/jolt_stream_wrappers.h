@@ -30,14 +30,80 @@
 
 #pragma once
 
-#ifdef DEBUG_ENABLED
-
-#include "core/io/file_access.h"
+#include "core/templates/local_vector.h"
 
 #include "Jolt/Jolt.h"
 
 #include "Jolt/Core/StreamIn.h"
 #include "Jolt/Core/StreamOut.h"
+#include "Jolt/Physics/StateRecorder.h"
+
+// Records the state of a physics system into a buffer, see `JoltSpace3D::save_state`.
+class JoltStateOutputWrapper final : public JPH::StateRecorder {
+	LocalVector<uint8_t> &buffer;
+
+public:
+	explicit JoltStateOutputWrapper(LocalVector<uint8_t> &p_buffer) :
+			buffer(p_buffer) {}
+
+	virtual void WriteBytes(const void *p_data, size_t p_bytes) override {
+		const uint32_t offset = buffer.size();
+		buffer.resize(offset + p_bytes);
+		memcpy(buffer.ptr() + offset, p_data, p_bytes);
+	}
+
+	virtual void ReadBytes(void *p_data, size_t p_bytes) override {
+		// Only used in validation mode, which isn't supported.
+		ERR_FAIL_MSG("Validating Jolt Physics states isn't supported.");
+	}
+
+	virtual bool IsEOF() const override {
+		return true;
+	}
+
+	virtual bool IsFailed() const override {
+		return false;
+	}
+};
+
+// Reads back a state recorded by `JoltStateOutputWrapper`, see `JoltSpace3D::restore_state`.
+class JoltStateInputWrapper final : public JPH::StateRecorder {
+	const uint8_t *data = nullptr;
+	const uint8_t *end = nullptr;
+	bool failed = false;
+
+public:
+	JoltStateInputWrapper(const uint8_t *p_data, size_t p_size) :
+			data(p_data), end(p_data + p_size) {}
+
+	virtual void WriteBytes(const void *p_data, size_t p_bytes) override {
+		failed = true;
+	}
+
+	virtual void ReadBytes(void *p_data, size_t p_bytes) override {
+		if (unlikely(failed || size_t(end - data) < p_bytes)) {
+			// Jolt checks for failure only after reading, so it must not read garbage meanwhile.
+			memset(p_data, 0, p_bytes);
+			failed = true;
+			return;
+		}
+
+		memcpy(p_data, data, p_bytes);
+		data += p_bytes;
+	}
+
+	virtual bool IsEOF() const override {
+		return data == end;
+	}
+
+	virtual bool IsFailed() const override {
+		return failed;
+	}
+};
+
+#ifdef DEBUG_ENABLED
+
+#include "core/io/file_access.h"
 
 class JoltStreamOutputWrapper final : public JPH::StreamOut {
 	Ref<FileAccess> file_access;
@@ -156,6 +156,7 @@ public:
 	virtual ~JoltBody3D() override;
 
 	void set_transform(Transform3D p_transform);
+	void reset_kinematic_transform() { _update_kinematic_transform(); }
 
 	Variant get_state(PhysicsServer3D::BodyState p_state) const;
 	void set_state(PhysicsServer3D::BodyState p_state, const Variant &p_value);
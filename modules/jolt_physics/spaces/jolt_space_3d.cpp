@@ -63,6 +63,25 @@ constexpr double SPACE_DEFAULT_SLEEP_THRESHOLD_LINEAR = 0.1;
 constexpr double SPACE_DEFAULT_SLEEP_THRESHOLD_ANGULAR = 8.0 * Math::PI / 180;
 constexpr double SPACE_DEFAULT_SOLVER_ITERATIONS = 8;
 
+// Saved states start with this header, followed by the state recorded by Jolt.
+struct JoltSpaceStateHeader {
+	static constexpr uint32_t MAGIC = 0x44334A47; // "GJ3D"
+
+	uint32_t magic = MAGIC;
+	uint32_t real_size = sizeof(JPH::Real);
+	// Jolt can only restore states into the same set of bodies they were saved from.
+	uint32_t body_count = 0;
+	uint32_t body_hash = 0;
+};
+
+uint32_t hash_body_ids(const JPH::BodyIDVector &p_body_ids) {
+	uint32_t hash = HASH_MURMUR3_SEED;
+	for (const JPH::BodyID &body_id : p_body_ids) {
+		hash = hash_murmur3_one_32(body_id.GetIndexAndSequenceNumber(), hash);
+	}
+	return hash_fmix32(hash);
+}
+
 } // namespace
 
 void JoltSpace3D::_pre_step(float p_step) {
@@ -475,6 +494,56 @@ void JoltSpace3D::flush_pending_objects() {
 	}
 }
 
+PackedByteArray JoltSpace3D::save_state() {
+	flush_pending_objects();
+
+	JPH::BodyIDVector body_ids;
+	physics_system->GetBodies(body_ids);
+
+	JoltSpaceStateHeader header;
+	header.body_count = (uint32_t)body_ids.size();
+	header.body_hash = hash_body_ids(body_ids);
+
+	// The buffer is kept between calls, since rollback saves states every frame.
+	state_buffer.clear();
+	JoltStateOutputWrapper recorder(state_buffer);
+	recorder.WriteBytes(&header, sizeof(JoltSpaceStateHeader));
+	physics_system->SaveState(recorder);
+
+	PackedByteArray state;
+	state.resize(state_buffer.size());
+	memcpy(state.ptrw(), state_buffer.ptr(), state_buffer.size());
+	return state;
+}
+
+bool JoltSpace3D::restore_state(const PackedByteArray &p_state) {
+	flush_pending_objects();
+
+	JoltSpaceStateHeader header;
+	ERR_FAIL_COND_V_MSG(p_state.size() < (int64_t)sizeof(JoltSpaceStateHeader), false, "Invalid physics space state.");
+	memcpy(&header, p_state.ptr(), sizeof(JoltSpaceStateHeader));
+	ERR_FAIL_COND_V_MSG(header.magic != JoltSpaceStateHeader::MAGIC, false, "Invalid physics space state, it wasn't saved by Jolt Physics.");
+	ERR_FAIL_COND_V_MSG(header.real_size != sizeof(JPH::Real), false, "Invalid physics space state, it was saved by a build using a different floating-point precision.");
+
+	JPH::BodyIDVector body_ids;
+	physics_system->GetBodies(body_ids);
+	ERR_FAIL_COND_V_MSG(header.body_count != body_ids.size() || header.body_hash != hash_body_ids(body_ids), false, "Physics space state can't be restored, since objects were added to or removed from the space after it was saved.");
+
+	JoltStateInputWrapper recorder(p_state.ptr() + sizeof(JoltSpaceStateHeader), p_state.size() - sizeof(JoltSpaceStateHeader));
+	const bool restored = physics_system->RestoreState(recorder) && !recorder.IsFailed();
+	ERR_FAIL_COND_V_MSG(!restored, false, "Invalid physics space state.");
+
+	// Kinematic bodies are moved towards their last set transform on every step, so it has to follow them back.
+	for (const JPH::BodyID &body_id : body_ids) {
+		JoltBody3D *body = try_get_body(body_id);
+		if (body != nullptr && body->is_kinematic()) {
+			body->reset_kinematic_transform();
+		}
+	}
+
+	return true;
+}
+
 void JoltSpace3D::set_is_object_sleeping(const JPH::BodyID &p_jolt_id, bool p_enable) {
 	if (p_enable) {
 		if (pending_objects_awake.erase_unordered(p_jolt_id)) {
@@ -65,6 +65,8 @@ class JoltSpace3D {
 	LocalVector<JPH::BodyID> pending_objects_sleeping;
 	LocalVector<JPH::BodyID> pending_objects_awake;
 
+	LocalVector<uint8_t> state_buffer;
+
 	RID rid;
 
 	JPH::JobSystem *job_system = nullptr;
@@ -138,6 +140,9 @@ public:
 
 	void set_is_object_sleeping(const JPH::BodyID &p_jolt_id, bool p_enable);
 
+	PackedByteArray save_state();
+	bool restore_state(const PackedByteArray &p_state);
+
 	void enqueue_call_queries(SelfList<JoltBody3D> *p_body);
 	void enqueue_call_queries(SelfList<JoltArea3D> *p_area);
 	void dequeue_call_queries(SelfList<JoltBody3D> *p_body);
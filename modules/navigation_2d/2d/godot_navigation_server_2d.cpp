@@ -455,6 +455,13 @@ Vector2 GodotNavigationServer2D::map_get_random_point(RID p_map, uint32_t p_navi
 	return map->get_random_point(p_navigation_layers, p_uniformly);
 }
 
+Vector2 GodotNavigationServer2D::map_get_flow_field_direction(RID p_map, const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers) const {
+	NavMap2D *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Vector2());
+
+	return map->get_flow_field_direction(p_target_position, p_position, p_navigation_layers);
+}
+
 RID GodotNavigationServer2D::region_create() {
 	MutexLock lock(operations_mutex);
 
@@ -971,6 +978,13 @@ bool GodotNavigationServer2D::agent_is_map_changed(RID p_agent) const {
 	return agent->is_map_changed();
 }
 
+Vector2 GodotNavigationServer2D::agent_get_flow_field_direction(RID p_agent, const Vector2 &p_target_position, uint32_t p_navigation_layers) const {
+	const NavAgent2D *agent = agent_owner.get_or_null(p_agent);
+	ERR_FAIL_NULL_V(agent, Vector2());
+
+	return agent->get_flow_field_direction(p_target_position, p_navigation_layers);
+}
+
 COMMAND_2(agent_set_avoidance_callback, RID, p_agent, Callable, p_callback) {
 	NavAgent2D *agent = agent_owner.get_or_null(p_agent);
 	ERR_FAIL_NULL(agent);
@@ -145,6 +145,7 @@ public:
 	virtual bool map_get_use_async_iterations(RID p_map) const override;
 
 	virtual Vector2 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const override;
+	virtual Vector2 map_get_flow_field_direction(RID p_map, const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const override;
 
 	virtual RID region_create() override;
 	virtual uint32_t region_get_iteration_id(RID p_region) const override;
@@ -288,6 +289,7 @@ public:
 
 	/// Returns true if the map got changed the previous frame.
 	virtual bool agent_is_map_changed(RID p_agent) const override;
+	virtual Vector2 agent_get_flow_field_direction(RID p_agent, const Vector2 &p_target_position, uint32_t p_navigation_layers = 1) const override;
 
 	/// Callback called at the end of the RVO process
 	COMMAND_2(agent_set_avoidance_callback, RID, p_agent, Callable, p_callback);
@@ -38,6 +38,7 @@
 #include "nav_region_iteration_2d.h"
 
 #include "core/config/project_settings.h"
+#include "servers/nav_heap.h"
 
 using namespace Nav2D;
 
@@ -71,6 +72,8 @@ void NavMapBuilder2D::build_navmap_iteration(NavMapIterationBuild2D &r_build) {
 
 	_build_step_navlink_connections(r_build);
 
+	_build_step_cluster_hierarchy(r_build);
+
 	_build_update_map_iteration(r_build);
 }
 
@@ -393,6 +396,348 @@ void NavMapBuilder2D::_build_step_navlink_connections(NavMapIterationBuild2D &r_
 	r_build.polygon_count = polygon_count;
 }
 
+void NavMapBuilder2D::_add_cluster_portal(LocalVector<ClusterPortal> &r_portals, HashMap<uint64_t, uint32_t> &r_portal_indices, uint32_t p_from_cluster, uint32_t p_from_polygon, uint32_t p_to_cluster, uint32_t p_to_polygon, const Vector2 &p_position) {
+	// All connections between the same two clusters share a single portal.
+	const uint32_t from_side = p_from_cluster < p_to_cluster ? 0 : 1;
+	const uint64_t key = from_side == 0 ? (((uint64_t)p_from_cluster << 32) | p_to_cluster) : (((uint64_t)p_to_cluster << 32) | p_from_cluster);
+
+	HashMap<uint64_t, uint32_t>::Iterator portal_it = r_portal_indices.find(key);
+	if (!portal_it) {
+		ClusterPortal portal;
+		portal.clusters[from_side] = p_from_cluster;
+		portal.clusters[1 - from_side] = p_to_cluster;
+		portal.polygons[from_side] = p_from_polygon;
+		portal.polygons[1 - from_side] = p_to_polygon;
+		portal.position = p_position;
+
+		portal_it = r_portal_indices.insert(key, r_portals.size());
+		r_portals.push_back(portal);
+	}
+	r_portals[portal_it->value].traversable[from_side] = true;
+}
+
+struct ClusterCostNode {
+	uint32_t polygon = 0;
+	real_t cost = 0.0;
+};
+
+struct ClusterCostNodeGreaterThan {
+	bool operator()(const ClusterCostNode &p_node_a, const ClusterCostNode &p_node_b) const {
+		return p_node_a.cost > p_node_b.cost;
+	}
+};
+
+void NavMapBuilder2D::_build_region_clusters(NavRegionIteration2D &r_region, real_t p_cluster_size) {
+	RegionClusters &region_clusters = r_region.clusters;
+	region_clusters.clear();
+	region_clusters.cluster_size = p_cluster_size;
+
+	const LocalVector<Polygon> &polygons = r_region.navmesh_polygons;
+	const LocalVector<LocalVector<Connection>> &internal_connections = r_region.internal_connections;
+	const uint32_t polygon_count = polygons.size();
+	const bool has_internal_connections = internal_connections.size() == polygon_count;
+
+	LocalVector<Vector2> polygon_centers;
+	LocalVector<Vector2i> polygon_cells;
+	polygon_centers.resize(polygon_count);
+	polygon_cells.resize(polygon_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		const Polygon &polygon = polygons[i];
+		Vector2 center;
+		for (const Vector2 &vertex : polygon.vertices) {
+			center += vertex;
+		}
+		if (!polygon.vertices.is_empty()) {
+			center /= polygon.vertices.size();
+		}
+		polygon_centers[i] = center;
+		polygon_cells[i] = Vector2i((center / p_cluster_size).floor());
+	}
+
+	// Clusters are the connected parts of the navmesh inside each cell of the cluster grid.
+	LocalVector<uint32_t> &polygon_clusters = region_clusters.polygon_clusters;
+	polygon_clusters.resize(polygon_count);
+	for (uint32_t &cluster : polygon_clusters) {
+		cluster = UINT32_MAX;
+	}
+
+	LocalVector<uint32_t> polygon_stack;
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_clusters[i] != UINT32_MAX) {
+			continue;
+		}
+
+		const uint32_t cluster = region_clusters.cluster_count++;
+		polygon_clusters[i] = cluster;
+		if (!has_internal_connections) {
+			continue;
+		}
+
+		polygon_stack.push_back(i);
+		while (!polygon_stack.is_empty()) {
+			const uint32_t polygon_index = polygon_stack[polygon_stack.size() - 1];
+			polygon_stack.remove_at(polygon_stack.size() - 1);
+
+			for (const Connection &connection : internal_connections[polygon_index]) {
+				const uint32_t neighbor_index = connection.polygon->id;
+				if (polygon_clusters[neighbor_index] == UINT32_MAX && polygon_cells[neighbor_index] == polygon_cells[i]) {
+					polygon_clusters[neighbor_index] = cluster;
+					polygon_stack.push_back(neighbor_index);
+				}
+			}
+		}
+	}
+
+	// Border polygons connect to other clusters or may be connected to other regions.
+	LocalVector<uint8_t> polygon_is_border;
+	polygon_is_border.resize_initialized(polygon_count);
+
+	HashMap<uint64_t, uint32_t> portal_indices;
+	if (has_internal_connections) {
+		for (uint32_t i = 0; i < polygon_count; i++) {
+			for (const Connection &connection : internal_connections[i]) {
+				const uint32_t neighbor_index = connection.polygon->id;
+				if (polygon_clusters[neighbor_index] == polygon_clusters[i]) {
+					continue;
+				}
+				polygon_is_border[i] = 1;
+				_add_cluster_portal(region_clusters.portals, portal_indices, polygon_clusters[i], i, polygon_clusters[neighbor_index], neighbor_index, (connection.pathway_start + connection.pathway_end) * 0.5);
+			}
+		}
+	}
+	for (const ConnectableEdge &external_edge : r_region.external_edges) {
+		polygon_is_border[external_edge.polygon_index] = 1;
+	}
+
+	const uint32_t cluster_count = region_clusters.cluster_count;
+
+	LocalVector<uint32_t> &border_offsets = region_clusters.cluster_border_offsets;
+	border_offsets.resize_initialized(cluster_count + 1);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_is_border[i]) {
+			border_offsets[polygon_clusters[i] + 1]++;
+		}
+	}
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		border_offsets[i + 1] += border_offsets[i];
+	}
+
+	LocalVector<uint32_t> &border_polygons = region_clusters.border_polygons;
+	LocalVector<uint32_t> &polygon_border_indices = region_clusters.polygon_border_indices;
+	border_polygons.resize(border_offsets[cluster_count]);
+	polygon_border_indices.resize(polygon_count);
+
+	LocalVector<uint32_t> border_fill_offsets;
+	border_fill_offsets.resize(cluster_count);
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		border_fill_offsets[i] = border_offsets[i];
+	}
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_is_border[i]) {
+			const uint32_t border_index = border_fill_offsets[polygon_clusters[i]]++;
+			border_polygons[border_index] = i;
+			polygon_border_indices[i] = border_index;
+		} else {
+			polygon_border_indices[i] = UINT32_MAX;
+		}
+	}
+
+	LocalVector<uint32_t> &cost_offsets = region_clusters.cluster_cost_offsets;
+	cost_offsets.resize(cluster_count);
+	uint32_t cost_count = 0;
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		const uint32_t border_count = border_offsets[i + 1] - border_offsets[i];
+		cost_offsets[i] = cost_count;
+		cost_count += border_count * border_count;
+	}
+	region_clusters.border_costs.resize(cost_count);
+
+	if (!has_internal_connections) {
+		// Every polygon is a cluster of its own.
+		for (real_t &cost : region_clusters.border_costs) {
+			cost = 0.0;
+		}
+		return;
+	}
+
+	// Precompute the travel costs between the border polygons of each cluster with a Dijkstra search from each of them.
+	const real_t travel_cost = r_region.get_travel_cost();
+
+	LocalVector<real_t> polygon_costs;
+	polygon_costs.resize(polygon_count);
+	for (real_t &cost : polygon_costs) {
+		cost = FLT_MAX;
+	}
+	LocalVector<uint32_t> visited_polygons;
+	Heap<ClusterCostNode, ClusterCostNodeGreaterThan> traversable_polygons;
+
+	for (uint32_t cluster = 0; cluster < cluster_count; cluster++) {
+		const uint32_t border_begin = border_offsets[cluster];
+		const uint32_t border_count = border_offsets[cluster + 1] - border_begin;
+
+		for (uint32_t source = 0; source < border_count; source++) {
+			const uint32_t source_polygon = border_polygons[border_begin + source];
+			polygon_costs[source_polygon] = 0.0;
+			visited_polygons.push_back(source_polygon);
+			traversable_polygons.push({ source_polygon, 0.0 });
+
+			while (!traversable_polygons.is_empty()) {
+				const ClusterCostNode node = traversable_polygons.pop();
+				if (node.cost > polygon_costs[node.polygon]) {
+					continue; // Already reached with a lower cost.
+				}
+
+				for (const Connection &connection : internal_connections[node.polygon]) {
+					const uint32_t neighbor_index = connection.polygon->id;
+					if (polygon_clusters[neighbor_index] != cluster) {
+						continue;
+					}
+
+					const real_t cost = node.cost + polygon_centers[node.polygon].distance_to(polygon_centers[neighbor_index]) * travel_cost;
+					if (cost < polygon_costs[neighbor_index]) {
+						if (polygon_costs[neighbor_index] == FLT_MAX) {
+							visited_polygons.push_back(neighbor_index);
+						}
+						polygon_costs[neighbor_index] = cost;
+						traversable_polygons.push({ neighbor_index, cost });
+					}
+				}
+			}
+
+			real_t *source_costs = &region_clusters.border_costs[cost_offsets[cluster] + source * border_count];
+			for (uint32_t target = 0; target < border_count; target++) {
+				source_costs[target] = polygon_costs[border_polygons[border_begin + target]];
+			}
+
+			for (uint32_t polygon_index : visited_polygons) {
+				polygon_costs[polygon_index] = FLT_MAX;
+			}
+			visited_polygons.clear();
+		}
+	}
+}
+
+void NavMapBuilder2D::_build_step_cluster_hierarchy(NavMapIterationBuild2D &r_build) {
+	NavMapIteration2D *map_iteration = r_build.map_iteration;
+	const real_t cluster_size = r_build.cluster_size;
+
+	LocalVector<uint32_t> &polygon_clusters = map_iteration->polygon_clusters;
+	LocalVector<ClusterInfo> &clusters = map_iteration->clusters;
+	LocalVector<ClusterPortal> &cluster_portals = map_iteration->cluster_portals;
+	LocalVector<uint32_t> &cluster_portal_offsets = map_iteration->cluster_portal_offsets;
+	LocalVector<uint32_t> &cluster_portal_indices = map_iteration->cluster_portal_indices;
+
+	map_iteration->cluster_size = cluster_size;
+	polygon_clusters.clear();
+	clusters.clear();
+	cluster_portals.clear();
+	cluster_portal_offsets.clear();
+	cluster_portal_indices.clear();
+
+	if (cluster_size <= 0.0) {
+		return;
+	}
+
+	polygon_clusters.resize(r_build.polygon_count);
+
+	// Map polygon id of the first polygon of each region and link, matching the ids used by the path query slots.
+	HashMap<const NavBaseIteration2D *, uint32_t> polygon_offsets;
+	HashMap<uint64_t, uint32_t> portal_indices;
+
+	uint32_t polygon_offset = 0;
+	for (const Ref<NavRegionIteration2D> &region : map_iteration->region_iterations) {
+		// Region iterations are replaced when their region changes, so only new ones need their clusters built.
+		if (region->clusters.cluster_size != cluster_size) {
+			_build_region_clusters(*region.ptr(), cluster_size);
+		}
+
+		const RegionClusters &region_clusters = region->clusters;
+		const uint32_t cluster_offset = clusters.size();
+
+		for (uint32_t i = 0; i < region_clusters.cluster_count; i++) {
+			ClusterInfo cluster;
+			cluster.owner = region.ptr();
+			cluster.region_clusters = &region_clusters;
+			cluster.local_cluster = i;
+			cluster.polygon_offset = polygon_offset;
+			clusters.push_back(cluster);
+		}
+
+		const uint32_t polygons_size = region->navmesh_polygons.size();
+		for (uint32_t i = 0; i < polygons_size; i++) {
+			polygon_clusters[polygon_offset + i] = cluster_offset + region_clusters.polygon_clusters[i];
+		}
+
+		for (const ClusterPortal &portal : region_clusters.portals) {
+			for (uint32_t side = 0; side < 2; side++) {
+				if (portal.traversable[side]) {
+					_add_cluster_portal(cluster_portals, portal_indices, cluster_offset + portal.clusters[side], polygon_offset + portal.polygons[side], cluster_offset + portal.clusters[1 - side], polygon_offset + portal.polygons[1 - side], portal.position);
+				}
+			}
+		}
+
+		polygon_offsets[region.ptr()] = polygon_offset;
+		polygon_offset += polygons_size;
+	}
+
+	// Every link is a cluster of its own.
+	for (const Polygon &link_polygon : map_iteration->navlink_polygons) {
+		ClusterInfo cluster;
+		cluster.owner = link_polygon.owner;
+		cluster.polygon_offset = polygon_offset;
+
+		polygon_clusters[polygon_offset] = clusters.size();
+		clusters.push_back(cluster);
+
+		polygon_offsets[link_polygon.owner] = polygon_offset;
+		polygon_offset++;
+	}
+
+	// Add the portals of the connections between regions and links.
+	for (const KeyValue<const NavBaseIteration2D *, LocalVector<LocalVector<Connection>>> &E : map_iteration->navbases_polygons_external_connections) {
+		const uint32_t *owner_polygon_offset = polygon_offsets.getptr(E.key);
+		ERR_CONTINUE(owner_polygon_offset == nullptr);
+		const bool owner_is_link = E.key->get_type() == NavigationEnums2D::PathSegmentType::PATH_SEGMENT_TYPE_LINK;
+
+		for (uint32_t i = 0; i < E.value.size(); i++) {
+			// Links have a single polygon that holds all of their connections.
+			const uint32_t from_polygon = *owner_polygon_offset + (owner_is_link ? 0 : i);
+
+			for (const Connection &connection : E.value[i]) {
+				const uint32_t *to_polygon_offset = polygon_offsets.getptr(connection.polygon->owner);
+				ERR_CONTINUE(to_polygon_offset == nullptr);
+				const uint32_t to_polygon = *to_polygon_offset + connection.polygon->id;
+
+				if (polygon_clusters[from_polygon] != polygon_clusters[to_polygon]) {
+					_add_cluster_portal(cluster_portals, portal_indices, polygon_clusters[from_polygon], from_polygon, polygon_clusters[to_polygon], to_polygon, (connection.pathway_start + connection.pathway_end) * 0.5);
+				}
+			}
+		}
+	}
+
+	// Index the portals of each cluster.
+	const uint32_t cluster_count = clusters.size();
+	cluster_portal_offsets.resize_initialized(cluster_count + 1);
+	for (const ClusterPortal &portal : cluster_portals) {
+		cluster_portal_offsets[portal.clusters[0] + 1]++;
+		cluster_portal_offsets[portal.clusters[1] + 1]++;
+	}
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		cluster_portal_offsets[i + 1] += cluster_portal_offsets[i];
+	}
+
+	LocalVector<uint32_t> portal_fill_offsets;
+	portal_fill_offsets.resize(cluster_count);
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		portal_fill_offsets[i] = cluster_portal_offsets[i];
+	}
+	cluster_portal_indices.resize(cluster_portal_offsets[cluster_count]);
+	for (uint32_t i = 0; i < cluster_portals.size(); i++) {
+		cluster_portal_indices[portal_fill_offsets[cluster_portals[i].clusters[0]]++] = i;
+		cluster_portal_indices[portal_fill_offsets[cluster_portals[i].clusters[1]]++] = i;
+	}
+}
+
 void NavMapBuilder2D::_build_update_map_iteration(NavMapIterationBuild2D &r_build) {
 	NavMapIteration2D *map_iteration = r_build.map_iteration;
 
@@ -412,6 +757,13 @@ void NavMapBuilder2D::_build_update_map_iteration(NavMapIterationBuild2D &r_buil
 		p_path_query_slot.poly_to_id.clear();
 		p_path_query_slot.poly_to_id.reserve(total_polygon_count);
 
+		p_path_query_slot.traversable_portals.clear();
+		p_path_query_slot.portal_nodes.clear();
+		p_path_query_slot.portal_nodes.resize(map_iteration->cluster_portals.size() * 2);
+		p_path_query_slot.cluster_corridor_marks.clear();
+		p_path_query_slot.cluster_corridor_marks.resize_initialized(map_iteration->clusters.size());
+		p_path_query_slot.cluster_corridor_mark = 0;
+
 		int polygon_id = 0;
 		for (Ref<NavRegionIteration2D> &region : map_iteration->region_iterations) {
 			for (const Polygon &polygon : region->navmesh_polygons) {
@@ -33,6 +33,7 @@
 #include "../nav_utils_2d.h"
 
 struct NavMapIterationBuild2D;
+class NavRegionIteration2D;
 
 class NavMapBuilder2D {
 	static void _build_step_gather_region_polygons(NavMapIterationBuild2D &r_build);
@@ -40,6 +41,9 @@ class NavMapBuilder2D {
 	static void _build_step_merge_edge_connection_pairs(NavMapIterationBuild2D &r_build);
 	static void _build_step_edge_connection_margin_connections(NavMapIterationBuild2D &r_build);
 	static void _build_step_navlink_connections(NavMapIterationBuild2D &r_build);
+	static void _build_step_cluster_hierarchy(NavMapIterationBuild2D &r_build);
+	static void _build_region_clusters(NavRegionIteration2D &r_region, real_t p_cluster_size);
+	static void _add_cluster_portal(LocalVector<Nav2D::ClusterPortal> &r_portals, HashMap<uint64_t, uint32_t> &r_portal_indices, uint32_t p_from_cluster, uint32_t p_from_polygon, uint32_t p_to_cluster, uint32_t p_to_polygon, const Vector2 &p_position);
 	static void _build_update_map_iteration(NavMapIterationBuild2D &r_build);
 
 public:
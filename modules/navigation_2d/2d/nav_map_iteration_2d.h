@@ -47,6 +47,7 @@ struct NavMapIterationBuild2D {
 	bool use_edge_connections = true;
 	real_t edge_connection_margin;
 	real_t link_connection_radius;
+	real_t cluster_size = 0.0;
 	Nav2D::PerformanceData performance_data;
 	int polygon_count = 0;
 	int free_edge_count = 0;
@@ -87,6 +88,14 @@ struct NavMapIteration2D {
 
 	HashMap<NavRegion2D *, Ref<NavRegionIteration2D>> region_ptr_to_region_iteration;
 
+	// Hierarchical pathfinding abstraction, only built when the cluster size is above zero.
+	real_t cluster_size = 0.0;
+	LocalVector<uint32_t> polygon_clusters;
+	LocalVector<Nav2D::ClusterInfo> clusters;
+	LocalVector<Nav2D::ClusterPortal> cluster_portals;
+	LocalVector<uint32_t> cluster_portal_offsets;
+	LocalVector<uint32_t> cluster_portal_indices;
+
 	LocalVector<NavMeshQueries2D::PathQuerySlot> path_query_slots;
 	Mutex path_query_slots_mutex;
 	Semaphore path_query_slots_semaphore;
@@ -100,6 +109,13 @@ struct NavMapIteration2D {
 		navbases_polygons_external_connections.clear();
 		navlink_polygons.clear();
 		region_ptr_to_region_iteration.clear();
+
+		cluster_size = 0.0;
+		polygon_clusters.clear();
+		clusters.clear();
+		cluster_portals.clear();
+		cluster_portal_offsets.clear();
+		cluster_portal_indices.clear();
 	}
 };
 
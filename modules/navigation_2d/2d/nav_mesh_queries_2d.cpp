@@ -39,6 +39,9 @@
 
 using namespace Nav2D;
 
+// Upper limit for the cells of the grid that finds the polygons of flow field positions.
+constexpr int64_t FLOW_FIELD_GRID_MAX_CELLS = 1 << 20;
+
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (-((m_c) - (m_a)).cross((m_b) - (m_a)))
 
 bool NavMeshQueries2D::emit_callback(const Callable &p_callback) {
@@ -84,13 +87,22 @@ Vector2 NavMeshQueries2D::polygons_get_random_point(const LocalVector<Polygon> &
 		uint32_t rrp_polygon_index = region_E->value;
 		ERR_FAIL_UNSIGNED_INDEX_V(rrp_polygon_index, region_polygons.size(), Vector2());
 
-		const Polygon &rr_polygon = region_polygons[rrp_polygon_index];
+		return _polygon_get_random_point(region_polygons[rrp_polygon_index], p_uniformly);
+
+	} else {
+		uint32_t rrp_polygon_index = Math::random(int(0), region_polygons.size() - 1);
+
+		return _polygon_get_random_point(region_polygons[rrp_polygon_index], p_uniformly);
+	}
+}
 
+Vector2 NavMeshQueries2D::_polygon_get_random_point(const Polygon &p_polygon, bool p_uniformly) {
+	if (p_uniformly) {
 		real_t accumulated_polygon_area = 0;
 		RBMap<real_t, uint32_t> polygon_area_map;
 
-		for (uint32_t rpp_index = 2; rpp_index < rr_polygon.vertices.size(); rpp_index++) {
-			real_t triangle_area = Triangle2(rr_polygon.vertices[0], rr_polygon.vertices[rpp_index - 1], rr_polygon.vertices[rpp_index]).get_area();
+		for (uint32_t rpp_index = 2; rpp_index < p_polygon.vertices.size(); rpp_index++) {
+			real_t triangle_area = Triangle2(p_polygon.vertices[0], p_polygon.vertices[rpp_index - 1], p_polygon.vertices[rpp_index]).get_area();
 
 			if (triangle_area == 0.0) {
 				continue;
@@ -108,21 +120,17 @@ Vector2 NavMeshQueries2D::polygons_get_random_point(const LocalVector<Polygon> &
 		RBMap<real_t, uint32_t>::Iterator polygon_E = polygon_area_map.find_closest(polygon_area_map_pos);
 		ERR_FAIL_COND_V(!polygon_E, Vector2());
 		uint32_t rrp_face_index = polygon_E->value;
-		ERR_FAIL_UNSIGNED_INDEX_V(rrp_face_index, rr_polygon.vertices.size(), Vector2());
+		ERR_FAIL_UNSIGNED_INDEX_V(rrp_face_index, p_polygon.vertices.size(), Vector2());
 
-		const Triangle2 triangle(rr_polygon.vertices[0], rr_polygon.vertices[rrp_face_index - 1], rr_polygon.vertices[rrp_face_index]);
+		const Triangle2 triangle(p_polygon.vertices[0], p_polygon.vertices[rrp_face_index - 1], p_polygon.vertices[rrp_face_index]);
 
 		Vector2 triangle_random_position = triangle.get_random_point_inside();
 		return triangle_random_position;
 
 	} else {
-		uint32_t rrp_polygon_index = Math::random(int(0), region_polygons.size() - 1);
-
-		const Polygon &rr_polygon = region_polygons[rrp_polygon_index];
-
-		uint32_t rrp_face_index = Math::random(int(2), rr_polygon.vertices.size() - 1);
+		uint32_t rrp_face_index = Math::random(int(2), p_polygon.vertices.size() - 1);
 
-		const Triangle2 triangle(rr_polygon.vertices[0], rr_polygon.vertices[rrp_face_index - 1], rr_polygon.vertices[rrp_face_index]);
+		const Triangle2 triangle(p_polygon.vertices[0], p_polygon.vertices[rrp_face_index - 1], p_polygon.vertices[rrp_face_index]);
 
 		Vector2 triangle_random_position = triangle.get_random_point_inside();
 		return triangle_random_position;
@@ -245,34 +253,40 @@ void NavMeshQueries2D::_query_task_find_start_end_positions(NavMeshPathQueryTask
 			continue;
 		}
 
-		// Find the initial poly and the end poly on this map.
-		for (const Polygon &p : region->get_navmesh_polygons()) {
-			// Only consider the polygon if it in a region with compatible layers.
-			if ((p_query_task.navigation_layers & p.owner->get_navigation_layers()) == 0) {
-				continue;
-			}
+		// Only consider the polygons if they are in a region with compatible layers.
+		if ((p_query_task.navigation_layers & region->get_navigation_layers()) == 0) {
+			continue;
+		}
 
-			// For each triangle check the distance between the origin/destination.
+		// Find the initial poly and the end poly on this map, only searching the polygons closer than the best ones so far.
+		// For each triangle check the distance between the origin/destination.
+		region->polygon_bvh.query_closest(p_query_task.start_position, begin_d, [&](uint32_t p_polygon_index, real_t &r_begin_d) {
+			const Polygon &p = region->navmesh_polygons[p_polygon_index];
 			for (uint32_t point_id = 2; point_id < p.vertices.size(); point_id++) {
 				const Triangle2 triangle(p.vertices[0], p.vertices[point_id - 1], p.vertices[point_id]);
-
-				Vector2 point = triangle.get_closest_point_to(p_query_task.start_position);
-				real_t distance_to_point = point.distance_to(p_query_task.start_position);
-				if (distance_to_point < begin_d) {
-					begin_d = distance_to_point;
+				const Vector2 point = triangle.get_closest_point_to(p_query_task.start_position);
+				const real_t distance_to_point = point.distance_squared_to(p_query_task.start_position);
+				if (distance_to_point < r_begin_d) {
+					r_begin_d = distance_to_point;
 					p_query_task.begin_polygon = &p;
 					p_query_task.begin_position = point;
 				}
+			}
+		});
 
-				point = triangle.get_closest_point_to(p_query_task.target_position);
-				distance_to_point = point.distance_to(p_query_task.target_position);
-				if (distance_to_point < end_d) {
-					end_d = distance_to_point;
+		region->polygon_bvh.query_closest(p_query_task.target_position, end_d, [&](uint32_t p_polygon_index, real_t &r_end_d) {
+			const Polygon &p = region->navmesh_polygons[p_polygon_index];
+			for (uint32_t point_id = 2; point_id < p.vertices.size(); point_id++) {
+				const Triangle2 triangle(p.vertices[0], p.vertices[point_id - 1], p.vertices[point_id]);
+				const Vector2 point = triangle.get_closest_point_to(p_query_task.target_position);
+				const real_t distance_to_point = point.distance_squared_to(p_query_task.target_position);
+				if (distance_to_point < r_end_d) {
+					r_end_d = distance_to_point;
 					p_query_task.end_polygon = &p;
 					p_query_task.end_position = point;
 				}
 			}
-		}
+		});
 	}
 }
 
@@ -293,8 +307,17 @@ void NavMeshQueries2D::_query_task_search_polygon_connections(NavMeshPathQueryTa
 	Vector2 new_entry = Geometry2D::get_closest_point_to_segment(p_least_cost_poly.entry, p_connection.pathway_start, p_connection.pathway_end);
 	real_t new_traveled_distance = p_least_cost_poly.entry.distance_to(new_entry) * poly_travel_cost + p_poly_enter_cost + p_least_cost_poly.traveled_distance;
 
+	const uint32_t neighbor_poly_id = p_query_task.path_query_slot->poly_to_id[p_connection.polygon];
+	if (p_query_task.corridor_polygon_clusters) {
+		// Only search the clusters along the abstract path.
+		const PathQuerySlot *path_query_slot = p_query_task.path_query_slot;
+		if (path_query_slot->cluster_corridor_marks[(*p_query_task.corridor_polygon_clusters)[neighbor_poly_id]] != path_query_slot->cluster_corridor_mark) {
+			return;
+		}
+	}
+
 	// Check if the neighbor polygon has already been processed.
-	NavigationPoly &neighbor_poly = navigation_polys[p_query_task.path_query_slot->poly_to_id[p_connection.polygon]];
+	NavigationPoly &neighbor_poly = navigation_polys[neighbor_poly_id];
 	if (new_traveled_distance < neighbor_poly.traveled_distance) {
 		// Add the polygon to the heap of polygons to traverse next.
 		neighbor_poly.back_navigation_poly_id = p_least_cost_id;
@@ -400,6 +423,12 @@ void NavMeshQueries2D::_query_task_build_path_corridor(NavMeshPathQueryTask2D &p
 		// When the heap of traversable polygons is empty at this point it means the end polygon is
 		// unreachable.
 		if (traversable_polys.is_empty()) {
+			if (p_query_task.corridor_polygon_clusters) {
+				// The abstract path could not be refined, let the caller search all polygons instead.
+				p_query_task.corridor_search_failed = true;
+				return;
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -511,6 +540,140 @@ void NavMeshQueries2D::_query_task_build_path_corridor(NavMeshPathQueryTask2D &p
 	}
 }
 
+void NavMeshQueries2D::_query_task_search_cluster_portal(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration, uint32_t p_portal_index, uint32_t p_exit_side, int p_from_portal_id, real_t p_traveled_distance) {
+	const ClusterPortal &portal = p_map_iteration.cluster_portals[p_portal_index];
+	if (!portal.traversable[p_exit_side]) {
+		return;
+	}
+
+	const uint32_t entry_side = 1 - p_exit_side;
+	const ClusterInfo &from_cluster = p_map_iteration.clusters[portal.clusters[p_exit_side]];
+	const ClusterInfo &to_cluster = p_map_iteration.clusters[portal.clusters[entry_side]];
+	if (!_query_task_is_connection_owner_usable(p_query_task, to_cluster.owner)) {
+		return;
+	}
+
+	real_t traveled_distance = p_traveled_distance;
+	if (to_cluster.owner != from_cluster.owner) {
+		traveled_distance += to_cluster.owner->get_enter_cost();
+	}
+
+	Heap<NavigationPortal *, NavPortalTravelCostGreaterThan, NavPortalHeapIndexer> &traversable_portals = p_query_task.path_query_slot->traversable_portals;
+
+	// Search nodes are portals entered from one of their sides, with the id `portal_index * 2 + entry_side`.
+	NavigationPortal &portal_node = p_query_task.path_query_slot->portal_nodes[p_portal_index * 2 + entry_side];
+	if (traveled_distance < portal_node.traveled_distance) {
+		portal_node.back_navigation_portal_id = p_from_portal_id;
+		portal_node.traveled_distance = traveled_distance;
+		portal_node.distance_to_destination = portal.position.distance_to(p_query_task.end_position) * to_cluster.owner->get_travel_cost();
+
+		if (portal_node.traversable_portal_index != traversable_portals.INVALID_INDEX) {
+			traversable_portals.shift(portal_node.traversable_portal_index);
+		} else {
+			traversable_portals.push(&portal_node);
+		}
+	}
+}
+
+bool NavMeshQueries2D::_query_task_build_cluster_corridor(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration) {
+	PathQuerySlot *path_query_slot = p_query_task.path_query_slot;
+	const LocalVector<uint32_t> &polygon_clusters = p_map_iteration.polygon_clusters;
+	const LocalVector<ClusterInfo> &clusters = p_map_iteration.clusters;
+	const LocalVector<ClusterPortal> &cluster_portals = p_map_iteration.cluster_portals;
+	const LocalVector<uint32_t> &cluster_portal_offsets = p_map_iteration.cluster_portal_offsets;
+	const LocalVector<uint32_t> &cluster_portal_indices = p_map_iteration.cluster_portal_indices;
+
+	if (clusters.is_empty()) {
+		return false;
+	}
+
+	const uint32_t begin_cluster = polygon_clusters[path_query_slot->poly_to_id[p_query_task.begin_polygon]];
+	const uint32_t end_cluster = polygon_clusters[path_query_slot->poly_to_id[p_query_task.end_polygon]];
+	if (begin_cluster == end_cluster) {
+		// Short paths are cheaper to search on the polygons directly.
+		return false;
+	}
+
+	Heap<NavigationPortal *, NavPortalTravelCostGreaterThan, NavPortalHeapIndexer> &traversable_portals = path_query_slot->traversable_portals;
+	traversable_portals.clear();
+
+	LocalVector<NavigationPortal> &portal_nodes = path_query_slot->portal_nodes;
+	for (NavigationPortal &portal_node : portal_nodes) {
+		portal_node.reset();
+	}
+
+	// Start from all portals of the begin cluster.
+	const real_t begin_travel_cost = clusters[begin_cluster].owner->get_travel_cost();
+	for (uint32_t i = cluster_portal_offsets[begin_cluster]; i < cluster_portal_offsets[begin_cluster + 1]; i++) {
+		const uint32_t portal_index = cluster_portal_indices[i];
+		const ClusterPortal &portal = cluster_portals[portal_index];
+		const uint32_t exit_side = portal.clusters[0] == begin_cluster ? 0 : 1;
+		_query_task_search_cluster_portal(p_query_task, p_map_iteration, portal_index, exit_side, -1, p_query_task.begin_position.distance_to(portal.position) * begin_travel_cost);
+	}
+
+	// This is an implementation of the A* algorithm over the portal graph.
+	int end_portal_id = -1;
+	while (!traversable_portals.is_empty()) {
+		NavigationPortal *least_cost_portal = traversable_portals.pop();
+		const uint32_t least_cost_id = least_cost_portal - portal_nodes.ptr();
+		const uint32_t portal_index = least_cost_id / 2;
+		const uint32_t entry_side = least_cost_id % 2;
+		const ClusterPortal &portal = cluster_portals[portal_index];
+
+		const uint32_t cluster_index = portal.clusters[entry_side];
+		if (cluster_index == end_cluster) {
+			end_portal_id = least_cost_id;
+			break;
+		}
+
+		const ClusterInfo &cluster = clusters[cluster_index];
+		for (uint32_t i = cluster_portal_offsets[cluster_index]; i < cluster_portal_offsets[cluster_index + 1]; i++) {
+			const uint32_t next_portal_index = cluster_portal_indices[i];
+			if (next_portal_index == portal_index) {
+				continue;
+			}
+
+			const ClusterPortal &next_portal = cluster_portals[next_portal_index];
+			const uint32_t exit_side = next_portal.clusters[0] == cluster_index ? 0 : 1;
+
+			// Prefer the precomputed travel cost inside of the cluster and fall back to the straight distance.
+			real_t travel_cost = -1.0;
+			if (cluster.region_clusters) {
+				travel_cost = cluster.region_clusters->get_travel_cost(cluster.local_cluster, portal.polygons[entry_side] - cluster.polygon_offset, next_portal.polygons[exit_side] - cluster.polygon_offset);
+			}
+			if (travel_cost < 0.0) {
+				travel_cost = portal.position.distance_to(next_portal.position) * cluster.owner->get_travel_cost();
+			}
+
+			_query_task_search_cluster_portal(p_query_task, p_map_iteration, next_portal_index, exit_side, least_cost_id, least_cost_portal->traveled_distance + travel_cost);
+		}
+	}
+
+	if (end_portal_id == -1) {
+		// Let the polygon search handle unreachable targets.
+		return false;
+	}
+
+	// Mark the clusters along the abstract path.
+	LocalVector<uint32_t> &cluster_corridor_marks = path_query_slot->cluster_corridor_marks;
+	path_query_slot->cluster_corridor_mark++;
+	if (path_query_slot->cluster_corridor_mark == 0) {
+		for (uint32_t &mark : cluster_corridor_marks) {
+			mark = 0;
+		}
+		path_query_slot->cluster_corridor_mark = 1;
+	}
+	const uint32_t mark = path_query_slot->cluster_corridor_mark;
+
+	cluster_corridor_marks[begin_cluster] = mark;
+	for (int portal_id = end_portal_id; portal_id != -1; portal_id = portal_nodes[portal_id].back_navigation_portal_id) {
+		cluster_corridor_marks[cluster_portals[portal_id / 2].clusters[portal_id % 2]] = mark;
+	}
+
+	p_query_task.corridor_polygon_clusters = &polygon_clusters;
+	return true;
+}
+
 void NavMeshQueries2D::query_task_map_iteration_get_path(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration) {
 	p_query_task.path_clear();
 
@@ -530,8 +693,20 @@ void NavMeshQueries2D::query_task_map_iteration_get_path(NavMeshPathQueryTask2D
 		return;
 	}
 
+	// Long queries search the cluster hierarchy first and then only search the polygons of the clusters along the abstract path.
+	if (p_map_iteration.cluster_size > 0.0) {
+		_query_task_build_cluster_corridor(p_query_task, p_map_iteration);
+	}
+
 	_query_task_build_path_corridor(p_query_task, p_map_iteration);
 
+	if (p_query_task.corridor_search_failed) {
+		p_query_task.corridor_polygon_clusters = nullptr;
+		p_query_task.corridor_search_failed = false;
+		_query_task_build_path_corridor(p_query_task, p_map_iteration);
+	}
+	p_query_task.corridor_polygon_clusters = nullptr;
+
 	if (p_query_task.status == NavMeshPathQueryTask2D::TaskStatus::QUERY_FINISHED || p_query_task.status == NavMeshPathQueryTask2D::TaskStatus::QUERY_FAILED) {
 		_query_task_process_path_result_limits(p_query_task);
 		return;
@@ -580,6 +755,304 @@ void NavMeshQueries2D::query_task_map_iteration_get_path(NavMeshPathQueryTask2D
 	p_query_task.status = NavMeshPathQueryTask2D::TaskStatus::QUERY_FINISHED;
 }
 
+void NavMeshQueries2D::_query_task_build_target_tree(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration) {
+	PathQuerySlot *path_query_slot = p_query_task.path_query_slot;
+	const uint32_t polygon_count = path_query_slot->path_corridor.size();
+
+	LocalVector<NavigationPoly> &target_tree = path_query_slot->target_tree;
+	LocalVector<Vector2> &polygon_centers = path_query_slot->polygon_centers;
+	LocalVector<ReverseConnection> &reverse_connections = path_query_slot->reverse_connections;
+	LocalVector<uint32_t> &reverse_connection_offsets = path_query_slot->reverse_connection_offsets;
+
+	target_tree.resize(polygon_count);
+	polygon_centers.resize(polygon_count);
+	reverse_connections.clear();
+
+	// Gather all connections in the global polygon id order, regions first and links last.
+	uint32_t polygon_id = 0;
+	auto gather_polygon = [&](const Polygon &p_polygon, const LocalVector<LocalVector<Connection>> *p_external_connections) {
+		NavigationPoly &tree_poly = target_tree[polygon_id];
+		tree_poly.reset();
+		tree_poly.poly = &p_polygon;
+
+		Vector2 center;
+		for (const Vector2 &vertex : p_polygon.vertices) {
+			center += vertex;
+		}
+		polygon_centers[polygon_id] = p_polygon.vertices.is_empty() ? center : center / p_polygon.vertices.size();
+
+		const LocalVector<LocalVector<Connection>> &internal_connections = p_polygon.owner->get_internal_connections();
+		if (internal_connections.size() > 0) {
+			for (const Connection &connection : internal_connections[p_polygon.id]) {
+				reverse_connections.push_back({ polygon_id, path_query_slot->poly_to_id[connection.polygon], &connection });
+			}
+		}
+		if (p_external_connections && p_polygon.id < p_external_connections->size()) {
+			for (const Connection &connection : (*p_external_connections)[p_polygon.id]) {
+				reverse_connections.push_back({ polygon_id, path_query_slot->poly_to_id[connection.polygon], &connection });
+			}
+		}
+		polygon_id++;
+	};
+
+	for (const Ref<NavRegionIteration2D> &region : p_map_iteration.region_iterations) {
+		const LocalVector<LocalVector<Connection>> *external_connections = p_map_iteration.navbases_polygons_external_connections.getptr(region.ptr());
+		for (const Polygon &polygon : region->get_navmesh_polygons()) {
+			gather_polygon(polygon, external_connections);
+		}
+	}
+	for (const Polygon &polygon : p_map_iteration.navlink_polygons) {
+		gather_polygon(polygon, p_map_iteration.navbases_polygons_external_connections.getptr(polygon.owner));
+	}
+	ERR_FAIL_COND(polygon_id != polygon_count);
+
+	// Sort the connections by the polygon they lead to.
+	reverse_connections.sort_custom<ReverseConnectionToIdLess>();
+	reverse_connection_offsets.resize(polygon_count + 1);
+	for (uint32_t &offset : reverse_connection_offsets) {
+		offset = 0;
+	}
+	for (const ReverseConnection &reverse_connection : reverse_connections) {
+		reverse_connection_offsets[reverse_connection.to_id + 1]++;
+	}
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		reverse_connection_offsets[i + 1] += reverse_connection_offsets[i];
+	}
+
+	Heap<NavigationPoly *, NavPolyTravelCostGreaterThan, NavPolyHeapIndexer> &traversable_polys = path_query_slot->traversable_polys;
+	traversable_polys.clear();
+
+	// This is an implementation of the Dijkstra algorithm from the target polygon, polygon costs are measured between their centers.
+	const uint32_t target_id = path_query_slot->poly_to_id[p_query_task.end_polygon];
+	NavigationPoly &target_poly = target_tree[target_id];
+	target_poly.entry = p_query_task.end_position;
+	target_poly.traveled_distance = 0.0;
+	traversable_polys.push(&target_poly);
+
+	while (!traversable_polys.is_empty()) {
+		const NavigationPoly *least_cost_poly = traversable_polys.pop();
+		const uint32_t least_cost_id = least_cost_poly - target_tree.ptr();
+		const NavBaseIteration2D *least_cost_owner = least_cost_poly->poly->owner;
+
+		for (uint32_t i = reverse_connection_offsets[least_cost_id]; i < reverse_connection_offsets[least_cost_id + 1]; i++) {
+			const ReverseConnection &reverse_connection = reverse_connections[i];
+			NavigationPoly &from_poly = target_tree[reverse_connection.from_id];
+			const NavBaseIteration2D *from_owner = from_poly.poly->owner;
+			if (!_query_task_is_connection_owner_usable(p_query_task, from_owner)) {
+				continue;
+			}
+
+			const Connection &connection = *reverse_connection.connection;
+			const Vector2 pathway_center = (connection.pathway_start + connection.pathway_end) * 0.5;
+			real_t traveled_distance = least_cost_poly->traveled_distance +
+					polygon_centers[reverse_connection.from_id].distance_to(pathway_center) * from_owner->get_travel_cost() +
+					pathway_center.distance_to(least_cost_poly->entry) * least_cost_owner->get_travel_cost();
+			if (from_owner != least_cost_owner) {
+				traveled_distance += least_cost_owner->get_enter_cost();
+			}
+
+			if (traveled_distance < from_poly.traveled_distance) {
+				from_poly.back_navigation_poly_id = least_cost_id;
+				from_poly.back_navigation_edge = connection.edge;
+				from_poly.back_navigation_edge_pathway_start = connection.pathway_start;
+				from_poly.back_navigation_edge_pathway_end = connection.pathway_end;
+				from_poly.traveled_distance = traveled_distance;
+				from_poly.entry = polygon_centers[reverse_connection.from_id];
+
+				if (from_poly.traversable_poly_index != traversable_polys.INVALID_INDEX) {
+					traversable_polys.shift(from_poly.traversable_poly_index);
+				} else {
+					traversable_polys.push(&from_poly);
+				}
+			}
+		}
+	}
+}
+
+void NavMeshQueries2D::map_iteration_build_flow_field_grid(const NavMapIteration2D &p_map_iteration, FlowFieldGrid &r_flow_field_grid) {
+	r_flow_field_grid.cell_offsets.clear();
+	r_flow_field_grid.cell_polygon_ids.clear();
+	r_flow_field_grid.polygons.clear();
+
+	// Collect the polygons in the global polygon id order, regions first and links last.
+	Rect2 bounds;
+	bool first_vertex = true;
+	real_t surface_area = 0.0;
+	for (const Ref<NavRegionIteration2D> &region : p_map_iteration.region_iterations) {
+		for (const Polygon &polygon : region->get_navmesh_polygons()) {
+			for (const Vector2 &vertex : polygon.vertices) {
+				if (first_vertex) {
+					bounds.position = vertex;
+					first_vertex = false;
+				} else {
+					bounds.expand_to(vertex);
+				}
+			}
+			surface_area += polygon.surface_area;
+			r_flow_field_grid.polygons.push_back(&polygon);
+		}
+	}
+	const uint32_t region_polygon_count = r_flow_field_grid.polygons.size();
+	for (const Polygon &polygon : p_map_iteration.navlink_polygons) {
+		r_flow_field_grid.polygons.push_back(&polygon);
+	}
+
+	if (region_polygon_count == 0) {
+		return;
+	}
+
+	// Cells with about the size of an average polygon keep the polygon lists of the cells short.
+	real_t cell_size = Math::sqrt(surface_area / region_polygon_count);
+	if (cell_size <= CMP_EPSILON) {
+		cell_size = MAX(MAX(bounds.size.x, bounds.size.y) / Math::sqrt((real_t)region_polygon_count), (real_t)CMP_EPSILON);
+	}
+	Vector2i size = Vector2i((int)(bounds.size.x / cell_size) + 1, (int)(bounds.size.y / cell_size) + 1);
+	while ((int64_t)size.x * size.y > FLOW_FIELD_GRID_MAX_CELLS) {
+		cell_size *= 2.0;
+		size = Vector2i((int)(bounds.size.x / cell_size) + 1, (int)(bounds.size.y / cell_size) + 1);
+	}
+
+	r_flow_field_grid.origin = bounds.position;
+	r_flow_field_grid.cell_size = cell_size;
+	r_flow_field_grid.size = size;
+
+	LocalVector<uint32_t> &cell_offsets = r_flow_field_grid.cell_offsets;
+	cell_offsets.resize_initialized(size.x * size.y + 1);
+
+	// Add every polygon to all cells that its bounds overlap.
+	LocalVector<Rect2i> polygon_cells;
+	polygon_cells.resize(region_polygon_count);
+	for (uint32_t polygon_id = 0; polygon_id < region_polygon_count; polygon_id++) {
+		const Polygon *polygon = r_flow_field_grid.polygons[polygon_id];
+		Vector2i cell_min = size;
+		Vector2i cell_max;
+		for (const Vector2 &vertex : polygon->vertices) {
+			const Vector2i cell = Vector2i(
+					CLAMP((int)((vertex.x - bounds.position.x) / cell_size), 0, size.x - 1),
+					CLAMP((int)((vertex.y - bounds.position.y) / cell_size), 0, size.y - 1));
+			cell_min = cell_min.min(cell);
+			cell_max = cell_max.max(cell);
+		}
+		polygon_cells[polygon_id] = Rect2i(cell_min, cell_max - cell_min);
+
+		for (int y = cell_min.y; y <= cell_max.y; y++) {
+			for (int x = cell_min.x; x <= cell_max.x; x++) {
+				cell_offsets[y * size.x + x + 1]++;
+			}
+		}
+	}
+	for (int i = 0; i < size.x * size.y; i++) {
+		cell_offsets[i + 1] += cell_offsets[i];
+	}
+
+	LocalVector<uint32_t> cell_cursors = cell_offsets;
+	r_flow_field_grid.cell_polygon_ids.resize(cell_offsets[size.x * size.y]);
+	for (uint32_t polygon_id = 0; polygon_id < region_polygon_count; polygon_id++) {
+		const Rect2i &cells = polygon_cells[polygon_id];
+		for (int y = cells.position.y; y <= cells.position.y + cells.size.y; y++) {
+			for (int x = cells.position.x; x <= cells.position.x + cells.size.x; x++) {
+				r_flow_field_grid.cell_polygon_ids[cell_cursors[y * size.x + x]++] = polygon_id;
+			}
+		}
+	}
+}
+
+void NavMeshQueries2D::query_task_build_flow_field(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration, FlowField &r_flow_field) {
+	r_flow_field.target_polygon_id = UINT32_MAX;
+	r_flow_field.polygons.clear();
+
+	_query_task_find_start_end_positions(p_query_task, p_map_iteration);
+	if (!p_query_task.end_polygon) {
+		return;
+	}
+
+	// The integration field is the tree of the cheapest paths from every polygon to the target polygon.
+	_query_task_build_target_tree(p_query_task, p_map_iteration);
+
+	const LocalVector<NavigationPoly> &target_tree = p_query_task.path_query_slot->target_tree;
+	r_flow_field.target_position = p_query_task.end_position;
+	r_flow_field.target_polygon_id = p_query_task.path_query_slot->poly_to_id[p_query_task.end_polygon];
+	r_flow_field.polygons.resize(target_tree.size());
+
+	for (uint32_t polygon_id = 0; polygon_id < target_tree.size(); polygon_id++) {
+		const NavigationPoly &tree_poly = target_tree[polygon_id];
+		FlowFieldPolygon &flow_field_polygon = r_flow_field.polygons[polygon_id];
+		flow_field_polygon = FlowFieldPolygon();
+		flow_field_polygon.travel_cost = tree_poly.traveled_distance;
+		if (tree_poly.back_navigation_poly_id != -1) {
+			flow_field_polygon.next_polygon_id = tree_poly.back_navigation_poly_id;
+			flow_field_polygon.pathway_start = tree_poly.back_navigation_edge_pathway_start;
+			flow_field_polygon.pathway_end = tree_poly.back_navigation_edge_pathway_end;
+		}
+	}
+}
+
+uint32_t NavMeshQueries2D::_flow_field_grid_get_polygon_id(const FlowFieldGrid &p_flow_field_grid, const Vector2 &p_position) {
+	if (p_flow_field_grid.cell_offsets.is_empty()) {
+		return UINT32_MAX;
+	}
+
+	const Vector2i &size = p_flow_field_grid.size;
+	const Vector2i cell = Vector2i(
+			CLAMP((int)Math::floor((p_position.x - p_flow_field_grid.origin.x) / p_flow_field_grid.cell_size), 0, size.x - 1),
+			CLAMP((int)Math::floor((p_position.y - p_flow_field_grid.origin.y) / p_flow_field_grid.cell_size), 0, size.y - 1));
+
+	uint32_t closest_polygon_id = UINT32_MAX;
+	real_t closest_distance = FLT_MAX;
+
+	// Search the cell of the position first and its neighbors only for positions off the navigation mesh.
+	for (int radius = 0; radius <= 1 && closest_polygon_id == UINT32_MAX; radius++) {
+		for (int y = MAX(cell.y - radius, 0); y <= MIN(cell.y + radius, size.y - 1); y++) {
+			for (int x = MAX(cell.x - radius, 0); x <= MIN(cell.x + radius, size.x - 1); x++) {
+				const uint32_t cell_index = y * size.x + x;
+				for (uint32_t i = p_flow_field_grid.cell_offsets[cell_index]; i < p_flow_field_grid.cell_offsets[cell_index + 1]; i++) {
+					const uint32_t polygon_id = p_flow_field_grid.cell_polygon_ids[i];
+					const Polygon *polygon = p_flow_field_grid.polygons[polygon_id];
+					for (uint32_t point_id = 2; point_id < polygon->vertices.size(); point_id++) {
+						const Triangle2 triangle(polygon->vertices[0], polygon->vertices[point_id - 1], polygon->vertices[point_id]);
+						const real_t distance = triangle.get_closest_point_to(p_position).distance_squared_to(p_position);
+						if (distance < closest_distance) {
+							closest_distance = distance;
+							closest_polygon_id = polygon_id;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return closest_polygon_id;
+}
+
+Vector2 NavMeshQueries2D::flow_field_get_direction(const FlowFieldGrid &p_flow_field_grid, const FlowField &p_flow_field, const Vector2 &p_position) {
+	if (p_flow_field.target_polygon_id == UINT32_MAX) {
+		return Vector2();
+	}
+
+	uint32_t polygon_id = _flow_field_grid_get_polygon_id(p_flow_field_grid, p_position);
+	if (polygon_id >= p_flow_field.polygons.size()) {
+		return Vector2();
+	}
+
+	// Steer to the closest point on the edge towards the next polygon, or to the next edge when already on it.
+	Vector2 direction;
+	for (int step = 0; step < 2 && direction.is_zero_approx(); step++) {
+		if (polygon_id == p_flow_field.target_polygon_id) {
+			direction = p_flow_field.target_position - p_position;
+			break;
+		}
+
+		const FlowFieldPolygon &flow_field_polygon = p_flow_field.polygons[polygon_id];
+		if (flow_field_polygon.next_polygon_id == UINT32_MAX) {
+			return Vector2();
+		}
+		direction = Geometry2D::get_closest_point_to_segment(p_position, flow_field_polygon.pathway_start, flow_field_polygon.pathway_end) - p_position;
+		polygon_id = flow_field_polygon.next_polygon_id;
+	}
+
+	return direction.normalized();
+}
+
 float NavMeshQueries2D::_calculate_path_length(const LocalVector<Vector2> &p_path, uint32_t p_start_index, uint32_t p_end_index) {
 	const uint32_t path_size = p_path.size();
 	if (path_size < 2) {
@@ -891,63 +1364,17 @@ ClosestPointQueryResult NavMeshQueries2D::map_iteration_get_closest_point_info(c
 	ClosestPointQueryResult result;
 	real_t closest_point_distance_squared = FLT_MAX;
 
-	// TODO: Check for further 2D improvements.
-
 	const LocalVector<Ref<NavRegionIteration2D>> &regions = p_map_iteration.region_iterations;
 	for (const Ref<NavRegionIteration2D> &region : regions) {
-		for (const Polygon &polygon : region->get_navmesh_polygons()) {
-			real_t cross = -(polygon.vertices[1] - polygon.vertices[0]).cross(polygon.vertices[2] - polygon.vertices[0]);
-			Vector2 closest_on_polygon;
-			real_t closest = FLT_MAX;
-			bool inside = true;
-			Vector2 previous = polygon.vertices[polygon.vertices.size() - 1];
-			for (uint32_t point_id = 0; point_id < polygon.vertices.size(); ++point_id) {
-				Vector2 edge = polygon.vertices[point_id] - previous;
-				Vector2 to_point = p_point - previous;
-				real_t edge_to_point_cross = -edge.cross(to_point);
-				bool clockwise = (edge_to_point_cross * cross) > 0;
-				// If we are not clockwise, the point will never be inside the polygon and so the closest point will be on an edge.
-				if (!clockwise) {
-					inside = false;
-					real_t point_projected_on_edge = edge.dot(to_point);
-					real_t edge_square = edge.length_squared();
-
-					if (point_projected_on_edge > edge_square) {
-						real_t distance = polygon.vertices[point_id].distance_squared_to(p_point);
-						if (distance < closest) {
-							closest_on_polygon = polygon.vertices[point_id];
-							closest = distance;
-						}
-					} else if (point_projected_on_edge < 0.0) {
-						real_t distance = previous.distance_squared_to(p_point);
-						if (distance < closest) {
-							closest_on_polygon = previous;
-							closest = distance;
-						}
-					} else {
-						// If we project on this edge, this will be the closest point.
-						real_t percent = point_projected_on_edge / edge_square;
-						closest_on_polygon = previous + percent * edge;
-						break;
-					}
-				}
-				previous = polygon.vertices[point_id];
-			}
-
-			if (inside) {
-				closest_point_distance_squared = 0.0;
-				result.point = p_point;
-				result.owner = polygon.owner->get_self();
-
-				break;
-			} else {
-				real_t distance = closest_on_polygon.distance_squared_to(p_point);
-				if (distance < closest_point_distance_squared) {
-					closest_point_distance_squared = distance;
-					result.point = closest_on_polygon;
-					result.owner = polygon.owner->get_self();
-				}
-			}
+		if (NavPolygonBVH2D::get_distance_squared(region->get_bounds(), p_point) >= closest_point_distance_squared) {
+			continue;
+		}
+		region->polygon_bvh.query_closest(p_point, closest_point_distance_squared, [&](uint32_t p_polygon_index, real_t &r_closest_point_distance_squared) {
+			_polygon_get_closest_point_info(region->navmesh_polygons[p_polygon_index], p_point, result, r_closest_point_distance_squared);
+		});
+		if (closest_point_distance_squared == 0.0) {
+			// The point is inside of a polygon.
+			break;
 		}
 	}
 
@@ -1005,7 +1432,25 @@ Vector2 NavMeshQueries2D::map_iteration_get_random_point(const NavMapIteration2D
 
 		const Ref<NavRegionIteration2D> &random_region = p_map_iteration.region_iterations[accessible_regions[random_region_index]];
 
-		return NavMeshQueries2D::polygons_get_random_point(random_region->navmesh_polygons, p_navigation_layers, p_uniformly);
+		// Pick the polygon by area from the surface areas accumulated when the region was built.
+		const LocalVector<real_t> &accumulated_surface_areas = random_region->polygon_accumulated_surface_areas;
+		if (accumulated_surface_areas.is_empty() || accumulated_surface_areas[accumulated_surface_areas.size() - 1] == 0.0) {
+			return Vector2();
+		}
+
+		const real_t random_surface_area = Math::random(real_t(0), accumulated_surface_areas[accumulated_surface_areas.size() - 1]);
+		uint32_t random_polygon_index = 0;
+		uint32_t polygon_index_end = accumulated_surface_areas.size() - 1;
+		while (random_polygon_index < polygon_index_end) {
+			const uint32_t middle = (random_polygon_index + polygon_index_end) / 2;
+			if (accumulated_surface_areas[middle] <= random_surface_area) {
+				random_polygon_index = middle + 1;
+			} else {
+				polygon_index_end = middle;
+			}
+		}
+
+		return _polygon_get_random_point(random_region->navmesh_polygons[random_polygon_index], p_uniformly);
 
 	} else {
 		uint32_t random_region_index = Math::random(int(0), accessible_regions.size() - 1);
@@ -1021,63 +1466,68 @@ Vector2 NavMeshQueries2D::polygons_get_closest_point(const LocalVector<Polygon>
 	return cp.point;
 }
 
+bool NavMeshQueries2D::_polygon_get_closest_point_info(const Polygon &p_polygon, const Vector2 &p_point, ClosestPointQueryResult &r_result, real_t &r_closest_point_distance_squared) {
+	real_t cross = -(p_polygon.vertices[1] - p_polygon.vertices[0]).cross(p_polygon.vertices[2] - p_polygon.vertices[0]);
+	Vector2 closest_on_polygon;
+	real_t closest = FLT_MAX;
+	bool inside = true;
+	Vector2 previous = p_polygon.vertices[p_polygon.vertices.size() - 1];
+	for (uint32_t point_id = 0; point_id < p_polygon.vertices.size(); ++point_id) {
+		Vector2 edge = p_polygon.vertices[point_id] - previous;
+		Vector2 to_point = p_point - previous;
+		real_t edge_to_point_cross = -edge.cross(to_point);
+		bool clockwise = (edge_to_point_cross * cross) > 0;
+		// If we are not clockwise, the point will never be inside the polygon and so the closest point will be on an edge.
+		if (!clockwise) {
+			inside = false;
+			real_t point_projected_on_edge = edge.dot(to_point);
+			real_t edge_square = edge.length_squared();
+
+			if (point_projected_on_edge > edge_square) {
+				real_t distance = p_polygon.vertices[point_id].distance_squared_to(p_point);
+				if (distance < closest) {
+					closest_on_polygon = p_polygon.vertices[point_id];
+					closest = distance;
+				}
+			} else if (point_projected_on_edge < 0.0) {
+				real_t distance = previous.distance_squared_to(p_point);
+				if (distance < closest) {
+					closest_on_polygon = previous;
+					closest = distance;
+				}
+			} else {
+				// If we project on this edge, this will be the closest point.
+				real_t percent = point_projected_on_edge / edge_square;
+				closest_on_polygon = previous + percent * edge;
+				break;
+			}
+		}
+		previous = p_polygon.vertices[point_id];
+	}
+
+	if (inside) {
+		r_closest_point_distance_squared = 0.0;
+		r_result.point = p_point;
+		r_result.owner = p_polygon.owner->get_self();
+		return true;
+	}
+
+	real_t distance = closest_on_polygon.distance_squared_to(p_point);
+	if (distance < r_closest_point_distance_squared) {
+		r_closest_point_distance_squared = distance;
+		r_result.point = closest_on_polygon;
+		r_result.owner = p_polygon.owner->get_self();
+	}
+	return false;
+}
+
 ClosestPointQueryResult NavMeshQueries2D::polygons_get_closest_point_info(const LocalVector<Polygon> &p_polygons, const Vector2 &p_point) {
 	ClosestPointQueryResult result;
 	real_t closest_point_distance_squared = FLT_MAX;
 
-	// TODO: Check for further 2D improvements.
-
 	for (const Polygon &polygon : p_polygons) {
-		real_t cross = -(polygon.vertices[1] - polygon.vertices[0]).cross(polygon.vertices[2] - polygon.vertices[0]);
-		Vector2 closest_on_polygon;
-		real_t closest = FLT_MAX;
-		bool inside = true;
-		Vector2 previous = polygon.vertices[polygon.vertices.size() - 1];
-		for (uint32_t point_id = 0; point_id < polygon.vertices.size(); ++point_id) {
-			Vector2 edge = polygon.vertices[point_id] - previous;
-			Vector2 to_point = p_point - previous;
-			real_t edge_to_point_cross = -edge.cross(to_point);
-			bool clockwise = (edge_to_point_cross * cross) > 0;
-			// If we are not clockwise, the point will never be inside the polygon and so the closest point will be on an edge.
-			if (!clockwise) {
-				inside = false;
-				real_t point_projected_on_edge = edge.dot(to_point);
-				real_t edge_square = edge.length_squared();
-
-				if (point_projected_on_edge > edge_square) {
-					real_t distance = polygon.vertices[point_id].distance_squared_to(p_point);
-					if (distance < closest) {
-						closest_on_polygon = polygon.vertices[point_id];
-						closest = distance;
-					}
-				} else if (point_projected_on_edge < 0.0) {
-					real_t distance = previous.distance_squared_to(p_point);
-					if (distance < closest) {
-						closest_on_polygon = previous;
-						closest = distance;
-					}
-				} else {
-					// If we project on this edge, this will be the closest point.
-					real_t percent = point_projected_on_edge / edge_square;
-					closest_on_polygon = previous + percent * edge;
-					break;
-				}
-			}
-			previous = polygon.vertices[point_id];
-		}
-
-		if (inside) {
-			closest_point_distance_squared = 0.0;
-			result.point = p_point;
-			result.owner = polygon.owner->get_self();
+		if (_polygon_get_closest_point_info(polygon, p_point, result, closest_point_distance_squared)) {
 			break;
-		} else {
-			real_t distance = closest_on_polygon.distance_squared_to(p_point);
-			if (distance < closest_point_distance_squared) {
-				closest_point_distance_squared = distance;
-				result.point = closest_on_polygon;
-				result.owner = polygon.owner->get_self();
-			}
 		}
 	}
 
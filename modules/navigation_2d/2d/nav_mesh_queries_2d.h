@@ -47,12 +47,37 @@ struct NavMapIteration2D;
 
 class NavMeshQueries2D {
 public:
+	// A connection from `from_id` into `to_id`, used to search the polygon graph backwards from a target.
+	struct ReverseConnection {
+		uint32_t from_id = 0;
+		uint32_t to_id = 0;
+		const Nav2D::Connection *connection = nullptr;
+	};
+
+	struct ReverseConnectionToIdLess {
+		bool operator()(const ReverseConnection &p_a, const ReverseConnection &p_b) const {
+			return p_a.to_id < p_b.to_id;
+		}
+	};
+
 	struct PathQuerySlot {
 		LocalVector<Nav2D::NavigationPoly> path_corridor;
 		Heap<Nav2D::NavigationPoly *, Nav2D::NavPolyTravelCostGreaterThan, Nav2D::NavPolyHeapIndexer> traversable_polys;
 		bool in_use = false;
 		uint32_t slot_index = 0;
 		AHashMap<const Nav2D::Polygon *, uint32_t> poly_to_id;
+
+		// Hierarchical search.
+		LocalVector<Nav2D::NavigationPortal> portal_nodes;
+		Heap<Nav2D::NavigationPortal *, Nav2D::NavPortalTravelCostGreaterThan, Nav2D::NavPortalHeapIndexer> traversable_portals;
+		LocalVector<uint32_t> cluster_corridor_marks;
+		uint32_t cluster_corridor_mark = 0;
+
+		// Search from a single target, every polygon links to its next polygon towards the target.
+		LocalVector<Nav2D::NavigationPoly> target_tree;
+		LocalVector<Vector2> polygon_centers;
+		LocalVector<ReverseConnection> reverse_connections;
+		LocalVector<uint32_t> reverse_connection_offsets;
 	};
 
 	struct NavMeshPathQueryTask2D {
@@ -91,6 +116,10 @@ public:
 		const Nav2D::Polygon *end_polygon = nullptr;
 		uint32_t least_cost_id = 0;
 
+		// Hierarchical search, the polygon search is restricted to the clusters of the abstract path while this is set.
+		const LocalVector<uint32_t> *corridor_polygon_clusters = nullptr;
+		bool corridor_search_failed = false;
+
 		// Map.
 		NavMap2D *map = nullptr;
 		PathQuerySlot *path_query_slot = nullptr;
@@ -138,15 +167,27 @@ public:
 	static void map_query_path(NavMap2D *p_map, const Ref<NavigationPathQueryParameters2D> &p_query_parameters, Ref<NavigationPathQueryResult2D> p_query_result, const Callable &p_callback);
 
 	static void query_task_map_iteration_get_path(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration);
+	static void _query_task_build_target_tree(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration);
+
+	static void map_iteration_build_flow_field_grid(const NavMapIteration2D &p_map_iteration, Nav2D::FlowFieldGrid &r_flow_field_grid);
+	static void query_task_build_flow_field(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration, Nav2D::FlowField &r_flow_field);
+	static Vector2 flow_field_get_direction(const Nav2D::FlowFieldGrid &p_flow_field_grid, const Nav2D::FlowField &p_flow_field, const Vector2 &p_position);
+	static uint32_t _flow_field_grid_get_polygon_id(const Nav2D::FlowFieldGrid &p_flow_field_grid, const Vector2 &p_position);
 	static void _query_task_push_back_point_with_metadata(NavMeshPathQueryTask2D &p_query_task, const Vector2 &p_point, const Nav2D::Polygon *p_point_polygon);
 	static void _query_task_find_start_end_positions(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration);
 	static void _query_task_build_path_corridor(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration);
+	static bool _query_task_build_cluster_corridor(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration);
+	static void _query_task_search_cluster_portal(NavMeshPathQueryTask2D &p_query_task, const NavMapIteration2D &p_map_iteration, uint32_t p_portal_index, uint32_t p_exit_side, int p_from_portal_id, real_t p_traveled_distance);
 	static void _query_task_post_process_corridorfunnel(NavMeshPathQueryTask2D &p_query_task);
 	static void _query_task_post_process_edgecentered(NavMeshPathQueryTask2D &p_query_task);
 	static void _query_task_post_process_nopostprocessing(NavMeshPathQueryTask2D &p_query_task);
 	static void _query_task_clip_path(NavMeshPathQueryTask2D &p_query_task, const Nav2D::NavigationPoly *p_from_poly, const Vector2 &p_to_point, const Nav2D::NavigationPoly *p_to_poly);
 	static void _query_task_simplified_path_points(NavMeshPathQueryTask2D &p_query_task);
 	static bool _query_task_is_connection_owner_usable(const NavMeshPathQueryTask2D &p_query_task, const NavBaseIteration2D *p_owner);
+
+	static Vector2 _polygon_get_random_point(const Nav2D::Polygon &p_polygon, bool p_uniformly);
+	// Returns `true` when the point is inside of the polygon, so no other polygon can be closer.
+	static bool _polygon_get_closest_point_info(const Nav2D::Polygon &p_polygon, const Vector2 &p_point, Nav2D::ClosestPointQueryResult &r_result, real_t &r_closest_point_distance_squared);
 	static void _query_task_process_path_result_limits(NavMeshPathQueryTask2D &p_query_task);
 
 	static void _query_task_search_polygon_connections(NavMeshPathQueryTask2D &p_query_task, const Nav2D::Connection &p_connection, uint32_t p_least_cost_id, const Nav2D::NavigationPoly &p_least_cost_poly, real_t p_poly_enter_cost, const Vector2 &p_end_point);
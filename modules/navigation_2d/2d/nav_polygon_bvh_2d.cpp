@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*  nav_polygon_bvh_2d.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_polygon_bvh_2d.h"
+
+#include "core/templates/sort_array.h"
+
+static const uint32_t NAV_POLYGON_BVH_LEAF_SIZE = 4;
+
+void NavPolygonBVH2D::build(const LocalVector<Nav2D::Polygon> &p_polygons) {
+	clear();
+
+	LocalVector<Item> items;
+	items.reserve(p_polygons.size());
+	for (uint32_t i = 0; i < p_polygons.size(); i++) {
+		const Nav2D::Polygon &polygon = p_polygons[i];
+		if (polygon.vertices.size() < 3) {
+			continue;
+		}
+
+		Item item;
+		item.bounds.position = polygon.vertices[0];
+		for (uint32_t j = 1; j < polygon.vertices.size(); j++) {
+			item.bounds.expand_to(polygon.vertices[j]);
+		}
+		item.center = item.bounds.get_center();
+		item.polygon_index = i;
+		items.push_back(item);
+	}
+
+	if (items.is_empty()) {
+		return;
+	}
+
+	nodes.reserve(2 * (items.size() / NAV_POLYGON_BVH_LEAF_SIZE) + 1);
+	nodes.push_back(Node());
+	_build_node(0, items, 0, items.size());
+
+	polygon_indices.resize(items.size());
+	for (uint32_t i = 0; i < items.size(); i++) {
+		polygon_indices[i] = items[i].polygon_index;
+	}
+}
+
+void NavPolygonBVH2D::_build_node(uint32_t p_node, LocalVector<Item> &r_items, uint32_t p_begin, uint32_t p_end) {
+	Rect2 bounds = r_items[p_begin].bounds;
+	Rect2 center_bounds(r_items[p_begin].center, Vector2());
+	for (uint32_t i = p_begin + 1; i < p_end; i++) {
+		bounds = bounds.merge(r_items[i].bounds);
+		center_bounds.expand_to(r_items[i].center);
+	}
+	nodes[p_node].bounds = bounds;
+
+	const uint32_t count = p_end - p_begin;
+	if (count <= NAV_POLYGON_BVH_LEAF_SIZE) {
+		nodes[p_node].first = p_begin;
+		nodes[p_node].count = count;
+		return;
+	}
+
+	// Split at the median of the polygon centers on the longest axis.
+	const uint32_t middle = p_begin + count / 2;
+	if (center_bounds.size.x >= center_bounds.size.y) {
+		SortArray<Item, ItemCompare<Vector2::AXIS_X>> sorter;
+		sorter.nth_element(p_begin, p_end, middle, r_items.ptr());
+	} else {
+		SortArray<Item, ItemCompare<Vector2::AXIS_Y>> sorter;
+		sorter.nth_element(p_begin, p_end, middle, r_items.ptr());
+	}
+
+	const uint32_t children = nodes.size();
+	nodes.push_back(Node());
+	nodes.push_back(Node());
+	nodes[p_node].first = children;
+	nodes[p_node].count = 0;
+
+	_build_node(children, r_items, p_begin, middle);
+	_build_node(children + 1, r_items, middle, p_end);
+}
+
+void NavPolygonBVH2D::clear() {
+	nodes.clear();
+	polygon_indices.clear();
+}
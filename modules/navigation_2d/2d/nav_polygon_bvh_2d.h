@@ -0,0 +1,106 @@
+/**************************************************************************/
+/*  nav_polygon_bvh_2d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "../nav_utils_2d.h"
+
+#include "core/math/rect2.h"
+
+// Bounding volume hierarchy over the polygons of a region, to only test the polygons close to a point.
+class NavPolygonBVH2D {
+	// Enough for any tree built from the uint32_t polygon indices.
+	static const uint32_t MAX_DEPTH = 64;
+
+	struct Node {
+		Rect2 bounds;
+		// Leaves have `count` polygons from `first` in `polygon_indices`, other nodes have their children at `first` and `first + 1`.
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+
+	struct Item {
+		Rect2 bounds;
+		Vector2 center;
+		uint32_t polygon_index = 0;
+	};
+
+	template <int AXIS>
+	struct ItemCompare {
+		_FORCE_INLINE_ bool operator()(const Item &p_a, const Item &p_b) const {
+			return p_a.center[AXIS] < p_b.center[AXIS];
+		}
+	};
+
+	LocalVector<Node> nodes;
+	LocalVector<uint32_t> polygon_indices;
+
+	void _build_node(uint32_t p_node, LocalVector<Item> &r_items, uint32_t p_begin, uint32_t p_end);
+
+public:
+	_FORCE_INLINE_ static real_t get_distance_squared(const Rect2 &p_bounds, const Vector2 &p_point) {
+		return (p_point.clamp(p_bounds.position, p_bounds.position + p_bounds.size) - p_point).length_squared();
+	}
+
+	void build(const LocalVector<Nav2D::Polygon> &p_polygons);
+	void clear();
+
+	// Calls `p_polygon_distance(polygon_index, r_distance_squared)` for the polygons with bounds closer than `r_distance_squared`, closest nodes first.
+	// The callback lowers `r_distance_squared` when the polygon is closer, which skips all farther nodes.
+	template <typename F>
+	void query_closest(const Vector2 &p_point, real_t &r_distance_squared, F &&p_polygon_distance) const {
+		if (nodes.is_empty()) {
+			return;
+		}
+
+		uint32_t stack[MAX_DEPTH];
+		uint32_t stack_size = 0;
+		stack[stack_size++] = 0;
+
+		while (stack_size > 0) {
+			const Node &node = nodes[stack[--stack_size]];
+			if (get_distance_squared(node.bounds, p_point) >= r_distance_squared) {
+				continue;
+			}
+
+			if (node.count > 0) {
+				for (uint32_t i = node.first; i < node.first + node.count; i++) {
+					p_polygon_distance(polygon_indices[i], r_distance_squared);
+				}
+				continue;
+			}
+
+			// Search the closer child first.
+			const bool first_is_closer = get_distance_squared(nodes[node.first].bounds, p_point) <= get_distance_squared(nodes[node.first + 1].bounds, p_point);
+			stack[stack_size++] = first_is_closer ? node.first + 1 : node.first;
+			stack[stack_size++] = first_is_closer ? node.first : node.first + 1;
+		}
+	}
+};
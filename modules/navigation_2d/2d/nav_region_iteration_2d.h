@@ -32,6 +32,7 @@
 
 #include "../nav_utils_2d.h"
 #include "nav_base_iteration_2d.h"
+#include "nav_polygon_bvh_2d.h"
 #include "scene/resources/2d/navigation_polygon.h"
 
 #include "core/math/rect2.h"
@@ -79,6 +80,14 @@ public:
 	Rect2 bounds;
 	LocalVector<Nav2D::ConnectableEdge> external_edges;
 
+	// Speed up the map queries that search the polygons of the region.
+	NavPolygonBVH2D polygon_bvh;
+	// The surface area of all polygons up to and including the polygon at each index, to pick random polygons by area.
+	LocalVector<real_t> polygon_accumulated_surface_areas;
+
+	// Built by the map builder the first time this iteration is used by a map with hierarchical pathfinding.
+	Nav2D::RegionClusters clusters;
+
 	const Transform2D &get_transform() const { return transform; }
 	real_t get_surface_area() const { return surface_area; }
 	Rect2 get_bounds() const { return bounds; }
@@ -98,6 +98,12 @@ bool NavAgent2D::is_map_changed() {
 	}
 }
 
+Vector2 NavAgent2D::get_flow_field_direction(const Vector2 &p_target_position, uint32_t p_navigation_layers) const {
+	ERR_FAIL_NULL_V(map, Vector2());
+
+	return map->get_flow_field_direction(p_target_position, position, p_navigation_layers);
+}
+
 void NavAgent2D::set_avoidance_callback(Callable p_callback) {
 	avoidance_callback = p_callback;
 }
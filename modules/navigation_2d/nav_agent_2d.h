@@ -84,6 +84,8 @@ public:
 
 	bool is_map_changed();
 
+	Vector2 get_flow_field_direction(const Vector2 &p_target_position, uint32_t p_navigation_layers) const;
+
 	RVO2D::Agent2D *get_rvo_agent() { return &rvo_agent; }
 
 	void set_avoidance_callback(Callable p_callback);
@@ -55,6 +55,9 @@ using namespace Nav2D;
 #define NAVMAP_ITERATION_ZERO_ERROR_MSG()
 #endif // DEBUG_ENABLED
 
+// Maximum number of cached flow fields per map.
+constexpr uint32_t FLOW_FIELD_CACHE_MAX_SIZE = 16;
+
 #define GET_MAP_ITERATION()                                                   \
 	iteration_slot_rwlock.read_lock();                                        \
 	NavMapIteration2D &map_iteration = iteration_slots[iteration_slot_index]; \
@@ -124,39 +127,154 @@ PointKey NavMap2D::get_point_key(const Vector2 &p_pos) const {
 	return p;
 }
 
-void NavMap2D::query_path(NavMeshQueries2D::NavMeshPathQueryTask2D &p_query_task) {
-	if (iteration_id == 0) {
-		return;
-	}
-
-	GET_MAP_ITERATION();
+NavMeshQueries2D::PathQuerySlot *NavMap2D::_acquire_path_query_slot(NavMapIteration2D &p_map_iteration) {
+	p_map_iteration.path_query_slots_semaphore.wait();
 
-	map_iteration.path_query_slots_semaphore.wait();
+	NavMeshQueries2D::PathQuerySlot *path_query_slot = nullptr;
 
-	map_iteration.path_query_slots_mutex.lock();
-	for (NavMeshQueries2D::PathQuerySlot &p_path_query_slot : map_iteration.path_query_slots) {
+	p_map_iteration.path_query_slots_mutex.lock();
+	for (NavMeshQueries2D::PathQuerySlot &p_path_query_slot : p_map_iteration.path_query_slots) {
 		if (!p_path_query_slot.in_use) {
 			p_path_query_slot.in_use = true;
-			p_query_task.path_query_slot = &p_path_query_slot;
+			path_query_slot = &p_path_query_slot;
 			break;
 		}
 	}
-	map_iteration.path_query_slots_mutex.unlock();
+	p_map_iteration.path_query_slots_mutex.unlock();
+
+	if (path_query_slot == nullptr) {
+		p_map_iteration.path_query_slots_semaphore.post();
+		ERR_FAIL_NULL_V_MSG(path_query_slot, nullptr, "No unused NavMap2D path query slot found! This should never happen :(.");
+	}
+
+	return path_query_slot;
+}
+
+void NavMap2D::_release_path_query_slot(NavMapIteration2D &p_map_iteration, NavMeshQueries2D::PathQuerySlot *p_path_query_slot) {
+	p_map_iteration.path_query_slots_mutex.lock();
+	p_map_iteration.path_query_slots[p_path_query_slot->slot_index].in_use = false;
+	p_map_iteration.path_query_slots_mutex.unlock();
+
+	p_map_iteration.path_query_slots_semaphore.post();
+}
+
+void NavMap2D::query_path(NavMeshQueries2D::NavMeshPathQueryTask2D &p_query_task) {
+	if (iteration_id == 0) {
+		return;
+	}
+
+	GET_MAP_ITERATION();
 
+	p_query_task.path_query_slot = _acquire_path_query_slot(map_iteration);
 	if (p_query_task.path_query_slot == nullptr) {
-		map_iteration.path_query_slots_semaphore.post();
-		ERR_FAIL_NULL_MSG(p_query_task.path_query_slot, "No unused NavMap2D path query slot found! This should never happen :(.");
+		return;
 	}
 
 	NavMeshQueries2D::query_task_map_iteration_get_path(p_query_task, map_iteration);
 
-	map_iteration.path_query_slots_mutex.lock();
-	uint32_t used_slot_index = p_query_task.path_query_slot->slot_index;
-	map_iteration.path_query_slots[used_slot_index].in_use = false;
+	_release_path_query_slot(map_iteration, p_query_task.path_query_slot);
 	p_query_task.path_query_slot = nullptr;
-	map_iteration.path_query_slots_mutex.unlock();
+}
+
+Vector2 NavMap2D::get_flow_field_direction(const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers) {
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return Vector2();
+	}
+
+	// The flow fields keep pointers to the polygons of the iteration, so the id must belong to the same slot.
+	iteration_slot_rwlock.read_lock();
+	NavMapIteration2D &map_iteration = iteration_slots[iteration_slot_index];
+	NavMapIterationRead2D iteration_read_lock(map_iteration);
+	const uint32_t flow_field_iteration_id = iteration_id;
+	iteration_slot_rwlock.read_unlock();
+	const Pair<Vector2, uint32_t> flow_field_key(p_target_position, p_navigation_layers);
+
+	bool flow_field_grid_outdated = true;
+	bool flow_field_outdated = true;
+	{
+		RWLockRead read_lock(flow_fields_rwlock);
+		const FlowField *flow_field = flow_fields.getptr(flow_field_key);
+		flow_field_grid_outdated = flow_field_grid.iteration_id != flow_field_iteration_id;
+		flow_field_outdated = flow_field == nullptr || flow_field->iteration_id != flow_field_iteration_id;
+		if (!flow_field_grid_outdated && !flow_field_outdated) {
+			return NavMeshQueries2D::flow_field_get_direction(flow_field_grid, *flow_field, p_position);
+		}
+	}
+
+	// Build the outdated parts without holding the lock, so the other flow fields can still be sampled meanwhile.
+	// Only the flow fields that are still sampled get rebuilt after the map changed.
+	FlowFieldGrid built_flow_field_grid;
+	if (flow_field_grid_outdated) {
+		NavMeshQueries2D::map_iteration_build_flow_field_grid(map_iteration, built_flow_field_grid);
+		built_flow_field_grid.iteration_id = flow_field_iteration_id;
+	}
+	FlowField built_flow_field;
+	if (flow_field_outdated) {
+		if (!_build_flow_field(map_iteration, p_target_position, p_navigation_layers, built_flow_field)) {
+			return Vector2();
+		}
+		built_flow_field.iteration_id = flow_field_iteration_id;
+	}
+
+	RWLockWrite write_lock(flow_fields_rwlock);
+
+	// Another query may have replaced the parts that were up to date, those are rebuilt while locked.
+	if (flow_field_grid.iteration_id != flow_field_iteration_id) {
+		if (flow_field_grid_outdated) {
+			flow_field_grid = std::move(built_flow_field_grid);
+		} else {
+			NavMeshQueries2D::map_iteration_build_flow_field_grid(map_iteration, flow_field_grid);
+			flow_field_grid.iteration_id = flow_field_iteration_id;
+		}
+	}
+
+	FlowField *flow_field = flow_fields.getptr(flow_field_key);
+	if (flow_field == nullptr) {
+		if (flow_fields.size() >= FLOW_FIELD_CACHE_MAX_SIZE) {
+			// Drop the outdated flow fields first and the oldest one when all are in use.
+			LocalVector<Pair<Vector2, uint32_t>> outdated_flow_field_keys;
+			for (const KeyValue<Pair<Vector2, uint32_t>, FlowField> &E : flow_fields) {
+				if (E.value.iteration_id != flow_field_iteration_id) {
+					outdated_flow_field_keys.push_back(E.key);
+				}
+			}
+			for (const Pair<Vector2, uint32_t> &outdated_flow_field_key : outdated_flow_field_keys) {
+				flow_fields.erase(outdated_flow_field_key);
+			}
+			if (flow_fields.size() >= FLOW_FIELD_CACHE_MAX_SIZE) {
+				flow_fields.erase(flow_fields.begin()->key);
+			}
+		}
+		flow_field = &flow_fields.insert(flow_field_key, FlowField())->value;
+	}
+
+	if (flow_field->iteration_id != flow_field_iteration_id) {
+		if (flow_field_outdated) {
+			*flow_field = std::move(built_flow_field);
+		} else if (_build_flow_field(map_iteration, p_target_position, p_navigation_layers, *flow_field)) {
+			flow_field->iteration_id = flow_field_iteration_id;
+		} else {
+			return Vector2();
+		}
+	}
+
+	return NavMeshQueries2D::flow_field_get_direction(flow_field_grid, *flow_field, p_position);
+}
+
+bool NavMap2D::_build_flow_field(NavMapIteration2D &p_map_iteration, const Vector2 &p_target_position, uint32_t p_navigation_layers, FlowField &r_flow_field) {
+	NavMeshQueries2D::NavMeshPathQueryTask2D query_task;
+	query_task.start_position = p_target_position;
+	query_task.target_position = p_target_position;
+	query_task.navigation_layers = p_navigation_layers;
 
-	map_iteration.path_query_slots_semaphore.post();
+	query_task.path_query_slot = _acquire_path_query_slot(p_map_iteration);
+	ERR_FAIL_NULL_V(query_task.path_query_slot, false);
+
+	NavMeshQueries2D::query_task_build_flow_field(query_task, p_map_iteration, r_flow_field);
+
+	_release_path_query_slot(p_map_iteration, query_task.path_query_slot);
+	return true;
 }
 
 Vector2 NavMap2D::get_closest_point(const Vector2 &p_point) const {
@@ -314,6 +432,7 @@ void NavMap2D::_build_iteration() {
 	iteration_build.use_edge_connections = get_use_edge_connections();
 	iteration_build.edge_connection_margin = get_edge_connection_margin();
 	iteration_build.link_connection_radius = get_link_connection_radius();
+	iteration_build.cluster_size = cluster_size;
 
 	next_map_iteration.clear();
 
@@ -359,10 +478,10 @@ void NavMap2D::_sync_iteration() {
 	performance_data.pm_edge_connection_count = iteration_build.performance_data.pm_edge_connection_count;
 	performance_data.pm_edge_free_count = iteration_build.performance_data.pm_edge_free_count;
 
-	iteration_id = iteration_id % UINT32_MAX + 1;
-
 	// Finally ping-pong switch the iteration slot.
+	// The id changes together with the slot, so readers never see the new id with the old slot.
 	iteration_slot_rwlock.write_lock();
+	iteration_id = iteration_id % UINT32_MAX + 1;
 	uint32_t next_iteration_slot_index = (iteration_slot_index + 1) % 2;
 	iteration_slot_index = next_iteration_slot_index;
 	iteration_slot_rwlock.write_unlock();
@@ -498,47 +617,62 @@ void NavMap2D::_update_rvo_obstacles_tree() {
 	rvo_simulation.kdTree_->buildObstacleTree(raw_obstacles);
 }
 
-void NavMap2D::_update_rvo_agents_tree() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO2D::Agent2D *> raw_agents;
-	raw_agents.reserve(active_avoidance_agents.size());
-	for (NavAgent2D *agent : active_avoidance_agents) {
-		raw_agents.push_back(agent->get_rvo_agent());
-	}
-	rvo_simulation.kdTree_->buildAgentTree(raw_agents);
-}
-
 void NavMap2D::_update_rvo_simulation() {
 	if (obstacles_dirty) {
 		_update_rvo_obstacles_tree();
 	}
-	if (agents_dirty) {
-		_update_rvo_agents_tree();
+}
+
+void NavMap2D::_gather_avoidance_agent(uint32_t p_index, NavAgent2D **p_agents) {
+	const RVO2D::Agent2D *rvo_agent = p_agents[p_index]->get_rvo_agent();
+	avoidance_grid.set_agent(p_index, rvo_agent->position_.x(), rvo_agent->position_.y(), rvo_agent->avoidance_layers_);
+}
+
+void NavMap2D::_compute_avoidance_velocity(uint32_t p_index, NavAgent2D **p_agents) {
+	RVO2D::Agent2D *rvo_agent = p_agents[p_index]->get_rvo_agent();
+
+	rvo_agent->obstacleNeighbors_.clear();
+	const float obstacle_range = rvo_agent->timeHorizonObst_ * rvo_agent->maxSpeed_ + rvo_agent->radius_;
+	rvo_simulation.kdTree_->computeObstacleNeighbors(rvo_agent, obstacle_range * obstacle_range);
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ > 0) {
+		float range_sq = rvo_agent->neighborDist_ * rvo_agent->neighborDist_;
+		avoidance_grid.query_neighbors(rvo_agent->position_.x(), rvo_agent->position_.y(), rvo_agent->avoidance_mask_, range_sq, [&](uint32_t p_neighbor_index, float &r_range_sq) {
+			rvo_agent->insertAgentNeighbor(p_agents[p_neighbor_index]->get_rvo_agent(), r_range_sq);
+		});
 	}
+
+	rvo_agent->computeNewVelocity(&rvo_simulation);
+}
+
+void NavMap2D::_update_avoidance_agent(uint32_t p_index, NavAgent2D **p_agents) {
+	p_agents[p_index]->get_rvo_agent()->update(&rvo_simulation);
+	p_agents[p_index]->update();
 }
 
-void NavMap2D::compute_single_avoidance_step(uint32_t p_index, NavAgent2D **p_agent) {
-	(*(p_agent + p_index))->get_rvo_agent()->computeNeighbors(&rvo_simulation);
-	(*(p_agent + p_index))->get_rvo_agent()->computeNewVelocity(&rvo_simulation);
-	(*(p_agent + p_index))->get_rvo_agent()->update(&rvo_simulation);
-	(*(p_agent + p_index))->update();
+void NavMap2D::_run_avoidance_phase(void (NavMap2D::*p_method)(uint32_t, NavAgent2D **), const String &p_description) {
+	if (use_threads && avoidance_use_multiple_threads) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_method, active_avoidance_agents.ptr(), active_avoidance_agents.size(), -1, true, p_description);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < active_avoidance_agents.size(); i++) {
+			(this->*p_method)(i, active_avoidance_agents.ptr());
+		}
+	}
 }
 
 void NavMap2D::step(double p_delta_time) {
 	rvo_simulation.setTimeStep(float(p_delta_time));
 
+	// Every phase has to finish for all agents before the next one starts,
+	// the new velocities are computed from the positions and velocities of the neighbors before they move.
 	if (active_avoidance_agents.size() > 0) {
-		if (use_threads && avoidance_use_multiple_threads) {
-			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap2D::compute_single_avoidance_step, active_avoidance_agents.ptr(), active_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents2D"));
-			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
-		} else {
-			for (NavAgent2D *agent : active_avoidance_agents) {
-				agent->get_rvo_agent()->computeNeighbors(&rvo_simulation);
-				agent->get_rvo_agent()->computeNewVelocity(&rvo_simulation);
-				agent->get_rvo_agent()->update(&rvo_simulation);
-				agent->update();
-			}
-		}
+		avoidance_grid.resize(active_avoidance_agents.size());
+		_run_avoidance_phase(&NavMap2D::_gather_avoidance_agent, "RVOAvoidanceGather2D");
+		avoidance_grid.build();
+		_run_avoidance_phase(&NavMap2D::_compute_avoidance_velocity, "RVOAvoidanceAgents2D");
+		_run_avoidance_phase(&NavMap2D::_update_avoidance_agent, "RVOAvoidanceUpdate2D");
 	}
 }
 
@@ -767,6 +901,8 @@ NavMap2D::NavMap2D() {
 		path_query_slots_max = 1;
 	}
 
+	cluster_size = GLOBAL_GET("navigation/2d/hierarchical_pathfinding_cluster_size");
+
 	iteration_slots.resize(2);
 
 	for (NavMapIteration2D &iteration_slot : iteration_slots) {
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "2d/nav_avoidance_grid_2d.h"
 #include "2d/nav_map_iteration_2d.h"
 #include "2d/nav_mesh_queries_2d.h"
 #include "nav_rid_2d.h"
@@ -79,6 +80,9 @@ class NavMap2D : public NavRid2D {
 	/// Avoidance controlled agents.
 	LocalVector<NavAgent2D *> active_avoidance_agents;
 
+	/// Neighbor search grid of the avoidance agents, rebuilt each step.
+	NavAvoidanceGrid2D avoidance_grid;
+
 	/// dirty flag when one of the agent's arrays are modified.
 	bool agents_dirty = true;
 
@@ -131,6 +135,9 @@ class NavMap2D : public NavRid2D {
 
 	bool use_async_iterations = true;
 
+	// Size of the clusters used for hierarchical pathfinding, disabled when zero.
+	real_t cluster_size = 0.0;
+
 	uint32_t iteration_slot_index = 0;
 	LocalVector<NavMapIteration2D> iteration_slots;
 	mutable RWLock iteration_slot_rwlock;
@@ -146,6 +153,15 @@ class NavMap2D : public NavRid2D {
 	void _build_iteration();
 	void _sync_iteration();
 
+	// Flow fields towards shared targets, rebuilt on demand when the map iteration changed.
+	RWLock flow_fields_rwlock;
+	Nav2D::FlowFieldGrid flow_field_grid;
+	HashMap<Pair<Vector2, uint32_t>, Nav2D::FlowField> flow_fields;
+
+	NavMeshQueries2D::PathQuerySlot *_acquire_path_query_slot(NavMapIteration2D &p_map_iteration);
+	void _release_path_query_slot(NavMapIteration2D &p_map_iteration, NavMeshQueries2D::PathQuerySlot *p_path_query_slot);
+	bool _build_flow_field(NavMapIteration2D &p_map_iteration, const Vector2 &p_target_position, uint32_t p_navigation_layers, Nav2D::FlowField &r_flow_field);
+
 public:
 	NavMap2D();
 	~NavMap2D();
@@ -181,6 +197,7 @@ public:
 	const Vector2 &get_merge_rasterizer_cell_size() const;
 
 	void query_path(NavMeshQueries2D::NavMeshPathQueryTask2D &p_query_task);
+	Vector2 get_flow_field_direction(const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers);
 
 	Vector2 get_closest_point(const Vector2 &p_point) const;
 	Nav2D::ClosestPointQueryResult get_closest_point_info(const Vector2 &p_point) const;
@@ -259,12 +276,14 @@ private:
 
 	void compute_single_step(uint32_t p_index, NavAgent2D **p_agent);
 
-	void compute_single_avoidance_step(uint32_t p_index, NavAgent2D **p_agent);
+	void _gather_avoidance_agent(uint32_t p_index, NavAgent2D **p_agents);
+	void _compute_avoidance_velocity(uint32_t p_index, NavAgent2D **p_agents);
+	void _update_avoidance_agent(uint32_t p_index, NavAgent2D **p_agents);
+	void _run_avoidance_phase(void (NavMap2D::*p_method)(uint32_t, NavAgent2D **), const String &p_description);
 
 	void _sync_avoidance();
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree();
-	void _update_rvo_agents_tree();
 
 	void _update_merge_rasterizer_cell_dimensions();
 };
@@ -381,6 +381,13 @@ Vector3 GodotNavigationServer3D::map_get_random_point(RID p_map, uint32_t p_navi
 	return map->get_random_point(p_navigation_layers, p_uniformly);
 }
 
+Vector3 GodotNavigationServer3D::map_get_flow_field_direction(RID p_map, const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	NavMap3D *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Vector3());
+
+	return map->get_flow_field_direction(p_target_position, p_position, p_navigation_layers);
+}
+
 RID GodotNavigationServer3D::region_create() {
 	MutexLock lock(operations_mutex);
 
@@ -969,6 +976,13 @@ bool GodotNavigationServer3D::agent_is_map_changed(RID p_agent) const {
 	return agent->is_map_changed();
 }
 
+Vector3 GodotNavigationServer3D::agent_get_flow_field_direction(RID p_agent, const Vector3 &p_target_position, uint32_t p_navigation_layers) const {
+	const NavAgent3D *agent = agent_owner.get_or_null(p_agent);
+	ERR_FAIL_NULL_V(agent, Vector3());
+
+	return agent->get_flow_field_direction(p_target_position, p_navigation_layers);
+}
+
 COMMAND_2(agent_set_avoidance_callback, RID, p_agent, Callable, p_callback) {
 	NavAgent3D *agent = agent_owner.get_or_null(p_agent);
 	ERR_FAIL_NULL(agent);
@@ -1403,6 +1417,9 @@ void GodotNavigationServer3D::physics_process(double p_delta_time) {
 	int _new_pm_edge_connection_count = 0;
 	int _new_pm_edge_free_count = 0;
 	int _new_pm_obstacle_count = 0;
+	int _new_pm_iteration_build_usec = 0;
+	int _new_pm_iteration_rebuilt_region_count = 0;
+	int _new_pm_iteration_reused_region_count = 0;
 
 	MutexLock lock(operations_mutex);
 	for (uint32_t i(0); i < active_maps.size(); i++) {
@@ -1419,6 +1436,9 @@ void GodotNavigationServer3D::physics_process(double p_delta_time) {
 		_new_pm_edge_connection_count += active_maps[i]->get_pm_edge_connection_count();
 		_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
 		_new_pm_obstacle_count += active_maps[i]->get_pm_obstacle_count();
+		_new_pm_iteration_build_usec += active_maps[i]->get_pm_iteration_build_usec();
+		_new_pm_iteration_rebuilt_region_count += active_maps[i]->get_pm_iteration_rebuilt_region_count();
+		_new_pm_iteration_reused_region_count += active_maps[i]->get_pm_iteration_reused_region_count();
 	}
 
 	pm_region_count = _new_pm_region_count;
@@ -1430,6 +1450,9 @@ void GodotNavigationServer3D::physics_process(double p_delta_time) {
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
 	pm_obstacle_count = _new_pm_obstacle_count;
+	pm_iteration_build_usec = _new_pm_iteration_build_usec;
+	pm_iteration_rebuilt_region_count = _new_pm_iteration_rebuilt_region_count;
+	pm_iteration_reused_region_count = _new_pm_iteration_reused_region_count;
 }
 
 void GodotNavigationServer3D::init() {
@@ -1457,6 +1480,41 @@ void GodotNavigationServer3D::query_path(const Ref<NavigationPathQueryParameters
 	NavMeshQueries3D::map_query_path(map, p_query_parameters, p_query_result, p_callback);
 }
 
+void GodotNavigationServer3D::query_path_batch(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results) {
+	ERR_FAIL_COND_MSG(p_query_parameters.size() != p_query_results.size(), "The number of path query parameters and results must match.");
+
+	const uint32_t query_count = p_query_parameters.size();
+	LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D> query_tasks;
+	query_tasks.resize(query_count);
+
+	// Queries can target different maps, every map processes its own queries as one batch.
+	HashMap<NavMap3D *, LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *>> map_query_tasks;
+	for (uint32_t i = 0; i < query_count; i++) {
+		const Ref<NavigationPathQueryParameters3D> query_parameters = p_query_parameters[i];
+		const Ref<NavigationPathQueryResult3D> query_result = p_query_results[i];
+		ERR_CONTINUE(query_parameters.is_null());
+		ERR_CONTINUE(query_result.is_null());
+
+		NavMap3D *map = map_owner.get_or_null(query_parameters->get_map());
+		ERR_CONTINUE(map == nullptr);
+
+		NavMeshQueries3D::NavMeshPathQueryTask3D &query_task = query_tasks[i];
+		NavMeshQueries3D::query_task_set_parameters(query_task, query_parameters);
+		query_task.query_result = query_result;
+		map_query_tasks[map].push_back(&query_task);
+	}
+
+	for (KeyValue<NavMap3D *, LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *>> &E : map_query_tasks) {
+		E.key->query_path_batch(E.value);
+	}
+
+	for (const NavMeshQueries3D::NavMeshPathQueryTask3D &query_task : query_tasks) {
+		if (query_task.query_result.is_valid()) {
+			NavMeshQueries3D::query_task_set_result(query_task, query_task.query_result);
+		}
+	}
+}
+
 RID GodotNavigationServer3D::source_geometry_parser_create() {
 	RWLockWrite write_lock(geometry_parser_rwlock);
 
@@ -1544,6 +1602,15 @@ int GodotNavigationServer3D::get_process_info(ProcessInfo p_info) const {
 		case INFO_OBSTACLE_COUNT: {
 			return pm_obstacle_count;
 		} break;
+		case INFO_ITERATION_BUILD_USEC: {
+			return pm_iteration_build_usec;
+		} break;
+		case INFO_ITERATION_REBUILT_REGION_COUNT: {
+			return pm_iteration_rebuilt_region_count;
+		} break;
+		case INFO_ITERATION_REUSED_REGION_COUNT: {
+			return pm_iteration_reused_region_count;
+		} break;
 	}
 
 	return 0;
@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*  nav_avoidance_grid_3d.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_avoidance_grid_3d.h"
+
+// Average amount of agents per cell, few enough to keep the scans of the closest rings short.
+static const float AVOIDANCE_GRID_AGENTS_PER_CELL = 2.0;
+static const float AVOIDANCE_GRID_MIN_CELL_SIZE = 0.01;
+static const int64_t AVOIDANCE_GRID_MAX_CELLS = 1 << 20;
+
+void NavAvoidanceGrid3D::resize(uint32_t p_agent_count) {
+	positions_x.resize(p_agent_count);
+	positions_y.resize(p_agent_count);
+	positions_z.resize(p_agent_count);
+	avoidance_layers.resize(p_agent_count);
+}
+
+void NavAvoidanceGrid3D::build() {
+	const uint32_t agent_count = positions_x.size();
+	if (agent_count == 0) {
+		cell_offsets.clear();
+		return;
+	}
+
+	float min[3] = { positions_x[0], positions_y[0], positions_z[0] };
+	float max[3] = { min[0], min[1], min[2] };
+	for (uint32_t i = 1; i < agent_count; i++) {
+		min[0] = MIN(min[0], positions_x[i]);
+		min[1] = MIN(min[1], positions_y[i]);
+		min[2] = MIN(min[2], positions_z[i]);
+		max[0] = MAX(max[0], positions_x[i]);
+		max[1] = MAX(max[1], positions_y[i]);
+		max[2] = MAX(max[2], positions_z[i]);
+	}
+
+	// Size the cells by the agent density on the axes the agents are spread on,
+	// e.g. only two axes for agents on flat ground.
+	int active_axes = 0;
+	float volume = 1.0;
+	for (int axis = 0; axis < 3; axis++) {
+		const float extent = max[axis] - min[axis];
+		if (extent > AVOIDANCE_GRID_MIN_CELL_SIZE) {
+			active_axes++;
+			volume *= extent;
+		}
+	}
+	cell_size = 1.0;
+	if (active_axes > 0) {
+		cell_size = Math::pow(volume * AVOIDANCE_GRID_AGENTS_PER_CELL / agent_count, 1.0f / active_axes);
+	}
+	cell_size = MAX(cell_size, AVOIDANCE_GRID_MIN_CELL_SIZE);
+
+	while (true) {
+		for (int axis = 0; axis < 3; axis++) {
+			origin[axis] = min[axis];
+			size[axis] = (int)((max[axis] - min[axis]) / cell_size) + 1;
+		}
+		if ((int64_t)size[0] * size[1] * size[2] <= AVOIDANCE_GRID_MAX_CELLS) {
+			break;
+		}
+		cell_size *= 2.0;
+	}
+
+	// Counting sort of the agents by cell.
+	const uint32_t cell_count = size[0] * size[1] * size[2];
+	cell_offsets.resize(cell_count + 1);
+	memset(cell_offsets.ptr(), 0, sizeof(uint32_t) * (cell_count + 1));
+
+	agent_cells.resize(agent_count);
+	for (uint32_t i = 0; i < agent_count; i++) {
+		const int x = _get_cell_coordinate(positions_x[i], 0);
+		const int y = _get_cell_coordinate(positions_y[i], 1);
+		const int z = _get_cell_coordinate(positions_z[i], 2);
+		const uint32_t cell = (z * size[1] + y) * size[0] + x;
+		agent_cells[i] = cell;
+		cell_offsets[cell]++;
+	}
+	for (uint32_t cell = 1; cell <= cell_count; cell++) {
+		cell_offsets[cell] += cell_offsets[cell - 1];
+	}
+
+	cell_agent_indices.resize(agent_count);
+	cell_positions_x.resize(agent_count);
+	cell_positions_y.resize(agent_count);
+	cell_positions_z.resize(agent_count);
+	cell_avoidance_layers.resize(agent_count);
+
+	// The offsets hold the end of each cell, filling the cells backwards leaves them at the start.
+	for (int64_t i = agent_count - 1; i >= 0; i--) {
+		const uint32_t index = --cell_offsets[agent_cells[i]];
+		cell_agent_indices[index] = i;
+		cell_positions_x[index] = positions_x[i];
+		cell_positions_y[index] = positions_y[i];
+		cell_positions_z[index] = positions_z[i];
+		cell_avoidance_layers[index] = avoidance_layers[i];
+	}
+}
@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  nav_avoidance_grid_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/math_funcs.h"
+#include "core/templates/local_vector.h"
+
+// Uniform grid to find the closest neighbors of avoidance agents.
+// The positions and layers of the agents are also stored sorted by cell, so scanning a cell only reads contiguous memory.
+class NavAvoidanceGrid3D {
+	float cell_size = 1.0;
+	float origin[3] = { 0.0, 0.0, 0.0 };
+	int size[3] = { 0, 0, 0 };
+
+	// Indexed by the agent index.
+	LocalVector<float> positions_x;
+	LocalVector<float> positions_y;
+	LocalVector<float> positions_z;
+	LocalVector<uint32_t> avoidance_layers;
+	LocalVector<uint32_t> agent_cells;
+
+	// Indexed by the agent order in the cells, from `cell_offsets[cell]` to `cell_offsets[cell + 1]`.
+	LocalVector<uint32_t> cell_offsets;
+	LocalVector<uint32_t> cell_agent_indices;
+	LocalVector<float> cell_positions_x;
+	LocalVector<float> cell_positions_y;
+	LocalVector<float> cell_positions_z;
+	LocalVector<uint32_t> cell_avoidance_layers;
+
+	_FORCE_INLINE_ int _get_cell_coordinate(float p_position, int p_axis) const {
+		return CLAMP((int)Math::floor((p_position - origin[p_axis]) / cell_size), 0, size[p_axis] - 1);
+	}
+
+	template <typename F>
+	_FORCE_INLINE_ void _scan_cell(int p_x, int p_y, int p_z, float p_position_x, float p_position_y, float p_position_z, uint32_t p_avoidance_mask, float &r_range_sq, F &p_insert_neighbor) const {
+		const uint32_t cell = (p_z * size[1] + p_y) * size[0] + p_x;
+		const uint32_t end = cell_offsets[cell + 1];
+		for (uint32_t i = cell_offsets[cell]; i < end; i++) {
+			if ((p_avoidance_mask & cell_avoidance_layers[i]) == 0) {
+				continue;
+			}
+			const float dx = cell_positions_x[i] - p_position_x;
+			const float dy = cell_positions_y[i] - p_position_y;
+			const float dz = cell_positions_z[i] - p_position_z;
+			if (dx * dx + dy * dy + dz * dz < r_range_sq) {
+				p_insert_neighbor(cell_agent_indices[i], r_range_sq);
+			}
+		}
+	}
+
+public:
+	void resize(uint32_t p_agent_count);
+
+	// Can be called for different agents from multiple threads.
+	_FORCE_INLINE_ void set_agent(uint32_t p_index, float p_position_x, float p_position_y, float p_position_z, uint32_t p_avoidance_layers) {
+		positions_x[p_index] = p_position_x;
+		positions_y[p_index] = p_position_y;
+		positions_z[p_index] = p_position_z;
+		avoidance_layers[p_index] = p_avoidance_layers;
+	}
+
+	void build();
+
+	// Calls `p_insert_neighbor(agent_index, r_range_sq)` for the agents closer than `r_range_sq`, nearest cells first.
+	// The callback can shrink `r_range_sq` once it found enough neighbors, which ends the search early.
+	template <typename F>
+	void query_neighbors(float p_position_x, float p_position_y, float p_position_z, uint32_t p_avoidance_mask, float &r_range_sq, F &&p_insert_neighbor) const {
+		if (cell_offsets.is_empty()) {
+			return;
+		}
+
+		const int cx = _get_cell_coordinate(p_position_x, 0);
+		const int cy = _get_cell_coordinate(p_position_y, 1);
+		const int cz = _get_cell_coordinate(p_position_z, 2);
+		const int max_ring = MAX(MAX(size[0], size[1]), size[2]);
+
+		for (int ring = 0; ring < max_ring; ring++) {
+			// All cells of this ring are at least `ring - 1` cells away from the position.
+			if (ring > 1) {
+				const float ring_distance = (ring - 1) * cell_size;
+				if (ring_distance * ring_distance >= r_range_sq) {
+					break;
+				}
+			}
+
+			const int min_x = MAX(cx - ring, 0);
+			const int max_x = MIN(cx + ring, size[0] - 1);
+			for (int z = MAX(cz - ring, 0); z <= MIN(cz + ring, size[2] - 1); z++) {
+				for (int y = MAX(cy - ring, 0); y <= MIN(cy + ring, size[1] - 1); y++) {
+					if (Math::abs(z - cz) == ring || Math::abs(y - cy) == ring) {
+						for (int x = min_x; x <= max_x; x++) {
+							_scan_cell(x, y, z, p_position_x, p_position_y, p_position_z, p_avoidance_mask, r_range_sq, p_insert_neighbor);
+						}
+					} else {
+						// Inside of the ring only the cells on its x faces are new.
+						if (cx - ring >= 0) {
+							_scan_cell(cx - ring, y, z, p_position_x, p_position_y, p_position_z, p_avoidance_mask, r_range_sq, p_insert_neighbor);
+						}
+						if (ring > 0 && cx + ring < size[0]) {
+							_scan_cell(cx + ring, y, z, p_position_x, p_position_y, p_position_z, p_avoidance_mask, r_range_sq, p_insert_neighbor);
+						}
+					}
+				}
+			}
+		}
+	}
+};
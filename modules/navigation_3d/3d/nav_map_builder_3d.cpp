@@ -37,6 +37,8 @@
 #include "nav_region_iteration_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/os.h"
+#include "servers/nav_heap.h"
 
 using namespace Nav3D;
 
@@ -56,12 +58,16 @@ PointKey NavMapBuilder3D::get_point_key(const Vector3 &p_pos, const Vector3 &p_c
 void NavMapBuilder3D::build_navmap_iteration(NavMapIterationBuild3D &r_build) {
 	PerformanceData &performance_data = r_build.performance_data;
 
+	const uint64_t build_start_usec = OS::get_singleton()->get_ticks_usec();
+
 	performance_data.pm_polygon_count = 0;
 	performance_data.pm_edge_count = 0;
 	performance_data.pm_edge_merge_count = 0;
 	performance_data.pm_edge_connection_count = 0;
 	performance_data.pm_edge_free_count = 0;
 
+	_build_step_find_reused_regions(r_build);
+
 	_build_step_gather_region_polygons(r_build);
 
 	_build_step_find_edge_connection_pairs(r_build);
@@ -72,12 +78,87 @@ void NavMapBuilder3D::build_navmap_iteration(NavMapIterationBuild3D &r_build) {
 
 	_build_step_navlink_connections(r_build);
 
+	_build_step_cluster_hierarchy(r_build);
+
 	_build_update_map_iteration(r_build);
+
+	performance_data.pm_iteration_build_usec = OS::get_singleton()->get_ticks_usec() - build_start_usec;
+}
+
+void NavMapBuilder3D::_build_step_find_reused_regions(NavMapIterationBuild3D &r_build) {
+	PerformanceData &performance_data = r_build.performance_data;
+	NavMapIteration3D *map_iteration = r_build.map_iteration;
+	const NavMapIteration3D *previous_map_iteration = r_build.previous_map_iteration;
+
+	const LocalVector<Ref<NavRegionIteration3D>> &regions = map_iteration->region_iterations;
+	HashSet<const NavBaseIteration3D *> &reused_regions = r_build.reused_regions;
+
+	reused_regions.clear();
+
+	map_iteration->merge_rasterizer_cell_size = r_build.merge_rasterizer_cell_size;
+	map_iteration->use_edge_connections = r_build.use_edge_connections;
+	map_iteration->edge_connection_margin = r_build.edge_connection_margin;
+
+	// Changed map settings can change every connection.
+	const bool can_reuse_regions = previous_map_iteration != nullptr &&
+			!previous_map_iteration->region_iterations.is_empty() &&
+			previous_map_iteration->map_up == map_iteration->map_up &&
+			previous_map_iteration->merge_rasterizer_cell_size == map_iteration->merge_rasterizer_cell_size &&
+			previous_map_iteration->use_edge_connections == map_iteration->use_edge_connections &&
+			previous_map_iteration->edge_connection_margin == map_iteration->edge_connection_margin;
+
+	if (can_reuse_regions) {
+		// Regions get a new iteration whenever they change, so a region iteration that was already in use is unchanged.
+		HashSet<const NavBaseIteration3D *> previous_regions;
+		for (const Ref<NavRegionIteration3D> &region : previous_map_iteration->region_iterations) {
+			previous_regions.insert(region.ptr());
+		}
+
+		HashSet<const NavBaseIteration3D *> current_regions;
+		LocalVector<AABB> changed_bounds;
+		const real_t connection_margin = r_build.edge_connection_margin + r_build.merge_rasterizer_cell_size.length();
+
+		for (const Ref<NavRegionIteration3D> &region : regions) {
+			current_regions.insert(region.ptr());
+			if (!previous_regions.has(region.ptr())) {
+				changed_bounds.push_back(region->get_bounds().grow(connection_margin));
+			}
+		}
+		for (const Ref<NavRegionIteration3D> &region : previous_map_iteration->region_iterations) {
+			if (!current_regions.has(region.ptr())) {
+				changed_bounds.push_back(region->get_bounds().grow(connection_margin));
+			}
+		}
+
+		// Unchanged regions within reach of an added or removed region iteration may have gained or lost connections.
+		for (const Ref<NavRegionIteration3D> &region : regions) {
+			if (!previous_regions.has(region.ptr())) {
+				continue;
+			}
+
+			const AABB region_bounds = region->get_bounds();
+			bool near_changed_region = false;
+			for (const AABB &bounds : changed_bounds) {
+				if (bounds.intersects_inclusive(region_bounds)) {
+					near_changed_region = true;
+					break;
+				}
+			}
+			if (!near_changed_region) {
+				reused_regions.insert(region.ptr());
+			}
+		}
+	}
+
+	performance_data.pm_iteration_reused_region_count = reused_regions.size();
+	performance_data.pm_iteration_rebuilt_region_count = regions.size() - reused_regions.size();
 }
 
 void NavMapBuilder3D::_build_step_gather_region_polygons(NavMapIterationBuild3D &r_build) {
 	PerformanceData &performance_data = r_build.performance_data;
 	NavMapIteration3D *map_iteration = r_build.map_iteration;
+	const NavMapIteration3D *previous_map_iteration = r_build.previous_map_iteration;
+	const HashSet<const NavBaseIteration3D *> &reused_regions = r_build.reused_regions;
 
 	const LocalVector<Ref<NavRegionIteration3D>> &regions = map_iteration->region_iterations;
 	HashMap<const NavBaseIteration3D *, LocalVector<Connection>> &region_external_connections = map_iteration->external_region_connections;
@@ -89,15 +170,44 @@ void NavMapBuilder3D::_build_step_gather_region_polygons(NavMapIterationBuild3D
 
 	// Copy all region polygons in the map.
 	int polygon_count = 0;
+	int reused_polygon_connection_count = 0;
+	int reused_margin_connection_count = 0;
 	for (const Ref<NavRegionIteration3D> &region : regions) {
 		const uint32_t polygons_size = region->navmesh_polygons.size();
 		polygon_count += polygons_size;
 
-		region_external_connections[region.ptr()] = LocalVector<Connection>();
-		map_iteration->navbases_polygons_external_connections[region.ptr()] = LocalVector<LocalVector<Connection>>();
-		map_iteration->navbases_polygons_external_connections[region.ptr()].resize(polygons_size);
+		LocalVector<Connection> &external_connections = region_external_connections.insert(region.ptr(), LocalVector<Connection>())->value;
+		LocalVector<LocalVector<Connection>> &polygons_connections = map_iteration->navbases_polygons_external_connections.insert(region.ptr(), LocalVector<LocalVector<Connection>>())->value;
+		polygons_connections.resize(polygons_size);
+
+		if (!reused_regions.has(region.ptr())) {
+			continue;
+		}
+
+		// Take over the connections between reused regions, the connections to rebuilt regions and links are added again by the following steps.
+		const LocalVector<LocalVector<Connection>> *previous_polygons_connections = previous_map_iteration->navbases_polygons_external_connections.getptr(region.ptr());
+		const LocalVector<Connection> *previous_external_connections = previous_map_iteration->external_region_connections.getptr(region.ptr());
+		ERR_CONTINUE(previous_polygons_connections == nullptr || previous_polygons_connections->size() != polygons_size || previous_external_connections == nullptr);
+
+		for (uint32_t i = 0; i < polygons_size; i++) {
+			for (const Connection &connection : (*previous_polygons_connections)[i]) {
+				if (reused_regions.has(connection.polygon->owner)) {
+					polygons_connections[i].push_back(connection);
+					reused_polygon_connection_count++;
+				}
+			}
+		}
+		for (const Connection &connection : *previous_external_connections) {
+			if (reused_regions.has(connection.polygon->owner)) {
+				external_connections.push_back(connection);
+				reused_margin_connection_count++;
+			}
+		}
 	}
 
+	// Shared edges count once for both directions while the edge connection margin connections count once per direction.
+	performance_data.pm_edge_connection_count += reused_margin_connection_count + (reused_polygon_connection_count - reused_margin_connection_count) / 2;
+
 	performance_data.pm_polygon_count = polygon_count;
 	r_build.polygon_count = polygon_count;
 }
@@ -166,6 +276,7 @@ void NavMapBuilder3D::_build_step_merge_edge_connection_pairs(NavMapIterationBui
 	free_edges.reserve(free_edges_count);
 
 	NavMapIteration3D *map_iteration = r_build.map_iteration;
+	const HashSet<const NavBaseIteration3D *> &reused_regions = r_build.reused_regions;
 
 	HashMap<const NavBaseIteration3D *, LocalVector<LocalVector<Nav3D::Connection>>> &navbases_polygons_external_connections = map_iteration->navbases_polygons_external_connections;
 
@@ -176,6 +287,11 @@ void NavMapBuilder3D::_build_step_merge_edge_connection_pairs(NavMapIterationBui
 			const Connection &c1 = pair.connections[0];
 			const Connection &c2 = pair.connections[1];
 
+			if (reused_regions.has(c1.polygon->owner) && reused_regions.has(c2.polygon->owner)) {
+				// Already taken over from the previous iteration.
+				continue;
+			}
+
 			navbases_polygons_external_connections[c1.polygon->owner][c1.polygon->id].push_back(c2);
 			navbases_polygons_external_connections[c2.polygon->owner][c2.polygon->id].push_back(c1);
 			performance_data.pm_edge_connection_count += 1;
@@ -189,9 +305,54 @@ void NavMapBuilder3D::_build_step_merge_edge_connection_pairs(NavMapIterationBui
 	}
 }
 
+bool NavMapBuilder3D::_get_edge_connection_margin_connection(const Connection &p_free_edge, const Connection &p_other_edge, real_t p_edge_connection_margin_squared, Connection &r_connection) {
+	const Vector3 &edge_p1 = p_free_edge.pathway_start;
+	const Vector3 &edge_p2 = p_free_edge.pathway_end;
+	const Vector3 &other_edge_p1 = p_other_edge.pathway_start;
+	const Vector3 &other_edge_p2 = p_other_edge.pathway_end;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return false;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_squared_to(self1) > p_edge_connection_margin_squared) {
+		return false;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_squared_to(self2) > p_edge_connection_margin_squared) {
+		return false;
+	}
+
+	// The edges can now be connected.
+	r_connection = p_other_edge;
+	r_connection.pathway_start = (self1 + other1) / 2.0;
+	r_connection.pathway_end = (self2 + other2) / 2.0;
+	return true;
+}
+
 void NavMapBuilder3D::_build_step_edge_connection_margin_connections(NavMapIterationBuild3D &r_build) {
 	PerformanceData &performance_data = r_build.performance_data;
 	NavMapIteration3D *map_iteration = r_build.map_iteration;
+	const HashSet<const NavBaseIteration3D *> &reused_regions = r_build.reused_regions;
 
 	real_t edge_connection_margin = r_build.edge_connection_margin;
 
@@ -211,57 +372,34 @@ void NavMapBuilder3D::_build_step_edge_connection_margin_connections(NavMapItera
 
 	const real_t edge_connection_margin_squared = edge_connection_margin * edge_connection_margin;
 
+	// Free edges of reused regions already have their connections to each other,
+	// they only need to be checked against the free edges of rebuilt regions.
+	LocalVector<uint32_t> rebuilt_free_edges;
+	if (!reused_regions.is_empty()) {
+		for (uint32_t i = 0; i < free_edges.size(); i++) {
+			if (!reused_regions.has(free_edges[i].polygon->owner)) {
+				rebuilt_free_edges.push_back(i);
+			}
+		}
+	}
+
 	for (uint32_t i = 0; i < free_edges.size(); i++) {
 		const Connection &free_edge = free_edges[i];
-		const Vector3 &edge_p1 = free_edge.pathway_start;
-		const Vector3 &edge_p2 = free_edge.pathway_end;
+		const bool free_edge_reused = !reused_regions.is_empty() && reused_regions.has(free_edge.polygon->owner);
+		const uint32_t other_edge_count = free_edge_reused ? rebuilt_free_edges.size() : free_edges.size();
 
-		for (uint32_t j = 0; j < free_edges.size(); j++) {
+		for (uint32_t k = 0; k < other_edge_count; k++) {
+			const uint32_t j = free_edge_reused ? rebuilt_free_edges[k] : k;
 			const Connection &other_edge = free_edges[j];
 			if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
 				continue;
 			}
 
-			const Vector3 &other_edge_p1 = other_edge.pathway_start;
-			const Vector3 &other_edge_p2 = other_edge.pathway_end;
-
-			// Compute the projection of the opposite edge on the current one
-			Vector3 edge_vector = edge_p2 - edge_p1;
-			real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-			real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-			if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-				continue;
-			}
-
-			// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-			Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-			Vector3 other1;
-			if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-				other1 = other_edge_p1;
-			} else {
-				other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-			}
-			if (other1.distance_squared_to(self1) > edge_connection_margin_squared) {
-				continue;
-			}
-
-			Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-			Vector3 other2;
-			if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-				other2 = other_edge_p2;
-			} else {
-				other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-			}
-			if (other2.distance_squared_to(self2) > edge_connection_margin_squared) {
+			Connection new_connection;
+			if (!_get_edge_connection_margin_connection(free_edge, other_edge, edge_connection_margin_squared, new_connection)) {
 				continue;
 			}
 
-			// The edges can now be connected.
-			Connection new_connection = other_edge;
-			new_connection.pathway_start = (self1 + other1) / 2.0;
-			new_connection.pathway_end = (self2 + other2) / 2.0;
-			//free_edge.polygon->connections.push_back(new_connection);
-
 			// Add the connection to the region_connection map.
 			region_external_connections[free_edge.polygon->owner].push_back(new_connection);
 			navbases_polygons_external_connections[free_edge.polygon->owner][free_edge.polygon->id].push_back(new_connection);
@@ -394,6 +532,348 @@ void NavMapBuilder3D::_build_step_navlink_connections(NavMapIterationBuild3D &r_
 	r_build.polygon_count = polygon_count;
 }
 
+void NavMapBuilder3D::_add_cluster_portal(LocalVector<ClusterPortal> &r_portals, HashMap<uint64_t, uint32_t> &r_portal_indices, uint32_t p_from_cluster, uint32_t p_from_polygon, uint32_t p_to_cluster, uint32_t p_to_polygon, const Vector3 &p_position) {
+	// All connections between the same two clusters share a single portal.
+	const uint32_t from_side = p_from_cluster < p_to_cluster ? 0 : 1;
+	const uint64_t key = from_side == 0 ? (((uint64_t)p_from_cluster << 32) | p_to_cluster) : (((uint64_t)p_to_cluster << 32) | p_from_cluster);
+
+	HashMap<uint64_t, uint32_t>::Iterator portal_it = r_portal_indices.find(key);
+	if (!portal_it) {
+		ClusterPortal portal;
+		portal.clusters[from_side] = p_from_cluster;
+		portal.clusters[1 - from_side] = p_to_cluster;
+		portal.polygons[from_side] = p_from_polygon;
+		portal.polygons[1 - from_side] = p_to_polygon;
+		portal.position = p_position;
+
+		portal_it = r_portal_indices.insert(key, r_portals.size());
+		r_portals.push_back(portal);
+	}
+	r_portals[portal_it->value].traversable[from_side] = true;
+}
+
+struct ClusterCostNode {
+	uint32_t polygon = 0;
+	real_t cost = 0.0;
+};
+
+struct ClusterCostNodeGreaterThan {
+	bool operator()(const ClusterCostNode &p_node_a, const ClusterCostNode &p_node_b) const {
+		return p_node_a.cost > p_node_b.cost;
+	}
+};
+
+void NavMapBuilder3D::_build_region_clusters(NavRegionIteration3D &r_region, real_t p_cluster_size) {
+	RegionClusters &region_clusters = r_region.clusters;
+	region_clusters.clear();
+	region_clusters.cluster_size = p_cluster_size;
+
+	const LocalVector<Polygon> &polygons = r_region.navmesh_polygons;
+	const LocalVector<LocalVector<Connection>> &internal_connections = r_region.internal_connections;
+	const uint32_t polygon_count = polygons.size();
+	const bool has_internal_connections = internal_connections.size() == polygon_count;
+
+	LocalVector<Vector3> polygon_centers;
+	LocalVector<Vector3i> polygon_cells;
+	polygon_centers.resize(polygon_count);
+	polygon_cells.resize(polygon_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		const Polygon &polygon = polygons[i];
+		Vector3 center;
+		for (const Vector3 &vertex : polygon.vertices) {
+			center += vertex;
+		}
+		if (!polygon.vertices.is_empty()) {
+			center /= polygon.vertices.size();
+		}
+		polygon_centers[i] = center;
+		polygon_cells[i] = Vector3i((center / p_cluster_size).floor());
+	}
+
+	// Clusters are the connected parts of the navmesh inside each cell of the cluster grid.
+	LocalVector<uint32_t> &polygon_clusters = region_clusters.polygon_clusters;
+	polygon_clusters.resize(polygon_count);
+	for (uint32_t &cluster : polygon_clusters) {
+		cluster = UINT32_MAX;
+	}
+
+	LocalVector<uint32_t> polygon_stack;
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_clusters[i] != UINT32_MAX) {
+			continue;
+		}
+
+		const uint32_t cluster = region_clusters.cluster_count++;
+		polygon_clusters[i] = cluster;
+		if (!has_internal_connections) {
+			continue;
+		}
+
+		polygon_stack.push_back(i);
+		while (!polygon_stack.is_empty()) {
+			const uint32_t polygon_index = polygon_stack[polygon_stack.size() - 1];
+			polygon_stack.remove_at(polygon_stack.size() - 1);
+
+			for (const Connection &connection : internal_connections[polygon_index]) {
+				const uint32_t neighbor_index = connection.polygon->id;
+				if (polygon_clusters[neighbor_index] == UINT32_MAX && polygon_cells[neighbor_index] == polygon_cells[i]) {
+					polygon_clusters[neighbor_index] = cluster;
+					polygon_stack.push_back(neighbor_index);
+				}
+			}
+		}
+	}
+
+	// Border polygons connect to other clusters or may be connected to other regions.
+	LocalVector<uint8_t> polygon_is_border;
+	polygon_is_border.resize_initialized(polygon_count);
+
+	HashMap<uint64_t, uint32_t> portal_indices;
+	if (has_internal_connections) {
+		for (uint32_t i = 0; i < polygon_count; i++) {
+			for (const Connection &connection : internal_connections[i]) {
+				const uint32_t neighbor_index = connection.polygon->id;
+				if (polygon_clusters[neighbor_index] == polygon_clusters[i]) {
+					continue;
+				}
+				polygon_is_border[i] = 1;
+				_add_cluster_portal(region_clusters.portals, portal_indices, polygon_clusters[i], i, polygon_clusters[neighbor_index], neighbor_index, (connection.pathway_start + connection.pathway_end) * 0.5);
+			}
+		}
+	}
+	for (const ConnectableEdge &external_edge : r_region.external_edges) {
+		polygon_is_border[external_edge.polygon_index] = 1;
+	}
+
+	const uint32_t cluster_count = region_clusters.cluster_count;
+
+	LocalVector<uint32_t> &border_offsets = region_clusters.cluster_border_offsets;
+	border_offsets.resize_initialized(cluster_count + 1);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_is_border[i]) {
+			border_offsets[polygon_clusters[i] + 1]++;
+		}
+	}
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		border_offsets[i + 1] += border_offsets[i];
+	}
+
+	LocalVector<uint32_t> &border_polygons = region_clusters.border_polygons;
+	LocalVector<uint32_t> &polygon_border_indices = region_clusters.polygon_border_indices;
+	border_polygons.resize(border_offsets[cluster_count]);
+	polygon_border_indices.resize(polygon_count);
+
+	LocalVector<uint32_t> border_fill_offsets;
+	border_fill_offsets.resize(cluster_count);
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		border_fill_offsets[i] = border_offsets[i];
+	}
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		if (polygon_is_border[i]) {
+			const uint32_t border_index = border_fill_offsets[polygon_clusters[i]]++;
+			border_polygons[border_index] = i;
+			polygon_border_indices[i] = border_index;
+		} else {
+			polygon_border_indices[i] = UINT32_MAX;
+		}
+	}
+
+	LocalVector<uint32_t> &cost_offsets = region_clusters.cluster_cost_offsets;
+	cost_offsets.resize(cluster_count);
+	uint32_t cost_count = 0;
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		const uint32_t border_count = border_offsets[i + 1] - border_offsets[i];
+		cost_offsets[i] = cost_count;
+		cost_count += border_count * border_count;
+	}
+	region_clusters.border_costs.resize(cost_count);
+
+	if (!has_internal_connections) {
+		// Every polygon is a cluster of its own.
+		for (real_t &cost : region_clusters.border_costs) {
+			cost = 0.0;
+		}
+		return;
+	}
+
+	// Precompute the travel costs between the border polygons of each cluster with a Dijkstra search from each of them.
+	const real_t travel_cost = r_region.get_travel_cost();
+
+	LocalVector<real_t> polygon_costs;
+	polygon_costs.resize(polygon_count);
+	for (real_t &cost : polygon_costs) {
+		cost = FLT_MAX;
+	}
+	LocalVector<uint32_t> visited_polygons;
+	Heap<ClusterCostNode, ClusterCostNodeGreaterThan> traversable_polygons;
+
+	for (uint32_t cluster = 0; cluster < cluster_count; cluster++) {
+		const uint32_t border_begin = border_offsets[cluster];
+		const uint32_t border_count = border_offsets[cluster + 1] - border_begin;
+
+		for (uint32_t source = 0; source < border_count; source++) {
+			const uint32_t source_polygon = border_polygons[border_begin + source];
+			polygon_costs[source_polygon] = 0.0;
+			visited_polygons.push_back(source_polygon);
+			traversable_polygons.push({ source_polygon, 0.0 });
+
+			while (!traversable_polygons.is_empty()) {
+				const ClusterCostNode node = traversable_polygons.pop();
+				if (node.cost > polygon_costs[node.polygon]) {
+					continue; // Already reached with a lower cost.
+				}
+
+				for (const Connection &connection : internal_connections[node.polygon]) {
+					const uint32_t neighbor_index = connection.polygon->id;
+					if (polygon_clusters[neighbor_index] != cluster) {
+						continue;
+					}
+
+					const real_t cost = node.cost + polygon_centers[node.polygon].distance_to(polygon_centers[neighbor_index]) * travel_cost;
+					if (cost < polygon_costs[neighbor_index]) {
+						if (polygon_costs[neighbor_index] == FLT_MAX) {
+							visited_polygons.push_back(neighbor_index);
+						}
+						polygon_costs[neighbor_index] = cost;
+						traversable_polygons.push({ neighbor_index, cost });
+					}
+				}
+			}
+
+			real_t *source_costs = &region_clusters.border_costs[cost_offsets[cluster] + source * border_count];
+			for (uint32_t target = 0; target < border_count; target++) {
+				source_costs[target] = polygon_costs[border_polygons[border_begin + target]];
+			}
+
+			for (uint32_t polygon_index : visited_polygons) {
+				polygon_costs[polygon_index] = FLT_MAX;
+			}
+			visited_polygons.clear();
+		}
+	}
+}
+
+void NavMapBuilder3D::_build_step_cluster_hierarchy(NavMapIterationBuild3D &r_build) {
+	NavMapIteration3D *map_iteration = r_build.map_iteration;
+	const real_t cluster_size = r_build.cluster_size;
+
+	LocalVector<uint32_t> &polygon_clusters = map_iteration->polygon_clusters;
+	LocalVector<ClusterInfo> &clusters = map_iteration->clusters;
+	LocalVector<ClusterPortal> &cluster_portals = map_iteration->cluster_portals;
+	LocalVector<uint32_t> &cluster_portal_offsets = map_iteration->cluster_portal_offsets;
+	LocalVector<uint32_t> &cluster_portal_indices = map_iteration->cluster_portal_indices;
+
+	map_iteration->cluster_size = cluster_size;
+	polygon_clusters.clear();
+	clusters.clear();
+	cluster_portals.clear();
+	cluster_portal_offsets.clear();
+	cluster_portal_indices.clear();
+
+	if (cluster_size <= 0.0) {
+		return;
+	}
+
+	polygon_clusters.resize(r_build.polygon_count);
+
+	// Map polygon id of the first polygon of each region and link, matching the ids used by the path query slots.
+	HashMap<const NavBaseIteration3D *, uint32_t> polygon_offsets;
+	HashMap<uint64_t, uint32_t> portal_indices;
+
+	uint32_t polygon_offset = 0;
+	for (const Ref<NavRegionIteration3D> &region : map_iteration->region_iterations) {
+		// Region iterations are replaced when their region changes, so only new ones need their clusters built.
+		if (region->clusters.cluster_size != cluster_size) {
+			_build_region_clusters(*region.ptr(), cluster_size);
+		}
+
+		const RegionClusters &region_clusters = region->clusters;
+		const uint32_t cluster_offset = clusters.size();
+
+		for (uint32_t i = 0; i < region_clusters.cluster_count; i++) {
+			ClusterInfo cluster;
+			cluster.owner = region.ptr();
+			cluster.region_clusters = &region_clusters;
+			cluster.local_cluster = i;
+			cluster.polygon_offset = polygon_offset;
+			clusters.push_back(cluster);
+		}
+
+		const uint32_t polygons_size = region->navmesh_polygons.size();
+		for (uint32_t i = 0; i < polygons_size; i++) {
+			polygon_clusters[polygon_offset + i] = cluster_offset + region_clusters.polygon_clusters[i];
+		}
+
+		for (const ClusterPortal &portal : region_clusters.portals) {
+			for (uint32_t side = 0; side < 2; side++) {
+				if (portal.traversable[side]) {
+					_add_cluster_portal(cluster_portals, portal_indices, cluster_offset + portal.clusters[side], polygon_offset + portal.polygons[side], cluster_offset + portal.clusters[1 - side], polygon_offset + portal.polygons[1 - side], portal.position);
+				}
+			}
+		}
+
+		polygon_offsets[region.ptr()] = polygon_offset;
+		polygon_offset += polygons_size;
+	}
+
+	// Every link is a cluster of its own.
+	for (const Polygon &link_polygon : map_iteration->navlink_polygons) {
+		ClusterInfo cluster;
+		cluster.owner = link_polygon.owner;
+		cluster.polygon_offset = polygon_offset;
+
+		polygon_clusters[polygon_offset] = clusters.size();
+		clusters.push_back(cluster);
+
+		polygon_offsets[link_polygon.owner] = polygon_offset;
+		polygon_offset++;
+	}
+
+	// Add the portals of the connections between regions and links.
+	for (const KeyValue<const NavBaseIteration3D *, LocalVector<LocalVector<Connection>>> &E : map_iteration->navbases_polygons_external_connections) {
+		const uint32_t *owner_polygon_offset = polygon_offsets.getptr(E.key);
+		ERR_CONTINUE(owner_polygon_offset == nullptr);
+		const bool owner_is_link = E.key->get_type() == NavigationEnums3D::PathSegmentType::PATH_SEGMENT_TYPE_LINK;
+
+		for (uint32_t i = 0; i < E.value.size(); i++) {
+			// Links have a single polygon that holds all of their connections.
+			const uint32_t from_polygon = *owner_polygon_offset + (owner_is_link ? 0 : i);
+
+			for (const Connection &connection : E.value[i]) {
+				const uint32_t *to_polygon_offset = polygon_offsets.getptr(connection.polygon->owner);
+				ERR_CONTINUE(to_polygon_offset == nullptr);
+				const uint32_t to_polygon = *to_polygon_offset + connection.polygon->id;
+
+				if (polygon_clusters[from_polygon] != polygon_clusters[to_polygon]) {
+					_add_cluster_portal(cluster_portals, portal_indices, polygon_clusters[from_polygon], from_polygon, polygon_clusters[to_polygon], to_polygon, (connection.pathway_start + connection.pathway_end) * 0.5);
+				}
+			}
+		}
+	}
+
+	// Index the portals of each cluster.
+	const uint32_t cluster_count = clusters.size();
+	cluster_portal_offsets.resize_initialized(cluster_count + 1);
+	for (const ClusterPortal &portal : cluster_portals) {
+		cluster_portal_offsets[portal.clusters[0] + 1]++;
+		cluster_portal_offsets[portal.clusters[1] + 1]++;
+	}
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		cluster_portal_offsets[i + 1] += cluster_portal_offsets[i];
+	}
+
+	LocalVector<uint32_t> portal_fill_offsets;
+	portal_fill_offsets.resize(cluster_count);
+	for (uint32_t i = 0; i < cluster_count; i++) {
+		portal_fill_offsets[i] = cluster_portal_offsets[i];
+	}
+	cluster_portal_indices.resize(cluster_portal_offsets[cluster_count]);
+	for (uint32_t i = 0; i < cluster_portals.size(); i++) {
+		cluster_portal_indices[portal_fill_offsets[cluster_portals[i].clusters[0]]++] = i;
+		cluster_portal_indices[portal_fill_offsets[cluster_portals[i].clusters[1]]++] = i;
+	}
+}
+
 void NavMapBuilder3D::_build_update_map_iteration(NavMapIterationBuild3D &r_build) {
 	NavMapIteration3D *map_iteration = r_build.map_iteration;
 
@@ -413,6 +893,13 @@ void NavMapBuilder3D::_build_update_map_iteration(NavMapIterationBuild3D &r_buil
 		p_path_query_slot.poly_to_id.clear();
 		p_path_query_slot.poly_to_id.reserve(total_polygon_count);
 
+		p_path_query_slot.traversable_portals.clear();
+		p_path_query_slot.portal_nodes.clear();
+		p_path_query_slot.portal_nodes.resize(map_iteration->cluster_portals.size() * 2);
+		p_path_query_slot.cluster_corridor_marks.clear();
+		p_path_query_slot.cluster_corridor_marks.resize_initialized(map_iteration->clusters.size());
+		p_path_query_slot.cluster_corridor_mark = 0;
+
 		int polygon_id = 0;
 		for (Ref<NavRegionIteration3D> &region : map_iteration->region_iterations) {
 			for (const Polygon &polygon : region->navmesh_polygons) {
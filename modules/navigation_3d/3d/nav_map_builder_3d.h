@@ -33,13 +33,19 @@
 #include "../nav_utils_3d.h"
 
 struct NavMapIterationBuild3D;
+class NavRegionIteration3D;
 
 class NavMapBuilder3D {
+	static void _build_step_find_reused_regions(NavMapIterationBuild3D &r_build);
 	static void _build_step_gather_region_polygons(NavMapIterationBuild3D &r_build);
 	static void _build_step_find_edge_connection_pairs(NavMapIterationBuild3D &r_build);
 	static void _build_step_merge_edge_connection_pairs(NavMapIterationBuild3D &r_build);
 	static void _build_step_edge_connection_margin_connections(NavMapIterationBuild3D &r_build);
+	static bool _get_edge_connection_margin_connection(const Nav3D::Connection &p_free_edge, const Nav3D::Connection &p_other_edge, real_t p_edge_connection_margin_squared, Nav3D::Connection &r_connection);
 	static void _build_step_navlink_connections(NavMapIterationBuild3D &r_build);
+	static void _build_step_cluster_hierarchy(NavMapIterationBuild3D &r_build);
+	static void _build_region_clusters(NavRegionIteration3D &r_region, real_t p_cluster_size);
+	static void _add_cluster_portal(LocalVector<Nav3D::ClusterPortal> &r_portals, HashMap<uint64_t, uint32_t> &r_portal_indices, uint32_t p_from_cluster, uint32_t p_from_polygon, uint32_t p_to_cluster, uint32_t p_to_polygon, const Vector3 &p_position);
 	static void _build_update_map_iteration(NavMapIterationBuild3D &r_build);
 
 public:
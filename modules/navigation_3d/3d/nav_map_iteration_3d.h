@@ -36,6 +36,7 @@
 
 #include "core/math/math_defs.h"
 #include "core/os/semaphore.h"
+#include "core/templates/hash_set.h"
 
 class NavLinkIteration3D;
 class NavRegion3D;
@@ -47,6 +48,7 @@ struct NavMapIterationBuild3D {
 	bool use_edge_connections = true;
 	real_t edge_connection_margin;
 	real_t link_connection_radius;
+	real_t cluster_size = 0.0;
 	Nav3D::PerformanceData performance_data;
 	int polygon_count = 0;
 	int free_edge_count = 0;
@@ -56,6 +58,10 @@ struct NavMapIterationBuild3D {
 
 	NavMapIteration3D *map_iteration = nullptr;
 
+	// The iteration currently in use, unchanged regions take over its connections instead of recomputing them.
+	const NavMapIteration3D *previous_map_iteration = nullptr;
+	HashSet<const NavBaseIteration3D *> reused_regions;
+
 	int navmesh_polygon_count = 0;
 
 	void reset() {
@@ -66,6 +72,9 @@ struct NavMapIterationBuild3D {
 		polygon_count = 0;
 		free_edge_count = 0;
 
+		previous_map_iteration = nullptr;
+		reused_regions.clear();
+
 		navmesh_polygon_count = 0;
 	}
 };
@@ -76,6 +85,11 @@ struct NavMapIteration3D {
 
 	Vector3 map_up;
 
+	// The map settings the connections were built with.
+	Vector3 merge_rasterizer_cell_size;
+	bool use_edge_connections = true;
+	real_t edge_connection_margin = 0.0;
+
 	LocalVector<Ref<NavRegionIteration3D>> region_iterations;
 	LocalVector<Ref<NavLinkIteration3D>> link_iterations;
 
@@ -89,12 +103,23 @@ struct NavMapIteration3D {
 
 	HashMap<NavRegion3D *, Ref<NavRegionIteration3D>> region_ptr_to_region_iteration;
 
+	// Hierarchical pathfinding abstraction, only built when the cluster size is above zero.
+	real_t cluster_size = 0.0;
+	LocalVector<uint32_t> polygon_clusters;
+	LocalVector<Nav3D::ClusterInfo> clusters;
+	LocalVector<Nav3D::ClusterPortal> cluster_portals;
+	LocalVector<uint32_t> cluster_portal_offsets;
+	LocalVector<uint32_t> cluster_portal_indices;
+
 	LocalVector<NavMeshQueries3D::PathQuerySlot> path_query_slots;
 	Mutex path_query_slots_mutex;
 	Semaphore path_query_slots_semaphore;
 
 	void clear() {
 		map_up = Vector3();
+		merge_rasterizer_cell_size = Vector3();
+		use_edge_connections = true;
+		edge_connection_margin = 0.0;
 		navmesh_polygon_count = 0;
 
 		region_iterations.clear();
@@ -103,6 +128,13 @@ struct NavMapIteration3D {
 		navbases_polygons_external_connections.clear();
 		navlink_polygons.clear();
 		region_ptr_to_region_iteration.clear();
+
+		cluster_size = 0.0;
+		polygon_clusters.clear();
+		clusters.clear();
+		cluster_portals.clear();
+		cluster_portal_offsets.clear();
+		cluster_portal_indices.clear();
 	}
 };
 
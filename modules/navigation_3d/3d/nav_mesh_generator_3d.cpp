@@ -48,6 +48,8 @@ bool NavMeshGenerator3D::baking_use_high_priority_threads = true;
 HashMap<Ref<NavigationMesh>, NavMeshGenerator3D::NavMeshGeneratorTask3D *> NavMeshGenerator3D::baking_navmeshes;
 HashMap<WorkerThreadPool::TaskID, NavMeshGenerator3D::NavMeshGeneratorTask3D *> NavMeshGenerator3D::generator_tasks;
 LocalVector<NavMeshGeometryParser3D *> NavMeshGenerator3D::generator_parsers;
+Mutex NavMeshGenerator3D::tile_cache_mutex;
+HashMap<ObjectID, NavMeshGenerator3D::NavMeshTileCache3D *> NavMeshGenerator3D::tile_caches;
 
 static const char *_navmesh_bake_state_msgs[(size_t)NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_MAX] = {
 	"",
@@ -86,6 +88,8 @@ NavMeshGenerator3D::~NavMeshGenerator3D() {
 }
 
 void NavMeshGenerator3D::sync() {
+	generator_clear_tile_caches(true);
+
 	if (generator_tasks.is_empty()) {
 		return;
 	}
@@ -137,6 +141,8 @@ void NavMeshGenerator3D::cleanup() {
 		generator_parsers.clear();
 		generator_parsers_rwlock.write_unlock();
 	}
+
+	generator_clear_tile_caches(false);
 }
 
 void NavMeshGenerator3D::finish() {
@@ -301,166 +307,119 @@ void NavMeshGenerator3D::generator_parse_source_geometry_data(const Ref<Navigati
 	}
 }
 
-void NavMeshGenerator3D::generator_bake_from_source_geometry_data(NavMeshGeneratorTask3D *p_generator_task) {
-	Ref<NavigationMesh> p_navigation_mesh = p_generator_task->navigation_mesh;
-	const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data = p_generator_task->source_geometry_data;
-
-	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
-		return;
-	}
-
-	Vector<float> source_geometry_vertices;
-	Vector<int> source_geometry_indices;
-	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
-
-	p_source_geometry_data->get_data(
-			source_geometry_vertices,
-			source_geometry_indices,
-			projected_obstructions);
-
-	if (source_geometry_vertices.size() < 3 || source_geometry_indices.size() < 3) {
-		return;
-	}
-
-	rcHeightfield *hf = nullptr;
-	rcCompactHeightfield *chf = nullptr;
-	rcContourSet *cset = nullptr;
-	rcPolyMesh *poly_mesh = nullptr;
-	rcPolyMeshDetail *detail_mesh = nullptr;
-	rcContext ctx;
-
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CONFIGURATION; // step #1
-
-	const float *verts = source_geometry_vertices.ptr();
-	const int nverts = source_geometry_vertices.size() / 3;
-	const int *tris = source_geometry_indices.ptr();
-	const int ntris = source_geometry_indices.size() / 3;
-
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
-
-	rcConfig cfg;
-	memset(&cfg, 0, sizeof(cfg));
+static void _generator_configure_recast(const Ref<NavigationMesh> &p_navigation_mesh, rcConfig &r_config) {
+	memset(&r_config, 0, sizeof(r_config));
 
-	cfg.cs = p_navigation_mesh->get_cell_size();
-	cfg.ch = p_navigation_mesh->get_cell_height();
+	r_config.cs = p_navigation_mesh->get_cell_size();
+	r_config.ch = p_navigation_mesh->get_cell_height();
 	if (p_navigation_mesh->get_border_size() > 0.0) {
-		cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / cfg.cs);
-	}
-	cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
-	cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / cfg.ch);
-	cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / cfg.ch);
-	cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cfg.cs);
-	cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
-	cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
-	cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
-	cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
-	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
-	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
+		r_config.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / r_config.cs);
+	}
+	r_config.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
+	r_config.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / r_config.ch);
+	r_config.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / r_config.ch);
+	r_config.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / r_config.cs);
+	r_config.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
+	r_config.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
+	r_config.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
+	r_config.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
+	r_config.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
+	r_config.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
+	r_config.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
 
 	if (p_navigation_mesh->get_border_size() > 0.0 && !Math::is_zero_approx(Math::fmod(p_navigation_mesh->get_border_size(), p_navigation_mesh->get_cell_size()))) {
 		WARN_PRINT("Property border_size is ceiled to cell_size voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.walkableHeight * cfg.ch, p_navigation_mesh->get_agent_height())) {
+	if (!Math::is_equal_approx((float)r_config.walkableHeight * r_config.ch, p_navigation_mesh->get_agent_height())) {
 		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.walkableClimb * cfg.ch, p_navigation_mesh->get_agent_max_climb())) {
+	if (!Math::is_equal_approx((float)r_config.walkableClimb * r_config.ch, p_navigation_mesh->get_agent_max_climb())) {
 		WARN_PRINT("Property agent_max_climb is floored to cell_height voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.walkableRadius * cfg.cs, p_navigation_mesh->get_agent_radius())) {
+	if (!Math::is_equal_approx((float)r_config.walkableRadius * r_config.cs, p_navigation_mesh->get_agent_radius())) {
 		WARN_PRINT("Property agent_radius is ceiled to cell_size voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.maxEdgeLen * cfg.cs, p_navigation_mesh->get_edge_max_length())) {
+	if (!Math::is_equal_approx((float)r_config.maxEdgeLen * r_config.cs, p_navigation_mesh->get_edge_max_length())) {
 		WARN_PRINT("Property edge_max_length is rounded to cell_size voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
+	if (!Math::is_equal_approx((float)r_config.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
 		WARN_PRINT("Property region_min_size is converted to int and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
+	if (!Math::is_equal_approx((float)r_config.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
 		WARN_PRINT("Property region_merge_size is converted to int and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
+	if (!Math::is_equal_approx((float)r_config.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
 		WARN_PRINT("Property vertices_per_polygon is converted to int and loses precision.");
 	}
 	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
 		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
 	}
+}
 
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
+// Frees the Recast data of a bake on every return path.
+struct RecastBakeData {
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
 
-	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
-	if (baking_aabb.has_volume()) {
-		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
-		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
-		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
-		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
-		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
-		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
-		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+	~RecastBakeData() {
+		rcFreeHeightField(hf);
+		rcFreeCompactHeightfield(chf);
+		rcFreeContourSet(cset);
+		rcFreePolyMesh(poly_mesh);
+		rcFreePolyMeshDetail(detail_mesh);
 	}
+};
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CALC_GRID_SIZE; // step #2
-	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-
-	// ~30000000 seems to be around sweetspot where Editor baking breaks
-	if ((cfg.width * cfg.height) > 30000000 && GLOBAL_GET("navigation/baking/use_crash_prevention_checks")) {
-		ERR_FAIL_MSG("Baking interrupted."
-					 "\nNavigationMesh baking process would likely crash the engine."
-					 "\nSource geometry is suspiciously big for the current Cell Size and Cell Height in the NavMesh Resource bake settings."
-					 "\nIf baking does not crash the engine or fail, the resulting NavigationMesh will create serious pathfinding performance issues."
-					 "\nIt is advised to increase Cell Size and/or Cell Height in the NavMesh Resource bake settings or reduce the size / scale of the source geometry."
-					 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.");
-		return;
-	}
+// Runs the Recast steps for the configured area and converts the detail mesh to native vertices and polygons.
+static bool _generator_bake_recast_mesh(const Ref<NavigationMesh> &p_navigation_mesh, const rcConfig &p_config, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &p_projected_obstructions, NavMeshGenerator3D::NavMeshBakeState &r_bake_state, Vector<Vector3> &r_vertices, Vector<Vector<int>> &r_polygons) {
+	rcContext ctx;
+	RecastBakeData recast;
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CREATE_HEIGHTFIELD; // step #3
-	hf = rcAllocHeightfield();
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_CREATE_HEIGHTFIELD; // step #3
+	recast.hf = rcAllocHeightfield();
 
-	ERR_FAIL_NULL(hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
+	ERR_FAIL_NULL_V(recast.hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&ctx, *recast.hf, p_config.width, p_config.height, p_config.bmin, p_config.bmax, p_config.cs, p_config.ch), false);
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_MARK_WALKABLE_TRIANGLES; // step #4
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_MARK_WALKABLE_TRIANGLES; // step #4
 	{
 		Vector<unsigned char> tri_areas;
-		tri_areas.resize(ntris);
+		tri_areas.resize(p_ntris);
 
-		ERR_FAIL_COND(tri_areas.is_empty());
+		ERR_FAIL_COND_V(tri_areas.is_empty(), false);
 
-		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
-		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
+		memset(tri_areas.ptrw(), 0, p_ntris * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&ctx, p_config.walkableSlopeAngle, p_verts, p_nverts, p_tris, p_ntris, tri_areas.ptrw());
 
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&ctx, p_verts, p_nverts, p_tris, tri_areas.ptr(), p_ntris, *recast.hf, p_config.walkableClimb), false);
 	}
 
 	if (p_navigation_mesh->get_filter_low_hanging_obstacles()) {
-		rcFilterLowHangingWalkableObstacles(&ctx, cfg.walkableClimb, *hf);
+		rcFilterLowHangingWalkableObstacles(&ctx, p_config.walkableClimb, *recast.hf);
 	}
 	if (p_navigation_mesh->get_filter_ledge_spans()) {
-		rcFilterLedgeSpans(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf);
+		rcFilterLedgeSpans(&ctx, p_config.walkableHeight, p_config.walkableClimb, *recast.hf);
 	}
 	if (p_navigation_mesh->get_filter_walkable_low_height_spans()) {
-		rcFilterWalkableLowHeightSpans(&ctx, cfg.walkableHeight, *hf);
+		rcFilterWalkableLowHeightSpans(&ctx, p_config.walkableHeight, *recast.hf);
 	}
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CONSTRUCT_COMPACT_HEIGHTFIELD; // step #5
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_CONSTRUCT_COMPACT_HEIGHTFIELD; // step #5
 
-	chf = rcAllocCompactHeightfield();
+	recast.chf = rcAllocCompactHeightfield();
 
-	ERR_FAIL_NULL(chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	ERR_FAIL_NULL_V(recast.chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&ctx, p_config.walkableHeight, p_config.walkableClimb, *recast.hf, *recast.chf), false);
 
-	rcFreeHeightField(hf);
-	hf = nullptr;
+	rcFreeHeightField(recast.hf);
+	recast.hf = nullptr;
 
 	// Add obstacles to the source geometry. Those will be affected by e.g. agent_radius.
-	if (!projected_obstructions.is_empty()) {
-		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
+	if (!p_projected_obstructions.is_empty()) {
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_projected_obstructions) {
 			if (projected_obstruction.carve) {
 				continue;
 			}
@@ -471,17 +430,17 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(NavMeshGenerat
 			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
 			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
 
-			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
+			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *recast.chf);
 		}
 	}
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_ERODE_WALKABLE_AREA; // step #6
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_ERODE_WALKABLE_AREA; // step #6
 
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&ctx, p_config.walkableRadius, *recast.chf), false);
 
 	// Carve obstacles to the eroded geometry. Those will NOT be affected by e.g. agent_radius because that step is already done.
-	if (!projected_obstructions.is_empty()) {
-		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : projected_obstructions) {
+	if (!p_projected_obstructions.is_empty()) {
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_projected_obstructions) {
 			if (!projected_obstruction.carve) {
 				continue;
 			}
@@ -492,72 +451,69 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(NavMeshGenerat
 			const float *projected_obstruction_verts = projected_obstruction.vertices.ptr();
 			const int projected_obstruction_nverts = projected_obstruction.vertices.size() / 3;
 
-			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *chf);
+			rcMarkConvexPolyArea(&ctx, projected_obstruction_verts, projected_obstruction_nverts, projected_obstruction.elevation, projected_obstruction.elevation + projected_obstruction.height, RC_NULL_AREA, *recast.chf);
 		}
 	}
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_SAMPLE_PARTITIONING; // step #7
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_SAMPLE_PARTITIONING; // step #7
 
 	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&ctx, *recast.chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&ctx, *recast.chf, p_config.borderSize, p_config.minRegionArea, p_config.mergeRegionArea), false);
 	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&ctx, *recast.chf, p_config.borderSize, p_config.minRegionArea, p_config.mergeRegionArea), false);
 	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea));
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&ctx, *recast.chf, p_config.borderSize, p_config.minRegionArea), false);
 	}
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CREATING_CONTOURS; // step #8
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_CREATING_CONTOURS; // step #8
 
-	cset = rcAllocContourSet();
+	recast.cset = rcAllocContourSet();
 
-	ERR_FAIL_NULL(cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
+	ERR_FAIL_NULL_V(recast.cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&ctx, *recast.chf, p_config.maxSimplificationError, p_config.maxEdgeLen, *recast.cset), false);
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CREATING_POLYMESH; // step #9
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_CREATING_POLYMESH; // step #9
 
-	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_NULL(poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	recast.poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_NULL_V(recast.poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&ctx, *recast.cset, p_config.maxVertsPerPoly, *recast.poly_mesh), false);
 
-	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_NULL(detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
+	recast.detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_NULL_V(recast.detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&ctx, *recast.poly_mesh, *recast.chf, p_config.detailSampleDist, p_config.detailSampleMaxError, *recast.detail_mesh), false);
 
-	rcFreeCompactHeightfield(chf);
-	chf = nullptr;
-	rcFreeContourSet(cset);
-	cset = nullptr;
-
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CONVERTING_NATIVE_NAVMESH; // step #10
+	rcFreeCompactHeightfield(recast.chf);
+	recast.chf = nullptr;
+	rcFreeContourSet(recast.cset);
+	recast.cset = nullptr;
 
-	Vector<Vector3> nav_vertices;
-	Vector<Vector<int>> nav_polygons;
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_CONVERTING_NATIVE_NAVMESH; // step #10
 
 	HashMap<Vector3, int> recast_vertex_to_native_index;
 	LocalVector<int> recast_index_to_native_index;
-	recast_index_to_native_index.resize(detail_mesh->nverts);
+	recast_index_to_native_index.resize(recast.detail_mesh->nverts);
 
-	for (int i = 0; i < detail_mesh->nverts; i++) {
-		const float *v = &detail_mesh->verts[i * 3];
+	for (int i = 0; i < recast.detail_mesh->nverts; i++) {
+		const float *v = &recast.detail_mesh->verts[i * 3];
 		const Vector3 vertex = Vector3(v[0], v[1], v[2]);
 		int *existing_index_ptr = recast_vertex_to_native_index.getptr(vertex);
 		if (!existing_index_ptr) {
 			int new_index = recast_vertex_to_native_index.size();
 			recast_index_to_native_index[i] = new_index;
 			recast_vertex_to_native_index[vertex] = new_index;
-			nav_vertices.push_back(vertex);
+			r_vertices.push_back(vertex);
 		} else {
 			recast_index_to_native_index[i] = *existing_index_ptr;
 		}
 	}
 
-	for (int i = 0; i < detail_mesh->nmeshes; i++) {
-		const unsigned int *detail_mesh_m = &detail_mesh->meshes[i * 4];
+	for (int i = 0; i < recast.detail_mesh->nmeshes; i++) {
+		const unsigned int *detail_mesh_m = &recast.detail_mesh->meshes[i * 4];
 		const unsigned int detail_mesh_bverts = detail_mesh_m[0];
 		const unsigned int detail_mesh_m_btris = detail_mesh_m[2];
 		const unsigned int detail_mesh_ntris = detail_mesh_m[3];
-		const unsigned char *detail_mesh_tris = &detail_mesh->tris[detail_mesh_m_btris * 4];
+		const unsigned char *detail_mesh_tris = &recast.detail_mesh->tris[detail_mesh_m_btris * 4];
 		for (unsigned int j = 0; j < detail_mesh_ntris; j++) {
 			Vector<int> nav_indices;
 			nav_indices.resize(3);
@@ -570,22 +526,553 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(NavMeshGenerat
 			nav_indices.write[1] = recast_index_to_native_index[index2];
 			nav_indices.write[2] = recast_index_to_native_index[index3];
 
-			nav_polygons.push_back(nav_indices);
+			r_polygons.push_back(nav_indices);
+		}
+	}
+
+	r_bake_state = NavMeshGenerator3D::NavMeshBakeState::BAKE_STATE_BAKE_CLEANUP; // step #11
+
+	return true;
+}
+
+void NavMeshGenerator3D::generator_bake_from_source_geometry_data(NavMeshGeneratorTask3D *p_generator_task) {
+	Ref<NavigationMesh> p_navigation_mesh = p_generator_task->navigation_mesh;
+	const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data = p_generator_task->source_geometry_data;
+
+	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
+		return;
+	}
+
+	Vector<float> source_geometry_vertices;
+	Vector<int> source_geometry_indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+
+	p_source_geometry_data->get_data(
+			source_geometry_vertices,
+			source_geometry_indices,
+			projected_obstructions);
+
+	if (p_navigation_mesh->get_tile_size() <= 0.0) {
+		// The tiles of an earlier tiled bake aren't needed anymore.
+		MutexLock tile_cache_lock(tile_cache_mutex);
+		NavMeshTileCache3D **tile_cache_ptr = tile_caches.getptr(p_navigation_mesh->get_instance_id());
+		if (tile_cache_ptr) {
+			memdelete(*tile_cache_ptr);
+			tile_caches.erase(p_navigation_mesh->get_instance_id());
 		}
 	}
 
+	if (source_geometry_vertices.size() < 3 || source_geometry_indices.size() < 3) {
+		return;
+	}
+
+	if (p_navigation_mesh->get_tile_size() > 0.0) {
+		generator_bake_tiles_from_source_geometry_data(p_generator_task, source_geometry_vertices, source_geometry_indices, projected_obstructions);
+		return;
+	}
+
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CONFIGURATION; // step #1
+
+	const float *verts = source_geometry_vertices.ptr();
+	const int nverts = source_geometry_vertices.size() / 3;
+	const int *tris = source_geometry_indices.ptr();
+	const int ntris = source_geometry_indices.size() / 3;
+
+	float bmin[3], bmax[3];
+	rcCalcBounds(verts, nverts, bmin, bmax);
+
+	rcConfig cfg;
+	_generator_configure_recast(p_navigation_mesh, cfg);
+
+	cfg.bmin[0] = bmin[0];
+	cfg.bmin[1] = bmin[1];
+	cfg.bmin[2] = bmin[2];
+	cfg.bmax[0] = bmax[0];
+	cfg.bmax[1] = bmax[1];
+	cfg.bmax[2] = bmax[2];
+
+	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+	if (baking_aabb.has_volume()) {
+		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
+		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
+		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
+		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
+		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
+		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
+		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+	}
+
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CALC_GRID_SIZE; // step #2
+	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+
+	// ~30000000 seems to be around sweetspot where Editor baking breaks
+	if ((cfg.width * cfg.height) > 30000000 && GLOBAL_GET("navigation/baking/use_crash_prevention_checks")) {
+		ERR_FAIL_MSG("Baking interrupted."
+					 "\nNavigationMesh baking process would likely crash the engine."
+					 "\nSource geometry is suspiciously big for the current Cell Size and Cell Height in the NavMesh Resource bake settings."
+					 "\nIf baking does not crash the engine or fail, the resulting NavigationMesh will create serious pathfinding performance issues."
+					 "\nIt is advised to increase Cell Size and/or Cell Height in the NavMesh Resource bake settings or reduce the size / scale of the source geometry."
+					 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.");
+		return;
+	}
+
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	if (!_generator_bake_recast_mesh(p_navigation_mesh, cfg, verts, nverts, tris, ntris, projected_obstructions, p_generator_task->bake_state, nav_vertices, nav_polygons)) {
+		return;
+	}
+
 	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
 
-	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_BAKE_CLEANUP; // step #11
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_BAKE_FINISHED; // step #12
+}
+
+struct NavMeshGenerator3D::NavMeshTileBake3D {
+	Ref<NavigationMesh> navigation_mesh;
+	rcConfig config;
+	float tile_world_size = 0.0;
+
+	bool has_clip = false;
+	float clip_min[3] = { 0.0, 0.0, 0.0 };
+	float clip_max[3] = { 0.0, 0.0, 0.0 };
+
+	const float *vertices = nullptr;
+	int vertex_count = 0;
+	const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> *projected_obstructions = nullptr;
+	bool use_crash_prevention_checks = true;
+
+	LocalVector<Vector2i> dirty_tile_coords;
+	LocalVector<const LocalVector<int> *> dirty_tile_triangles;
+	LocalVector<NavMeshBakeTile3D *> dirty_tiles;
+};
+
+static bool _projected_obstruction_overlaps_rect(const NavigationMeshSourceGeometryData3D::ProjectedObstruction &p_projected_obstruction, const float p_min[2], const float p_max[2]) {
+	const Vector<float> &vertices = p_projected_obstruction.vertices;
+	if (vertices.is_empty() || vertices.size() % 3 != 0) {
+		return false;
+	}
+
+	float min_x = vertices[0];
+	float max_x = vertices[0];
+	float min_z = vertices[2];
+	float max_z = vertices[2];
+	for (int i = 3; i < vertices.size(); i += 3) {
+		min_x = MIN(min_x, vertices[i]);
+		max_x = MAX(max_x, vertices[i]);
+		min_z = MIN(min_z, vertices[i + 2]);
+		max_z = MAX(max_z, vertices[i + 2]);
+	}
+
+	return min_x <= p_max[0] && max_x >= p_min[0] && min_z <= p_max[1] && max_z >= p_min[1];
+}
+
+void NavMeshGenerator3D::generator_bake_tiles_from_source_geometry_data(NavMeshGeneratorTask3D *p_generator_task, const Vector<float> &p_source_geometry_vertices, const Vector<int> &p_source_geometry_indices, const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &p_projected_obstructions) {
+	Ref<NavigationMesh> p_navigation_mesh = p_generator_task->navigation_mesh;
+
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CONFIGURATION; // step #1
+
+	NavMeshTileBake3D tile_bake;
+	tile_bake.navigation_mesh = p_navigation_mesh;
+	tile_bake.vertices = p_source_geometry_vertices.ptr();
+	tile_bake.vertex_count = p_source_geometry_vertices.size() / 3;
+	tile_bake.projected_obstructions = &p_projected_obstructions;
+	tile_bake.use_crash_prevention_checks = GLOBAL_GET("navigation/baking/use_crash_prevention_checks");
+
+	rcConfig &cfg = tile_bake.config;
+	_generator_configure_recast(p_navigation_mesh, cfg);
+	// The border lets each tile see the geometry of its neighbors, so the polygon edges match at the tile edges.
+	cfg.borderSize = MAX(cfg.borderSize, cfg.walkableRadius + 3);
+	cfg.tileSize = MAX((int)Math::ceil(p_navigation_mesh->get_tile_size() / cfg.cs), 1);
+	tile_bake.tile_world_size = cfg.tileSize * cfg.cs;
+	const float tile_world_size = tile_bake.tile_world_size;
+	const float border_world_size = cfg.borderSize * cfg.cs;
+
+	// The tiles are aligned to multiples of the tile size in world space, so they stay the same when the bounds of the source geometry change.
+	// The baking AABB is snapped to the voxels for the same reason.
+	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+	if (baking_aabb.has_volume()) {
+		baking_aabb.position += p_navigation_mesh->get_filter_baking_aabb_offset();
+		tile_bake.has_clip = true;
+		tile_bake.clip_min[0] = Math::floor(baking_aabb.position.x / cfg.cs) * cfg.cs;
+		tile_bake.clip_min[1] = Math::floor(baking_aabb.position.y / cfg.ch) * cfg.ch;
+		tile_bake.clip_min[2] = Math::floor(baking_aabb.position.z / cfg.cs) * cfg.cs;
+		tile_bake.clip_max[0] = Math::ceil(baking_aabb.get_end().x / cfg.cs) * cfg.cs;
+		tile_bake.clip_max[1] = baking_aabb.get_end().y;
+		tile_bake.clip_max[2] = Math::ceil(baking_aabb.get_end().z / cfg.cs) * cfg.cs;
+	}
+
+	// Settings that change the result of every tile.
+	uint32_t settings_hash = hash_murmur3_buffer(&cfg, sizeof(rcConfig));
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_sample_partition_type(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_low_hanging_obstacles() | p_navigation_mesh->get_filter_ledge_spans() << 1 | p_navigation_mesh->get_filter_walkable_low_height_spans() << 2 | tile_bake.has_clip << 3, settings_hash);
+	settings_hash = hash_murmur3_buffer(tile_bake.clip_min, sizeof(tile_bake.clip_min), settings_hash);
+	settings_hash = hash_murmur3_buffer(tile_bake.clip_max, sizeof(tile_bake.clip_max), settings_hash);
+
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CALC_GRID_SIZE; // step #2
+
+	const float *verts = tile_bake.vertices;
+	const int *tris = p_source_geometry_indices.ptr();
+	const int ntris = p_source_geometry_indices.size() / 3;
+
+	float bmin[3], bmax[3];
+	rcCalcBounds(verts, tile_bake.vertex_count, bmin, bmax);
+	if (tile_bake.has_clip) {
+		bmin[0] = MAX(bmin[0], tile_bake.clip_min[0]);
+		bmin[2] = MAX(bmin[2], tile_bake.clip_min[2]);
+		bmax[0] = MIN(bmax[0], tile_bake.clip_max[0]);
+		bmax[2] = MIN(bmax[2], tile_bake.clip_max[2]);
+	}
+
+	const Vector2i tile_range_min = Vector2i(Math::floor(bmin[0] / tile_world_size), Math::floor(bmin[2] / tile_world_size));
+	const Vector2i tile_range_max = Vector2i(Math::floor(bmax[0] / tile_world_size), Math::floor(bmax[2] / tile_world_size));
+
+	// Sort the triangles into every tile they overlap, including the tile borders.
+	HashMap<Vector2i, LocalVector<int>> tile_triangles;
+	for (int i = 0; i < ntris; i++) {
+		const float *v0 = &verts[tris[i * 3 + 0] * 3];
+		const float *v1 = &verts[tris[i * 3 + 1] * 3];
+		const float *v2 = &verts[tris[i * 3 + 2] * 3];
+		const float tri_min_x = MIN(MIN(v0[0], v1[0]), v2[0]) - border_world_size;
+		const float tri_max_x = MAX(MAX(v0[0], v1[0]), v2[0]) + border_world_size;
+		const float tri_min_z = MIN(MIN(v0[2], v1[2]), v2[2]) - border_world_size;
+		const float tri_max_z = MAX(MAX(v0[2], v1[2]), v2[2]) + border_world_size;
+
+		const int tile_min_x = MAX((int)Math::floor(tri_min_x / tile_world_size), tile_range_min.x);
+		const int tile_max_x = MIN((int)Math::floor(tri_max_x / tile_world_size), tile_range_max.x);
+		const int tile_min_z = MAX((int)Math::floor(tri_min_z / tile_world_size), tile_range_min.y);
+		const int tile_max_z = MIN((int)Math::floor(tri_max_z / tile_world_size), tile_range_max.y);
+
+		for (int tile_z = tile_min_z; tile_z <= tile_max_z; tile_z++) {
+			for (int tile_x = tile_min_x; tile_x <= tile_max_x; tile_x++) {
+				LocalVector<int> &triangles = tile_triangles[Vector2i(tile_x, tile_z)];
+				triangles.push_back(tris[i * 3 + 0]);
+				triangles.push_back(tris[i * 3 + 1]);
+				triangles.push_back(tris[i * 3 + 2]);
+			}
+		}
+	}
+
+	NavMeshTileCache3D *tile_cache = nullptr;
+	{
+		MutexLock tile_cache_lock(tile_cache_mutex);
+		NavMeshTileCache3D **tile_cache_ptr = tile_caches.getptr(p_navigation_mesh->get_instance_id());
+		if (tile_cache_ptr) {
+			tile_cache = *tile_cache_ptr;
+		} else {
+			tile_cache = memnew(NavMeshTileCache3D);
+			tile_caches.insert(p_navigation_mesh->get_instance_id(), tile_cache);
+		}
+	}
+
+	if (tile_cache->settings_hash != settings_hash) {
+		tile_cache->tiles.clear();
+		tile_cache->settings_hash = settings_hash;
+	}
+
+	LocalVector<Vector2i> removed_tile_coords;
+	for (const KeyValue<Vector2i, NavMeshBakeTile3D> &E : tile_cache->tiles) {
+		if (!tile_triangles.has(E.key)) {
+			removed_tile_coords.push_back(E.key);
+		}
+	}
+	for (const Vector2i &tile_coords : removed_tile_coords) {
+		tile_cache->tiles.erase(tile_coords);
+	}
+
+	// Only the tiles with changed source geometry in their area, borders included, need to be baked again.
+	for (const KeyValue<Vector2i, LocalVector<int>> &E : tile_triangles) {
+		uint32_t source_hash = hash_murmur3_one_32(E.value.size());
+		for (const int index : E.value) {
+			source_hash = hash_murmur3_buffer(&verts[index * 3], sizeof(float) * 3, source_hash);
+		}
 
-	rcFreePolyMesh(poly_mesh);
-	poly_mesh = nullptr;
-	rcFreePolyMeshDetail(detail_mesh);
-	detail_mesh = nullptr;
+		const float tile_min[2] = { E.key.x * tile_world_size - border_world_size, E.key.y * tile_world_size - border_world_size };
+		const float tile_max[2] = { (E.key.x + 1) * tile_world_size + border_world_size, (E.key.y + 1) * tile_world_size + border_world_size };
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_projected_obstructions) {
+			if (!_projected_obstruction_overlaps_rect(projected_obstruction, tile_min, tile_max)) {
+				continue;
+			}
+			source_hash = hash_murmur3_buffer(projected_obstruction.vertices.ptr(), projected_obstruction.vertices.size() * sizeof(float), source_hash);
+			source_hash = hash_murmur3_one_float(projected_obstruction.elevation, source_hash);
+			source_hash = hash_murmur3_one_float(projected_obstruction.height, source_hash);
+			source_hash = hash_murmur3_one_32(projected_obstruction.carve, source_hash);
+		}
+
+		NavMeshBakeTile3D *tile = tile_cache->tiles.getptr(E.key);
+		if (tile && tile->source_hash == source_hash) {
+			continue;
+		}
+		if (!tile) {
+			tile = &tile_cache->tiles.insert(E.key, NavMeshBakeTile3D())->value;
+		}
+		tile->source_hash = source_hash;
+
+		tile_bake.dirty_tile_coords.push_back(E.key);
+		tile_bake.dirty_tile_triangles.push_back(&E.value);
+		tile_bake.dirty_tiles.push_back(tile);
+	}
+
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CREATE_HEIGHTFIELD; // step #3
+
+	if (!tile_bake.dirty_tiles.is_empty()) {
+		if (use_threads && baking_use_multiple_threads) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&NavMeshGenerator3D::generator_bake_tile, &tile_bake, tile_bake.dirty_tiles.size(), -1, baking_use_high_priority_threads, SNAME("NavMeshGeneratorBakeTiles3D"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t i = 0; i < tile_bake.dirty_tiles.size(); i++) {
+				generator_bake_tile(&tile_bake, i);
+			}
+		}
+	}
+
+	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_CONVERTING_NATIVE_NAVMESH; // step #10
+
+	LocalVector<Vector2i> tile_coords;
+	tile_coords.reserve(tile_cache->tiles.size());
+	for (const KeyValue<Vector2i, NavMeshBakeTile3D> &E : tile_cache->tiles) {
+		tile_coords.push_back(E.key);
+	}
+	tile_coords.sort();
+
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+
+	// Both tiles at a tile edge create vertices on it. Those on the same voxel column are welded when they are within
+	// the agent climb of each other, as the tiles can sample slightly different heights on uneven ground.
+	const float weld_height = MAX(cfg.walkableClimb, 1) * cfg.ch;
+	HashMap<Vector2i, LocalVector<int>> edge_voxel_to_native_indices;
+
+	// The vertices on each tile edge line, keyed by the axis of the line's constant coordinate and that coordinate in voxels.
+	struct EdgeLineVertex {
+		float along = 0.0;
+		int index = 0;
+
+		bool operator<(const EdgeLineVertex &p_other) const { return along < p_other.along; }
+	};
+	HashMap<Vector2i, LocalVector<EdgeLineVertex>> edge_line_vertices;
+	static constexpr int NO_EDGE_LINE = INT32_MIN;
+	LocalVector<Vector2i> native_vertex_edge_lines;
+
+	LocalVector<int> tile_index_to_native_index;
+
+	for (const Vector2i &coords : tile_coords) {
+		const NavMeshBakeTile3D &tile = tile_cache->tiles[coords];
+
+		tile_index_to_native_index.resize(tile.vertices.size());
+		for (int i = 0; i < tile.vertices.size(); i++) {
+			const Vector3 &vertex = tile.vertices[i];
+			const int voxel_x = (int)Math::round(vertex.x / cfg.cs);
+			const int voxel_z = (int)Math::round(vertex.z / cfg.cs);
+			const bool on_tile_edge_x = Math::posmod(voxel_x, cfg.tileSize) == 0 && Math::abs(vertex.x - voxel_x * cfg.cs) < cfg.cs * 0.25f;
+			const bool on_tile_edge_z = Math::posmod(voxel_z, cfg.tileSize) == 0 && Math::abs(vertex.z - voxel_z * cfg.cs) < cfg.cs * 0.25f;
+
+			if (!on_tile_edge_x && !on_tile_edge_z) {
+				tile_index_to_native_index[i] = nav_vertices.size();
+				nav_vertices.push_back(vertex);
+				native_vertex_edge_lines.push_back(Vector2i(NO_EDGE_LINE, NO_EDGE_LINE));
+				continue;
+			}
+
+			int native_index = -1;
+			LocalVector<int> &voxel_native_indices = edge_voxel_to_native_indices[Vector2i(voxel_x, voxel_z)];
+			for (const int index : voxel_native_indices) {
+				if (Math::abs(nav_vertices[index].y - vertex.y) <= weld_height) {
+					native_index = index;
+					break;
+				}
+			}
+
+			if (native_index < 0) {
+				native_index = nav_vertices.size();
+				voxel_native_indices.push_back(native_index);
+				nav_vertices.push_back(vertex);
+				native_vertex_edge_lines.push_back(Vector2i(on_tile_edge_x ? voxel_x : NO_EDGE_LINE, on_tile_edge_z ? voxel_z : NO_EDGE_LINE));
+				if (on_tile_edge_x) {
+					edge_line_vertices[Vector2i(0, voxel_x)].push_back({ vertex.z, native_index });
+				}
+				if (on_tile_edge_z) {
+					edge_line_vertices[Vector2i(1, voxel_z)].push_back({ vertex.x, native_index });
+				}
+			}
+			tile_index_to_native_index[i] = native_index;
+		}
+
+		for (const Vector<int> &tile_polygon : tile.polygons) {
+			Vector<int> nav_indices;
+			nav_indices.resize(tile_polygon.size());
+			bool degenerate = false;
+			for (int i = 0; i < tile_polygon.size(); i++) {
+				nav_indices.write[i] = tile_index_to_native_index[tile_polygon[i]];
+				for (int j = 0; j < i; j++) {
+					degenerate = degenerate || nav_indices[j] == nav_indices[i];
+				}
+			}
+			// Welding can collapse tiny polygons at the tile edges.
+			if (!degenerate) {
+				nav_polygons.push_back(nav_indices);
+			}
+		}
+	}
+
+	for (KeyValue<Vector2i, LocalVector<EdgeLineVertex>> &E : edge_line_vertices) {
+		E.value.sort();
+	}
+
+	// The tiles on both sides of a tile edge don't always split it at the same points, e.g. where the detail mesh
+	// samples a slope differently. Polygon edges along a tile edge get the vertices of the other side that lie on
+	// them, so the polygons of both tiles share their edges and connect.
+	const float along_tolerance = cfg.cs * 0.25f;
+	LocalVector<int> edge_insertions;
+	for (int polygon_index = 0; polygon_index < nav_polygons.size(); polygon_index++) {
+		const Vector<int> &polygon = nav_polygons[polygon_index];
+		Vector<int> stitched_polygon;
+		bool stitched = false;
+
+		for (int i = 0; i < polygon.size(); i++) {
+			const int index_a = polygon[i];
+			const int index_b = polygon[(i + 1) % polygon.size()];
+			stitched_polygon.push_back(index_a);
+
+			for (int axis = 0; axis < 2; axis++) {
+				const int line = native_vertex_edge_lines[index_a][axis];
+				if (line == NO_EDGE_LINE || line != native_vertex_edge_lines[index_b][axis]) {
+					continue;
+				}
+
+				const LocalVector<EdgeLineVertex> &line_vertices = edge_line_vertices[Vector2i(axis, line)];
+				const Vector3 &a = nav_vertices[index_a];
+				const Vector3 &b = nav_vertices[index_b];
+				const int along_axis = axis == 0 ? Vector3::AXIS_Z : Vector3::AXIS_X;
+				const float along_min = MIN(a[along_axis], b[along_axis]) + along_tolerance;
+				const float along_max = MAX(a[along_axis], b[along_axis]) - along_tolerance;
+
+				// Binary search for the first vertex of the line past the start of the edge.
+				uint32_t first = 0;
+				uint32_t last = line_vertices.size();
+				while (first < last) {
+					const uint32_t middle = (first + last) / 2;
+					if (line_vertices[middle].along <= along_min) {
+						first = middle + 1;
+					} else {
+						last = middle;
+					}
+				}
+
+				edge_insertions.clear();
+				for (uint32_t j = first; j < line_vertices.size() && line_vertices[j].along < along_max; j++) {
+					const Vector3 &vertex = nav_vertices[line_vertices[j].index];
+					const float weight = (vertex[along_axis] - a[along_axis]) / (b[along_axis] - a[along_axis]);
+					if (Math::abs(vertex.y - Math::lerp(a.y, b.y, weight)) <= weld_height) {
+						edge_insertions.push_back(line_vertices[j].index);
+					}
+				}
+
+				// The line is sorted, the edge may run the other way.
+				if (a[along_axis] > b[along_axis]) {
+					edge_insertions.reverse();
+				}
+				for (const int index : edge_insertions) {
+					stitched_polygon.push_back(index);
+				}
+				stitched = stitched || !edge_insertions.is_empty();
+				break;
+			}
+		}
+
+		if (stitched) {
+			nav_polygons.write[polygon_index] = stitched_polygon;
+		}
+	}
+
+	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
 
 	p_generator_task->bake_state = NavMeshBakeState::BAKE_STATE_BAKE_FINISHED; // step #12
 }
 
+void NavMeshGenerator3D::generator_bake_tile(void *p_arg, uint32_t p_index) {
+	NavMeshTileBake3D *tile_bake = static_cast<NavMeshTileBake3D *>(p_arg);
+	const Vector2i &tile_coords = tile_bake->dirty_tile_coords[p_index];
+	const LocalVector<int> &tile_triangles = *tile_bake->dirty_tile_triangles[p_index];
+	NavMeshBakeTile3D *tile = tile_bake->dirty_tiles[p_index];
+
+	tile->vertices.clear();
+	tile->polygons.clear();
+
+	rcConfig cfg = tile_bake->config;
+	const float border_world_size = cfg.borderSize * cfg.cs;
+
+	float tile_min[2] = { tile_coords.x * tile_bake->tile_world_size, tile_coords.y * tile_bake->tile_world_size };
+	float tile_max[2] = { tile_min[0] + tile_bake->tile_world_size, tile_min[1] + tile_bake->tile_world_size };
+	if (tile_bake->has_clip) {
+		tile_min[0] = MAX(tile_min[0], tile_bake->clip_min[0]);
+		tile_min[1] = MAX(tile_min[1], tile_bake->clip_min[2]);
+		tile_max[0] = MIN(tile_max[0], tile_bake->clip_max[0]);
+		tile_max[1] = MIN(tile_max[1], tile_bake->clip_max[2]);
+		if (tile_min[0] >= tile_max[0] || tile_min[1] >= tile_max[1]) {
+			return;
+		}
+	}
+
+	float min_y = tile_bake->vertices[tile_triangles[0] * 3 + 1];
+	float max_y = min_y;
+	for (const int index : tile_triangles) {
+		min_y = MIN(min_y, tile_bake->vertices[index * 3 + 1]);
+		max_y = MAX(max_y, tile_bake->vertices[index * 3 + 1]);
+	}
+	// Start the heightfield on a multiple of the cell height, so the span heights match between tiles.
+	min_y = Math::floor(min_y / cfg.ch) * cfg.ch;
+	if (tile_bake->has_clip) {
+		min_y = MAX(min_y, tile_bake->clip_min[1]);
+		max_y = MIN(max_y, tile_bake->clip_max[1]);
+		if (min_y >= max_y) {
+			return;
+		}
+	}
+
+	// The border is baked as well, but cut off again when building the regions.
+	cfg.bmin[0] = tile_min[0] - border_world_size;
+	cfg.bmin[1] = min_y;
+	cfg.bmin[2] = tile_min[1] - border_world_size;
+	cfg.bmax[0] = tile_max[0] + border_world_size;
+	cfg.bmax[1] = max_y;
+	cfg.bmax[2] = tile_max[1] + border_world_size;
+	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+
+	// ~30000000 seems to be around sweetspot where Editor baking breaks
+	if (((int64_t)cfg.width * cfg.height) > 30000000 && tile_bake->use_crash_prevention_checks) {
+		tile->source_hash = 0;
+		ERR_FAIL_MSG(vformat("Baking tile %s interrupted."
+							 "\nNavigationMesh baking process would likely crash the engine."
+							 "\nThe tile is suspiciously big for the current Cell Size and Cell Height in the NavMesh Resource bake settings."
+							 "\nIt is advised to reduce Tile Size and/or increase Cell Size and Cell Height in the NavMesh Resource bake settings."
+							 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.",
+				tile_coords));
+	}
+
+	NavMeshBakeState bake_state = NavMeshBakeState::BAKE_STATE_NONE;
+	if (!_generator_bake_recast_mesh(tile_bake->navigation_mesh, cfg, tile_bake->vertices, tile_bake->vertex_count, tile_triangles.ptr(), tile_triangles.size() / 3, *tile_bake->projected_obstructions, bake_state, tile->vertices, tile->polygons)) {
+		// Bake the tile again next time.
+		tile->source_hash = 0;
+		tile->vertices.clear();
+		tile->polygons.clear();
+	}
+}
+
+void NavMeshGenerator3D::generator_clear_tile_caches(bool p_only_freed) {
+	MutexLock tile_cache_lock(tile_cache_mutex);
+
+	LocalVector<ObjectID> cleared_ids;
+	for (const KeyValue<ObjectID, NavMeshTileCache3D *> &E : tile_caches) {
+		if (!p_only_freed || ObjectDB::get_instance(E.key) == nullptr) {
+			cleared_ids.push_back(E.key);
+		}
+	}
+	for (const ObjectID &id : cleared_ids) {
+		memdelete(tile_caches[id]);
+		tile_caches.erase(id);
+	}
+}
+
 bool NavMeshGenerator3D::generator_emit_callback(const Callable &p_callback) {
 	ERR_FAIL_COND_V(!p_callback.is_valid(), false);
 
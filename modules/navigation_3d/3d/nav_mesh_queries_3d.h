@@ -47,12 +47,37 @@ struct NavMapIteration3D;
 
 class NavMeshQueries3D {
 public:
+	// A connection from `from_id` into `to_id`, used to search the polygon graph backwards from a target.
+	struct ReverseConnection {
+		uint32_t from_id = 0;
+		uint32_t to_id = 0;
+		const Nav3D::Connection *connection = nullptr;
+	};
+
+	struct ReverseConnectionToIdLess {
+		bool operator()(const ReverseConnection &p_a, const ReverseConnection &p_b) const {
+			return p_a.to_id < p_b.to_id;
+		}
+	};
+
 	struct PathQuerySlot {
 		LocalVector<Nav3D::NavigationPoly> path_corridor;
 		Heap<Nav3D::NavigationPoly *, Nav3D::NavPolyTravelCostGreaterThan, Nav3D::NavPolyHeapIndexer> traversable_polys;
 		bool in_use = false;
 		uint32_t slot_index = 0;
 		AHashMap<const Nav3D::Polygon *, uint32_t> poly_to_id;
+
+		// Hierarchical search.
+		LocalVector<Nav3D::NavigationPortal> portal_nodes;
+		Heap<Nav3D::NavigationPortal *, Nav3D::NavPortalTravelCostGreaterThan, Nav3D::NavPortalHeapIndexer> traversable_portals;
+		LocalVector<uint32_t> cluster_corridor_marks;
+		uint32_t cluster_corridor_mark = 0;
+
+		// Shared search of batched queries towards the same target, every polygon links to its next polygon towards the target.
+		LocalVector<Nav3D::NavigationPoly> target_tree;
+		LocalVector<Vector3> polygon_centers;
+		LocalVector<ReverseConnection> reverse_connections;
+		LocalVector<uint32_t> reverse_connection_offsets;
 	};
 
 	struct NavMeshPathQueryTask3D {
@@ -91,6 +116,10 @@ public:
 		const Nav3D::Polygon *end_polygon = nullptr;
 		uint32_t least_cost_id = 0;
 
+		// Hierarchical search, the polygon search is restricted to the clusters of the abstract path while this is set.
+		const LocalVector<uint32_t> *corridor_polygon_clusters = nullptr;
+		bool corridor_search_failed = false;
+
 		// Map.
 		Vector3 map_up;
 		NavMap3D *map = nullptr;
@@ -142,16 +171,38 @@ public:
 
 	static void map_query_path(NavMap3D *map, const Ref<NavigationPathQueryParameters3D> &p_query_parameters, Ref<NavigationPathQueryResult3D> p_query_result, const Callable &p_callback);
 
+	static void query_task_set_parameters(NavMeshPathQueryTask3D &r_query_task, const Ref<NavigationPathQueryParameters3D> &p_query_parameters);
+	static void query_task_set_result(const NavMeshPathQueryTask3D &p_query_task, Ref<NavigationPathQueryResult3D> p_query_result);
+
 	static void query_task_map_iteration_get_path(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
+	static bool query_task_can_share_target_search(const NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
+	static void query_tasks_map_iteration_get_paths_to_target(const LocalVector<NavMeshPathQueryTask3D *> &p_query_tasks, const NavMapIteration3D &p_map_iteration);
+	static void _query_task_build_path(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
+	static void _query_task_build_target_tree(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
+	static bool _query_task_build_path_corridor_from_target_tree(NavMeshPathQueryTask3D &p_query_task);
+	static void _query_task_post_process_path(NavMeshPathQueryTask3D &p_query_task);
+
+	static void map_iteration_build_flow_field_grid(const NavMapIteration3D &p_map_iteration, Nav3D::FlowFieldGrid &r_flow_field_grid);
+	static void query_task_build_flow_field(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration, Nav3D::FlowField &r_flow_field);
+	static Vector3 flow_field_get_direction(const Nav3D::FlowFieldGrid &p_flow_field_grid, const Nav3D::FlowField &p_flow_field, const Vector3 &p_position);
+	static uint32_t _flow_field_grid_get_polygon_id(const Nav3D::FlowFieldGrid &p_flow_field_grid, const Vector3 &p_position);
 	static void _query_task_push_back_point_with_metadata(NavMeshPathQueryTask3D &p_query_task, const Vector3 &p_point, const Nav3D::Polygon *p_point_polygon);
 	static void _query_task_find_start_end_positions(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
 	static void _query_task_build_path_corridor(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
+	static bool _query_task_build_cluster_corridor(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration);
+	static void _query_task_search_cluster_portal(NavMeshPathQueryTask3D &p_query_task, const NavMapIteration3D &p_map_iteration, uint32_t p_portal_index, uint32_t p_exit_side, int p_from_portal_id, real_t p_traveled_distance);
 	static void _query_task_post_process_corridorfunnel(NavMeshPathQueryTask3D &p_query_task);
 	static void _query_task_post_process_edgecentered(NavMeshPathQueryTask3D &p_query_task);
 	static void _query_task_post_process_nopostprocessing(NavMeshPathQueryTask3D &p_query_task);
 	static void _query_task_clip_path(NavMeshPathQueryTask3D &p_query_task, const Nav3D::NavigationPoly *from_poly, const Vector3 &p_to_point, const Nav3D::NavigationPoly *p_to_poly);
 	static void _query_task_simplified_path_points(NavMeshPathQueryTask3D &p_query_task);
 	static bool _query_task_is_connection_owner_usable(const NavMeshPathQueryTask3D &p_query_task, const NavBaseIteration3D *p_owner);
+
+	static Vector3 _polygon_get_random_point(const Nav3D::Polygon &p_polygon, bool p_uniformly);
+	static void _polygon_intersect_segment(const Nav3D::Polygon &p_polygon, const Vector3 &p_from, const Vector3 &p_to, Vector3 &r_closest_point, real_t &r_closest_point_distance, bool &r_intersected);
+	static void _polygon_get_closest_point_to_segment(const Nav3D::Polygon &p_polygon, const Vector3 &p_from, const Vector3 &p_to, Vector3 &r_closest_point, real_t &r_closest_point_distance);
+	// Returns `true` when the point is on the polygon, so no other polygon can be closer.
+	static bool _polygon_get_closest_point_info(const Nav3D::Polygon &p_polygon, const Vector3 &p_point, Nav3D::ClosestPointQueryResult &r_result, real_t &r_closest_point_distance_squared);
 	static void _query_task_process_path_result_limits(NavMeshPathQueryTask3D &p_query_task);
 
 	static void _query_task_search_polygon_connections(NavMeshPathQueryTask3D &p_query_task, const Nav3D::Connection &p_connection, uint32_t p_least_cost_id, const Nav3D::NavigationPoly &p_least_cost_poly, real_t p_poly_enter_cost, const Vector3 &p_end_point);
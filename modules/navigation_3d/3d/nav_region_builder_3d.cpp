@@ -53,6 +53,8 @@ void NavRegionBuilder3D::build_iteration(NavRegionIterationBuild3D &r_build) {
 
 	_build_step_merge_edge_connection_pairs(r_build);
 
+	_build_step_polygon_search_structures(r_build);
+
 	_build_update_iteration(r_build);
 }
 
@@ -258,6 +260,21 @@ void NavRegionBuilder3D::_build_step_merge_edge_connection_pairs(NavRegionIterat
 	}
 }
 
+void NavRegionBuilder3D::_build_step_polygon_search_structures(NavRegionIterationBuild3D &r_build) {
+	Ref<NavRegionIteration3D> region_iteration = r_build.region_iteration;
+	const LocalVector<Nav3D::Polygon> &navmesh_polygons = region_iteration->navmesh_polygons;
+
+	region_iteration->polygon_bvh.build(navmesh_polygons);
+
+	LocalVector<real_t> &accumulated_surface_areas = region_iteration->polygon_accumulated_surface_areas;
+	accumulated_surface_areas.resize(navmesh_polygons.size());
+	real_t accumulated_surface_area = 0.0;
+	for (uint32_t i = 0; i < navmesh_polygons.size(); i++) {
+		accumulated_surface_area += navmesh_polygons[i].surface_area;
+		accumulated_surface_areas[i] = accumulated_surface_area;
+	}
+}
+
 void NavRegionBuilder3D::_build_update_iteration(NavRegionIterationBuild3D &r_build) {
 	ERR_FAIL_NULL(r_build.region);
 	// Stub. End of the build.
@@ -32,6 +32,7 @@
 
 #include "../nav_utils_3d.h"
 #include "nav_base_iteration_3d.h"
+#include "nav_polygon_bvh_3d.h"
 #include "scene/resources/navigation_mesh.h"
 
 #include "core/math/aabb.h"
@@ -79,6 +80,14 @@ public:
 	AABB bounds;
 	LocalVector<Nav3D::ConnectableEdge> external_edges;
 
+	// Speed up the map queries that search the polygons of the region.
+	NavPolygonBVH3D polygon_bvh;
+	// The surface area of all polygons up to and including the polygon at each index, to pick random polygons by area.
+	LocalVector<real_t> polygon_accumulated_surface_areas;
+
+	// Built by the map builder the first time this iteration is used by a map with hierarchical pathfinding.
+	Nav3D::RegionClusters clusters;
+
 	const Transform3D &get_transform() const { return transform; }
 	real_t get_surface_area() const { return surface_area; }
 	AABB get_bounds() const { return bounds; }
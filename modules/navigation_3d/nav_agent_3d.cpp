@@ -122,6 +122,12 @@ bool NavAgent3D::is_map_changed() {
 	}
 }
 
+Vector3 NavAgent3D::get_flow_field_direction(const Vector3 &p_target_position, uint32_t p_navigation_layers) const {
+	ERR_FAIL_NULL_V(map, Vector3());
+
+	return map->get_flow_field_direction(p_target_position, position, p_navigation_layers);
+}
+
 void NavAgent3D::set_avoidance_callback(Callable p_callback) {
 	avoidance_callback = p_callback;
 }
@@ -91,6 +91,8 @@ public:
 
 	bool is_map_changed();
 
+	Vector3 get_flow_field_direction(const Vector3 &p_target_position, uint32_t p_navigation_layers) const;
+
 	RVO2D::Agent2D *get_rvo_agent_2d() { return &rvo_agent_2d; }
 	RVO3D::Agent3D *get_rvo_agent_3d() { return &rvo_agent_3d; }
 
@@ -55,6 +55,12 @@ using namespace Nav3D;
 #define NAVMAP_ITERATION_ZERO_ERROR_MSG()
 #endif // DEBUG_ENABLED
 
+// Minimum number of batched queries towards the same target before they share a single search.
+constexpr uint32_t PATH_QUERY_BATCH_SHARED_TARGET_MIN_QUERIES = 8;
+
+// Maximum number of cached flow fields per map.
+constexpr uint32_t FLOW_FIELD_CACHE_MAX_SIZE = 16;
+
 #define GET_MAP_ITERATION()                                                   \
 	iteration_slot_rwlock.read_lock();                                        \
 	NavMapIteration3D &map_iteration = iteration_slots[iteration_slot_index]; \
@@ -143,41 +149,242 @@ PointKey NavMap3D::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-void NavMap3D::query_path(NavMeshQueries3D::NavMeshPathQueryTask3D &p_query_task) {
-	if (iteration_id == 0) {
-		return;
-	}
-
-	GET_MAP_ITERATION();
+NavMeshQueries3D::PathQuerySlot *NavMap3D::_acquire_path_query_slot(NavMapIteration3D &p_map_iteration) {
+	p_map_iteration.path_query_slots_semaphore.wait();
 
-	map_iteration.path_query_slots_semaphore.wait();
+	NavMeshQueries3D::PathQuerySlot *path_query_slot = nullptr;
 
-	map_iteration.path_query_slots_mutex.lock();
-	for (NavMeshQueries3D::PathQuerySlot &p_path_query_slot : map_iteration.path_query_slots) {
+	p_map_iteration.path_query_slots_mutex.lock();
+	for (NavMeshQueries3D::PathQuerySlot &p_path_query_slot : p_map_iteration.path_query_slots) {
 		if (!p_path_query_slot.in_use) {
 			p_path_query_slot.in_use = true;
-			p_query_task.path_query_slot = &p_path_query_slot;
+			path_query_slot = &p_path_query_slot;
 			break;
 		}
 	}
-	map_iteration.path_query_slots_mutex.unlock();
+	p_map_iteration.path_query_slots_mutex.unlock();
 
+	if (path_query_slot == nullptr) {
+		p_map_iteration.path_query_slots_semaphore.post();
+		ERR_FAIL_NULL_V_MSG(path_query_slot, nullptr, "No unused NavMap3D path query slot found! This should never happen :(.");
+	}
+
+	return path_query_slot;
+}
+
+void NavMap3D::_release_path_query_slot(NavMapIteration3D &p_map_iteration, NavMeshQueries3D::PathQuerySlot *p_path_query_slot) {
+	p_map_iteration.path_query_slots_mutex.lock();
+	p_map_iteration.path_query_slots[p_path_query_slot->slot_index].in_use = false;
+	p_map_iteration.path_query_slots_mutex.unlock();
+
+	p_map_iteration.path_query_slots_semaphore.post();
+}
+
+void NavMap3D::query_path(NavMeshQueries3D::NavMeshPathQueryTask3D &p_query_task) {
+	if (iteration_id == 0) {
+		return;
+	}
+
+	GET_MAP_ITERATION();
+
+	p_query_task.path_query_slot = _acquire_path_query_slot(map_iteration);
 	if (p_query_task.path_query_slot == nullptr) {
-		map_iteration.path_query_slots_semaphore.post();
-		ERR_FAIL_NULL_MSG(p_query_task.path_query_slot, "No unused NavMap3D path query slot found! This should never happen :(.");
+		return;
 	}
 
 	p_query_task.map_up = map_iteration.map_up;
 
 	NavMeshQueries3D::query_task_map_iteration_get_path(p_query_task, map_iteration);
 
-	map_iteration.path_query_slots_mutex.lock();
-	uint32_t used_slot_index = p_query_task.path_query_slot->slot_index;
-	map_iteration.path_query_slots[used_slot_index].in_use = false;
+	_release_path_query_slot(map_iteration, p_query_task.path_query_slot);
 	p_query_task.path_query_slot = nullptr;
-	map_iteration.path_query_slots_mutex.unlock();
+}
+
+void NavMap3D::_query_path_batch_worker(uint32_t p_index, PathQueryBatch *p_batch) {
+	NavMapIteration3D &map_iteration = *p_batch->map_iteration;
+
+	// Every worker keeps one path query slot as its scratch memory for all the items it processes.
+	NavMeshQueries3D::PathQuerySlot *path_query_slot = _acquire_path_query_slot(map_iteration);
+	if (path_query_slot == nullptr) {
+		return;
+	}
+
+	const uint32_t item_count = p_batch->items.size();
+	for (uint32_t item_index = p_batch->next_item.postincrement(); item_index < item_count; item_index = p_batch->next_item.postincrement()) {
+		const LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *> &item = p_batch->items[item_index];
+
+		for (NavMeshQueries3D::NavMeshPathQueryTask3D *query_task : item) {
+			query_task->path_query_slot = path_query_slot;
+			query_task->map_up = map_iteration.map_up;
+		}
+
+		if (item.size() == 1) {
+			NavMeshQueries3D::query_task_map_iteration_get_path(*item[0], map_iteration);
+		} else {
+			NavMeshQueries3D::query_tasks_map_iteration_get_paths_to_target(item, map_iteration);
+		}
 
-	map_iteration.path_query_slots_semaphore.post();
+		for (NavMeshQueries3D::NavMeshPathQueryTask3D *query_task : item) {
+			query_task->path_query_slot = nullptr;
+		}
+	}
+
+	_release_path_query_slot(map_iteration, path_query_slot);
+}
+
+void NavMap3D::query_path_batch(const LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *> &p_query_tasks) {
+	if (iteration_id == 0 || p_query_tasks.is_empty()) {
+		return;
+	}
+
+	GET_MAP_ITERATION();
+
+	PathQueryBatch batch;
+	batch.map_iteration = &map_iteration;
+
+	// Group the queries towards the same target so they can share a single search.
+	LocalVector<LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *>> target_groups;
+	HashMap<Pair<Vector3, uint32_t>, uint32_t> target_group_indices;
+	for (NavMeshQueries3D::NavMeshPathQueryTask3D *query_task : p_query_tasks) {
+		if (!NavMeshQueries3D::query_task_can_share_target_search(*query_task, map_iteration)) {
+			batch.items.push_back({ query_task });
+			continue;
+		}
+
+		const Pair<Vector3, uint32_t> target_key(query_task->target_position, query_task->navigation_layers);
+		const uint32_t *target_group_index = target_group_indices.getptr(target_key);
+		if (target_group_index) {
+			target_groups[*target_group_index].push_back(query_task);
+		} else {
+			target_group_indices.insert(target_key, target_groups.size());
+			target_groups.push_back({ query_task });
+		}
+	}
+
+	// Small groups are cheaper to search one by one.
+	for (LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *> &target_group : target_groups) {
+		if (target_group.size() >= PATH_QUERY_BATCH_SHARED_TARGET_MIN_QUERIES) {
+			batch.items.push_back(target_group);
+		} else {
+			for (NavMeshQueries3D::NavMeshPathQueryTask3D *query_task : target_group) {
+				batch.items.push_back({ query_task });
+			}
+		}
+	}
+
+	const uint32_t worker_count = MIN(map_iteration.path_query_slots.size(), batch.items.size());
+	if (worker_count == 0) {
+		return;
+	}
+
+	if (use_threads && worker_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap3D::_query_path_batch_worker, &batch, worker_count, worker_count, true, SNAME("NavMapPathQueryBatch3D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_query_path_batch_worker(0, &batch);
+	}
+}
+
+Vector3 NavMap3D::get_flow_field_direction(const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers) {
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return Vector3();
+	}
+
+	// The flow fields keep pointers to the polygons of the iteration, so the id must belong to the same slot.
+	iteration_slot_rwlock.read_lock();
+	NavMapIteration3D &map_iteration = iteration_slots[iteration_slot_index];
+	NavMapIterationRead3D iteration_read_lock(map_iteration);
+	const uint32_t flow_field_iteration_id = iteration_id;
+	iteration_slot_rwlock.read_unlock();
+	const Pair<Vector3, uint32_t> flow_field_key(p_target_position, p_navigation_layers);
+
+	bool flow_field_grid_outdated = true;
+	bool flow_field_outdated = true;
+	{
+		RWLockRead read_lock(flow_fields_rwlock);
+		const FlowField *flow_field = flow_fields.getptr(flow_field_key);
+		flow_field_grid_outdated = flow_field_grid.iteration_id != flow_field_iteration_id;
+		flow_field_outdated = flow_field == nullptr || flow_field->iteration_id != flow_field_iteration_id;
+		if (!flow_field_grid_outdated && !flow_field_outdated) {
+			return NavMeshQueries3D::flow_field_get_direction(flow_field_grid, *flow_field, p_position);
+		}
+	}
+
+	// Build the outdated parts without holding the lock, so the other flow fields can still be sampled meanwhile.
+	// Only the flow fields that are still sampled get rebuilt after the map changed.
+	FlowFieldGrid built_flow_field_grid;
+	if (flow_field_grid_outdated) {
+		NavMeshQueries3D::map_iteration_build_flow_field_grid(map_iteration, built_flow_field_grid);
+		built_flow_field_grid.iteration_id = flow_field_iteration_id;
+	}
+	FlowField built_flow_field;
+	if (flow_field_outdated) {
+		if (!_build_flow_field(map_iteration, p_target_position, p_navigation_layers, built_flow_field)) {
+			return Vector3();
+		}
+		built_flow_field.iteration_id = flow_field_iteration_id;
+	}
+
+	RWLockWrite write_lock(flow_fields_rwlock);
+
+	// Another query may have replaced the parts that were up to date, those are rebuilt while locked.
+	if (flow_field_grid.iteration_id != flow_field_iteration_id) {
+		if (flow_field_grid_outdated) {
+			flow_field_grid = std::move(built_flow_field_grid);
+		} else {
+			NavMeshQueries3D::map_iteration_build_flow_field_grid(map_iteration, flow_field_grid);
+			flow_field_grid.iteration_id = flow_field_iteration_id;
+		}
+	}
+
+	FlowField *flow_field = flow_fields.getptr(flow_field_key);
+	if (flow_field == nullptr) {
+		if (flow_fields.size() >= FLOW_FIELD_CACHE_MAX_SIZE) {
+			// Drop the outdated flow fields first and the oldest one when all are in use.
+			LocalVector<Pair<Vector3, uint32_t>> outdated_flow_field_keys;
+			for (const KeyValue<Pair<Vector3, uint32_t>, FlowField> &E : flow_fields) {
+				if (E.value.iteration_id != flow_field_iteration_id) {
+					outdated_flow_field_keys.push_back(E.key);
+				}
+			}
+			for (const Pair<Vector3, uint32_t> &outdated_flow_field_key : outdated_flow_field_keys) {
+				flow_fields.erase(outdated_flow_field_key);
+			}
+			if (flow_fields.size() >= FLOW_FIELD_CACHE_MAX_SIZE) {
+				flow_fields.erase(flow_fields.begin()->key);
+			}
+		}
+		flow_field = &flow_fields.insert(flow_field_key, FlowField())->value;
+	}
+
+	if (flow_field->iteration_id != flow_field_iteration_id) {
+		if (flow_field_outdated) {
+			*flow_field = std::move(built_flow_field);
+		} else if (_build_flow_field(map_iteration, p_target_position, p_navigation_layers, *flow_field)) {
+			flow_field->iteration_id = flow_field_iteration_id;
+		} else {
+			return Vector3();
+		}
+	}
+
+	return NavMeshQueries3D::flow_field_get_direction(flow_field_grid, *flow_field, p_position);
+}
+
+bool NavMap3D::_build_flow_field(NavMapIteration3D &p_map_iteration, const Vector3 &p_target_position, uint32_t p_navigation_layers, FlowField &r_flow_field) {
+	NavMeshQueries3D::NavMeshPathQueryTask3D query_task;
+	query_task.start_position = p_target_position;
+	query_task.target_position = p_target_position;
+	query_task.navigation_layers = p_navigation_layers;
+	query_task.map_up = p_map_iteration.map_up;
+
+	query_task.path_query_slot = _acquire_path_query_slot(p_map_iteration);
+	ERR_FAIL_NULL_V(query_task.path_query_slot, false);
+
+	NavMeshQueries3D::query_task_build_flow_field(query_task, p_map_iteration, r_flow_field);
+
+	_release_path_query_slot(p_map_iteration, query_task.path_query_slot);
+	return true;
 }
 
 Vector3 NavMap3D::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
@@ -368,6 +575,7 @@ void NavMap3D::_build_iteration() {
 	iteration_build.use_edge_connections = get_use_edge_connections();
 	iteration_build.edge_connection_margin = get_edge_connection_margin();
 	iteration_build.link_connection_radius = get_link_connection_radius();
+	iteration_build.cluster_size = cluster_size;
 
 	next_map_iteration.clear();
 
@@ -390,6 +598,8 @@ void NavMap3D::_build_iteration() {
 	next_map_iteration.map_up = get_up();
 
 	iteration_build.map_iteration = &next_map_iteration;
+	// The current iteration is only read by queries until the slots switch after the build.
+	iteration_build.previous_map_iteration = &iteration_slots[iteration_slot_index];
 
 	if (use_async_iterations) {
 		iteration_build_thread_task_id = WorkerThreadPool::get_singleton()->add_native_task(&NavMap3D::_build_iteration_threaded, &iteration_build, true, SNAME("NavMapBuilder3D"));
@@ -414,11 +624,14 @@ void NavMap3D::_sync_iteration() {
 
 	performance_data.pm_edge_connection_count = iteration_build.performance_data.pm_edge_connection_count;
 	performance_data.pm_edge_free_count = iteration_build.performance_data.pm_edge_free_count;
-
-	iteration_id = iteration_id % UINT32_MAX + 1;
+	performance_data.pm_iteration_build_usec = iteration_build.performance_data.pm_iteration_build_usec;
+	performance_data.pm_iteration_rebuilt_region_count = iteration_build.performance_data.pm_iteration_rebuilt_region_count;
+	performance_data.pm_iteration_reused_region_count = iteration_build.performance_data.pm_iteration_reused_region_count;
 
 	// Finally ping-pong switch the iteration slot.
+	// The id changes together with the slot, so readers never see the new id with the old slot.
 	iteration_slot_rwlock.write_lock();
+	iteration_id = iteration_id % UINT32_MAX + 1;
 	uint32_t next_iteration_slot_index = (iteration_slot_index + 1) % 2;
 	iteration_slot_index = next_iteration_slot_index;
 	iteration_slot_rwlock.write_unlock();
@@ -562,80 +775,95 @@ void NavMap3D::_update_rvo_obstacles_tree_2d() {
 	rvo_simulation_2d.kdTree_->buildObstacleTree(raw_obstacles);
 }
 
-void NavMap3D::_update_rvo_agents_tree_2d() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO2D::Agent2D *> raw_agents;
-	raw_agents.reserve(active_2d_avoidance_agents.size());
-	for (NavAgent3D *agent : active_2d_avoidance_agents) {
-		raw_agents.push_back(agent->get_rvo_agent_2d());
+void NavMap3D::_update_rvo_simulation() {
+	if (obstacles_dirty) {
+		_update_rvo_obstacles_tree_2d();
 	}
-	rvo_simulation_2d.kdTree_->buildAgentTree(raw_agents);
 }
 
-void NavMap3D::_update_rvo_agents_tree_3d() {
-	// Cannot use LocalVector here as RVO library expects std::vector to build KdTree.
-	std::vector<RVO3D::Agent3D *> raw_agents;
-	raw_agents.reserve(active_3d_avoidance_agents.size());
-	for (NavAgent3D *agent : active_3d_avoidance_agents) {
-		raw_agents.push_back(agent->get_rvo_agent_3d());
-	}
-	rvo_simulation_3d.kdTree_->buildAgentTree(raw_agents);
+void NavMap3D::_gather_avoidance_agent_2d(uint32_t p_index, NavAgent3D **p_agents) {
+	const RVO2D::Agent2D *rvo_agent = p_agents[p_index]->get_rvo_agent_2d();
+	avoidance_grid_2d.set_agent(p_index, rvo_agent->position_.x(), rvo_agent->position_.y(), 0.0, rvo_agent->avoidance_layers_);
 }
 
-void NavMap3D::_update_rvo_simulation() {
-	if (obstacles_dirty) {
-		_update_rvo_obstacles_tree_2d();
+void NavMap3D::_gather_avoidance_agent_3d(uint32_t p_index, NavAgent3D **p_agents) {
+	const RVO3D::Agent3D *rvo_agent = p_agents[p_index]->get_rvo_agent_3d();
+	avoidance_grid_3d.set_agent(p_index, rvo_agent->position_.x(), rvo_agent->position_.y(), rvo_agent->position_.z(), rvo_agent->avoidance_layers_);
+}
+
+void NavMap3D::_compute_avoidance_velocity_2d(uint32_t p_index, NavAgent3D **p_agents) {
+	RVO2D::Agent2D *rvo_agent = p_agents[p_index]->get_rvo_agent_2d();
+
+	rvo_agent->obstacleNeighbors_.clear();
+	const float obstacle_range = rvo_agent->timeHorizonObst_ * rvo_agent->maxSpeed_ + rvo_agent->radius_;
+	rvo_simulation_2d.kdTree_->computeObstacleNeighbors(rvo_agent, obstacle_range * obstacle_range);
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ > 0) {
+		float range_sq = rvo_agent->neighborDist_ * rvo_agent->neighborDist_;
+		avoidance_grid_2d.query_neighbors(rvo_agent->position_.x(), rvo_agent->position_.y(), 0.0, rvo_agent->avoidance_mask_, range_sq, [&](uint32_t p_neighbor_index, float &r_range_sq) {
+			rvo_agent->insertAgentNeighbor(p_agents[p_neighbor_index]->get_rvo_agent_2d(), r_range_sq);
+		});
 	}
-	if (agents_dirty) {
-		_update_rvo_agents_tree_2d();
-		_update_rvo_agents_tree_3d();
+
+	rvo_agent->computeNewVelocity(&rvo_simulation_2d);
+}
+
+void NavMap3D::_compute_avoidance_velocity_3d(uint32_t p_index, NavAgent3D **p_agents) {
+	RVO3D::Agent3D *rvo_agent = p_agents[p_index]->get_rvo_agent_3d();
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ > 0) {
+		float range_sq = rvo_agent->neighborDist_ * rvo_agent->neighborDist_;
+		avoidance_grid_3d.query_neighbors(rvo_agent->position_.x(), rvo_agent->position_.y(), rvo_agent->position_.z(), rvo_agent->avoidance_mask_, range_sq, [&](uint32_t p_neighbor_index, float &r_range_sq) {
+			rvo_agent->insertAgentNeighbor(p_agents[p_neighbor_index]->get_rvo_agent_3d(), r_range_sq);
+		});
 	}
+
+	rvo_agent->computeNewVelocity(&rvo_simulation_3d);
 }
 
-void NavMap3D::compute_single_avoidance_step_2d(uint32_t index, NavAgent3D **agent) {
-	(*(agent + index))->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
-	(*(agent + index))->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-	(*(agent + index))->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-	(*(agent + index))->update();
+void NavMap3D::_update_avoidance_agent_2d(uint32_t p_index, NavAgent3D **p_agents) {
+	p_agents[p_index]->get_rvo_agent_2d()->update(&rvo_simulation_2d);
+	p_agents[p_index]->update();
 }
 
-void NavMap3D::compute_single_avoidance_step_3d(uint32_t index, NavAgent3D **agent) {
-	(*(agent + index))->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
-	(*(agent + index))->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-	(*(agent + index))->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-	(*(agent + index))->update();
+void NavMap3D::_update_avoidance_agent_3d(uint32_t p_index, NavAgent3D **p_agents) {
+	p_agents[p_index]->get_rvo_agent_3d()->update(&rvo_simulation_3d);
+	p_agents[p_index]->update();
+}
+
+void NavMap3D::_run_avoidance_phase(void (NavMap3D::*p_method)(uint32_t, NavAgent3D **), LocalVector<NavAgent3D *> &p_agents, const String &p_description) {
+	if (use_threads && avoidance_use_multiple_threads) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, p_method, p_agents.ptr(), p_agents.size(), -1, true, p_description);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < p_agents.size(); i++) {
+			(this->*p_method)(i, p_agents.ptr());
+		}
+	}
 }
 
 void NavMap3D::step(double p_delta_time) {
 	rvo_simulation_2d.setTimeStep(float(p_delta_time));
 	rvo_simulation_3d.setTimeStep(float(p_delta_time));
 
+	// Every phase has to finish for all agents before the next one starts,
+	// the new velocities are computed from the positions and velocities of the neighbors before they move.
 	if (active_2d_avoidance_agents.size() > 0) {
-		if (use_threads && avoidance_use_multiple_threads) {
-			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap3D::compute_single_avoidance_step_2d, active_2d_avoidance_agents.ptr(), active_2d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents2D"));
-			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
-		} else {
-			for (NavAgent3D *agent : active_2d_avoidance_agents) {
-				agent->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-				agent->update();
-			}
-		}
+		avoidance_grid_2d.resize(active_2d_avoidance_agents.size());
+		_run_avoidance_phase(&NavMap3D::_gather_avoidance_agent_2d, active_2d_avoidance_agents, "RVOAvoidanceGather2D");
+		avoidance_grid_2d.build();
+		_run_avoidance_phase(&NavMap3D::_compute_avoidance_velocity_2d, active_2d_avoidance_agents, "RVOAvoidanceAgents2D");
+		_run_avoidance_phase(&NavMap3D::_update_avoidance_agent_2d, active_2d_avoidance_agents, "RVOAvoidanceUpdate2D");
 	}
 
 	if (active_3d_avoidance_agents.size() > 0) {
-		if (use_threads && avoidance_use_multiple_threads) {
-			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap3D::compute_single_avoidance_step_3d, active_3d_avoidance_agents.ptr(), active_3d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents3D"));
-			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
-		} else {
-			for (NavAgent3D *agent : active_3d_avoidance_agents) {
-				agent->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-				agent->update();
-			}
-		}
+		avoidance_grid_3d.resize(active_3d_avoidance_agents.size());
+		_run_avoidance_phase(&NavMap3D::_gather_avoidance_agent_3d, active_3d_avoidance_agents, "RVOAvoidanceGather3D");
+		avoidance_grid_3d.build();
+		_run_avoidance_phase(&NavMap3D::_compute_avoidance_velocity_3d, active_3d_avoidance_agents, "RVOAvoidanceAgents3D");
+		_run_avoidance_phase(&NavMap3D::_update_avoidance_agent_3d, active_3d_avoidance_agents, "RVOAvoidanceUpdate3D");
 	}
 }
 
@@ -869,6 +1097,8 @@ NavMap3D::NavMap3D() {
 		path_query_slots_max = 1;
 	}
 
+	cluster_size = GLOBAL_GET("navigation/3d/hierarchical_pathfinding_cluster_size");
+
 	iteration_slots.resize(2);
 
 	for (NavMapIteration3D &iteration_slot : iteration_slots) {
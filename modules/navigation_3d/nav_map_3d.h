@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "3d/nav_avoidance_grid_3d.h"
 #include "3d/nav_map_iteration_3d.h"
 #include "3d/nav_mesh_queries_3d.h"
 #include "nav_rid_3d.h"
@@ -87,6 +88,10 @@ class NavMap3D : public NavRid3D {
 	LocalVector<NavAgent3D *> active_2d_avoidance_agents;
 	LocalVector<NavAgent3D *> active_3d_avoidance_agents;
 
+	/// Neighbor search grids of the avoidance agents, rebuilt each step
+	NavAvoidanceGrid3D avoidance_grid_2d;
+	NavAvoidanceGrid3D avoidance_grid_3d;
+
 	/// dirty flag when one of the agent's arrays are modified
 	bool agents_dirty = true;
 
@@ -139,6 +144,9 @@ class NavMap3D : public NavRid3D {
 
 	bool use_async_iterations = true;
 
+	// Size of the clusters used for hierarchical pathfinding, disabled when zero.
+	real_t cluster_size = 0.0;
+
 	uint32_t iteration_slot_index = 0;
 	LocalVector<NavMapIteration3D> iteration_slots;
 	mutable RWLock iteration_slot_rwlock;
@@ -154,6 +162,23 @@ class NavMap3D : public NavRid3D {
 	void _build_iteration();
 	void _sync_iteration();
 
+	struct PathQueryBatch {
+		NavMapIteration3D *map_iteration = nullptr;
+		// Items with more than one task share a single search towards their target.
+		LocalVector<LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *>> items;
+		SafeNumeric<uint32_t> next_item;
+	};
+
+	// Flow fields towards shared targets, rebuilt on demand when the map iteration changed.
+	RWLock flow_fields_rwlock;
+	Nav3D::FlowFieldGrid flow_field_grid;
+	HashMap<Pair<Vector3, uint32_t>, Nav3D::FlowField> flow_fields;
+
+	NavMeshQueries3D::PathQuerySlot *_acquire_path_query_slot(NavMapIteration3D &p_map_iteration);
+	void _release_path_query_slot(NavMapIteration3D &p_map_iteration, NavMeshQueries3D::PathQuerySlot *p_path_query_slot);
+	bool _build_flow_field(NavMapIteration3D &p_map_iteration, const Vector3 &p_target_position, uint32_t p_navigation_layers, Nav3D::FlowField &r_flow_field);
+	void _query_path_batch_worker(uint32_t p_index, PathQueryBatch *p_batch);
+
 public:
 	NavMap3D();
 	~NavMap3D();
@@ -197,6 +222,8 @@ public:
 	const Vector3 &get_merge_rasterizer_cell_size() const;
 
 	void query_path(NavMeshQueries3D::NavMeshPathQueryTask3D &p_query_task);
+	void query_path_batch(const LocalVector<NavMeshQueries3D::NavMeshPathQueryTask3D *> &p_query_tasks);
+	Vector3 get_flow_field_direction(const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers);
 
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
@@ -249,6 +276,9 @@ public:
 	int get_pm_edge_connection_count() const { return performance_data.pm_edge_connection_count; }
 	int get_pm_edge_free_count() const { return performance_data.pm_edge_free_count; }
 	int get_pm_obstacle_count() const { return performance_data.pm_obstacle_count; }
+	int get_pm_iteration_build_usec() const { return performance_data.pm_iteration_build_usec; }
+	int get_pm_iteration_rebuilt_region_count() const { return performance_data.pm_iteration_rebuilt_region_count; }
+	int get_pm_iteration_reused_region_count() const { return performance_data.pm_iteration_reused_region_count; }
 
 	int get_region_connections_count(NavRegion3D *p_region) const;
 	Vector3 get_region_connection_pathway_start(NavRegion3D *p_region, int p_connection_id) const;
@@ -277,14 +307,17 @@ private:
 
 	void compute_single_step(uint32_t index, NavAgent3D **agent);
 
-	void compute_single_avoidance_step_2d(uint32_t index, NavAgent3D **agent);
-	void compute_single_avoidance_step_3d(uint32_t index, NavAgent3D **agent);
+	void _gather_avoidance_agent_2d(uint32_t p_index, NavAgent3D **p_agents);
+	void _gather_avoidance_agent_3d(uint32_t p_index, NavAgent3D **p_agents);
+	void _compute_avoidance_velocity_2d(uint32_t p_index, NavAgent3D **p_agents);
+	void _compute_avoidance_velocity_3d(uint32_t p_index, NavAgent3D **p_agents);
+	void _update_avoidance_agent_2d(uint32_t p_index, NavAgent3D **p_agents);
+	void _update_avoidance_agent_3d(uint32_t p_index, NavAgent3D **p_agents);
+	void _run_avoidance_phase(void (NavMap3D::*p_method)(uint32_t, NavAgent3D **), LocalVector<NavAgent3D *> &p_agents, const String &p_description);
 
 	void _sync_avoidance();
 	void _update_rvo_simulation();
 	void _update_rvo_obstacles_tree_2d();
-	void _update_rvo_agents_tree_2d();
-	void _update_rvo_agents_tree_3d();
 
 	void _update_merge_rasterizer_cell_dimensions();
 };
@@ -171,6 +171,166 @@ struct NavPolyHeapIndexer {
 	}
 };
 
+struct ClusterPortal {
+	/// Clusters on both sides of the portal.
+	uint32_t clusters[2] = { UINT32_MAX, UINT32_MAX };
+
+	/// Polygons on both sides of the portal, used to look up the intra-cluster travel costs.
+	uint32_t polygons[2] = { UINT32_MAX, UINT32_MAX };
+
+	/// Whether the portal can be crossed from side 0 to side 1, and from side 1 to side 0.
+	bool traversable[2] = { false, false };
+
+	/// Point where paths cross the portal.
+	Vector3 position;
+};
+
+struct RegionClusters {
+	/// Cluster size these clusters were built with, zero if they were not built yet.
+	real_t cluster_size = 0.0;
+
+	uint32_t cluster_count = 0;
+
+	/// Cluster of each navmesh polygon.
+	LocalVector<uint32_t> polygon_clusters;
+
+	/// Portals between clusters of the same region.
+	LocalVector<ClusterPortal> portals;
+
+	/// Polygons of each cluster that connect to other clusters or regions, indexed by `cluster_border_offsets`.
+	LocalVector<uint32_t> border_polygons;
+	LocalVector<uint32_t> cluster_border_offsets;
+
+	/// Index of each navmesh polygon in `border_polygons`, or `UINT32_MAX` if it is not a border polygon.
+	LocalVector<uint32_t> polygon_border_indices;
+
+	/// Travel costs between the border polygons of a cluster, one square matrix per cluster starting at `cluster_cost_offsets`.
+	LocalVector<real_t> border_costs;
+	LocalVector<uint32_t> cluster_cost_offsets;
+
+	/// Returns the precomputed travel cost between two polygons of a cluster, or a negative value if it is unknown.
+	real_t get_travel_cost(uint32_t p_cluster, uint32_t p_from_polygon, uint32_t p_to_polygon) const {
+		const uint32_t from_border = polygon_border_indices[p_from_polygon];
+		const uint32_t to_border = polygon_border_indices[p_to_polygon];
+		if (from_border == UINT32_MAX || to_border == UINT32_MAX) {
+			return -1.0;
+		}
+		const uint32_t border_offset = cluster_border_offsets[p_cluster];
+		const uint32_t border_count = cluster_border_offsets[p_cluster + 1] - border_offset;
+		return border_costs[cluster_cost_offsets[p_cluster] + (from_border - border_offset) * border_count + (to_border - border_offset)];
+	}
+
+	void clear() {
+		cluster_size = 0.0;
+		cluster_count = 0;
+		polygon_clusters.clear();
+		portals.clear();
+		border_polygons.clear();
+		cluster_border_offsets.clear();
+		polygon_border_indices.clear();
+		border_costs.clear();
+		cluster_cost_offsets.clear();
+	}
+};
+
+struct ClusterInfo {
+	/// Navigation region or link that contains this cluster.
+	const NavBaseIteration3D *owner = nullptr;
+
+	/// Cluster data of the owning region, `nullptr` for links.
+	const RegionClusters *region_clusters = nullptr;
+
+	/// Cluster index inside of the owning region.
+	uint32_t local_cluster = 0;
+
+	/// Map polygon id of the first polygon of the owner.
+	uint32_t polygon_offset = 0;
+};
+
+struct NavigationPortal {
+	/// Index in the heap of traversable portals.
+	uint32_t traversable_portal_index = UINT32_MAX;
+
+	/// Search node this portal was reached from, used to travel the abstract path backwards.
+	int back_navigation_portal_id = -1;
+
+	/// The distance traveled until now (g cost).
+	real_t traveled_distance = 0.0;
+	/// The distance to the destination (h cost).
+	real_t distance_to_destination = 0.0;
+
+	/// The total travel cost (f cost).
+	real_t total_travel_cost() const {
+		return traveled_distance + distance_to_destination;
+	}
+
+	void reset() {
+		traversable_portal_index = UINT32_MAX;
+		back_navigation_portal_id = -1;
+		traveled_distance = FLT_MAX;
+		distance_to_destination = 0.0;
+	}
+};
+
+struct NavPortalTravelCostGreaterThan {
+	// Returns `true` if the travel cost of `a` is higher than that of `b`.
+	bool operator()(const NavigationPortal *p_portal_a, const NavigationPortal *p_portal_b) const {
+		real_t f_cost_a = p_portal_a->total_travel_cost();
+		real_t f_cost_b = p_portal_b->total_travel_cost();
+
+		if (f_cost_a != f_cost_b) {
+			return f_cost_a > f_cost_b;
+		} else {
+			return p_portal_a->distance_to_destination > p_portal_b->distance_to_destination;
+		}
+	}
+};
+
+struct NavPortalHeapIndexer {
+	void operator()(NavigationPortal *p_portal, uint32_t p_heap_index) const {
+		p_portal->traversable_portal_index = p_heap_index;
+	}
+};
+
+struct FlowFieldPolygon {
+	/// Next polygon towards the target, `UINT32_MAX` if the target can not be reached.
+	uint32_t next_polygon_id = UINT32_MAX;
+
+	/// The edge of this polygon that leads to the next polygon.
+	Vector3 pathway_start;
+	Vector3 pathway_end;
+
+	/// The travel cost to the target.
+	real_t travel_cost = FLT_MAX;
+};
+
+struct FlowField {
+	uint32_t iteration_id = 0;
+
+	/// The target position on the navigation mesh and its polygon, `UINT32_MAX` if there is no navigation mesh.
+	Vector3 target_position;
+	uint32_t target_polygon_id = UINT32_MAX;
+
+	/// Indexed by the global polygon id, regions first and links last.
+	LocalVector<FlowFieldPolygon> polygons;
+};
+
+/// Grid on the XZ plane to find the region polygons under a position.
+struct FlowFieldGrid {
+	uint32_t iteration_id = 0;
+
+	Vector2 origin;
+	real_t cell_size = 1.0;
+	Vector2i size;
+
+	/// Polygon ids of every cell, from `cell_offsets[cell]` to `cell_offsets[cell + 1]`.
+	LocalVector<uint32_t> cell_offsets;
+	LocalVector<uint32_t> cell_polygon_ids;
+
+	/// Indexed by the global polygon id.
+	LocalVector<const Polygon *> polygons;
+};
+
 struct ClosestPointQueryResult {
 	Vector3 point;
 	Vector3 normal;
@@ -192,6 +352,9 @@ struct PerformanceData {
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
+	int pm_iteration_build_usec = 0;
+	int pm_iteration_rebuilt_region_count = 0;
+	int pm_iteration_reused_region_count = 0;
 
 	void reset() {
 		pm_region_count = 0;
@@ -203,6 +366,9 @@ struct PerformanceData {
 		pm_edge_connection_count = 0;
 		pm_edge_free_count = 0;
 		pm_obstacle_count = 0;
+		pm_iteration_build_usec = 0;
+		pm_iteration_rebuilt_region_count = 0;
+		pm_iteration_reused_region_count = 0;
 	}
 };
 
@@ -212,6 +212,14 @@ RID CompressedTexture2D::get_rid() const {
 	return texture;
 }
 
+uint64_t CompressedTexture2D::get_memory_usage() const {
+	if (w == 0 || h == 0) {
+		return 0;
+	}
+	// Mipmap presence isn't kept after loading, so this is a lower bound for mipmapped textures.
+	return Image::get_image_data_size(w, h, format, false);
+}
+
 void CompressedTexture2D::draw(RID p_canvas_item, const Point2 &p_pos, const Color &p_modulate, bool p_transpose) const {
 	if ((w | h) == 0) {
 		return;
@@ -64,6 +64,7 @@ public:
 	int get_height() const override;
 
 	virtual RID get_rid() const override;
+	virtual uint64_t get_memory_usage() const override;
 
 	bool has_alpha() const override;
 	virtual void draw(RID p_canvas_item, const Point2 &p_pos, const Color &p_modulate = Color(1, 1, 1), bool p_transpose = false) const override;
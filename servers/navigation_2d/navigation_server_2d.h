@@ -100,6 +100,8 @@ public:
 
 	virtual Vector2 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const = 0;
 
+	virtual Vector2 map_get_flow_field_direction(RID p_map, const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	/* REGION API */
 
 	virtual RID region_create() = 0;
@@ -216,6 +218,8 @@ public:
 
 	virtual bool agent_is_map_changed(RID p_agent) const = 0;
 
+	virtual Vector2 agent_get_flow_field_direction(RID p_agent, const Vector2 &p_target_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	virtual void agent_set_avoidance_callback(RID p_agent, Callable p_callback) = 0;
 	virtual bool agent_has_avoidance_callback(RID p_agent) const = 0;
 
@@ -60,6 +60,7 @@ public:
 	TypedArray<RID> map_get_obstacles(RID p_map) const override { return TypedArray<RID>(); }
 	void map_force_update(RID p_map) override {}
 	Vector2 map_get_random_point(RID p_map, uint32_t p_naviation_layers, bool p_uniformly) const override { return Vector2(); }
+	Vector2 map_get_flow_field_direction(RID p_map, const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const override { return Vector2(); }
 	uint32_t map_get_iteration_id(RID p_map) const override { return 0; }
 	void map_set_use_async_iterations(RID p_map, bool p_enabled) override {}
 	bool map_get_use_async_iterations(RID p_map) const override { return false; }
@@ -139,6 +140,7 @@ public:
 	void agent_set_position(RID p_agent, Vector2 p_position) override {}
 	Vector2 agent_get_position(RID p_agent) const override { return Vector2(); }
 	bool agent_is_map_changed(RID p_agent) const override { return false; }
+	Vector2 agent_get_flow_field_direction(RID p_agent, const Vector2 &p_target_position, uint32_t p_navigation_layers = 1) const override { return Vector2(); }
 	void agent_set_avoidance_callback(RID p_agent, Callable p_callback) override {}
 	bool agent_has_avoidance_callback(RID p_agent) const override { return false; }
 	void agent_set_avoidance_layers(RID p_agent, uint32_t p_layers) override {}
@@ -79,7 +79,10 @@ void NavigationServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer3D::map_get_random_point);
 
+	ClassDB::bind_method(D_METHOD("map_get_flow_field_direction", "map", "target_position", "position", "navigation_layers"), &NavigationServer3D::map_get_flow_field_direction, DEFVAL(1));
+
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result", "callback"), &NavigationServer3D::query_path, DEFVAL(Callable()));
+	ClassDB::bind_method(D_METHOD("query_path_batch", "parameters", "results"), &NavigationServer3D::query_path_batch);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_get_iteration_id", "region"), &NavigationServer3D::region_get_iteration_id);
@@ -166,6 +169,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("agent_set_position", "agent", "position"), &NavigationServer3D::agent_set_position);
 	ClassDB::bind_method(D_METHOD("agent_get_position", "agent"), &NavigationServer3D::agent_get_position);
 	ClassDB::bind_method(D_METHOD("agent_is_map_changed", "agent"), &NavigationServer3D::agent_is_map_changed);
+	ClassDB::bind_method(D_METHOD("agent_get_flow_field_direction", "agent", "target_position", "navigation_layers"), &NavigationServer3D::agent_get_flow_field_direction, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("agent_set_avoidance_callback", "agent", "callback"), &NavigationServer3D::agent_set_avoidance_callback);
 	ClassDB::bind_method(D_METHOD("agent_has_avoidance_callback", "agent"), &NavigationServer3D::agent_has_avoidance_callback);
 	ClassDB::bind_method(D_METHOD("agent_set_avoidance_layers", "agent", "layers"), &NavigationServer3D::agent_set_avoidance_layers);
@@ -233,6 +237,9 @@ void NavigationServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(INFO_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(INFO_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(INFO_ITERATION_BUILD_USEC);
+	BIND_ENUM_CONSTANT(INFO_ITERATION_REBUILT_REGION_COUNT);
+	BIND_ENUM_CONSTANT(INFO_ITERATION_REUSED_REGION_COUNT);
 }
 
 NavigationServer3D *NavigationServer3D::get_singleton() {
@@ -250,6 +257,7 @@ NavigationServer3D::NavigationServer3D() {
 	GLOBAL_DEF("navigation/3d/use_edge_connections", true);
 	GLOBAL_DEF_BASIC(PropertyInfo(Variant::FLOAT, "navigation/3d/default_edge_connection_margin", PROPERTY_HINT_RANGE, "0.01,10,0.001,or_greater"), NavigationDefaults3D::EDGE_CONNECTION_MARGIN);
 	GLOBAL_DEF_BASIC(PropertyInfo(Variant::FLOAT, "navigation/3d/default_link_connection_radius", PROPERTY_HINT_RANGE, "0.01,10,0.001,or_greater"), NavigationDefaults3D::LINK_CONNECTION_RADIUS);
+	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "navigation/3d/hierarchical_pathfinding_cluster_size", PROPERTY_HINT_RANGE, "0,1000,0.01,or_greater,suffix:m"), 0.0);
 
 #ifdef DEBUG_ENABLED
 #ifndef DISABLE_DEPRECATED
@@ -104,6 +104,8 @@ public:
 
 	virtual Vector3 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const = 0;
 
+	virtual Vector3 map_get_flow_field_direction(RID p_map, const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	/* REGION API */
 
 	virtual RID region_create() = 0;
@@ -234,6 +236,8 @@ public:
 
 	virtual bool agent_is_map_changed(RID p_agent) const = 0;
 
+	virtual Vector3 agent_get_flow_field_direction(RID p_agent, const Vector3 &p_target_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	virtual void agent_set_avoidance_callback(RID p_agent, Callable p_callback) = 0;
 	virtual bool agent_has_avoidance_callback(RID p_agent) const = 0;
 
@@ -278,6 +282,7 @@ public:
 	/* QUERY API */
 
 	virtual void query_path(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, Ref<NavigationPathQueryResult3D> p_query_result, const Callable &p_callback = Callable()) = 0;
+	virtual void query_path_batch(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const TypedArray<NavigationPathQueryResult3D> &p_query_results) = 0;
 
 	/* NAVMESH BAKE API */
 
@@ -331,6 +336,9 @@ public:
 		INFO_EDGE_CONNECTION_COUNT,
 		INFO_EDGE_FREE_COUNT,
 		INFO_OBSTACLE_COUNT,
+		INFO_ITERATION_BUILD_USEC,
+		INFO_ITERATION_REBUILT_REGION_COUNT,
+		INFO_ITERATION_REUSED_REGION_COUNT,
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) const = 0;
@@ -283,6 +283,15 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// Returns a hash of the state of the bodies in the space, used to detect
+	// desyncs between peers running a deterministic simulation.
+	virtual uint32_t space_get_state_hash(RID p_space) const;
+
+	// Saves the bodies of the space and the contacts between them, so that the simulation
+	// can be rolled back with space_restore_state(). Only works on physics process.
+	virtual PackedByteArray space_save_state(RID p_space) const;
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state);
+
 	//missing space parameters
 
 	/* AREA API */
@@ -241,6 +241,16 @@ public:
 	EXBIND1RC(Vector<Vector2>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	GDVIRTUAL1RC(uint32_t, _space_get_state_hash, RID)
+
+	virtual uint32_t space_get_state_hash(RID p_space) const override {
+		uint32_t ret = 0;
+		if (GDVIRTUAL_CALL(_space_get_state_hash, p_space, ret)) {
+			return ret;
+		}
+		return PhysicsServer2D::space_get_state_hash(p_space);
+	}
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
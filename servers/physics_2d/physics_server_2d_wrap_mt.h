@@ -117,6 +117,22 @@ public:
 		return physics_server_2d->space_get_direct_state(p_space);
 	}
 
+	virtual uint32_t space_get_state_hash(RID p_space) const override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), 0);
+		return physics_server_2d->space_get_state_hash(p_space);
+	}
+
+	// These only work on physics process, like space_get_direct_state().
+	virtual PackedByteArray space_save_state(RID p_space) const override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), PackedByteArray());
+		return physics_server_2d->space_save_state(p_space);
+	}
+
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), false);
+		return physics_server_2d->space_restore_state(p_space, p_state);
+	}
+
 	FUNC2(space_set_debug_contacts, RID, int);
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const override {
 		ERR_FAIL_COND_V(!Thread::is_main_thread(), Vector<Vector2>());
@@ -382,6 +382,74 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(RequiredParam<PhysicsRayQue
 	return d;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays(RequiredParam<PhysicsRayQueryParameters3D> rp_ray_query, const Vector<Vector3> &p_from, const Vector<Vector3> &p_to) {
+	EXTRACT_PARAM_OR_FAIL_V(p_ray_query, rp_ray_query, Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The 'from' and 'to' arrays must have the same size.");
+
+	const int ray_count = p_from.size();
+
+	LocalVector<RayResult> results;
+	LocalVector<bool> hits;
+	results.resize(ray_count);
+	hits.resize(ray_count);
+
+	intersect_rays(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), ray_count, results.ptr(), hits.ptr());
+
+	Vector<uint8_t> hit;
+	Vector<Vector3> position;
+	Vector<Vector3> normal;
+	Vector<int64_t> collider_id;
+	Vector<int32_t> shape;
+	Vector<int32_t> face_index;
+	Array rid;
+	hit.resize(ray_count);
+	position.resize(ray_count);
+	normal.resize(ray_count);
+	collider_id.resize(ray_count);
+	shape.resize(ray_count);
+	face_index.resize(ray_count);
+	rid.resize(ray_count);
+
+	uint8_t *hit_w = hit.ptrw();
+	Vector3 *position_w = position.ptrw();
+	Vector3 *normal_w = normal.ptrw();
+	int64_t *collider_id_w = collider_id.ptrw();
+	int32_t *shape_w = shape.ptrw();
+	int32_t *face_index_w = face_index.ptrw();
+
+	for (int i = 0; i < ray_count; i++) {
+		if (!hits[i]) {
+			hit_w[i] = 0;
+			position_w[i] = Vector3();
+			normal_w[i] = Vector3();
+			collider_id_w[i] = 0;
+			shape_w[i] = 0;
+			face_index_w[i] = -1;
+			continue;
+		}
+
+		const RayResult &result = results[i];
+		hit_w[i] = 1;
+		position_w[i] = result.position;
+		normal_w[i] = result.normal;
+		collider_id_w[i] = (int64_t)result.collider_id;
+		shape_w[i] = result.shape;
+		face_index_w[i] = result.face_index;
+		rid[i] = result.rid;
+	}
+
+	Dictionary d;
+	d["hit"] = hit;
+	d["position"] = position;
+	d["normal"] = normal;
+	d["collider_id"] = collider_id;
+	d["shape"] = shape;
+	d["face_index"] = face_index;
+	d["rid"] = rid;
+
+	return d;
+}
+
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(RequiredParam<PhysicsPointQueryParameters3D> rp_point_query, int p_max_results) {
 	EXTRACT_PARAM_OR_FAIL_V(p_point_query, rp_point_query, TypedArray<Dictionary>());
 
@@ -442,6 +510,36 @@ Vector<real_t> PhysicsDirectSpaceState3D::_cast_motion(RequiredParam<PhysicsShap
 	return ret;
 }
 
+Vector<real_t> PhysicsDirectSpaceState3D::_cast_motions(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query, const TypedArray<Transform3D> &p_transforms) {
+	EXTRACT_PARAM_OR_FAIL_V(p_shape_query, rp_shape_query, Vector<real_t>());
+
+	const int count = p_transforms.size();
+
+	LocalVector<Transform3D> transforms;
+	LocalVector<real_t> closest_safe;
+	LocalVector<real_t> closest_unsafe;
+	transforms.resize(count);
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms[i] = p_transforms[i];
+	}
+
+	bool res = cast_motions(p_shape_query->get_parameters(), transforms.ptr(), count, closest_safe.ptr(), closest_unsafe.ptr());
+	if (!res) {
+		return Vector<real_t>();
+	}
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	real_t *ret_w = ret.ptrw();
+	for (int i = 0; i < count; i++) {
+		ret_w[i * 2 + 0] = closest_safe[i];
+		ret_w[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
 TypedArray<Vector3> PhysicsDirectSpaceState3D::_collide_shape(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query, int p_max_results) {
 	EXTRACT_PARAM_OR_FAIL_V(p_shape_query, rp_shape_query, TypedArray<Vector3>());
 
@@ -481,14 +579,38 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(RequiredParam<PhysicsShapeQ
 	return r;
 }
 
+void PhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits) {
+	RayParameters parameters = p_parameters;
+	for (int i = 0; i < p_ray_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_hits[i] = intersect_ray(parameters, r_results[i]);
+	}
+}
+
+bool PhysicsDirectSpaceState3D::cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform = p_transforms[i];
+		r_closest_safe[i] = 1.0f;
+		r_closest_unsafe[i] = 1.0f;
+		if (!cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
 void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_point", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_point, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState3D::_intersect_ray);
+	ClassDB::bind_method(D_METHOD("intersect_rays", "parameters", "from", "to"), &PhysicsDirectSpaceState3D::_intersect_rays);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
+	ClassDB::bind_method(D_METHOD("cast_motions", "parameters", "transforms"), &PhysicsDirectSpaceState3D::_cast_motions);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState3D::_get_rest_info);
 }
@@ -694,6 +816,18 @@ RID PhysicsServer3D::shape_create(ShapeType p_shape) {
 	}
 }
 
+PackedByteArray PhysicsServer3D::space_save_state(RID p_space) const {
+	ERR_FAIL_V_MSG(PackedByteArray(), "The current physics server does not support saving space states.");
+}
+
+bool PhysicsServer3D::space_restore_state(RID p_space, const PackedByteArray &p_state) {
+	ERR_FAIL_V_MSG(false, "The current physics server does not support restoring space states.");
+}
+
+PackedInt32Array PhysicsServer3D::get_process_histogram(ProcessHistogram p_histogram) {
+	ERR_FAIL_V_MSG(PackedInt32Array(), "The current physics server does not support process histograms.");
+}
+
 void PhysicsServer3D::_bind_methods() {
 #ifndef _3D_DISABLED
 
@@ -721,6 +855,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_state", "space"), &PhysicsServer3D::space_save_state);
+	ClassDB::bind_method(D_METHOD("space_restore_state", "space", "state"), &PhysicsServer3D::space_restore_state);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -1048,6 +1184,7 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_active", "active"), &PhysicsServer3D::set_active);
 
 	ClassDB::bind_method(D_METHOD("get_process_info", "process_info"), &PhysicsServer3D::get_process_info);
+	ClassDB::bind_method(D_METHOD("get_process_histogram", "histogram"), &PhysicsServer3D::get_process_histogram);
 
 	BIND_ENUM_CONSTANT(SHAPE_WORLD_BOUNDARY);
 	BIND_ENUM_CONSTANT(SHAPE_SEPARATION_RAY);
@@ -1114,6 +1251,19 @@ void PhysicsServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_BROADPHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_PAIR_GENERATION_TIME);
+	BIND_ENUM_CONSTANT(INFO_NARROWPHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_ISLAND_GENERATION_TIME);
+	BIND_ENUM_CONSTANT(INFO_SOLVE_TIME);
+	BIND_ENUM_CONSTANT(INFO_INTEGRATION_TIME);
+	BIND_ENUM_CONSTANT(INFO_CALLBACK_TIME);
+	BIND_ENUM_CONSTANT(INFO_CONTACT_COUNT);
+	BIND_ENUM_CONSTANT(INFO_GJK_QUERY_COUNT);
+	BIND_ENUM_CONSTANT(INFO_MAX_ISLAND_SIZE);
+
+	BIND_ENUM_CONSTANT(HISTOGRAM_GJK_ITERATIONS);
+	BIND_ENUM_CONSTANT(HISTOGRAM_ISLAND_SIZE);
 
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_RECYCLE_RADIUS);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_MAX_SEPARATION);
@@ -1148,10 +1298,12 @@ PhysicsServer3D::PhysicsServer3D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/sleep_threshold_angular", PROPERTY_HINT_RANGE, "0,90,0.1,radians_as_degrees"), Math::deg_to_rad(8.0));
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/time_before_sleep", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"), 0.5);
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"), 16);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/contact_solver", PROPERTY_HINT_ENUM, "Scalar,SIMD"), 0);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_recycle_radius", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.05);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.001,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
+	GLOBAL_DEF("physics/3d/performance_monitors", false);
 }
 
 PhysicsServer3D::~PhysicsServer3D() {
@@ -127,9 +127,11 @@ class PhysicsDirectSpaceState3D : public Object {
 
 private:
 	Dictionary _intersect_ray(RequiredParam<PhysicsRayQueryParameters3D> rp_ray_query);
+	Dictionary _intersect_rays(RequiredParam<PhysicsRayQueryParameters3D> rp_ray_query, const Vector<Vector3> &p_from, const Vector<Vector3> &p_to);
 	TypedArray<Dictionary> _intersect_point(RequiredParam<PhysicsPointQueryParameters3D> rp_point_query, int p_max_results = 32);
 	TypedArray<Dictionary> _intersect_shape(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query, int p_max_results = 32);
 	Vector<real_t> _cast_motion(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query);
+	Vector<real_t> _cast_motions(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query, const TypedArray<Transform3D> &p_transforms);
 	TypedArray<Vector3> _collide_shape(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(RequiredParam<PhysicsShapeQueryParameters3D> rp_shape_query);
 
@@ -163,6 +165,9 @@ public:
 	};
 
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) = 0;
+	// Casts p_ray_count rays sharing p_parameters, except for their end points.
+	// The default implementation calls intersect_ray() for each of them.
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits);
 
 	struct ShapeResult {
 		RID rid;
@@ -205,6 +210,9 @@ public:
 
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) = 0;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) = 0;
+	// Casts the shape of p_parameters from each of p_transforms.
+	// The default implementation calls cast_motion() for each of them.
+	virtual bool cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe);
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) = 0;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) = 0;
 
@@ -311,6 +319,11 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// Saves the bodies of the space and the contacts between them, so that the simulation
+	// can be rolled back with space_restore_state(). Only works on physics process.
+	virtual PackedByteArray space_save_state(RID p_space) const;
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state);
+
 	//missing space parameters
 
 	/* AREA API */
@@ -823,10 +836,26 @@ public:
 	enum ProcessInfo {
 		INFO_ACTIVE_OBJECTS,
 		INFO_COLLISION_PAIRS,
-		INFO_ISLAND_COUNT
+		INFO_ISLAND_COUNT,
+		INFO_BROADPHASE_TIME,
+		INFO_PAIR_GENERATION_TIME,
+		INFO_NARROWPHASE_TIME,
+		INFO_ISLAND_GENERATION_TIME,
+		INFO_SOLVE_TIME,
+		INFO_INTEGRATION_TIME,
+		INFO_CALLBACK_TIME,
+		INFO_CONTACT_COUNT,
+		INFO_GJK_QUERY_COUNT,
+		INFO_MAX_ISLAND_SIZE,
+	};
+
+	enum ProcessHistogram {
+		HISTOGRAM_GJK_ITERATIONS,
+		HISTOGRAM_ISLAND_SIZE,
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) = 0;
+	virtual PackedInt32Array get_process_histogram(ProcessHistogram p_histogram);
 
 	PhysicsServer3D();
 	~PhysicsServer3D();
@@ -1072,3 +1101,4 @@ VARIANT_ENUM_CAST(PhysicsServer3D::G6DOFJointAxisParam);
 VARIANT_ENUM_CAST(PhysicsServer3D::G6DOFJointAxisFlag);
 VARIANT_ENUM_CAST(PhysicsServer3D::AreaBodyStatus);
 VARIANT_ENUM_CAST(PhysicsServer3D::ProcessInfo);
+VARIANT_ENUM_CAST(PhysicsServer3D::ProcessHistogram);
@@ -53,11 +53,178 @@ void PhysicsServer3DWrapMT::_thread_sync() {
 	doing_sync.set();
 }
 
+void PhysicsServer3DWrapMT::_thread_step(real_t p_delta, uint64_t p_step) {
+	physics_server_3d->step(p_delta);
+
+	if (!published_bodies.is_empty()) {
+		_thread_publish_body_states(p_step);
+	}
+}
+
+/* BODY STATE PUBLISHING */
+
+void PhysicsServer3DWrapMT::_thread_publish_body_state(RID p_body) {
+	published_bodies.insert(p_body);
+}
+
+void PhysicsServer3DWrapMT::_thread_unpublish_body_state(RID p_body) {
+	published_bodies.erase(p_body);
+}
+
+void PhysicsServer3DWrapMT::_thread_publish_body_states(uint64_t p_step) {
+	BodyStateBuffer &buffer = body_state_buffers[body_state_write_buffer];
+	buffer.step = p_step;
+	buffer.states.clear();
+
+	for (const RID &body : published_bodies) {
+		BodyStateSnapshot &snapshot = buffer.states[body];
+		snapshot.transform = physics_server_3d->body_get_state(body, BODY_STATE_TRANSFORM);
+		snapshot.linear_velocity = physics_server_3d->body_get_state(body, BODY_STATE_LINEAR_VELOCITY);
+		snapshot.angular_velocity = physics_server_3d->body_get_state(body, BODY_STATE_ANGULAR_VELOCITY);
+		snapshot.sleeping = physics_server_3d->body_get_state(body, BODY_STATE_SLEEPING);
+	}
+
+	body_state_write_buffer = body_state_ready_buffer.exchange(body_state_write_buffer | BODY_STATE_BUFFER_FRESH, std::memory_order_acq_rel) & ~BODY_STATE_BUFFER_FRESH;
+}
+
+bool PhysicsServer3DWrapMT::_get_published_body_state(RID p_body, BodyState p_state, Variant &r_value) const {
+	if (p_state == BODY_STATE_CAN_SLEEP) {
+		return false;
+	}
+
+	if (has_unpublished_bodies.is_set()) {
+		_flush_unpublished_body_states();
+	}
+
+	if (!requested_bodies.has(p_body)) {
+		// Published from the next step on, this time the caller has to wait.
+		requested_bodies.insert(p_body);
+		command_queue.push(const_cast<PhysicsServer3DWrapMT *>(this), &PhysicsServer3DWrapMT::_thread_publish_body_state, p_body);
+		return false;
+	}
+
+	if (body_state_ready_buffer.load(std::memory_order_acquire) & BODY_STATE_BUFFER_FRESH) {
+		body_state_read_buffer = body_state_ready_buffer.exchange(body_state_read_buffer, std::memory_order_acq_rel) & ~BODY_STATE_BUFFER_FRESH;
+	}
+
+	const BodyStateBuffer &buffer = body_state_buffers[body_state_read_buffer];
+	const BodyStateSnapshot *snapshot = buffer.states.getptr(p_body);
+	if (snapshot == nullptr) {
+		return false;
+	}
+
+	if (buffer.step < all_bodies_dirty_step.get()) {
+		return false;
+	}
+
+	const uint64_t *dirty_step = dirty_bodies.getptr(p_body);
+	if (dirty_step != nullptr) {
+		if (buffer.step < *dirty_step) {
+			return false;
+		}
+		const_cast<PhysicsServer3DWrapMT *>(this)->dirty_bodies.erase(p_body);
+	}
+
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM: {
+			r_value = snapshot->transform;
+		} break;
+		case BODY_STATE_LINEAR_VELOCITY: {
+			r_value = snapshot->linear_velocity;
+		} break;
+		case BODY_STATE_ANGULAR_VELOCITY: {
+			r_value = snapshot->angular_velocity;
+		} break;
+		case BODY_STATE_SLEEPING: {
+			r_value = snapshot->sleeping;
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void PhysicsServer3DWrapMT::_mark_body_state_dirty(RID p_body) {
+	if (!create_thread) {
+		return;
+	}
+
+	// The writes are processed before the next step, whose state is published after it.
+	const uint64_t step = pushed_steps.get() + 1;
+	if (Thread::is_main_thread()) {
+		if (requested_bodies.has(p_body)) {
+			dirty_bodies[p_body] = step;
+		}
+	} else {
+		all_bodies_dirty_step.exchange_if_greater(step);
+	}
+}
+
+void PhysicsServer3DWrapMT::_unpublish_body_state(RID p_body) {
+	if (!create_thread) {
+		return;
+	}
+
+	if (Thread::is_main_thread()) {
+		if (!requested_bodies.erase(p_body)) {
+			return;
+		}
+		dirty_bodies.erase(p_body);
+	} else {
+		MutexLock lock(unpublished_bodies_mutex);
+		unpublished_bodies.push_back(p_body);
+		has_unpublished_bodies.set();
+	}
+	command_queue.push(this, &PhysicsServer3DWrapMT::_thread_unpublish_body_state, p_body);
+}
+
+void PhysicsServer3DWrapMT::_flush_unpublished_body_states() const {
+	PhysicsServer3DWrapMT *self = const_cast<PhysicsServer3DWrapMT *>(this);
+	MutexLock lock(self->unpublished_bodies_mutex);
+	for (const RID &body : self->unpublished_bodies) {
+		requested_bodies.erase(body);
+		self->dirty_bodies.erase(body);
+	}
+	self->unpublished_bodies.clear();
+	self->has_unpublished_bodies.clear();
+}
+
+void PhysicsServer3DWrapMT::_refresh_published_body_states() {
+	if (has_unpublished_bodies.is_set()) {
+		_flush_unpublished_body_states();
+	}
+
+	if (requested_bodies.is_empty()) {
+		return;
+	}
+
+	// Writes through direct body states (e.g. in _integrate_forces()) don't go through the
+	// wrapper, so the states read until the next step is published are taken from the bodies
+	// while the physics thread still waits. Writes queued during the sync are still dirty.
+	if (body_state_ready_buffer.load(std::memory_order_acquire) & BODY_STATE_BUFFER_FRESH) {
+		body_state_read_buffer = body_state_ready_buffer.exchange(body_state_read_buffer, std::memory_order_acq_rel) & ~BODY_STATE_BUFFER_FRESH;
+	}
+
+	BodyStateBuffer &buffer = body_state_buffers[body_state_read_buffer];
+	for (const RID &body : requested_bodies) {
+		BodyStateSnapshot *snapshot = buffer.states.getptr(body);
+		if (snapshot == nullptr) {
+			continue;
+		}
+		snapshot->transform = physics_server_3d->body_get_state(body, BODY_STATE_TRANSFORM);
+		snapshot->linear_velocity = physics_server_3d->body_get_state(body, BODY_STATE_LINEAR_VELOCITY);
+		snapshot->angular_velocity = physics_server_3d->body_get_state(body, BODY_STATE_ANGULAR_VELOCITY);
+		snapshot->sleeping = physics_server_3d->body_get_state(body, BODY_STATE_SLEEPING);
+	}
+}
+
 /* EVENT QUEUING */
 
 void PhysicsServer3DWrapMT::step(real_t p_step) {
 	if (create_thread) {
-		command_queue.push(physics_server_3d, &PhysicsServer3D::step, p_step);
+		command_queue.push(this, &PhysicsServer3DWrapMT::_thread_step, p_step, pushed_steps.increment());
 	} else {
 		physics_server_3d->step(p_step);
 	}
@@ -80,6 +247,7 @@ void PhysicsServer3DWrapMT::end_sync() {
 	physics_server_3d->end_sync();
 
 	if (create_thread) {
+		_refresh_published_body_states();
 		doing_sync.clear();
 	}
 }
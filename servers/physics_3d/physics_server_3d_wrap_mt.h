@@ -32,8 +32,10 @@
 
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
 #include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
+#include "core/templates/local_vector.h"
 #include "servers/physics_3d/physics_server_3d.h"
 
 #define ASYNC_COND_PUSH (Thread::get_caller_id() != server_thread)
@@ -67,9 +69,55 @@ class PhysicsServer3DWrapMT : public PhysicsServer3D {
 	bool create_thread = false;
 	SafeFlag doing_sync;
 
+	// The state of the bodies queried from the main thread is published by the physics thread
+	// after each step, so that body_get_state() can return it without waiting for the physics
+	// thread to finish its current work. Buffers are tripled: the physics thread fills one while
+	// the main thread reads another, and they exchange them through the latest complete one.
+	struct BodyStateSnapshot {
+		Transform3D transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		bool sleeping = false;
+	};
+
+	struct BodyStateBuffer {
+		HashMap<RID, BodyStateSnapshot> states;
+		uint64_t step = 0;
+	};
+
+	static constexpr uint32_t BODY_STATE_BUFFER_FRESH = 4;
+
+	BodyStateBuffer body_state_buffers[3];
+	uint32_t body_state_write_buffer = 0; // Physics thread only.
+	mutable uint32_t body_state_read_buffer = 1; // Main thread only.
+	mutable std::atomic<uint32_t> body_state_ready_buffer = { 2 };
+
+	HashSet<RID> published_bodies; // Physics thread only.
+	mutable HashSet<RID> requested_bodies; // Main thread only.
+
+	// Bodies freed from other threads, removed from requested_bodies by the main thread.
+	Mutex unpublished_bodies_mutex;
+	LocalVector<RID> unpublished_bodies;
+	SafeFlag has_unpublished_bodies;
+
+	// Bodies written since the step whose state is published. Reads fall back to waiting
+	// for the physics thread until the state published includes the writes.
+	HashMap<RID, uint64_t> dirty_bodies; // Main thread only.
+	SafeNumeric<uint64_t> all_bodies_dirty_step;
+	SafeNumeric<uint64_t> pushed_steps;
+
+	bool _get_published_body_state(RID p_body, BodyState p_state, Variant &r_value) const;
+	void _mark_body_state_dirty(RID p_body);
+	void _unpublish_body_state(RID p_body);
+	void _flush_unpublished_body_states() const;
+	void _refresh_published_body_states();
+
 	void _assign_mt_ids(WorkerThreadPool::TaskID p_pump_task_id);
 	void _thread_exit();
-	void _thread_step(real_t p_delta);
+	void _thread_step(real_t p_delta, uint64_t p_step);
+	void _thread_publish_body_state(RID p_body);
+	void _thread_unpublish_body_state(RID p_body);
+	void _thread_publish_body_states(uint64_t p_step);
 	void _thread_loop();
 	void _thread_sync();
 
@@ -124,6 +172,18 @@ public:
 		return physics_server_3d->space_get_direct_state(p_space);
 	}
 
+	// These only work on physics process, like space_get_direct_state().
+	virtual PackedByteArray space_save_state(RID p_space) const override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), PackedByteArray());
+		return physics_server_3d->space_save_state(p_space);
+	}
+
+	virtual bool space_restore_state(RID p_space, const PackedByteArray &p_state) override {
+		ERR_FAIL_COND_V(!Thread::is_main_thread(), false);
+		all_bodies_dirty_step.exchange_if_greater(pushed_steps.get() + 1);
+		return physics_server_3d->space_restore_state(p_space, p_state);
+	}
+
 	FUNC2(space_set_debug_contacts, RID, int);
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override {
 		ERR_FAIL_COND_V(!Thread::is_main_thread(), Vector<Vector3>());
@@ -180,11 +240,16 @@ public:
 	//FUNC2RID(body,BodyMode,bool);
 	FUNCRID(body)
 
+	// Changes the state published to the main thread, see _mark_body_state_dirty().
+#undef WRITE_ACTION
+#define WRITE_ACTION _mark_body_state_dirty(p1);
 	FUNC2(body_set_space, RID, RID);
 	FUNC1RC(RID, body_get_space, RID);
 
 	FUNC2(body_set_mode, RID, BodyMode);
 	FUNC1RC(BodyMode, body_get_mode, RID);
+#undef WRITE_ACTION
+#define WRITE_ACTION
 
 	FUNC4(body_add_shape, RID, RID, const Transform3D &, bool);
 	FUNC3(body_set_shape, RID, int, RID);
@@ -222,12 +287,34 @@ public:
 
 	FUNC1(body_reset_mass_properties, RID);
 
+	// Changes the state published to the main thread, see _mark_body_state_dirty().
+#undef WRITE_ACTION
+#define WRITE_ACTION _mark_body_state_dirty(p1);
 	FUNC3(body_set_state, RID, BodyState, const Variant &);
-	FUNC2RC(Variant, body_get_state, RID, BodyState);
+	FUNC2(body_set_axis_velocity, RID, const Vector3 &);
 
 	FUNC2(body_apply_torque_impulse, RID, const Vector3 &);
 	FUNC2(body_apply_central_impulse, RID, const Vector3 &);
 	FUNC3(body_apply_impulse, RID, const Vector3 &, const Vector3 &);
+#undef WRITE_ACTION
+#define WRITE_ACTION
+
+	// Reads the state published by the physics thread when possible, see _get_published_body_state().
+	virtual Variant body_get_state(RID p_body, BodyState p_state) const override {
+		if (ASYNC_COND_PUSH_AND_RET) {
+			Variant ret;
+			if (Thread::is_main_thread() && _get_published_body_state(p_body, p_state, ret)) {
+				return ret;
+			}
+			command_queue.push_and_ret(physics_server_3d, &PhysicsServer3D::body_get_state, &ret, p_body, p_state);
+			SYNC_DEBUG
+			MAIN_THREAD_SYNC_CHECK
+			return ret;
+		} else {
+			command_queue.flush_if_pending();
+			return physics_server_3d->body_get_state(p_body, p_state);
+		}
+	}
 
 	FUNC2(body_apply_central_force, RID, const Vector3 &);
 	FUNC3(body_apply_force, RID, const Vector3 &, const Vector3 &);
@@ -248,8 +335,6 @@ public:
 	FUNC2(body_set_constant_torque, RID, const Vector3 &);
 	FUNC1RC(Vector3, body_get_constant_torque, RID);
 
-	FUNC2(body_set_axis_velocity, RID, const Vector3 &);
-
 	FUNC3(body_set_axis_lock, RID, BodyAxis, bool);
 	FUNC2RC(bool, body_is_axis_locked, RID, BodyAxis);
 
@@ -394,7 +479,15 @@ public:
 
 	/* MISC */
 
-	FUNC1(free_rid, RID);
+	virtual void free_rid(RID p_rid) override {
+		_unpublish_body_state(p_rid);
+		if (ASYNC_COND_PUSH) {
+			command_queue.push(physics_server_3d, &PhysicsServer3D::free_rid, p_rid);
+		} else {
+			command_queue.flush_if_pending();
+			physics_server_3d->free_rid(p_rid);
+		}
+	}
 	FUNC1(set_active, bool);
 
 	virtual void init() override;
@@ -412,6 +505,10 @@ public:
 		return physics_server_3d->get_process_info(p_info);
 	}
 
+	PackedInt32Array get_process_histogram(ProcessHistogram p_histogram) override {
+		return physics_server_3d->get_process_histogram(p_histogram);
+	}
+
 	PhysicsServer3DWrapMT(PhysicsServer3D *p_contained, bool p_create_thread);
 	~PhysicsServer3DWrapMT();
 
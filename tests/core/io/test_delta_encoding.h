@@ -0,0 +1,140 @@
+/**************************************************************************/
+/*  test_delta_encoding.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/delta_encoding.h"
+#include "core/io/marshalls.h"
+#include "core/math/random_pcg.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDeltaEncoding {
+
+static Vector<uint8_t> make_random_data(int p_size, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	Vector<uint8_t> data;
+	data.resize(p_size);
+	for (int i = 0; i < p_size; i++) {
+		data.write[i] = rng.rand() & 0xff;
+	}
+	return data;
+}
+
+TEST_CASE("[DeltaEncoding] Encode and decode delta") {
+	const Vector<uint8_t> old_data = make_random_data(64 * 1024, 1);
+	Vector<uint8_t> new_data = old_data;
+	new_data.write[1000] ^= 0xff;
+
+	Vector<uint8_t> delta;
+	CHECK(DeltaEncoding::encode_delta(old_data, new_data, delta) == OK);
+	CHECK(delta.size() < new_data.size() / 10);
+
+	Vector<uint8_t> decoded;
+	CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) == OK);
+	CHECK(decoded == new_data);
+}
+
+TEST_CASE("[DeltaEncoding] Encode and decode chunked delta") {
+	const Vector<uint8_t> old_data = make_random_data(1024 * 1024, 2);
+
+	SUBCASE("Identical data") {
+		Vector<uint8_t> delta;
+		CHECK(DeltaEncoding::encode_chunked_delta(old_data, old_data, delta) == OK);
+		CHECK_MESSAGE(delta.size() < 1024, "Unchanged data should only produce copy operations.");
+
+		Vector<uint8_t> decoded;
+		CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) == OK);
+		CHECK(decoded == old_data);
+	}
+
+	SUBCASE("Insertion shifting the rest of the data") {
+		// Chunk boundaries are content-defined, so data after the insertion should still be matched.
+		const Vector<uint8_t> inserted = make_random_data(3000, 3);
+		Vector<uint8_t> new_data = old_data.slice(0, 500 * 1024);
+		new_data.append_array(inserted);
+		new_data.append_array(old_data.slice(500 * 1024));
+
+		Vector<uint8_t> delta;
+		CHECK(DeltaEncoding::encode_chunked_delta(old_data, new_data, delta) == OK);
+		CHECK(delta.size() < 256 * 1024);
+
+		Vector<uint8_t> decoded;
+		CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) == OK);
+		CHECK(decoded == new_data);
+	}
+
+	SUBCASE("Empty data") {
+		Vector<uint8_t> delta;
+		CHECK(DeltaEncoding::encode_chunked_delta(old_data, Vector<uint8_t>(), delta) == OK);
+
+		Vector<uint8_t> decoded;
+		CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) == OK);
+		CHECK(decoded.is_empty());
+	}
+
+	SUBCASE("Corrupted delta") {
+		Vector<uint8_t> delta;
+		CHECK(DeltaEncoding::encode_chunked_delta(old_data, old_data, delta) == OK);
+
+		Vector<uint8_t> decoded;
+		ERR_PRINT_OFF;
+		CHECK(DeltaEncoding::decode_delta(Vector<uint8_t>(), delta, decoded) != OK);
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("Truncated delta") {
+		Vector<uint8_t> delta;
+		CHECK(DeltaEncoding::encode_chunked_delta(old_data, old_data, delta) == OK);
+		delta.resize(delta.size() - 8);
+
+		Vector<uint8_t> decoded;
+		ERR_PRINT_OFF;
+		CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) != OK);
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("New size not matching the operations") {
+		Vector<uint8_t> delta;
+		CHECK(DeltaEncoding::encode_chunked_delta(old_data, old_data, delta) == OK);
+
+		// The new size follows the 5-byte header. A huge size must be rejected before allocating.
+		Vector<uint8_t> decoded;
+		ERR_PRINT_OFF;
+		encode_uint64(UINT64_MAX, delta.ptrw() + 5);
+		CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) != OK);
+		encode_uint64(old_data.size() - 1, delta.ptrw() + 5);
+		CHECK(DeltaEncoding::decode_delta(old_data, delta, decoded) != OK);
+		ERR_PRINT_ON;
+		CHECK(decoded.is_empty());
+	}
+}
+
+} // namespace TestDeltaEncoding
@@ -32,6 +32,7 @@
 
 #include "core/io/json.h"
 
+#include "tests/test_utils.h"
 #include "thirdparty/doctest/doctest.h"
 
 namespace TestJSON {
@@ -423,4 +424,190 @@ TEST_CASE("[JSON] Serialization") {
 		}
 	}
 }
+TEST_CASE("[JSON] UTF-8 buffer") {
+	const String json_text = String::utf8("{\n\t\"name\": \"Gödöllő \\u00e9\\ud83d\\ude00\",\n\t\"list\": [1, 2.5, -3e2, true, false, null, \"\"],\n\t\"nested\": {\"key\": \"line\\nbreak\"}\n}");
+
+	SUBCASE("Parsing matches String parsing") {
+		JSON json_string;
+		REQUIRE(json_string.parse(json_text) == OK);
+		JSON json_buffer;
+		REQUIRE(json_buffer.parse_utf8_buffer(json_text.to_utf8_buffer()) == OK);
+		CHECK(json_buffer.get_data() == json_string.get_data());
+
+		Dictionary dictionary = json_buffer.get_data();
+		CHECK(String(dictionary["name"]) == String::utf8("Gödöllő é😀"));
+		CHECK(Dictionary(dictionary["nested"])["key"] == "line\nbreak");
+	}
+
+	SUBCASE("Byte order mark is skipped") {
+		Vector<uint8_t> buffer = { 0xef, 0xbb, 0xbf, '[', '1', ']' };
+		JSON json;
+		CHECK(json.parse_utf8_buffer(buffer) == OK);
+		CHECK(json.get_data() == Variant(Array({ 1.0 })));
+	}
+
+	SUBCASE("Errors match String parsing") {
+		const char *invalid[] = { "", "[1, 2", "{\"a\" 1}", "\"unterminated", "\"\\ud800\"", "[tru]", "[1] 2", "\n\n[1,,]" };
+		ERR_PRINT_OFF
+		for (const char *text : invalid) {
+			JSON json_string;
+			const Error err = json_string.parse(String::utf8(text));
+			JSON json_buffer;
+			CHECK_MESSAGE(json_buffer.parse_utf8_buffer(String::utf8(text).to_utf8_buffer()) == err, text);
+			if (*text) {
+				CHECK_MESSAGE(json_buffer.get_error_message() == json_string.get_error_message(), text);
+				CHECK_MESSAGE(json_buffer.get_error_line() == json_string.get_error_line(), text);
+			}
+		}
+		ERR_PRINT_ON
+	}
+
+	SUBCASE("Stringify matches String stringify") {
+		JSON json;
+		REQUIRE(json.parse(json_text) == OK);
+		for (const String &indent : { String(), String("\t"), String::utf8("→ ") }) {
+			const String expected = JSON::stringify(json.get_data(), indent);
+			CHECK(JSON::stringify_to_utf8_buffer(json.get_data(), indent) == expected.to_utf8_buffer());
+		}
+		CHECK(JSON::stringify_to_utf8_buffer("\\\b\f\n\r\t\v\"") == JSON::stringify("\\\b\f\n\r\t\v\"").to_utf8_buffer());
+	}
+}
+
+TEST_CASE("[JSON] Stream parser") {
+	const String json_text = "{\"records\": [{\"id\": 1, \"tags\": [\"a\", \"b\"]}, {\"id\": 2, \"tags\": []}], \"count\": 2}";
+	const Vector<uint8_t> json_buffer = json_text.to_utf8_buffer();
+
+	const JSONStreamParser::EventType expected_events[] = {
+		JSONStreamParser::EVENT_OBJECT_BEGIN,
+		JSONStreamParser::EVENT_KEY,
+		JSONStreamParser::EVENT_ARRAY_BEGIN,
+		JSONStreamParser::EVENT_OBJECT_BEGIN,
+		JSONStreamParser::EVENT_KEY,
+		JSONStreamParser::EVENT_VALUE,
+		JSONStreamParser::EVENT_KEY,
+		JSONStreamParser::EVENT_ARRAY_BEGIN,
+		JSONStreamParser::EVENT_VALUE,
+		JSONStreamParser::EVENT_VALUE,
+		JSONStreamParser::EVENT_ARRAY_END,
+		JSONStreamParser::EVENT_OBJECT_END,
+		JSONStreamParser::EVENT_OBJECT_BEGIN,
+		JSONStreamParser::EVENT_KEY,
+		JSONStreamParser::EVENT_VALUE,
+		JSONStreamParser::EVENT_KEY,
+		JSONStreamParser::EVENT_ARRAY_BEGIN,
+		JSONStreamParser::EVENT_ARRAY_END,
+		JSONStreamParser::EVENT_OBJECT_END,
+		JSONStreamParser::EVENT_ARRAY_END,
+		JSONStreamParser::EVENT_KEY,
+		JSONStreamParser::EVENT_VALUE,
+		JSONStreamParser::EVENT_OBJECT_END,
+	};
+	const int expected_count = std_size(expected_events);
+
+	SUBCASE("Buffer") {
+		Ref<JSONStreamParser> parser;
+		parser.instantiate();
+		REQUIRE(parser->open_buffer(json_buffer) == OK);
+
+		int count = 0;
+		Array values;
+		while (parser->read() == OK) {
+			REQUIRE(count < expected_count);
+			CHECK(parser->get_event_type() == expected_events[count]);
+			if (parser->get_event_type() == JSONStreamParser::EVENT_KEY || parser->get_event_type() == JSONStreamParser::EVENT_VALUE) {
+				values.push_back(parser->get_value());
+			}
+			count++;
+		}
+		CHECK(count == expected_count);
+		CHECK(parser->get_depth() == 0);
+		CHECK(parser->read() == ERR_FILE_EOF);
+		CHECK(values == Array({ "records", "id", 1.0, "tags", "a", "b", "id", 2.0, "tags", "count", 2.0 }));
+	}
+
+	SUBCASE("Fed one byte at a time") {
+		Ref<JSONStreamParser> parser;
+		parser.instantiate();
+
+		int count = 0;
+		Error err = OK;
+		for (int i = 0; i <= json_buffer.size(); i++) {
+			if (i < json_buffer.size()) {
+				parser->feed(json_buffer.slice(i, i + 1));
+			} else {
+				parser->finish();
+			}
+			while ((err = parser->read()) == OK) {
+				REQUIRE(count < expected_count);
+				CHECK(parser->get_event_type() == expected_events[count]);
+				count++;
+			}
+			REQUIRE_MESSAGE((err == ERR_UNAVAILABLE || err == ERR_FILE_EOF), parser->get_error_message());
+		}
+		CHECK(err == ERR_FILE_EOF);
+		CHECK(count == expected_count);
+	}
+
+	SUBCASE("File") {
+		const String path = TestUtils::get_temp_path("stream_parser.json");
+		{
+			Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+			REQUIRE(f.is_valid());
+			// Large enough to be read in several chunks.
+			f->store_string("[");
+			for (int i = 0; i < 20000; i++) {
+				f->store_string(i == 0 ? "{\"value\": 0.5}" : ", {\"value\": 0.5}");
+			}
+			f->store_string("]");
+		}
+
+		Ref<JSONStreamParser> parser;
+		parser.instantiate();
+		REQUIRE(parser->open(path) == OK);
+		REQUIRE(parser->read() == OK);
+		CHECK(parser->get_event_type() == JSONStreamParser::EVENT_ARRAY_BEGIN);
+
+		int objects = 0;
+		double total = 0.0;
+		while (parser->read() == OK) {
+			if (parser->get_event_type() == JSONStreamParser::EVENT_VALUE) {
+				total += double(parser->get_value());
+			} else if (parser->get_event_type() == JSONStreamParser::EVENT_OBJECT_END) {
+				objects++;
+			}
+		}
+		CHECK(parser->get_error_message().is_empty());
+		CHECK(objects == 20000);
+		CHECK(total == doctest::Approx(10000.0));
+	}
+
+	SUBCASE("Skip section") {
+		Ref<JSONStreamParser> parser;
+		parser.instantiate();
+		REQUIRE(parser->open_buffer(json_buffer) == OK);
+		REQUIRE(parser->read() == OK); // {
+		REQUIRE(parser->read() == OK); // "records"
+		REQUIRE(parser->read() == OK); // [
+		CHECK(parser->skip_section() == OK);
+		CHECK(parser->get_event_type() == JSONStreamParser::EVENT_ARRAY_END);
+		CHECK(parser->get_depth() == 1);
+		REQUIRE(parser->read() == OK);
+		CHECK(parser->get_event_type() == JSONStreamParser::EVENT_KEY);
+		CHECK(parser->get_value() == "count");
+	}
+
+	SUBCASE("Errors") {
+		Ref<JSONStreamParser> parser;
+		parser.instantiate();
+		REQUIRE(parser->open_buffer(String("{\"a\": 1\n\"b\": 2}").to_utf8_buffer()) == OK);
+		CHECK(parser->read() == OK);
+		CHECK(parser->read() == OK);
+		CHECK(parser->read() == OK);
+		CHECK(parser->read() == ERR_PARSE_ERROR);
+		CHECK(parser->get_error_message() == "Expected '}' or ','");
+		CHECK(parser->get_current_line() == 1);
+		CHECK(parser->read() == ERR_PARSE_ERROR);
+	}
+}
+
 } // namespace TestJSON
@@ -489,4 +489,76 @@ TEST_CASE("[Marshalls] Typed dictionary decoding") {
 	CHECK(dictionary[Variant(uint64_t(0x0f123456789abcdef))] == Variant(uint64_t(0x0f123456789abcdef)));
 }
 
+TEST_CASE("[Marshalls] Packed array encoding") {
+	PackedInt32Array array;
+	array.push_back(0x01234567);
+	array.push_back(-2);
+	int r_len;
+	uint8_t buffer[16];
+
+	CHECK(encode_variant(array, nullptr, r_len) == OK);
+	CHECK_MESSAGE(r_len == 16, "Length == 4 bytes for header + 4 bytes for size + 4 bytes per element");
+	CHECK(encode_variant(array, buffer, r_len) == OK);
+	CHECK_MESSAGE(buffer[0] == 0x1e, "Variant::PACKED_INT32_ARRAY");
+	CHECK(buffer[1] == 0x00);
+	CHECK(buffer[2] == 0x00);
+	CHECK(buffer[3] == 0x00);
+	// Check size.
+	CHECK(buffer[4] == 0x02);
+	CHECK(buffer[5] == 0x00);
+	CHECK(buffer[6] == 0x00);
+	CHECK(buffer[7] == 0x00);
+	// Check elements, stored as little-endian.
+	CHECK(buffer[8] == 0x67);
+	CHECK(buffer[9] == 0x45);
+	CHECK(buffer[10] == 0x23);
+	CHECK(buffer[11] == 0x01);
+	CHECK(buffer[12] == 0xfe);
+	CHECK(buffer[13] == 0xff);
+	CHECK(buffer[14] == 0xff);
+	CHECK(buffer[15] == 0xff);
+}
+
+TEST_CASE("[Marshalls] Packed array round trip") {
+	const int count = 1000;
+	PackedByteArray bytes;
+	PackedInt64Array int64s;
+	PackedFloat32Array float32s;
+	PackedFloat64Array float64s;
+	PackedVector2Array vector2s;
+	PackedVector3Array vector3s;
+	PackedVector4Array vector4s;
+	PackedColorArray colors;
+	for (int i = 0; i < count; i++) {
+		bytes.push_back(i * 7);
+		int64s.push_back(int64_t(i) * 0x100000001LL - 500);
+		float32s.push_back(i * 0.25f);
+		float64s.push_back(i / 3.0);
+		vector2s.push_back(Vector2(i, -i));
+		vector3s.push_back(Vector3(i, i * 0.5, -i));
+		vector4s.push_back(Vector4(i, i + 1, i + 2, i + 3));
+		colors.push_back(Color(i / 1000.0f, 0.5f, 1.0f, 0.25f));
+	}
+	// An odd byte count exercises the padding after the payload.
+	bytes.push_back(0xff);
+
+	Array arrays = { bytes, int64s, float32s, float64s, vector2s, vector3s, vector4s, colors, PackedVector3Array() };
+	for (const Variant &array : arrays) {
+		int len;
+		REQUIRE(encode_variant(array, nullptr, len) == OK);
+		Vector<uint8_t> buffer;
+		buffer.resize(len);
+		int written_len;
+		REQUIRE(encode_variant(array, buffer.ptrw(), written_len) == OK);
+		CHECK(written_len == len);
+
+		Variant decoded;
+		int r_len;
+		CHECK(decode_variant(decoded, buffer.ptr(), buffer.size(), &r_len) == OK);
+		CHECK(r_len == len);
+		CHECK(decoded.get_type() == array.get_type());
+		CHECK(decoded == array);
+	}
+}
+
 } // namespace TestMarshalls
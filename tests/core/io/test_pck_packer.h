@@ -116,4 +116,185 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 27000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Pack a PCK file with duplicate contents deduplicated") {
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+	const uint64_t icon_size = FileAccess::get_file_as_bytes(base_dir.path_join("../icon.png")).size();
+
+	PCKPacker pck_packer;
+	const String output_pck_path = TestUtils::get_temp_path("output_deduplicated.pck");
+	pck_packer.set_deduplicate(true);
+	CHECK_MESSAGE(
+			pck_packer.pck_start(output_pck_path) == OK,
+			"Starting a PCK file should return an OK error code.");
+
+	CHECK(pck_packer.add_file("icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer.add_file("copies/icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer.add_file("copies/icon_again.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer.add_file("version.py", base_dir.path_join("../version.py")) == OK);
+	CHECK_MESSAGE(
+			pck_packer.add_file("missing.png", base_dir.path_join("../does_not_exist.png")) == ERR_FILE_CANT_OPEN,
+			"Missing source files should still be reported when adding them.");
+	CHECK_MESSAGE(
+			pck_packer.flush() == OK,
+			"Flushing the PCK should return an OK error code.");
+
+	CHECK_MESSAGE(
+			pck_packer.get_deduplicated_size() == icon_size * 2,
+			"Both copies of the icon should point to the first one.");
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(output_pck_path, FileAccess::READ, &err);
+	CHECK_MESSAGE(
+			err == OK,
+			"The generated deduplicated PCK file should be opened successfully.");
+	CHECK_MESSAGE(
+			f->get_length() < icon_size * 2,
+			"The icon contents should only be stored once.");
+}
+
+TEST_CASE("[PCKPacker] Create a patch from two packs") {
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+	const String icon_path = base_dir.path_join("../icon.png");
+	Vector<uint8_t> icon_data = FileAccess::get_file_as_bytes(icon_path);
+	REQUIRE(icon_data.size() > 1024);
+
+	// Modified copy of the icon, with a few bytes changed.
+	icon_data.write[icon_data.size() / 2] ^= 0xff;
+	const String modified_icon_path = TestUtils::get_temp_path("modified_icon.png");
+	{
+		Ref<FileAccess> f = FileAccess::open(modified_icon_path, FileAccess::WRITE);
+		f->store_buffer(icon_data);
+	}
+
+	const String base_pck_path = TestUtils::get_temp_path("patch_base.pck");
+	{
+		PCKPacker pck_packer;
+		CHECK(pck_packer.pck_start(base_pck_path) == OK);
+		CHECK(pck_packer.add_file("icon.png", icon_path) == OK);
+		CHECK(pck_packer.add_file("removed.py", base_dir.path_join("../version.py")) == OK);
+		CHECK(pck_packer.add_file("unchanged.svg", base_dir.path_join("../icon.svg")) == OK);
+		CHECK(pck_packer.flush() == OK);
+	}
+
+	const String new_pck_path = TestUtils::get_temp_path("patch_new.pck");
+	{
+		PCKPacker pck_packer;
+		CHECK(pck_packer.pck_start(new_pck_path) == OK);
+		CHECK(pck_packer.add_file("icon.png", modified_icon_path) == OK);
+		CHECK(pck_packer.add_file("unchanged.svg", base_dir.path_join("../icon.svg")) == OK);
+		CHECK(pck_packer.add_file("added.py", base_dir.path_join("../version.py")) == OK);
+		CHECK(pck_packer.flush() == OK);
+	}
+
+	const String patch_pck_path = TestUtils::get_temp_path("patch.pck");
+	PCKPacker pck_packer;
+	CHECK(pck_packer.pck_start(patch_pck_path) == OK);
+	CHECK_MESSAGE(
+			pck_packer.add_pack_patch(base_pck_path, new_pck_path) == OK,
+			"Creating a patch from two packs should return an OK error code.");
+	CHECK(pck_packer.flush() == OK);
+
+	Ref<FileAccess> f = FileAccess::open(patch_pck_path, FileAccess::READ);
+	REQUIRE(f.is_valid());
+	CHECK_MESSAGE(
+			f->get_length() < FileAccess::get_file_as_bytes(new_pck_path).size(),
+			"The patch should be smaller than the new pack, as unchanged files are skipped and changed ones delta encoded.");
+	f.unref();
+
+	// Loading the patch over the base pack should give the contents of the new pack.
+	PackedData *packed_data = PackedData::get_singleton();
+	REQUIRE(packed_data != nullptr);
+	CHECK(packed_data->add_pack(base_pck_path, true, 0) == OK);
+	CHECK(packed_data->add_pack(patch_pck_path, true, 0) == OK);
+
+	CHECK_MESSAGE(
+			packed_data->has_delta_patches("res://icon.png"),
+			"The changed file should be stored as a delta.");
+	Ref<FileAccess> patched_icon = packed_data->try_open_path("res://icon.png");
+	REQUIRE(patched_icon.is_valid());
+	CHECK(patched_icon->get_buffer(patched_icon->get_length()) == icon_data);
+
+	Ref<FileAccess> unchanged_svg = packed_data->try_open_path("res://unchanged.svg");
+	REQUIRE(unchanged_svg.is_valid());
+	CHECK(unchanged_svg->get_buffer(unchanged_svg->get_length()) == FileAccess::get_file_as_bytes(base_dir.path_join("../icon.svg")));
+
+	Ref<FileAccess> added_py = packed_data->try_open_path("res://added.py");
+	REQUIRE(added_py.is_valid());
+	CHECK(added_py->get_buffer(added_py->get_length()) == FileAccess::get_file_as_bytes(base_dir.path_join("../version.py")));
+
+	CHECK_FALSE(packed_data->has_path("res://removed.py"));
+
+	packed_data->clear();
+}
+
+TEST_CASE("[PCKPacker] Reject a corrupted delta in a patch") {
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+	const String icon_path = base_dir.path_join("../icon.png");
+	Vector<uint8_t> icon_data = FileAccess::get_file_as_bytes(icon_path);
+	REQUIRE(icon_data.size() > 1024);
+
+	icon_data.write[icon_data.size() / 2] ^= 0xff;
+	const String modified_icon_path = TestUtils::get_temp_path("corrupted_patch_icon.png");
+	{
+		Ref<FileAccess> f = FileAccess::open(modified_icon_path, FileAccess::WRITE);
+		f->store_buffer(icon_data);
+	}
+
+	const String base_pck_path = TestUtils::get_temp_path("corrupted_patch_base.pck");
+	{
+		PCKPacker pck_packer;
+		CHECK(pck_packer.pck_start(base_pck_path) == OK);
+		CHECK(pck_packer.add_file("icon.png", icon_path) == OK);
+		CHECK(pck_packer.flush() == OK);
+	}
+
+	const String new_pck_path = TestUtils::get_temp_path("corrupted_patch_new.pck");
+	{
+		PCKPacker pck_packer;
+		CHECK(pck_packer.pck_start(new_pck_path) == OK);
+		CHECK(pck_packer.add_file("icon.png", modified_icon_path) == OK);
+		CHECK(pck_packer.flush() == OK);
+	}
+
+	const String patch_pck_path = TestUtils::get_temp_path("corrupted_patch.pck");
+	{
+		PCKPacker pck_packer;
+		CHECK(pck_packer.pck_start(patch_pck_path) == OK);
+		CHECK(pck_packer.add_pack_patch(base_pck_path, new_pck_path) == OK);
+		CHECK(pck_packer.flush() == OK);
+	}
+
+	// Flip a byte in the compressed data of the delta, right after its header.
+	Vector<uint8_t> patch_data = FileAccess::get_file_as_bytes(patch_pck_path);
+	int64_t delta_offset = -1;
+	for (int64_t i = 0; i + 4 < patch_data.size(); i++) {
+		if (memcmp(patch_data.ptr() + i, "GDDL", 4) == 0) {
+			delta_offset = i;
+			break;
+		}
+	}
+	REQUIRE_MESSAGE(delta_offset >= 0, "The changed file should be stored as a delta.");
+	REQUIRE(delta_offset + 16 < patch_data.size());
+	patch_data.write[delta_offset + 16] ^= 0xff;
+	{
+		Ref<FileAccess> f = FileAccess::open(patch_pck_path, FileAccess::WRITE);
+		f->store_buffer(patch_data);
+	}
+
+	PackedData *packed_data = PackedData::get_singleton();
+	REQUIRE(packed_data != nullptr);
+	CHECK(packed_data->add_pack(base_pck_path, true, 0) == OK);
+
+	CHECK(packed_data->add_pack(patch_pck_path, true, 0) == OK);
+
+	ERR_PRINT_OFF;
+	Ref<FileAccess> patched_icon = packed_data->try_open_path("res://icon.png");
+	CHECK_MESSAGE(
+			(patched_icon.is_null() || patched_icon->get_buffer(patched_icon->get_length()) != icon_data),
+			"A corrupted delta should never be applied.");
+	ERR_PRINT_ON;
+
+	packed_data->clear();
+}
 } // namespace TestPCKPacker
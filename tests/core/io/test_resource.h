@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "core/io/image.h"
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
@@ -627,4 +628,63 @@ TEST_CASE("[Resource] Breaking circular references on save") {
 	// Break circular reference to avoid memory leak
 	resource_c->remove_meta("next");
 }
+
+TEST_CASE("[Resource] Retained cache tier") {
+	// Each image takes 64 * 64 * 4 = 16384 bytes.
+	Ref<Image> image = Image::create_empty(64, 64, false, Image::FORMAT_RGBA8);
+	const uint64_t image_size = image->get_memory_usage();
+	const String save_path_a = TestUtils::get_temp_path("retained_a.res");
+	const String save_path_b = TestUtils::get_temp_path("retained_b.res");
+	const String save_path_unknown = TestUtils::get_temp_path("retained_unknown.res");
+	ResourceSaver::save(image, save_path_a);
+	ResourceSaver::save(image, save_path_b);
+	Ref<Resource> unknown_size_resource;
+	unknown_size_resource.instantiate();
+	ResourceSaver::save(unknown_size_resource, save_path_unknown);
+
+	const uint64_t previous_budget = ResourceCache::get_retained_budget();
+	const uint64_t previous_resident_size = ResourceCache::get_resident_memory_usage();
+	ResourceCache::set_retained_budget(image_size + image_size / 2);
+
+	const String cached_path_a = ResourceLoader::load(save_path_a)->get_path();
+	CHECK_MESSAGE(
+			ResourceCache::has(cached_path_a),
+			"The resource should stay cached after its last reference is dropped.");
+	CHECK(ResourceCache::get_retained_resource_count() == 1);
+	CHECK(ResourceCache::get_retained_memory_usage() == image_size);
+	CHECK(ResourceCache::get_resident_memory_usage() == previous_resident_size + image_size);
+
+	HashMap<StringName, uint64_t> usage;
+	ResourceCache::get_resident_memory_usage_by_type(usage);
+	CHECK(usage.has("Image"));
+	CHECK(usage["Image"] >= image_size);
+
+	const String cached_path_b = ResourceLoader::load(save_path_b)->get_path();
+	CHECK_MESSAGE(
+			!ResourceCache::has(cached_path_a),
+			"The least recently used resource should be evicted once the budget is exceeded.");
+	CHECK(ResourceCache::has(cached_path_b));
+	CHECK(ResourceCache::get_retained_resource_count() == 1);
+	CHECK(ResourceCache::get_resident_memory_usage() == previous_resident_size + image_size);
+
+	const String cached_path_unknown = ResourceLoader::load(save_path_unknown)->get_path();
+	CHECK_MESSAGE(
+			!ResourceCache::has(cached_path_unknown),
+			"Resources of unknown size should not be retained.");
+	CHECK(ResourceCache::has(cached_path_b));
+
+	{
+		// Held elsewhere, so eviction from the retained tier must not free it.
+		Ref<Resource> held = ResourceLoader::load(save_path_b);
+		ResourceCache::clear_retained();
+		CHECK(ResourceCache::get_retained_resource_count() == 0);
+		CHECK(ResourceCache::has(cached_path_b));
+	}
+	CHECK_MESSAGE(
+			!ResourceCache::has(cached_path_b),
+			"The resource should be freed once it is neither retained nor referenced.");
+	CHECK(ResourceCache::get_resident_memory_usage() == previous_resident_size);
+
+	ResourceCache::set_retained_budget(previous_budget);
+}
 } // namespace TestResource
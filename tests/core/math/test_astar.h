@@ -31,6 +31,8 @@
 #pragma once
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
+#include "core/object/worker_thread_pool.h"
 
 #include "tests/test_macros.h"
 
@@ -211,4 +213,335 @@ TEST_CASE("[AStar3D] Add/Remove") {
 	}
 	// It's been great work, cheers. \(^ ^)/
 }
+
+struct CompactPathQueries {
+	AStar3D *astar = nullptr;
+	LocalVector<int64_t> from_ids;
+	LocalVector<int64_t> to_ids;
+	LocalVector<Vector<int64_t>> paths;
+};
+
+static void compact_path_query(void *p_userdata, uint32_t p_index) {
+	CompactPathQueries *queries = static_cast<CompactPathQueries *>(p_userdata);
+	queries->paths[p_index] = queries->astar->get_id_path(queries->from_ids[p_index], queries->to_ids[p_index]);
+}
+
+static real_t get_path_cost(const AStar3D &p_astar, const Vector<int64_t> &p_path) {
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		cost += p_astar.get_point_position(p_path[i - 1]).distance_to(p_astar.get_point_position(p_path[i])) * p_astar.get_point_weight_scale(p_path[i]);
+	}
+	return cost;
+}
+
+TEST_CASE("[AStar3D] Compact graph paths") {
+	// A grid with random weights, one way connections, missing connections and disabled points.
+	const int size = 16;
+	AStar3D a;
+	Math::seed(1);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			a.add_point(y * size + x, Vector3(x, y, 0), 1 + Math::rand() % 3);
+		}
+	}
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			if (x + 1 < size && Math::rand() % 5 != 0) {
+				a.connect_points(y * size + x, y * size + x + 1, Math::rand() % 4 != 0);
+			}
+			if (y + 1 < size && Math::rand() % 5 != 0) {
+				a.connect_points(y * size + x, (y + 1) * size + x, Math::rand() % 4 != 0);
+			}
+		}
+	}
+	for (int i = 0; i < 20; i++) {
+		a.set_point_disabled(Math::rand() % (size * size));
+	}
+
+	CompactPathQueries queries;
+	queries.astar = &a;
+	for (int i = 0; i < 64; i++) {
+		queries.from_ids.push_back(Math::rand() % (size * size));
+		queries.to_ids.push_back(Math::rand() % (size * size));
+	}
+
+	LocalVector<Vector<int64_t>> paths;
+	LocalVector<Vector<int64_t>> partial_paths;
+	for (uint32_t i = 0; i < queries.from_ids.size(); i++) {
+		paths.push_back(a.get_id_path(queries.from_ids[i], queries.to_ids[i]));
+		partial_paths.push_back(a.get_id_path(queries.from_ids[i], queries.to_ids[i], true));
+	}
+
+	// Same neighbor order and scores, so the same paths are found.
+	a.set_compact_graph_enabled(true);
+	for (uint32_t i = 0; i < queries.from_ids.size(); i++) {
+		CHECK(a.get_id_path(queries.from_ids[i], queries.to_ids[i]) == paths[i]);
+		CHECK(a.get_id_path(queries.from_ids[i], queries.to_ids[i], true) == partial_paths[i]);
+	}
+
+	queries.paths.resize(queries.from_ids.size());
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&compact_path_query, &queries, queries.from_ids.size(), -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	for (uint32_t i = 0; i < queries.from_ids.size(); i++) {
+		CHECK(queries.paths[i] == paths[i]);
+	}
+
+	// Landmarks can lead to other paths, but they must be as short.
+	a.set_landmark_count(4);
+	for (uint32_t i = 0; i < queries.from_ids.size(); i++) {
+		const Vector<int64_t> path = a.get_id_path(queries.from_ids[i], queries.to_ids[i]);
+		CHECK(path.is_empty() == paths[i].is_empty());
+		CHECK(get_path_cost(a, path) == doctest::Approx(get_path_cost(a, paths[i])));
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Jumping paths after solid changes") {
+	// Two walls with a gap each, the second gap gets moved after the first queries.
+	const Rect2i region(-4, -4, 24, 24);
+	const Rect2i walls[] = { Rect2i(4, -4, 2, 18), Rect2i(10, 2, 2, 18) };
+	const Rect2i closed_gap(10, -4, 2, 6);
+	const Rect2i opened_gap(10, 8, 2, 2);
+
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(region);
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	grid->set_jumping_enabled(true);
+	grid->update();
+	for (const Rect2i &wall : walls) {
+		grid->fill_solid_region(wall);
+	}
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	for (int i = 0; i < 8; i++) {
+		from_ids.push_back(Vector2i(-4 + i, 19 - i));
+		to_ids.push_back(Vector2i(19 - i, -4 + 3 * i));
+	}
+
+	TypedArray<Array> paths = grid->get_id_paths(from_ids, to_ids);
+	REQUIRE(paths.size() == from_ids.size());
+	for (int i = 0; i < from_ids.size(); i++) {
+		const TypedArray<Vector2i> path = grid->get_id_path(from_ids[i], to_ids[i]);
+		CHECK(Array(paths[i]) == Array(path));
+		REQUIRE(path.size() > 1);
+		CHECK(Vector2i(path[0]) == Vector2i(from_ids[i]));
+		CHECK(Vector2i(path[path.size() - 1]) == Vector2i(to_ids[i]));
+	}
+
+	// Only the lines around the changed points are recomputed, the paths must match a grid built from scratch.
+	grid->fill_solid_region(closed_gap);
+	grid->fill_solid_region(opened_gap, false);
+	grid->set_point_solid(Vector2i(4, 14), true);
+	grid->set_point_solid(Vector2i(4, 14), false);
+
+	Ref<AStarGrid2D> reference_grid;
+	reference_grid.instantiate();
+	reference_grid->set_region(region);
+	reference_grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	reference_grid->set_jumping_enabled(true);
+	reference_grid->update();
+	for (const Rect2i &wall : walls) {
+		reference_grid->fill_solid_region(wall);
+	}
+	reference_grid->fill_solid_region(closed_gap);
+	reference_grid->fill_solid_region(opened_gap, false);
+
+	paths = grid->get_id_paths(from_ids, to_ids);
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(Array(paths[i]) == Array(reference_grid->get_id_path(from_ids[i], to_ids[i])));
+		CHECK_FALSE(Array(paths[i]).is_empty());
+	}
+}
+
+static real_t get_grid_path_cost(const TypedArray<Vector2i> &p_path) {
+	// Jumping paths only hold the jump points, the points between them are on a straight or diagonal line.
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		cost += Vector2(Vector2i(p_path[i - 1])).distance_to(Vector2(Vector2i(p_path[i])));
+	}
+	return cost;
+}
+
+TEST_CASE("[AStarGrid2D] Jumping paths cost the same as full searches") {
+	const AStarGrid2D::DiagonalMode diagonal_modes[] = {
+		AStarGrid2D::DIAGONAL_MODE_ALWAYS,
+		AStarGrid2D::DIAGONAL_MODE_NEVER,
+		AStarGrid2D::DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE,
+		AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES,
+	};
+
+	// A random maze, with the corners kept walkable for the queries.
+	const Rect2i region(0, 0, 32, 32);
+	LocalVector<Vector2i> solids;
+	Math::seed(2);
+	for (int i = 0; i < 240; i++) {
+		const Vector2i id(Math::rand() % region.size.x, Math::rand() % region.size.y);
+		if (id.x > 1 && id.y > 1 && id.x < region.size.x - 2 && id.y < region.size.y - 2) {
+			solids.push_back(id);
+		}
+	}
+
+	LocalVector<Vector2i> from_ids;
+	LocalVector<Vector2i> to_ids;
+	from_ids.push_back(Vector2i(0, 0));
+	to_ids.push_back(Vector2i(31, 31));
+	from_ids.push_back(Vector2i(31, 0));
+	to_ids.push_back(Vector2i(0, 31));
+	from_ids.push_back(Vector2i(0, 0));
+	to_ids.push_back(Vector2i(31, 0));
+	for (int i = 0; i < 16; i++) {
+		from_ids.push_back(Vector2i(Math::rand() % region.size.x, Math::rand() % region.size.y));
+		to_ids.push_back(Vector2i(Math::rand() % region.size.x, Math::rand() % region.size.y));
+	}
+
+	for (AStarGrid2D::DiagonalMode diagonal_mode : diagonal_modes) {
+		Ref<AStarGrid2D> grid;
+		grid.instantiate();
+		grid->set_region(region);
+		grid->set_diagonal_mode(diagonal_mode);
+		grid->update();
+		for (const Vector2i &solid : solids) {
+			grid->set_point_solid(solid);
+		}
+
+		for (uint32_t i = 0; i < from_ids.size(); i++) {
+			if (grid->is_point_solid(from_ids[i]) || grid->is_point_solid(to_ids[i])) {
+				continue;
+			}
+
+			grid->set_jumping_enabled(false);
+			const TypedArray<Vector2i> path = grid->get_id_path(from_ids[i], to_ids[i]);
+			grid->set_jumping_enabled(true);
+			const TypedArray<Vector2i> jumping_path = grid->get_id_path(from_ids[i], to_ids[i]);
+
+			INFO("Diagonal mode: ", int(diagonal_mode), ", from ", from_ids[i], " to ", to_ids[i]);
+			CHECK(jumping_path.is_empty() == path.is_empty());
+			CHECK(get_grid_path_cost(jumping_path) == doctest::Approx(get_grid_path_cost(path)));
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Jumping along lines longer than the stored distances") {
+	// The rows are longer than the jump distances can hold, a wall piece forces a stop after the first run.
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 40000, 3));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->update();
+	grid->fill_solid_region(Rect2i(35000, 0, 1, 2));
+
+	const Vector2i straight_from(0, 2);
+	const Vector2i straight_to(39999, 2);
+	const Vector2i forced_from(0, 0);
+	const Vector2i forced_to(39999, 0);
+
+	grid->set_jumping_enabled(false);
+	const real_t forced_cost = get_grid_path_cost(grid->get_id_path(forced_from, forced_to));
+	grid->set_jumping_enabled(true);
+
+	const TypedArray<Vector2i> straight_path = grid->get_id_path(straight_from, straight_to);
+	REQUIRE_FALSE(straight_path.is_empty());
+	CHECK(Vector2i(straight_path[straight_path.size() - 1]) == straight_to);
+	CHECK(get_grid_path_cost(straight_path) == doctest::Approx(39999));
+
+	const TypedArray<Vector2i> forced_path = grid->get_id_path(forced_from, forced_to);
+	REQUIRE_FALSE(forced_path.is_empty());
+	CHECK(Vector2i(forced_path[forced_path.size() - 1]) == forced_to);
+	CHECK(get_grid_path_cost(forced_path) == doctest::Approx(forced_cost));
+}
+
+TEST_CASE("[AStarGrid2D] Weight scales") {
+	// A heavy wall with a single light gap, paths go through the gap when it is shorter than crossing the wall.
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 10, 10));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->update();
+	grid->fill_weight_scale_region(Rect2i(4, 0, 1, 9), 100.0);
+
+	CHECK(grid->get_point_weight_scale(Vector2i(4, 0)) == doctest::Approx(100.0));
+	CHECK(grid->get_point_weight_scale(Vector2i(4, 9)) == doctest::Approx(1.0));
+	CHECK(grid->get_point_weight_scale(Vector2i(3, 0)) == doctest::Approx(1.0));
+
+	TypedArray<Vector2i> path = grid->get_id_path(Vector2i(0, 0), Vector2i(9, 0));
+	REQUIRE_FALSE(path.is_empty());
+	CHECK(path.has(Vector2i(4, 9)));
+	CHECK_FALSE(path.has(Vector2i(4, 0)));
+
+	// Once the gap gets heavier than going around it, the path crosses the wall directly.
+	grid->set_point_weight_scale(Vector2i(4, 9), 100.0);
+	path = grid->get_id_path(Vector2i(0, 0), Vector2i(9, 0));
+	REQUIRE_FALSE(path.is_empty());
+	CHECK(path.size() == 10);
+	CHECK(path.has(Vector2i(4, 0)));
+
+	ERR_PRINT_OFF;
+	grid->set_point_weight_scale(Vector2i(4, 0), -1.0);
+	ERR_PRINT_ON;
+	CHECK(grid->get_point_weight_scale(Vector2i(4, 0)) == doctest::Approx(100.0));
+}
+
+TEST_CASE("[AStarGrid2D] Partial paths") {
+	// A full wall splits the grid, only partial paths can get closer to the other side.
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 10, 10));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->update();
+	grid->fill_solid_region(Rect2i(5, 0, 1, 10));
+
+	const Vector2i from(0, 5);
+	const Vector2i to(9, 5);
+	CHECK(grid->get_id_path(from, to).is_empty());
+
+	const TypedArray<Vector2i> path = grid->get_id_path(from, to, true);
+	REQUIRE_FALSE(path.is_empty());
+	CHECK(Vector2i(path[0]) == from);
+	CHECK(Vector2i(path[path.size() - 1]) == Vector2i(4, 5));
+	CHECK(grid->get_point_path(from, to, true).size() == path.size());
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	from_ids.push_back(from);
+	to_ids.push_back(to);
+	CHECK(Array(grid->get_id_paths(from_ids, to_ids, true)[0]) == Array(path));
+	CHECK(Array(grid->get_id_paths(from_ids, to_ids)[0]).is_empty());
+}
+
+TEST_CASE("[AStarGrid2D] Point data in regions") {
+	// Rows wider than a mask word, with an offset region, so points span several words.
+	const Rect2i region(-3, -2, 70, 5);
+	const Rect2i solid_region(-1, -1, 66, 2);
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(region);
+	grid->set_cell_size(Size2(2, 2));
+	grid->update();
+	grid->fill_solid_region(solid_region);
+	grid->set_point_solid(Vector2i(0, -1), false);
+	grid->set_point_weight_scale(Vector2i(66, 2), 3.0);
+
+	for (int32_t y = region.position.y; y < region.get_end().y; y++) {
+		for (int32_t x = region.position.x; x < region.get_end().x; x++) {
+			const Vector2i id(x, y);
+			CHECK(grid->is_point_solid(id) == (solid_region.has_point(id) && id != Vector2i(0, -1)));
+		}
+	}
+
+	// The region is clipped to the grid, the points are listed row by row.
+	const Rect2i query_region(60, 0, 20, 10);
+	const Rect2i clipped_region = region.intersection(query_region);
+	const TypedArray<Dictionary> data = grid->get_point_data_in_region(query_region);
+	REQUIRE(data.size() == clipped_region.get_area());
+	for (int i = 0; i < data.size(); i++) {
+		const Dictionary point = data[i];
+		const Vector2i id = clipped_region.position + Vector2i(i % clipped_region.size.x, i / clipped_region.size.x);
+		CHECK(Vector2i(point["id"]) == id);
+		CHECK(Vector2(point["position"]) == grid->get_point_position(id));
+		CHECK(bool(point["solid"]) == grid->is_point_solid(id));
+		CHECK(real_t(point["weight_scale"]) == doctest::Approx(grid->get_point_weight_scale(id)));
+	}
+	CHECK(real_t(Dictionary(data[data.size() - 1])["weight_scale"]) == doctest::Approx(3.0));
+}
 } // namespace TestAStar
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "core/config/project_settings.h"
 #include "modules/navigation_2d/nav_utils_2d.h"
 #include "servers/navigation_2d/navigation_server_2d.h"
 
@@ -741,6 +742,165 @@ TEST_SUITE("[Navigation2D]") {
 		navigation_server->physics_process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer2D] Server should answer map point queries like a search through all polygons") {
+		NavigationServer2D *navigation_server = NavigationServer2D::get_singleton();
+
+		// A grid of 32 by 32 quads.
+		Ref<NavigationPolygon> navigation_polygon = memnew(NavigationPolygon);
+		Vector<Vector2> vertices;
+		for (int x = 0; x <= 32; x++) {
+			for (int y = 0; y <= 32; y++) {
+				vertices.push_back(Vector2(x * 10.0, y * 10.0));
+			}
+		}
+		navigation_polygon->set_vertices(vertices);
+		for (int x = 0; x < 32; x++) {
+			for (int y = 0; y < 32; y++) {
+				const int index = x * 33 + y;
+				navigation_polygon->add_polygon({ index, index + 33, index + 34, index + 1 });
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, false);
+		navigation_server->region_set_use_async_iterations(region, false);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_polygon(region, navigation_polygon);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		// The region queries still test every polygon of the region.
+		for (int i = 0; i < 64; i++) {
+			const Vector2 point = Vector2(Math::fmod(i * 73.1, 400.0) - 40.0, Math::fmod(i * 37.7, 400.0) - 40.0);
+			CHECK(navigation_server->map_get_closest_point(map, point).is_equal_approx(navigation_server->region_get_closest_point(region, point)));
+
+			const Vector2 random_point = navigation_server->map_get_random_point(map, 1, true);
+			CHECK(navigation_server->map_get_closest_point(map, random_point).is_equal_approx(random_point));
+		}
+
+		navigation_server->free_rid(region);
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer2D] Server should find paths with hierarchical pathfinding") {
+		NavigationServer2D *navigation_server = NavigationServer2D::get_singleton();
+
+		// A strip of 64 by 4 quads that spans many clusters.
+		Ref<NavigationPolygon> navigation_polygon = memnew(NavigationPolygon);
+		Vector<Vector2> vertices;
+		for (int x = 0; x <= 64; x++) {
+			for (int y = 0; y <= 4; y++) {
+				vertices.push_back(Vector2(x * 10.0, y * 10.0));
+			}
+		}
+		navigation_polygon->set_vertices(vertices);
+		for (int x = 0; x < 64; x++) {
+			for (int y = 0; y < 4; y++) {
+				const int index = x * 5 + y;
+				Vector<int> polygon = { index, index + 5, index + 6, index + 1 };
+				navigation_polygon->add_polygon(polygon);
+			}
+		}
+
+		// Maps read the cluster size when they are created.
+		RID flat_map = navigation_server->map_create();
+		ProjectSettings::get_singleton()->set_setting("navigation/2d/hierarchical_pathfinding_cluster_size", 40.0);
+		RID hierarchical_map = navigation_server->map_create();
+		ProjectSettings::get_singleton()->set_setting("navigation/2d/hierarchical_pathfinding_cluster_size", 0.0);
+
+		RID flat_region = navigation_server->region_create();
+		RID hierarchical_region = navigation_server->region_create();
+		const RID maps[2] = { flat_map, hierarchical_map };
+		const RID regions[2] = { flat_region, hierarchical_region };
+		for (int i = 0; i < 2; i++) {
+			navigation_server->map_set_active(maps[i], true);
+			navigation_server->map_set_use_async_iterations(maps[i], false);
+			navigation_server->region_set_use_async_iterations(regions[i], false);
+			navigation_server->region_set_map(regions[i], maps[i]);
+			navigation_server->region_set_navigation_polygon(regions[i], navigation_polygon);
+		}
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		const Vector2 start_position = Vector2(5.0, 5.0);
+		const Vector2 target_position = Vector2(635.0, 35.0);
+		const Vector<Vector2> flat_path = navigation_server->map_get_path(flat_map, start_position, target_position, true);
+		const Vector<Vector2> hierarchical_path = navigation_server->map_get_path(hierarchical_map, start_position, target_position, true);
+		REQUIRE(flat_path.size() >= 2);
+		REQUIRE(hierarchical_path.size() >= 2);
+
+		CHECK(hierarchical_path[0].is_equal_approx(start_position));
+		CHECK(hierarchical_path[hierarchical_path.size() - 1].is_equal_approx(target_position));
+
+		real_t flat_path_length = 0.0;
+		for (int i = 1; i < flat_path.size(); i++) {
+			flat_path_length += flat_path[i - 1].distance_to(flat_path[i]);
+		}
+		real_t hierarchical_path_length = 0.0;
+		for (int i = 1; i < hierarchical_path.size(); i++) {
+			hierarchical_path_length += hierarchical_path[i - 1].distance_to(hierarchical_path[i]);
+		}
+		CHECK(hierarchical_path_length == doctest::Approx(flat_path_length).epsilon(0.05));
+
+		for (int i = 0; i < 2; i++) {
+			navigation_server->free_rid(regions[i]);
+			navigation_server->free_rid(maps[i]);
+		}
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer2D] Server should steer agents along flow fields") {
+		NavigationServer2D *navigation_server = NavigationServer2D::get_singleton();
+
+		// A strip of 16 by 2 quads.
+		Ref<NavigationPolygon> navigation_polygon = memnew(NavigationPolygon);
+		Vector<Vector2> vertices;
+		for (int x = 0; x <= 16; x++) {
+			for (int y = 0; y <= 2; y++) {
+				vertices.push_back(Vector2(x * 10.0, y * 10.0));
+			}
+		}
+		navigation_polygon->set_vertices(vertices);
+		for (int x = 0; x < 16; x++) {
+			for (int y = 0; y < 2; y++) {
+				const int index = x * 3 + y;
+				Vector<int> polygon = { index, index + 3, index + 4, index + 1 };
+				navigation_polygon->add_polygon(polygon);
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		RID agent = navigation_server->agent_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, false);
+		navigation_server->region_set_use_async_iterations(region, false);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_polygon(region, navigation_polygon);
+		navigation_server->agent_set_map(agent, map);
+		navigation_server->agent_set_position(agent, Vector2(25.0, 15.0));
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		const Vector2 end_target_position = Vector2(155.0, 15.0);
+		const Vector2 begin_target_position = Vector2(5.0, 15.0);
+		CHECK(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector2(25.0, 15.0)).is_equal_approx(Vector2(1.0, 0.0)));
+		CHECK(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector2(30.0, 15.0)).is_equal_approx(Vector2(1.0, 0.0)));
+		CHECK(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector2(152.0, 15.0)).is_equal_approx(Vector2(1.0, 0.0)));
+		CHECK(navigation_server->map_get_flow_field_direction(map, begin_target_position, Vector2(85.0, 15.0)).is_equal_approx(Vector2(-1.0, 0.0)));
+		CHECK(navigation_server->agent_get_flow_field_direction(agent, end_target_position).is_equal_approx(Vector2(1.0, 0.0)));
+
+		// Flow fields are rebuilt when the map changes.
+		navigation_server->region_set_enabled(region, false);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector2(25.0, 15.0)), Vector2());
+
+		navigation_server->free_rid(agent);
+		navigation_server->free_rid(region);
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
 	TEST_CASE("[NavigationServer2D] Server should simplify path properly") {
 		real_t simplify_epsilon = 0.2;
 		Vector<Vector2> source_path;
@@ -30,6 +30,10 @@
 
 #pragma once
 
+#include "core/config/project_settings.h"
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/os.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
 #include "servers/navigation_3d/navigation_server_3d.h"
@@ -515,6 +519,245 @@ TEST_SUITE("[Navigation3D]") {
 		navigation_server->physics_process(0.0); // Give server some cycles to commit.
 	}
 
+	// Times the avoidance steps of a crowd of 10000 agents crossing each other. Skipped by default,
+	// run it with `--test --test-case="*Avoidance crowd benchmark*" --no-skip`.
+	TEST_CASE("[NavigationServer3D] Avoidance crowd benchmark" * doctest::skip()) {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int crowd_size = 100;
+		const int step_count = 60;
+		const real_t agent_spacing = 1.5;
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+
+		LocalVector<RID> agents;
+		agents.reserve(crowd_size * crowd_size);
+		const real_t crowd_half_extent = crowd_size * agent_spacing * 0.5;
+		for (int z = 0; z < crowd_size; z++) {
+			for (int x = 0; x < crowd_size; x++) {
+				RID agent = navigation_server->agent_create();
+				const Vector3 position = Vector3(x * agent_spacing - crowd_half_extent, 0.0, z * agent_spacing - crowd_half_extent);
+				navigation_server->agent_set_map(agent, map);
+				navigation_server->agent_set_avoidance_enabled(agent, true);
+				navigation_server->agent_set_position(agent, position);
+				navigation_server->agent_set_radius(agent, 0.5);
+				navigation_server->agent_set_neighbor_distance(agent, 5.0);
+				navigation_server->agent_set_max_neighbors(agent, 10);
+				navigation_server->agent_set_max_speed(agent, 2.0);
+				// Each half of the crowd walks through the other one.
+				navigation_server->agent_set_velocity(agent, Vector3(x < crowd_size / 2 ? 2.0 : -2.0, 0.0, 0.0));
+				agents.push_back(agent);
+			}
+		}
+		CallableMock agent_avoidance_callback_mock;
+		navigation_server->agent_set_avoidance_callback(agents[agents.size() / 2], callable_mp(&agent_avoidance_callback_mock, &CallableMock::function1));
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		const uint64_t start_usec = OS::get_singleton()->get_ticks_usec();
+		for (int step = 0; step < step_count; step++) {
+			navigation_server->physics_process(1.0 / 60.0);
+		}
+		const uint64_t elapsed_usec = OS::get_singleton()->get_ticks_usec() - start_usec;
+
+		MESSAGE(vformat("%d agents: %d steps in %.2f ms, %.3f ms per step.", agents.size(), step_count, elapsed_usec / 1000.0, elapsed_usec / 1000.0 / step_count));
+		CHECK_EQ(agent_avoidance_callback_mock.function1_calls, step_count + 1);
+
+		for (const RID &agent : agents) {
+			navigation_server->free_rid(agent);
+		}
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	// Builds a navigation mesh for one tile of a grid of `p_cells` by `p_cells` unit quads.
+	// A few walls are cut out of the grid so that paths need to go around them.
+	static Ref<NavigationMesh> _create_benchmark_tile(int p_tile_x, int p_tile_z, int p_tile_cells) {
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Vector<Vector3> vertices;
+		for (int x = 0; x <= p_tile_cells; x++) {
+			for (int z = 0; z <= p_tile_cells; z++) {
+				vertices.push_back(Vector3(x, 0.0, z));
+			}
+		}
+		navigation_mesh->set_vertices(vertices);
+		for (int x = 0; x < p_tile_cells; x++) {
+			for (int z = 0; z < p_tile_cells; z++) {
+				const int cell_x = p_tile_x * p_tile_cells + x;
+				const int cell_z = p_tile_z * p_tile_cells + z;
+				if (cell_x % 8 == 4 && cell_z % 8 >= 1 && cell_z % 8 <= 5) {
+					continue;
+				}
+				const int index = x * (p_tile_cells + 1) + z;
+				Vector<int> polygon = { index, index + p_tile_cells + 1, index + p_tile_cells + 2, index + 1 };
+				navigation_mesh->add_polygon(polygon);
+			}
+		}
+		return navigation_mesh;
+	}
+
+	// Benchmark, skipped by default.
+	// Run it with `--test --test-case="*Navigation benchmark*" --no-skip`.
+	// The results are printed as JSON and also written to the file in the `NAVIGATION_BENCHMARK_OUTPUT` environment variable, if set.
+	TEST_CASE("[NavigationServer3D] Navigation benchmark" * doctest::skip()) {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int tile_cells = 16;
+		const int query_count = 100;
+		const int avoidance_step_count = 30;
+
+		Array navigation_mesh_results;
+		for (const int grid_cells : { 16, 64, 256 }) {
+			const int tile_count = grid_cells / tile_cells;
+
+			RID map = navigation_server->map_create();
+			navigation_server->map_set_active(map, true);
+			navigation_server->map_set_use_async_iterations(map, false);
+
+			LocalVector<RID> regions;
+			int polygon_count = 0;
+			for (int tile_x = 0; tile_x < tile_count; tile_x++) {
+				for (int tile_z = 0; tile_z < tile_count; tile_z++) {
+					Ref<NavigationMesh> navigation_mesh = _create_benchmark_tile(tile_x, tile_z, tile_cells);
+					polygon_count += navigation_mesh->get_polygon_count();
+					RID region = navigation_server->region_create();
+					navigation_server->region_set_use_async_iterations(region, false);
+					navigation_server->region_set_map(region, map);
+					navigation_server->region_set_transform(region, Transform3D(Basis(), Vector3(tile_x * tile_cells, 0.0, tile_z * tile_cells)));
+					navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+					regions.push_back(region);
+				}
+			}
+
+			// An island far away from the grid that no path can reach.
+			Ref<NavigationMesh> island_mesh = memnew(NavigationMesh);
+			island_mesh->set_vertices({ Vector3(0.0, 0.0, 0.0), Vector3(0.0, 0.0, 4.0), Vector3(4.0, 0.0, 4.0), Vector3(4.0, 0.0, 0.0) });
+			island_mesh->add_polygon({ 0, 1, 2, 3 });
+			RID island = navigation_server->region_create();
+			navigation_server->region_set_use_async_iterations(island, false);
+			navigation_server->region_set_map(island, map);
+			navigation_server->region_set_transform(island, Transform3D(Basis(), Vector3(grid_cells + 100.0, 0.0, 0.0)));
+			navigation_server->region_set_navigation_mesh(island, island_mesh);
+			regions.push_back(island);
+
+			// The first cycle syncs all regions and builds the map iteration.
+			const uint64_t sync_start_usec = OS::get_singleton()->get_ticks_usec();
+			navigation_server->physics_process(0.0);
+			const uint64_t sync_usec = OS::get_singleton()->get_ticks_usec() - sync_start_usec;
+			const int map_build_usec = navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_BUILD_USEC);
+
+			// Moving a single region only rebuilds the map iteration.
+			navigation_server->region_set_transform(island, Transform3D(Basis(), Vector3(grid_cells + 100.0, 0.0, 8.0)));
+			navigation_server->physics_process(0.0);
+			const int map_rebuild_usec = navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_BUILD_USEC);
+
+			const Vector3 island_position = Vector3(grid_cells + 102.0, 0.0, 10.0);
+			uint64_t short_path_usec = 0;
+			uint64_t long_path_usec = 0;
+			uint64_t unreachable_path_usec = 0;
+			uint64_t closest_point_usec = 0;
+			for (int i = 0; i < query_count; i++) {
+				const Vector3 start_position = Vector3(Math::fmod(i * 7.31, grid_cells - 4.0) + 0.5, 0.0, Math::fmod(i * 3.77, grid_cells - 4.0) + 0.5);
+
+				uint64_t start_usec = OS::get_singleton()->get_ticks_usec();
+				const Vector<Vector3> short_path = navigation_server->map_get_path(map, start_position, start_position + Vector3(3.0, 0.0, 3.0), true);
+				short_path_usec += OS::get_singleton()->get_ticks_usec() - start_usec;
+				CHECK_GE(short_path.size(), 2);
+
+				start_usec = OS::get_singleton()->get_ticks_usec();
+				const Vector<Vector3> long_path = navigation_server->map_get_path(map, start_position, Vector3(grid_cells - 0.5, 0.0, grid_cells - 0.5) - start_position, true);
+				long_path_usec += OS::get_singleton()->get_ticks_usec() - start_usec;
+				CHECK_GE(long_path.size(), 2);
+
+				start_usec = OS::get_singleton()->get_ticks_usec();
+				const Vector<Vector3> unreachable_path = navigation_server->map_get_path(map, start_position, island_position, true);
+				unreachable_path_usec += OS::get_singleton()->get_ticks_usec() - start_usec;
+				if (!unreachable_path.is_empty()) {
+					CHECK(unreachable_path[unreachable_path.size() - 1].x < grid_cells + 1.0);
+				}
+
+				const Vector3 query_point = Vector3(Math::fmod(i * 5.17, grid_cells + 8.0) - 4.0, Math::fmod(i * 1.93, 4.0) - 2.0, Math::fmod(i * 2.71, grid_cells + 8.0) - 4.0);
+				start_usec = OS::get_singleton()->get_ticks_usec();
+				navigation_server->map_get_closest_point(map, query_point);
+				closest_point_usec += OS::get_singleton()->get_ticks_usec() - start_usec;
+			}
+
+			Dictionary result;
+			result["grid_cells"] = grid_cells;
+			result["region_count"] = regions.size();
+			result["polygon_count"] = polygon_count;
+			result["region_sync_usec"] = (int64_t)sync_usec - map_build_usec;
+			result["map_build_usec"] = map_build_usec;
+			result["map_rebuild_usec"] = map_rebuild_usec;
+			result["short_path_usec"] = short_path_usec / (double)query_count;
+			result["long_path_usec"] = long_path_usec / (double)query_count;
+			result["unreachable_path_usec"] = unreachable_path_usec / (double)query_count;
+			result["closest_point_usec"] = closest_point_usec / (double)query_count;
+			navigation_mesh_results.push_back(result);
+
+			for (const RID &region : regions) {
+				navigation_server->free_rid(region);
+			}
+			navigation_server->free_rid(map);
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+		}
+
+		Array avoidance_results;
+		for (const int agent_count : { 100, 1000, 10000 }) {
+			RID map = navigation_server->map_create();
+			navigation_server->map_set_active(map, true);
+
+			// Two halves of a square crowd walk through each other.
+			const int crowd_size = (int)Math::ceil(Math::sqrt((double)agent_count));
+			const real_t agent_spacing = 1.5;
+			LocalVector<RID> agents;
+			agents.reserve(agent_count);
+			for (int i = 0; i < agent_count; i++) {
+				const int x = i % crowd_size;
+				const int z = i / crowd_size;
+				RID agent = navigation_server->agent_create();
+				navigation_server->agent_set_map(agent, map);
+				navigation_server->agent_set_avoidance_enabled(agent, true);
+				navigation_server->agent_set_position(agent, Vector3(x * agent_spacing, 0.0, z * agent_spacing));
+				navigation_server->agent_set_radius(agent, 0.5);
+				navigation_server->agent_set_neighbor_distance(agent, 5.0);
+				navigation_server->agent_set_max_neighbors(agent, 10);
+				navigation_server->agent_set_max_speed(agent, 2.0);
+				navigation_server->agent_set_velocity(agent, Vector3(x < crowd_size / 2 ? 2.0 : -2.0, 0.0, 0.0));
+				agents.push_back(agent);
+			}
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+			const uint64_t start_usec = OS::get_singleton()->get_ticks_usec();
+			for (int step = 0; step < avoidance_step_count; step++) {
+				navigation_server->physics_process(1.0 / 60.0);
+			}
+			const uint64_t elapsed_usec = OS::get_singleton()->get_ticks_usec() - start_usec;
+
+			Dictionary result;
+			result["agent_count"] = agent_count;
+			result["step_usec"] = elapsed_usec / (double)avoidance_step_count;
+			avoidance_results.push_back(result);
+
+			for (const RID &agent : agents) {
+				navigation_server->free_rid(agent);
+			}
+			navigation_server->free_rid(map);
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+		}
+
+		Dictionary results;
+		results["navigation_meshes"] = navigation_mesh_results;
+		results["avoidance"] = avoidance_results;
+		const String json = JSON::stringify(results, "\t");
+		MESSAGE(json);
+
+		const String output_path = OS::get_singleton()->get_environment("NAVIGATION_BENCHMARK_OUTPUT");
+		if (!output_path.is_empty()) {
+			Ref<FileAccess> file = FileAccess::open(output_path, FileAccess::WRITE);
+			REQUIRE(file.is_valid());
+			file->store_string(json);
+		}
+	}
+
 #ifndef DISABLE_DEPRECATED
 	// This test case uses only public APIs on purpose - other test cases use simplified baking.
 	// FIXME: Remove once deprecated `region_bake_navigation_mesh()` is removed.
@@ -824,6 +1067,422 @@ TEST_SUITE("[Navigation3D]") {
 	}
 	*/
 
+	TEST_CASE("[NavigationServer3D] Server should bake navigation meshes in tiles") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_tile_size(4.0);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(20.0, 0.001, 20.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		CHECK_GT(navigation_mesh->get_polygon_count(), 0);
+		const Vector<Vector3> tiled_vertices = navigation_mesh->get_vertices();
+		const int tiled_polygon_count = navigation_mesh->get_polygon_count();
+
+		SUBCASE("Baking unchanged source geometry again should give the same navigation mesh") {
+			navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+			CHECK_EQ(navigation_mesh->get_polygon_count(), tiled_polygon_count);
+			CHECK_EQ(navigation_mesh->get_vertices(), tiled_vertices);
+		}
+
+		SUBCASE("Adding an obstruction should only change the tiles around it") {
+			source_geometry->add_projected_obstruction({ Vector3(5.0, 0.0, 5.0), Vector3(7.0, 0.0, 5.0), Vector3(7.0, 0.0, 7.0), Vector3(5.0, 0.0, 7.0) }, -1.0, 2.0, true);
+			navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+			CHECK_NE(navigation_mesh->get_vertices(), tiled_vertices);
+
+			// The tiles with negative coordinates are far from the obstruction and are not baked again.
+			Vector<Vector3> far_vertices;
+			for (const Vector3 &vertex : tiled_vertices) {
+				if (vertex.x < 0.0 && vertex.z < 0.0) {
+					far_vertices.push_back(vertex);
+				}
+			}
+			Vector<Vector3> rebaked_far_vertices;
+			for (const Vector3 &vertex : navigation_mesh->get_vertices()) {
+				if (vertex.x < 0.0 && vertex.z < 0.0) {
+					rebaked_far_vertices.push_back(vertex);
+				}
+			}
+			CHECK_EQ(rebaked_far_vertices, far_vertices);
+		}
+
+		SUBCASE("Tiles should be stitched into a connected navigation mesh") {
+			RID map = navigation_server->map_create();
+			RID region = navigation_server->region_create();
+			navigation_server->map_set_use_async_iterations(map, false);
+			navigation_server->map_set_active(map, true);
+			navigation_server->region_set_use_async_iterations(region, false);
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-8.0, 0.0, -8.0), Vector3(8.0, 0.0, 8.0), true);
+			REQUIRE_FALSE(path.is_empty());
+			CHECK_LT(path[path.size() - 1].distance_to(Vector3(8.0, 0.0, 8.0)), 0.5);
+
+			navigation_server->free_rid(region);
+			navigation_server->free_rid(map);
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+		}
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should stitch tiles baked on uneven terrain") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_tile_size(4.0);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		// A slope with bumps across it, so the tiles sample different heights along their edges.
+		const auto terrain_height = [](real_t p_x, real_t p_z) {
+			return p_x * 0.15 + Math::sin(p_z * 0.7) * 0.3;
+		};
+		PackedVector3Array faces;
+		for (int x = -12; x < 12; x++) {
+			for (int z = -12; z < 12; z++) {
+				const Vector3 v00 = Vector3(x, terrain_height(x, z), z);
+				const Vector3 v10 = Vector3(x + 1, terrain_height(x + 1, z), z);
+				const Vector3 v01 = Vector3(x, terrain_height(x, z + 1), z + 1);
+				const Vector3 v11 = Vector3(x + 1, terrain_height(x + 1, z + 1), z + 1);
+				faces.append_array({ v00, v10, v11, v00, v11, v01 });
+			}
+		}
+		source_geometry->add_faces(faces, Transform3D());
+
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		REQUIRE_GT(navigation_mesh->get_polygon_count(), 0);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_use_async_iterations(map, false);
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_use_async_iterations(region, false);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		// Paths crossing many tile edges in both directions should reach their targets.
+		const Vector3 corners[4] = {
+			Vector3(-10.0, terrain_height(-10.0, -10.0), -10.0),
+			Vector3(10.0, terrain_height(10.0, -10.0), -10.0),
+			Vector3(10.0, terrain_height(10.0, 10.0), 10.0),
+			Vector3(-10.0, terrain_height(-10.0, 10.0), 10.0),
+		};
+		for (int i = 0; i < 4; i++) {
+			const Vector3 &from = corners[i];
+			const Vector3 &to = corners[(i + 2) % 4];
+			const Vector<Vector3> path = navigation_server->map_get_path(map, from, to, true);
+			REQUIRE_FALSE(path.is_empty());
+			const Vector3 path_end = path[path.size() - 1];
+			CHECK_MESSAGE(Vector2(path_end.x, path_end.z).distance_to(Vector2(to.x, to.z)) < 0.5, vformat("The path from %s should reach %s, but it ends at %s.", from, to, path_end));
+		}
+
+		navigation_server->free_rid(region);
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should answer map point queries like a search through all polygons") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// A grid of 32 by 32 quads split into triangles at different heights.
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Vector<Vector3> vertices;
+		for (int x = 0; x <= 32; x++) {
+			for (int z = 0; z <= 32; z++) {
+				vertices.push_back(Vector3(x, ((x * 7 + z * 3) % 5) * 0.1, z));
+			}
+		}
+		navigation_mesh->set_vertices(vertices);
+		for (int x = 0; x < 32; x++) {
+			for (int z = 0; z < 32; z++) {
+				const int index = x * 33 + z;
+				navigation_mesh->add_polygon({ index, index + 33, index + 34 });
+				navigation_mesh->add_polygon({ index, index + 34, index + 1 });
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, false);
+		navigation_server->region_set_use_async_iterations(region, false);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		// The region queries still test every polygon of the region.
+		for (int i = 0; i < 64; i++) {
+			const Vector3 point = Vector3(Math::fmod(i * 7.31, 40.0) - 4.0, Math::fmod(i * 1.93, 4.0) - 2.0, Math::fmod(i * 3.77, 40.0) - 4.0);
+			CHECK(navigation_server->map_get_closest_point(map, point).is_equal_approx(navigation_server->region_get_closest_point(region, point)));
+
+			const Vector3 segment_end = point + Vector3(Math::fmod(i * 5.17, 8.0) - 4.0, 3.0, Math::fmod(i * 2.71, 8.0) - 4.0);
+			CHECK(navigation_server->map_get_closest_point_to_segment(map, point, segment_end).is_equal_approx(navigation_server->region_get_closest_point_to_segment(region, point, segment_end)));
+
+			const Vector3 random_point = navigation_server->map_get_random_point(map, 1, true);
+			CHECK(navigation_server->map_get_closest_point(map, random_point).is_equal_approx(random_point));
+		}
+
+		navigation_server->free_rid(region);
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find paths with hierarchical pathfinding") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// A strip of 64 by 4 quads that spans many clusters.
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Vector<Vector3> vertices;
+		for (int x = 0; x <= 64; x++) {
+			for (int z = 0; z <= 4; z++) {
+				vertices.push_back(Vector3(x, 0.0, z));
+			}
+		}
+		navigation_mesh->set_vertices(vertices);
+		for (int x = 0; x < 64; x++) {
+			for (int z = 0; z < 4; z++) {
+				const int index = x * 5 + z;
+				Vector<int> polygon = { index, index + 5, index + 6, index + 1 };
+				navigation_mesh->add_polygon(polygon);
+			}
+		}
+
+		// Maps read the cluster size when they are created.
+		RID flat_map = navigation_server->map_create();
+		ProjectSettings::get_singleton()->set_setting("navigation/3d/hierarchical_pathfinding_cluster_size", 4.0);
+		RID hierarchical_map = navigation_server->map_create();
+		ProjectSettings::get_singleton()->set_setting("navigation/3d/hierarchical_pathfinding_cluster_size", 0.0);
+
+		RID flat_region = navigation_server->region_create();
+		RID hierarchical_region = navigation_server->region_create();
+		const RID maps[2] = { flat_map, hierarchical_map };
+		const RID regions[2] = { flat_region, hierarchical_region };
+		for (int i = 0; i < 2; i++) {
+			navigation_server->map_set_active(maps[i], true);
+			navigation_server->map_set_use_async_iterations(maps[i], false);
+			navigation_server->region_set_use_async_iterations(regions[i], false);
+			navigation_server->region_set_map(regions[i], maps[i]);
+			navigation_server->region_set_navigation_mesh(regions[i], navigation_mesh);
+		}
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		const Vector3 start_position = Vector3(0.5, 0.0, 0.5);
+		const Vector3 target_position = Vector3(63.5, 0.0, 3.5);
+		const Vector<Vector3> flat_path = navigation_server->map_get_path(flat_map, start_position, target_position, true);
+		const Vector<Vector3> hierarchical_path = navigation_server->map_get_path(hierarchical_map, start_position, target_position, true);
+		REQUIRE(flat_path.size() >= 2);
+		REQUIRE(hierarchical_path.size() >= 2);
+
+		CHECK(hierarchical_path[0].is_equal_approx(start_position));
+		CHECK(hierarchical_path[hierarchical_path.size() - 1].is_equal_approx(target_position));
+
+		real_t flat_path_length = 0.0;
+		for (int i = 1; i < flat_path.size(); i++) {
+			flat_path_length += flat_path[i - 1].distance_to(flat_path[i]);
+		}
+		real_t hierarchical_path_length = 0.0;
+		for (int i = 1; i < hierarchical_path.size(); i++) {
+			hierarchical_path_length += hierarchical_path[i - 1].distance_to(hierarchical_path[i]);
+		}
+		CHECK(hierarchical_path_length == doctest::Approx(flat_path_length).epsilon(0.05));
+
+		for (int i = 0; i < 2; i++) {
+			navigation_server->free_rid(regions[i]);
+			navigation_server->free_rid(maps[i]);
+		}
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should reuse unchanged regions when building map iterations") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_vertices({ Vector3(0.0, 0.0, 0.0), Vector3(0.0, 0.0, 4.0), Vector3(4.0, 0.0, 4.0), Vector3(4.0, 0.0, 0.0) });
+		navigation_mesh->add_polygon({ 0, 1, 2, 3 });
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, false);
+
+		// A row of three connected regions and a platform far away from them.
+		RID regions[4];
+		for (int i = 0; i < 4; i++) {
+			regions[i] = navigation_server->region_create();
+			navigation_server->region_set_use_async_iterations(regions[i], false);
+			navigation_server->region_set_map(regions[i], map);
+			navigation_server->region_set_navigation_mesh(regions[i], navigation_mesh);
+			navigation_server->region_set_transform(regions[i], Transform3D(Basis(), Vector3(i < 3 ? i * 4.0 : 100.0, 0.0, 0.0)));
+		}
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_REBUILT_REGION_COUNT), 4);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_REUSED_REGION_COUNT), 0);
+		const int edge_connection_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
+		CHECK_GE(edge_connection_count, 2);
+
+		SUBCASE("Moving the far platform should only rebuild its own connections") {
+			navigation_server->region_set_transform(regions[3], Transform3D(Basis(), Vector3(100.0, 0.0, 8.0)));
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_REBUILT_REGION_COUNT), 1);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_REUSED_REGION_COUNT), 3);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), edge_connection_count);
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0.5, 0.0, 2.0), Vector3(11.5, 0.0, 2.0), true);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(11.5, 0.0, 2.0)));
+		}
+
+		SUBCASE("Moving the platform next to the row should connect it with the closest region") {
+			navigation_server->region_set_transform(regions[3], Transform3D(Basis(), Vector3(12.0, 0.0, 0.0)));
+			navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_REBUILT_REGION_COUNT), 2);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ITERATION_REUSED_REGION_COUNT), 2);
+			CHECK_GT(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), edge_connection_count);
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0.5, 0.0, 2.0), Vector3(15.5, 0.0, 2.0), true);
+			REQUIRE(path.size() >= 2);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(15.5, 0.0, 2.0)));
+		}
+
+		for (int i = 0; i < 4; i++) {
+			navigation_server->free_rid(regions[i]);
+		}
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find paths in batches") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// A strip of 32 by 4 quads.
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Vector<Vector3> vertices;
+		for (int x = 0; x <= 32; x++) {
+			for (int z = 0; z <= 4; z++) {
+				vertices.push_back(Vector3(x, 0.0, z));
+			}
+		}
+		navigation_mesh->set_vertices(vertices);
+		for (int x = 0; x < 32; x++) {
+			for (int z = 0; z < 4; z++) {
+				const int index = x * 5 + z;
+				Vector<int> polygon = { index, index + 5, index + 6, index + 1 };
+				navigation_mesh->add_polygon(polygon);
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, false);
+		navigation_server->region_set_use_async_iterations(region, false);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		// Most queries share a target and use a shared search, the others are searched on their own.
+		const Vector3 shared_target_position = Vector3(31.5, 0.0, 2.5);
+		TypedArray<NavigationPathQueryParameters3D> query_parameters;
+		TypedArray<NavigationPathQueryResult3D> query_results;
+		for (int i = 0; i < 20; i++) {
+			Ref<NavigationPathQueryParameters3D> parameters;
+			parameters.instantiate();
+			parameters->set_map(map);
+			parameters->set_start_position(Vector3(i + 0.5, 0.0, (i % 4) + 0.5));
+			parameters->set_target_position(i < 16 ? shared_target_position : Vector3(0.5, 0.0, 0.5));
+			query_parameters.push_back(parameters);
+
+			Ref<NavigationPathQueryResult3D> result;
+			result.instantiate();
+			query_results.push_back(result);
+		}
+
+		navigation_server->query_path_batch(query_parameters, query_results);
+
+		for (int i = 0; i < query_parameters.size(); i++) {
+			const Ref<NavigationPathQueryParameters3D> parameters = query_parameters[i];
+			const Ref<NavigationPathQueryResult3D> result = query_results[i];
+			const Vector<Vector3> batch_path = result->get_path();
+			const Vector<Vector3> path = navigation_server->map_get_path(map, parameters->get_start_position(), parameters->get_target_position(), true);
+			REQUIRE(path.size() >= 2);
+			REQUIRE(batch_path.size() >= 2);
+
+			CHECK(batch_path[0].is_equal_approx(path[0]));
+			CHECK(batch_path[batch_path.size() - 1].is_equal_approx(path[path.size() - 1]));
+
+			real_t path_length = 0.0;
+			for (int j = 1; j < path.size(); j++) {
+				path_length += path[j - 1].distance_to(path[j]);
+			}
+			real_t batch_path_length = 0.0;
+			for (int j = 1; j < batch_path.size(); j++) {
+				batch_path_length += batch_path[j - 1].distance_to(batch_path[j]);
+			}
+			CHECK(batch_path_length == doctest::Approx(path_length).epsilon(0.05));
+		}
+
+		navigation_server->free_rid(region);
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should steer agents along flow fields") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// A strip of 16 by 2 quads.
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		Vector<Vector3> vertices;
+		for (int x = 0; x <= 16; x++) {
+			for (int z = 0; z <= 2; z++) {
+				vertices.push_back(Vector3(x, 0.0, z));
+			}
+		}
+		navigation_mesh->set_vertices(vertices);
+		for (int x = 0; x < 16; x++) {
+			for (int z = 0; z < 2; z++) {
+				const int index = x * 3 + z;
+				Vector<int> polygon = { index, index + 3, index + 4, index + 1 };
+				navigation_mesh->add_polygon(polygon);
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		RID agent = navigation_server->agent_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->map_set_use_async_iterations(map, false);
+		navigation_server->region_set_use_async_iterations(region, false);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->agent_set_map(agent, map);
+		navigation_server->agent_set_position(agent, Vector3(2.5, 0.0, 1.5));
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+
+		const Vector3 end_target_position = Vector3(15.5, 0.0, 1.5);
+		const Vector3 begin_target_position = Vector3(0.5, 0.0, 1.5);
+		CHECK(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector3(2.5, 0.0, 1.5)).is_equal_approx(Vector3(1.0, 0.0, 0.0)));
+		CHECK(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector3(3.0, 0.0, 1.5)).is_equal_approx(Vector3(1.0, 0.0, 0.0)));
+		CHECK(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector3(15.2, 0.0, 1.5)).is_equal_approx(Vector3(1.0, 0.0, 0.0)));
+		CHECK(navigation_server->map_get_flow_field_direction(map, begin_target_position, Vector3(8.5, 0.0, 1.5)).is_equal_approx(Vector3(-1.0, 0.0, 0.0)));
+		CHECK(navigation_server->agent_get_flow_field_direction(agent, end_target_position).is_equal_approx(Vector3(1.0, 0.0, 0.0)));
+
+		// Flow fields are rebuilt when the map changes.
+		navigation_server->region_set_enabled(region, false);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(navigation_server->map_get_flow_field_direction(map, end_target_position, Vector3(2.5, 0.0, 1.5)), Vector3());
+
+		navigation_server->free_rid(agent);
+		navigation_server->free_rid(region);
+		navigation_server->free_rid(map);
+		navigation_server->physics_process(0.0); // Give server some cycles to commit.
+	}
+
 	TEST_CASE("[NavigationServer3D] Server should simplify path properly") {
 		real_t simplify_epsilon = 0.2;
 		Vector<Vector3> source_path;
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include "core/config/project_settings.h"
+
 struct ErrorDetector {
 	ErrorDetector() {
 		eh.errfunc = _detect_error;
@@ -54,3 +56,19 @@ struct ErrorDetector {
 	ErrorHandlerList eh;
 	bool has_error = false;
 };
+
+// Sets a project setting for the lifetime of the object, then restores its previous value.
+struct ProjectSettingOverride {
+	ProjectSettingOverride(const String &p_name, const Variant &p_value) :
+			name(p_name) {
+		previous_value = ProjectSettings::get_singleton()->get_setting(p_name);
+		ProjectSettings::get_singleton()->set_setting(p_name, p_value);
+	}
+
+	~ProjectSettingOverride() {
+		ProjectSettings::get_singleton()->set_setting(name, previous_value);
+	}
+
+	String name;
+	Variant previous_value;
+};